@@ -81,62 +81,75 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
         std::vector<ColMeta> all_cols;
         get_all_cols({x->tab_name}, all_cols);
 
-        // 处理insert 的values值
-        for(int i = 0;i < x->vals.size();i++){
-            Value value;
-            //先检查是不是向string中插入datetime,如果是直接收录
-            auto str_lit = std::dynamic_pointer_cast<ast::DateTimeLit>(x->vals[i]);
-            if(str_lit != nullptr && all_cols[i].type == TYPE_STRING)
-            {
-                value.set_str(str_lit->val);
-            }else{
-                value = convert_sv_value(x->vals[i]);
-            }
-            //如果是bigint类型插入int,报错
-            //CHECK(liamY)bigint应该只能插入bigint的话，可以改为assert(value.type != TYPE_BIGINT || all_cols[i].type == TYPE_BIGINT);
-            if(value.type == TYPE_BIGINT && all_cols[i].type != TYPE_BIGINT) {
-                throw BigintOutOfRangeError("",std::to_string(value.bigint_val));
-            }
-            //如果是int类型插入bigint,转换成bigint
-            if(value.type == TYPE_INT && all_cols[i].type == TYPE_BIGINT){
-                Value num;
-                num.set_bigint(value.int_val);
-                query->values.push_back(num);
+        // 处理insert 的values值，多行VALUES的各行按顺序连续存放在query->values中
+        for (auto &row : x->rows) {
+            if (row.size() != all_cols.size()) {
+                throw InvalidValueCountError();
             }
-            else if(value.type != all_cols[i].type){
-                if(all_cols[i].type == TYPE_FLOAT)
+            size_t row_begin = query->values.size();
+            for(int i = 0;i < row.size();i++){
+                Value value;
+                //先检查是不是向string中插入datetime,如果是直接收录
+                auto str_lit = std::dynamic_pointer_cast<ast::DateTimeLit>(row[i]);
+                if(str_lit != nullptr && is_string_type(all_cols[i].type))
                 {
-                    //int转float
-                    if(value.type == TYPE_INT) {
-                        auto num = static_cast<float>(value.int_val);
-                        value.int_val= 0;
-                        value.set_float(num);
-                        query->values.push_back(value);
-                    }
-                    else if(value.type == TYPE_STRING){
-                        float num = std::stof(value.str_val);
-                        value.set_float(num);
-                        query->values.push_back(value);
-                    }
+                    value.set_str(str_lit->val);
+                }else{
+                    value = convert_sv_value(row[i]);
                 }
-                else if(all_cols[i].type == TYPE_INT)
-                {
-                    //float转int
-                    if(value.type == TYPE_FLOAT){
-                        int num = static_cast<int>(value.float_val);
-                        value.float_val = 0;
-                        value.set_int(num);
-                        query->values.push_back(value);
+                //字符串常量插入VARCHAR列
+                if(value.type == TYPE_STRING && all_cols[i].type == TYPE_VARCHAR) {
+                    value.set_varchar(std::move(value.str_val));
+                }
+                //如果是bigint类型插入int,报错
+                //CHECK(liamY)bigint应该只能插入bigint的话，可以改为assert(value.type != TYPE_BIGINT || all_cols[i].type == TYPE_BIGINT);
+                if(value.type == TYPE_BIGINT && all_cols[i].type != TYPE_BIGINT) {
+                    throw BigintOutOfRangeError("",std::to_string(value.bigint_val));
+                }
+                //如果是int类型插入bigint,转换成bigint
+                if(value.type == TYPE_INT && all_cols[i].type == TYPE_BIGINT){
+                    Value num;
+                    num.set_bigint(value.int_val);
+                    query->values.push_back(num);
+                }
+                else if(value.type != all_cols[i].type){
+                    if(all_cols[i].type == TYPE_FLOAT)
+                    {
+                        //int转float
+                        if(value.type == TYPE_INT) {
+                            auto num = static_cast<float>(value.int_val);
+                            value.int_val= 0;
+                            value.set_float(num);
+                            query->values.push_back(value);
+                        }
+                        else if(value.type == TYPE_STRING){
+                            float num = std::stof(value.str_val);
+                            value.set_float(num);
+                            query->values.push_back(value);
+                        }
                     }
-                    else if(value.type == TYPE_STRING){
-                        int num = std::stoi(value.str_val);
-                        value.set_int(num);
-                        query->values.push_back(value);
+                    else if(all_cols[i].type == TYPE_INT)
+                    {
+                        //float转int
+                        if(value.type == TYPE_FLOAT){
+                            int num = static_cast<int>(value.float_val);
+                            value.float_val = 0;
+                            value.set_int(num);
+                            query->values.push_back(value);
+                        }
+                        else if(value.type == TYPE_STRING){
+                            int num = std::stoi(value.str_val);
+                            value.set_int(num);
+                            query->values.push_back(value);
+                        }
                     }
                 }
+                else
+                    query->values.push_back(value);
+            }
+            if (query->values.size() - row_begin != all_cols.size()) {
+                throw InvalidValueCountError();
             }
-            else
-                query->values.push_back(value);
         }
 
 //        for (auto &sv_val : x->vals) {
@@ -170,6 +183,10 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
         //处理where条件
         get_clause(x->conds, query->conds,query->tables);
         check_clause(query->tables, query->conds);
+    } else if (auto x = std::dynamic_pointer_cast<ast::LoadStmt>(parse)) {
+        if (!sm_manager_->db_.is_table(x->tab_name)) {
+            throw TableNotFoundError(x->tab_name);
+        }
     } else {
         // do nothing
     }
@@ -288,6 +305,16 @@ void Analyze::fix_setClause(SetClause &setClause, const std::vector<std::string>
                 setClause.rhs = value;
             }
         }
+        //字符串常量、datetime转varchar
+        else if(lhs_type == TYPE_VARCHAR) {
+            if (setClause.rhs.type == TYPE_STRING) {
+                setClause.rhs.set_varchar(std::move(setClause.rhs.str_val));
+            } else if (setClause.rhs.type == TYPE_DATETIME) {
+                Value value;
+                value.set_varchar(datenum2datetime(std::to_string(setClause.rhs.datetime_val)));
+                setClause.rhs = value;
+            }
+        }
     }
 }
 
@@ -386,6 +413,16 @@ void Analyze::get_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv
                         cond.rhs_val = value;
                     }
                 }
+                else if(lhs_type == TYPE_VARCHAR){
+                    //字符串常量、datetime转varchar
+                    if(cond.rhs_val.type == TYPE_STRING){
+                        cond.rhs_val.set_varchar(std::move(cond.rhs_val.str_val));
+                    } else if(cond.rhs_val.type == TYPE_DATETIME){
+                        Value value;
+                        value.set_varchar(datenum2datetime(std::to_string(cond.rhs_val.datetime_val)));
+                        cond.rhs_val = value;
+                    }
+                }
             }
         }
 
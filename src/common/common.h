@@ -63,6 +63,11 @@ struct Value {
         str_val = std::move(str_val_);
     }
 
+    void set_varchar(std::string str_val_) {
+        type = TYPE_VARCHAR;
+        str_val = std::move(str_val_);
+    }
+
     void set_bigint(int64_t bigint_val_){
         type = TYPE_BIGINT;
         bigint_val = bigint_val_;
@@ -143,7 +148,7 @@ inline bool is_valid_date(const std::string& date_str) {
         } else if (type == TYPE_FLOAT) {
             assert(len == sizeof(float));
             *(float *)(raw->data) = float_val;
-        } else if (type == TYPE_STRING) {
+        } else if (is_string_type(type)) {
             if (len < (int)str_val.size()) {
                 throw StringOverflowError();
             }
@@ -206,6 +211,7 @@ inline int value_compare(const char *a, const char *b, ColType type, int col_len
             return (fa < fb) ? -1 : ((fa > fb) ? 1 : 0);
         }
         case TYPE_STRING:
+        case TYPE_VARCHAR:
         {
             auto res = memcmp(a, b, col_len);
             return res > 0? 1: (res<0 ? -1: 0);
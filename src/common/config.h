@@ -29,7 +29,7 @@ extern std::atomic<bool> enable_logging;
 extern std::chrono::duration<int64_t> log_timeout;
 
 static constexpr bool ARIES_DEBUG_MODE = false; // 是否调试ARIES
-static constexpr bool INDEX_REBUILD_MODE = true; // 是否重构索引
+static constexpr bool INDEX_REBUILD_MODE = false; // 启动时是否总是重构索引，为false时只重构校验失败的索引
 
 static constexpr int INVALID_FRAME_ID = -1;                                   // invalid frame id
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
@@ -38,15 +38,38 @@ static constexpr int INVALID_TIMESTAMP = -1;                                  //
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
 static constexpr int INVALID_OFFSET = -1;
 static constexpr int HEADER_PAGE_ID = 0;                                      // the header page id
-static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte  4KB
+static constexpr int DEFAULT_PAGE_SIZE = 4096;                                // 新建数据库默认的页面大小 4KB
+static constexpr int MIN_PAGE_SIZE = 4096;
+static constexpr int MAX_PAGE_SIZE = 32768;                                   // 栈上的页面缓冲区按此大小分配
+// size of a data page in byte。每个数据库在create_db时确定页面大小并记录在db.meta中，
+// 启动时在创建任何管理器之前设置为要打开的数据库的页面大小，之后不再改变
+inline int PAGE_SIZE = DEFAULT_PAGE_SIZE;
 // static constexpr int BUFFER_POOL_SIZE = 4;                                      // size of buffer pool 16KB
 // static constexpr int BUFFER_POOL_SIZE = 65536;                                // size of buffer pool 256MB
-static constexpr int BUFFER_POOL_SIZE = 131072;                                // size of buffer pool 512MB
+static constexpr int BUFFER_POOL_SIZE = 131072;                                // 默认的buffer pool帧数(4KB页面时512MB)，可由启动参数-b覆盖
 // static constexpr int BUFFER_POOL_SIZE = 262144;                                // size of buffer pool 1GB
 //static constexpr int BUFFER_POOL_SIZE =  262144;
-static constexpr int JOIN_POOL_SIZE = BUFFER_POOL_SIZE/2;
-static constexpr int LOG_BUFFER_SIZE = (1024 * PAGE_SIZE);                    // size of a log buffer in byte
-// static constexpr int LOG_BUFFER_SIZE = (1 * PAGE_SIZE);                    // 测试性质的小buffer
+static constexpr int BUFFER_POOL_INSTANCES = 16;                              // buffer pool分片数，每个分片独立加锁
+static constexpr int BUFFER_POOL_MIN_INSTANCE_SIZE = 64;                      // 每个分片最少的帧数，pool较小时减少分片数
+static constexpr bool BUFFER_POOL_HUGE_PAGES = true;                          // 帧数据区按大页对齐并建议内核使用透明大页
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;                     // 透明大页的大小(2MB)
+static constexpr int BUFFER_RING_SIZE = 32;                                   // 大表扫描使用的私有帧环大小(128KB)
+static constexpr int BUFFER_RING_SCAN_DIVISOR = 4;                            // 表的页数超过pool_size/4时顺序扫描使用帧环
+static constexpr int BG_WRITER_DELAY_MS = 20;                                 // 后台写页线程两轮之间的间隔
+static constexpr int BG_WRITER_CLEAN_DIVISOR = 8;                             // 后台写页线程让每个分片中空闲或干净的可淘汰帧达到1/8
+static constexpr int BG_WRITER_MAX_PAGES = 512;                               // 后台写页线程每轮最多写回的页数
+static constexpr int IO_BATCH_PAGES = 256;                                    // 批量写回时每批复制和写回的页数(1MB)
+static constexpr int READAHEAD_PAGES = 32;                                    // 顺序扫描每次预读的页数(128KB)
+static constexpr int IO_URING_QUEUE_DEPTH = 256;                              // io_uring后端同时在设备上执行的最大请求数
+static constexpr int FREE_SPACE_MAP_OFFSET = 1024;                             // 空闲页面位图在文件头页面中的偏移，文件头不能超过此长度
+static constexpr int FILE_EXTENT_SIZE = 1024 * 1024;                          // 数据文件每次增长预分配的大小(1MB)
+static constexpr size_t BULK_LOAD_WINDOW_SIZE = 16 * 1024 * 1024;             // 批量导入CSV时每个窗口的大小，窗口内并行解析
+static constexpr size_t BULK_LOAD_MIN_PART_SIZE = 64 * 1024;                  // 窗口切分给每个解析线程的最小字节数
+static constexpr size_t BULK_LOAD_MIN_SORT_RUN = 16 * 1024;                   // 并行排序索引键时每个线程的最少键数
+static constexpr size_t INDEX_SORT_MEMORY = 64 * 1024 * 1024;                 // 建索引时排序键使用的内存上限，超过时写入临时文件
+static constexpr double INDEX_BULK_LOAD_FILL_FACTOR = 0.9;                    // 自底向上建索引时结点的填充率，留出空间给之后的插入
+static constexpr int LOG_BUFFER_SIZE = (1024 * DEFAULT_PAGE_SIZE);            // size of a log buffer in byte
+// static constexpr int LOG_BUFFER_SIZE = (1 * DEFAULT_PAGE_SIZE);            // 测试性质的小buffer
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
 static constexpr int TMP_FD = -2; // 临时使用的fd (不知道会不会有冲突)
 
@@ -63,7 +86,7 @@ using timestamp_t = int32_t;  // timestamp type, used for transaction concurrenc
 // log file
 static const std::string LOG_FILE_NAME = "db.log";
 
-// replacer
-static const std::string REPLACER_TYPE = "LRU";
+// replacer (置换策略由启动参数选择，见ReplacerType)
+static constexpr size_t LRUK_REPLACER_K = 2;                                  // LRU-K的K
 
 static const std::string DB_META_NAME = "db.meta";
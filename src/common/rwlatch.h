@@ -6,77 +6,233 @@
 #define RMDB_RWLATCH_H
 #pragma once
 
-#include <iostream>
+#include <cstdint>
 #include <thread>
-#include <condition_variable>
-#include <mutex>
-#include <string>
-#include <vector>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 /**
- * @description 读写锁
- *
- * @use 通过read_lock, read_unlock,  write_lock, write_unlock 对page进行读写锁操作
- * @see rwlatch_test中的测试用例
- *
- * @reference https://stackoverflow.com/questions/12033188/how-would-you-implement-your-own-reader-writer-lock-in-c11
- * @reference https://github.com/kw90/ReadWriteLock
- * @reference https://www.educative.io/blog/modern-multithreading-and-concurrency-in-cpp
- * @reference https://github.com/Kevin-ziyue/RWLatch/blob/master/rwlatch.hpp
+ * @description: 8字节的读写latch：一个32位状态字加一个32位版本号，无竞争时加锁解锁各只需一次原子操作。
+ * 竞争时先自旋一小段时间，再在状态字上futex等待。
+ * 状态字的低位是持有读锁的线程数，高位分别表示写锁、升级锁、有写者在等待、有线程在futex上等待。
+ * 有写者等待时新的读者不再进入，写者不会被源源不断的读者饿死。
+ * 支持三种模式：读(共享)、写(独占)、升级(与读者共享，与写者和其他升级者互斥，之后可无死锁地升级为写锁)。
+ * 版本号在写锁期间为奇数，乐观读记录版本号、不加锁读取数据，再校验版本号未变。
  */
 class RWLatch {
-
 public:
     void read_lock() {
-        std::unique_lock<std::mutex> unq_mtx(mtx);
-        while (write_locked){
-            can_read_or_write.wait(unq_mtx);  // wait under notification(notify-all)
-            // Atomically unlocks lock, blocks the current executing thread. A notify will allow it to lock the lock, and unblocks the current thread.
+        // 无竞争时只有一次fetch_add；有写者或等待的写者时撤销加上的计数，按read_unlock的规则唤醒后进入慢路径
+        uint32_t old = __atomic_fetch_add(&state_, 1, __ATOMIC_ACQUIRE);
+        if (!(old & (WRITER | WRITER_PENDING))) {
+            return;
+        }
+        read_unlock();
+        read_lock_slow();
+    }
+
+    bool try_read_lock() {
+        uint32_t state = __atomic_load_n(&state_, __ATOMIC_RELAXED);
+        return !(state & (WRITER | WRITER_PENDING)) &&
+               __atomic_compare_exchange_n(&state_, &state, state + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    }
+
+    void read_unlock() {
+        uint32_t old = __atomic_fetch_sub(&state_, 1, __ATOMIC_RELEASE);
+        // 最后一个读者离开时唤醒等待的写者或升级者
+        if ((old & READERS) == 1 && (old & WAITERS)) {
+            __atomic_fetch_and(&state_, ~WAITERS, __ATOMIC_RELAXED);
+            wake_all();
+        }
+    }
+
+    void write_lock() {
+        for (int spins = 0;; spins++) {
+            uint32_t state = __atomic_load_n(&state_, __ATOMIC_RELAXED);
+            if (!(state & (WRITER | UPGRADER | READERS))) {
+                if (__atomic_compare_exchange_n(&state_, &state, (state & ~WRITER_PENDING) | WRITER, true,
+                                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                    begin_write();
+                    return;
+                }
+                continue;
+            }
+            // 阻止新的读者进入，等待现有的读者和写者离开
+            if (!(state & WRITER_PENDING) &&
+                !__atomic_compare_exchange_n(&state_, &state, state | WRITER_PENDING, true, __ATOMIC_RELAXED,
+                                             __ATOMIC_RELAXED)) {
+                continue;
+            }
+            backoff(spins, state | WRITER_PENDING);
+        }
+    }
+
+    bool try_write_lock() {
+        uint32_t state = __atomic_load_n(&state_, __ATOMIC_RELAXED);
+        if (state & (WRITER | UPGRADER | READERS)) {
+            return false;
+        }
+        if (!__atomic_compare_exchange_n(&state_, &state, (state & ~WRITER_PENDING) | WRITER, false, __ATOMIC_ACQUIRE,
+                                         __ATOMIC_RELAXED)) {
+            return false;
         }
-        reader_cnt++;
-        can_unlock.notify_all();
+        begin_write();
+        return true;
     }
 
-    void read_unlock(){
-        std::unique_lock<std::mutex> unq_mtx(mtx);
-        while(reader_cnt < 1){ // check(AntiO2) 此处应该时reader_cnt >= 1 ?
-            can_unlock.wait(unq_mtx);
+    void write_unlock() {
+        __atomic_fetch_add(&version_, 1, __ATOMIC_RELEASE);
+        uint32_t old = __atomic_fetch_and(&state_, ~(WRITER | WAITERS), __ATOMIC_RELEASE);
+        if (old & WAITERS) {
+            wake_all();
         }
-        reader_cnt --;
-        if(reader_cnt == 0){
-            can_read_or_write.notify_all();
+    }
+
+    /**
+     * @description: 加升级锁：可与读者同时持有，之后调用upgrade()升级为写锁。
+     * 同一时刻只有一个升级者，因此升级不会与其他升级者互相等待而死锁
+     */
+    void upgrade_lock() {
+        for (int spins = 0;; spins++) {
+            uint32_t state = __atomic_load_n(&state_, __ATOMIC_RELAXED);
+            if (!(state & (WRITER | UPGRADER | WRITER_PENDING))) {
+                if (__atomic_compare_exchange_n(&state_, &state, state | UPGRADER, true, __ATOMIC_ACQUIRE,
+                                                __ATOMIC_RELAXED)) {
+                    return;
+                }
+                continue;
+            }
+            backoff(spins, state);
+        }
+    }
+
+    void upgrade_unlock() {
+        uint32_t old = __atomic_fetch_and(&state_, ~(UPGRADER | WAITERS), __ATOMIC_RELEASE);
+        if (old & WAITERS) {
+            wake_all();
         }
     }
 
-    void write_lock(){
-        std::unique_lock<std::mutex> unq_mtx(mtx);
-        while(reader_cnt || write_locked){
-            can_read_or_write.wait(unq_mtx);
+    /**
+     * @description: 把持有的升级锁升级为写锁，等待现有的读者离开
+     */
+    void upgrade() {
+        for (int spins = 0;; spins++) {
+            uint32_t state = __atomic_load_n(&state_, __ATOMIC_RELAXED);
+            if (!(state & READERS)) {
+                if (__atomic_compare_exchange_n(&state_, &state, (state & ~(UPGRADER | WRITER_PENDING)) | WRITER, true,
+                                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                    begin_write();
+                    return;
+                }
+                continue;
+            }
+            if (!(state & WRITER_PENDING) &&
+                !__atomic_compare_exchange_n(&state_, &state, state | WRITER_PENDING, true, __ATOMIC_RELAXED,
+                                             __ATOMIC_RELAXED)) {
+                continue;
+            }
+            backoff(spins, state | WRITER_PENDING);
         }
-        write_locked = true;
-        can_unlock.notify_all();
     }
 
-    void write_unlock(){
-        std::unique_lock<std::mutex> unq_mtx(mtx);
-        while(!write_locked){
-            can_unlock.wait(unq_mtx);
+    /**
+     * @description: 乐观读的开始：等待当前的写者离开，返回版本号
+     */
+    uint32_t read_version() const {
+        uint32_t version = __atomic_load_n(&version_, __ATOMIC_ACQUIRE);
+        for (int spins = 0; version & 1; spins++) {
+            pause(spins);
+            version = __atomic_load_n(&version_, __ATOMIC_ACQUIRE);
         }
-        write_locked = false;
-        can_read_or_write.notify_all();  // notify all waits
+        return version;
+    }
+
+    /**
+     * @description: 乐观读的结束：读取期间没有写者修改过数据时返回true，否则调用者需要重读
+     */
+    bool validate(uint32_t version) const {
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        return __atomic_load_n(&version_, __ATOMIC_RELAXED) == version;
     }
 
     [[nodiscard]] size_t getReaderCnt() const {
-        return reader_cnt;
+        return __atomic_load_n(&state_, __ATOMIC_RELAXED) & READERS;
     }
 
 private:
-    std::mutex mtx;         // mutex for critical section
-    bool write_locked = false;
-    size_t reader_cnt = 0;
-    std::condition_variable can_read_or_write;
-    std::condition_variable can_unlock;
+    static constexpr uint32_t WRITER = 1u << 31;
+    static constexpr uint32_t UPGRADER = 1u << 30;
+    static constexpr uint32_t WRITER_PENDING = 1u << 29;
+    static constexpr uint32_t WAITERS = 1u << 28;
+    static constexpr uint32_t READERS = WAITERS - 1;
+    static constexpr int SPIN_LIMIT = 64;
+
+    // 写锁期间版本号为奇数，乐观读者据此得知数据正在被修改；fence保证之后对数据的修改不会早于版本号可见
+    void begin_write() {
+        __atomic_fetch_add(&version_, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    // read_lock的慢路径：有写者或等待的写者时自旋，之后futex等待
+    void read_lock_slow() {
+        for (int spins = 0;; spins++) {
+            uint32_t state = __atomic_load_n(&state_, __ATOMIC_RELAXED);
+            if (!(state & (WRITER | WRITER_PENDING))) {
+                if (__atomic_compare_exchange_n(&state_, &state, state + 1, true, __ATOMIC_ACQUIRE,
+                                                __ATOMIC_RELAXED)) {
+                    return;
+                }
+                continue;
+            }
+            backoff(spins, state);
+        }
+    }
+
+    static void pause(int spins) {
+        if (spins < SPIN_LIMIT) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    // 自旋一段时间后设置WAITERS位，在状态字仍为state | WAITERS时睡眠；期间状态字被改变则futex立即返回
+    void backoff(int spins, uint32_t state) {
+        if (spins < SPIN_LIMIT) {
+            pause(spins);
+            return;
+        }
+#ifdef __linux__
+        if (!(state & WAITERS) &&
+            !__atomic_compare_exchange_n(&state_, &state, state | WAITERS, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            return;
+        }
+        syscall(SYS_futex, &state_, FUTEX_WAIT_PRIVATE, state | WAITERS, nullptr,
+                nullptr, 0);
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    void wake_all() {
+#ifdef __linux__
+        syscall(SYS_futex, &state_, FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr,
+                0);
+#endif
+    }
+
+    // 只通过__atomic内建函数访问：与std::atomic的成员函数不同，它们在-O0下也直接展开为原子指令
+    uint32_t state_{0};
+    uint32_t version_{0};
 };
 
+static_assert(sizeof(RWLatch) == 8, "RWLatch should stay one word");
 
-#endif //RMDB_RWLATCH_H
\ No newline at end of file
+#endif //RMDB_RWLATCH_H
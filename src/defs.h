@@ -57,9 +57,16 @@ struct RidHash {
  * TODO 添加新的类信息。
  */
 enum ColType {
-    TYPE_INT, TYPE_FLOAT, TYPE_STRING, TYPE_BIGINT,TYPE_DATETIME,
+    TYPE_INT, TYPE_FLOAT, TYPE_STRING, TYPE_BIGINT,TYPE_DATETIME, TYPE_VARCHAR,
 };
 
+/**
+ * CHAR和VARCHAR列在内存中的记录里都占声明的长度、以0补齐，VARCHAR只在数据文件中按实际长度存储
+ */
+inline bool is_string_type(ColType type) {
+    return type == TYPE_STRING || type == TYPE_VARCHAR;
+}
+
 inline int col2len(ColType type) {
     std::map<ColType, int> l = {
             {TYPE_INT,    sizeof(int)},
@@ -86,7 +93,8 @@ inline std::string coltype2str(ColType type) {
             {TYPE_FLOAT,  "FLOAT"},
             {TYPE_STRING, "STRING"},
             {TYPE_BIGINT,"BIGINT"},//liamY
-            {TYPE_DATETIME,"DATETIME"}
+            {TYPE_DATETIME,"DATETIME"},
+            {TYPE_VARCHAR, "VARCHAR"}
     };
     return m.at(type);
 }
@@ -11,6 +11,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <cerrno>
+#include <cstdint>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -59,6 +60,13 @@ class FileNotFoundError : public RMDBError {
     FileNotFoundError(const std::string &filename) : RMDBError("File not found: " + filename) {}
 };
 
+class PageChecksumError : public RMDBError {
+   public:
+    PageChecksumError(const std::string &filename, int page_no, uint32_t expected, uint32_t actual)
+        : RMDBError("Page checksum mismatch: " + filename + " page " + std::to_string(page_no) + ", stored " +
+                    std::to_string(expected) + ", computed " + std::to_string(actual)) {}
+};
+
 // RM errors
 class RecordNotFoundError : public RMDBError {
    public:
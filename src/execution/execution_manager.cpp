@@ -25,7 +25,7 @@ See the Mulan PSL v2 for more details. */
 const char *help_info = "Supported SQL syntax:\n"
                    "  command ;\n"
                    "command:\n"
-                   "  CREATE TABLE table_name (column_name type [, column_name type ...])\n"
+                   "  CREATE TABLE table_name (column_name type [, column_name type ...]) [USING PAX]\n"
                    "  DROP TABLE table_name\n"
                    "  CREATE INDEX table_name (column_name)\n"
                    "  DROP INDEX table_name (column_name)\n"
@@ -33,6 +33,7 @@ const char *help_info = "Supported SQL syntax:\n"
                    "  DELETE FROM table_name [WHERE where_clause]\n"
                    "  UPDATE table_name SET column_name = value [, column_name = value ...] [WHERE where_clause]\n"
                    "  SELECT selector FROM table_name [WHERE where_clause]\n"
+                   "  LOAD 'file_name' INTO table_name\n"
                    "type:\n"
                    "  {INT | FLOAT | CHAR(n)}\n"
                    "where_clause:\n"
@@ -52,7 +53,7 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
         switch(x->tag) {
             case T_CreateTable:
             {
-                sm_manager_->create_table(x->tab_name_, x->cols_, context);
+                sm_manager_->create_table(x->tab_name_, x->cols_, context, x->pax_);
                 break;
             }
             case T_DropTable:
@@ -74,6 +75,8 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
                 throw InternalError("Unexpected field type");
                 break;  
         }
+    } else if (auto x = std::dynamic_pointer_cast<LoadPlan>(plan)) {
+        sm_manager_->load_csv(x->file_name_, x->tab_name_, context);
     }
 }
 
@@ -162,9 +165,9 @@ void QlManager::select_from_aggregate(std::unique_ptr<AbstractExecutor> executor
             float col_res_float = 0;
             int choose = 0;//为1则是int 2则是float;
             for (executorTreeRoot->beginTuple(); !executorTreeRoot->is_end(); executorTreeRoot->nextTuple()) {
-                auto Tuple = executorTreeRoot->Next();
+                auto Tuple = executorTreeRoot->NextView();
                 for (auto &col : executorTreeRoot->cols()) {
-                    char *rec_buf = Tuple->data + col.offset;
+                    const char *rec_buf = Tuple.data() + col.offset;
                     if (col.type == TYPE_INT) {
                         col_res_int += *(int *)rec_buf;
                         choose = 1;
@@ -197,16 +200,16 @@ void QlManager::select_from_aggregate(std::unique_ptr<AbstractExecutor> executor
             executorTreeRoot->beginTuple();
             int choose = 0;//选择1为int 2为float 3为string
             if(!executorTreeRoot->is_end()) {
-                auto Tuple = executorTreeRoot->Next();
+                auto Tuple = executorTreeRoot->NextView();
                 for (auto &col: executorTreeRoot->cols()) {
-                    char *rec_buf = Tuple->data + col.offset;
+                    const char *rec_buf = Tuple.data() + col.offset;
                     if (col.type == TYPE_INT) {
                         maxInt = *(int *) rec_buf;
                         choose = 1;
                     } else if (col.type == TYPE_FLOAT) {
                         maxFloat = *(float *) rec_buf;
                         choose = 2;
-                    } else if (col.type == TYPE_STRING) {
+                    } else if (is_string_type(col.type)) {
                         auto str = std::string((char *) rec_buf, col.len);
                         maxStr = str;
                         choose = 3;
@@ -215,14 +218,14 @@ void QlManager::select_from_aggregate(std::unique_ptr<AbstractExecutor> executor
                 executorTreeRoot->nextTuple();
             }
             for (; !executorTreeRoot->is_end(); executorTreeRoot->nextTuple()) {
-                auto Tuple = executorTreeRoot->Next();
+                auto Tuple = executorTreeRoot->NextView();
                 for (auto &col: executorTreeRoot->cols()) {
-                    char *rec_buf = Tuple->data + col.offset;
+                    const char *rec_buf = Tuple.data() + col.offset;
                     if (col.type == TYPE_INT) {
                         maxInt = maxInt > *(int *) rec_buf ? maxInt : *(int *) rec_buf;
                     } else if (col.type == TYPE_FLOAT) {
                         maxFloat = maxFloat > *(float *) rec_buf ? maxFloat : *(float *) rec_buf;
-                    } else if (col.type == TYPE_STRING) {
+                    } else if (is_string_type(col.type)) {
                         auto str = std::string((char *) rec_buf, col.len);
                         maxStr = maxStr > str ? maxStr : str;
                     }
@@ -246,16 +249,16 @@ void QlManager::select_from_aggregate(std::unique_ptr<AbstractExecutor> executor
             executorTreeRoot->beginTuple();
             int choose = 0;//选择1为int 2为float 3为string,因为最后结果可能为0
             if(!executorTreeRoot->is_end()){
-                auto Tuple = executorTreeRoot->Next();
+                auto Tuple = executorTreeRoot->NextView();
                 for (auto &col: executorTreeRoot->cols()) {
-                    char *rec_buf = Tuple->data + col.offset;
+                    const char *rec_buf = Tuple.data() + col.offset;
                     if (col.type == TYPE_INT) {
                         minInt = *(int *) rec_buf;
                         choose = 1;
                     } else if (col.type == TYPE_FLOAT) {
                         minFloat = *(float *) rec_buf;
                         choose = 2;
-                    } else if (col.type == TYPE_STRING) {
+                    } else if (is_string_type(col.type)) {
                         auto str = std::string((char *) rec_buf, col.len);
                         minStr = str;
                         choose = 3;
@@ -264,14 +267,14 @@ void QlManager::select_from_aggregate(std::unique_ptr<AbstractExecutor> executor
                 executorTreeRoot->nextTuple();
             }
             for (; !executorTreeRoot->is_end(); executorTreeRoot->nextTuple()) {
-                auto Tuple = executorTreeRoot->Next();
+                auto Tuple = executorTreeRoot->NextView();
                 for (auto &col: executorTreeRoot->cols()) {
-                    char *rec_buf = Tuple->data + col.offset;
+                    const char *rec_buf = Tuple.data() + col.offset;
                     if (col.type == TYPE_INT) {
                         minInt = minInt < *(int *) rec_buf ? minInt : *(int *) rec_buf;
                     } else if (col.type == TYPE_FLOAT) {
                         minFloat = minFloat < *(float *) rec_buf ? minFloat : *(float *) rec_buf;
-                    } else if (col.type == TYPE_STRING) {
+                    } else if (is_string_type(col.type)) {
                         auto str = std::string((char *) rec_buf, col.len);
                         minStr = minStr < str ? minStr : str;
                     }
@@ -337,16 +340,16 @@ void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
     size_t num_rec = 0;
     // 执行query_plan
     for (executorTreeRoot->beginTuple(); !executorTreeRoot->is_end(); executorTreeRoot->nextTuple()) {
-        auto Tuple = executorTreeRoot->Next();
+        auto Tuple = executorTreeRoot->NextView();
         std::vector<std::string> columns;
         for (auto &col : executorTreeRoot->cols()) {
             std::string col_str;
-            char *rec_buf = Tuple->data + col.offset;
+            const char *rec_buf = Tuple.data() + col.offset;
             if (col.type == TYPE_INT) {
                 col_str = std::to_string(*(int *)rec_buf);
             } else if (col.type == TYPE_FLOAT) {
                 col_str = std::to_string(*(float *)rec_buf);
-            } else if (col.type == TYPE_STRING) {
+            } else if (is_string_type(col.type)) {
                 col_str = std::string((char *)rec_buf, col.len);
                 col_str.resize(strlen(col_str.c_str()));
             }else if(col.type == TYPE_BIGINT){
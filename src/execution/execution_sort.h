@@ -55,6 +55,14 @@ public:
         used_tuple.clear();
     }
 
+    void set_needed_cols(const std::vector<ColMeta> &cols) override {
+        std::vector<ColMeta> needed_cols = cols;
+        for (auto &order_col : order_cols) {
+            needed_cols.push_back(*get_col(prev_->cols(), order_col.tab_col));
+        }
+        prev_->set_needed_cols(needed_cols);
+    }
+
     bool compare(const std::unique_ptr<RmRecord> &lhs, const std::unique_ptr<RmRecord> &rhs)
     {
         for( auto &order_col : order_cols){
@@ -115,6 +123,11 @@ public:
         return std::move(tuples[tuple_num]);
     }
 
+    RmTupleView NextView() override
+    {
+        return RmTupleView(*tuples[tuple_num]);
+    }
+
     Rid &rid() override { return _abstract_rid; }
 
     //limit 的is_end判断不能用原来的
@@ -21,6 +21,8 @@ class AbstractExecutor {
 
     Context *context_;
 
+    std::unique_ptr<RmRecord> view_rec_;   // 默认的NextView()物化出的当前元组
+
     virtual ~AbstractExecutor() = default;
 
     virtual size_t tupleLen() const { return 0; };
@@ -40,8 +42,23 @@ class AbstractExecutor {
 
     virtual Rid &rid() = 0;
 
+    /**
+     * 上层算子只会读取输出元组中的cols字段。扫描算子据此只读取需要的列(PAX表)，
+     * 其它算子把cols连同自身用到的字段传给儿子节点。默认不做任何事，输出元组中的所有字段都有效
+     */
+    virtual void set_needed_cols(const std::vector<ColMeta> &cols) {}
+
     virtual std::unique_ptr<RmRecord> Next() = 0;
 
+    /**
+     * 当前元组的只读视图，在下一次beginTuple()/nextTuple()之前有效。只读取当前元组、不需要保存它的上层算子
+     * 应使用NextView()代替Next()。默认实现物化Next()的结果，能直接给出视图的算子重写它以避免复制
+     */
+    virtual RmTupleView NextView() {
+        view_rec_ = Next();
+        return view_rec_ == nullptr ? RmTupleView() : RmTupleView(*view_rec_);
+    }
+
     /**
      * Warn(AntiO2) 不要用这个
      * @param target
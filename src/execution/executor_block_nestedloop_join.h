@@ -95,6 +95,19 @@ class BlockNestedLoopJoinExecutor : public AbstractExecutor {
 
     }
 
+    /**
+     * 儿子节点按表名和字段名取出属于自己的字段，这里的offset不会被使用
+     */
+    void set_needed_cols(const std::vector<ColMeta> &cols) override {
+        std::vector<ColMeta> needed_cols = cols;
+        for (auto &[left_join_col, right_join_col] : join_cols_) {
+            needed_cols.push_back(left_join_col);
+            needed_cols.push_back(right_join_col);
+        }
+        left_->set_needed_cols(needed_cols);
+        right_->set_needed_cols(needed_cols);
+    }
+
     void beginTuple() override {
         init_right_page();
         init_left_page();
@@ -106,6 +119,10 @@ class BlockNestedLoopJoinExecutor : public AbstractExecutor {
     }
 
     void nextTuple() override {
+        if(is_end_) {
+            // 结束时已经释放了join buffer，上层算子(如Sort)在结束后继续调用时不能重复释放
+            return;
+        }
         // for(left buffer)
         //      for(right buffer in whole right)
         //          for(page in left buffer)          \
@@ -223,11 +240,15 @@ class BlockNestedLoopJoinExecutor : public AbstractExecutor {
         return std::make_unique<RmRecord>(join_record);
     }
 
+    RmTupleView NextView() override {
+        return is_end_ ? RmTupleView() : RmTupleView(join_record);
+    }
+
     Rid &rid() override { return _abstract_rid; }
     void init_right_page() {
       right_->beginTuple();
       while(!right_->is_end()) {
-        if(right_buffer_pages_.size()>=JOIN_POOL_SIZE/2) {
+        if(right_buffer_pages_.size()>=bpm_->get_pool_size()/4) {
           break;
         }
 
@@ -252,7 +273,7 @@ class BlockNestedLoopJoinExecutor : public AbstractExecutor {
     bool fill_right_page(Page* page) {
       int record_cnt = 0;// 当前页存放的page数
       while(!right_->is_end()&&record_cnt < right_num_per_page_) {
-        memcpy(page->get_data()+record_cnt*right_len_,right_->Next()->data,right_len_);
+        memcpy(page->get_data()+record_cnt*right_len_,right_->NextView().data(),right_len_);
         record_cnt++;
         right_->nextTuple();
       }
@@ -267,7 +288,7 @@ class BlockNestedLoopJoinExecutor : public AbstractExecutor {
         left_->beginTuple();
         while(!left_->is_end()) {
           // if(bpm_->get_free_size() <= 35) {
-             if(left_buffer_pages_.size()>=JOIN_POOL_SIZE/2) { // 在测试时，可以只用两个buffer page
+             if(left_buffer_pages_.size()>=bpm_->get_pool_size()/4) { // 在测试时，可以只用两个buffer page
                 // 已经缓存了足够数量的左侧tuple
                 // 这个35是我随便写的数字，最后给bpm 留个几页防止出什么问题。
                 // 比如 如果不小心调用到了index scan，给b+树的页留个几页。
@@ -291,7 +312,7 @@ class BlockNestedLoopJoinExecutor : public AbstractExecutor {
     bool fill_left_page(Page* page) {
         int record_cnt = 0;// 当前页存放的page数
         while(!left_->is_end()&&record_cnt < left_num_per_page_) {
-            memcpy(page->get_data()+record_cnt*left_len_,left_->Next()->data,left_len_);
+            memcpy(page->get_data()+record_cnt*left_len_,left_->NextView().data(),left_len_);
             record_cnt++;
             left_->nextTuple();
         }
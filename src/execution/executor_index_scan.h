@@ -35,7 +35,11 @@ class IndexScanExecutor : public AbstractExecutor {
     Rid rid_;
     SmManager *sm_manager_;
     std::unique_ptr<IxScan> ix_scan_;
-    std::unique_ptr<RmRecord> rm_; //下一个Next返回的record
+    PageGuard page_guard_;          // 当前元组所在页面的pin
+    std::vector<char> decode_buf_;  // slotted page和PAX页面中的记录解码到这里
+    RmColumnMask cond_cols_{0};     // conds_用到的字段
+    RmColumnMask read_cols_{RM_ALL_COLUMNS};    // 上层算子需要的字段和cond_cols_，PAX表只读取这些列
+    RmTupleView view_;              // 下一个Next返回的record，指向帧内或decode_buf_
 
     bool is_end_{false};
    public:
@@ -54,6 +58,7 @@ class IndexScanExecutor : public AbstractExecutor {
         fh_ = sm_manager_->fhs_.at(tab_name_).get();
         cols_ = tab_.cols;
         len_ = cols_.back().offset + cols_.back().len;
+        decode_buf_.resize(fh_->getFileHdr().record_size);
         std::map<CompOp, CompOp> swap_op = {
             {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT}, {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
         };
@@ -66,10 +71,21 @@ class IndexScanExecutor : public AbstractExecutor {
                 std::swap(cond.lhs_col, cond.rhs_col);
                 cond.op = swap_op.at(cond.op);
             }
+            cond_cols_ |= rm_column_bit(cols_, cond.lhs_col.tab_name, cond.lhs_col.col_name);
+            if (!cond.is_rhs_val) {
+                cond_cols_ |= rm_column_bit(cols_, cond.rhs_col.tab_name, cond.rhs_col.col_name);
+            }
         }
         fed_conds_ = conds_;
     }
 
+    void set_needed_cols(const std::vector<ColMeta> &cols) override {
+        read_cols_ = cond_cols_;
+        for (auto &col : cols) {
+            read_cols_ |= rm_column_bit(cols_, col.tab_name, col.name);
+        }
+    }
+
     void beginTuple() override {
         auto index_name = sm_manager_->get_ix_manager()->get_index_name(tab_name_,index_meta_.cols);
         auto iter = sm_manager_->ihs_.find(index_name);
@@ -196,7 +212,7 @@ class IndexScanExecutor : public AbstractExecutor {
         }
         while(!ix_scan_->is_end()) {
             rid_ = ix_scan_->rid(); // 获取下一个rid
-            rm_ = fh_->get_record(rid_,context_);
+            view_ = fh_->get_record_view(rid_, &page_guard_, decode_buf_.data(), nullptr, read_cols_);
             if(CheckConditions()) {
                 // 如果条件为真（所有where 通过）
                 ix_scan_->next();
@@ -205,10 +221,18 @@ class IndexScanExecutor : public AbstractExecutor {
             ix_scan_->next();
         }
         is_end_=true;
+        page_guard_.reset();
     }
 
     std::unique_ptr<RmRecord> Next() override {
-        return std::move(rm_);
+        if(is_end_) {
+            return nullptr;
+        }
+        return view_.materialize();
+    }
+
+    RmTupleView NextView() override {
+        return view_;
     }
 
     Rid &rid() override { return rid_; }
@@ -241,8 +265,8 @@ class IndexScanExecutor : public AbstractExecutor {
             return false;
         }
         auto left_col = get_col(cols_,condition.lhs_col); // 首先根据condition中，左侧列的名字，来获取该列的数据
-        char* l_value = rm_->data+left_col->offset; // 获得左值。CHECK(AntiO2) 这里左值一定是常量吗？有没有可能两边都是常数。
-        char* r_value;
+        const char* l_value = view_.data()+left_col->offset; // 获得左值。CHECK(AntiO2) 这里左值一定是常量吗？有没有可能两边都是常数。
+        const char* r_value;
         ColType r_type{};
         if(condition.is_rhs_val) {
             // 如果右值是一个常数
@@ -251,7 +275,7 @@ class IndexScanExecutor : public AbstractExecutor {
         } else {
             // check(AntiO2) 这里只有同一张表上两个列比较的情况吗？
             auto r_col =  get_col(cols_,condition.rhs_col);
-            r_value = rm_->data + r_col->offset;
+            r_value = view_.data() + r_col->offset;
             r_type = r_col->type;
         }
      //    assert(left_col->type==r_type); // 保证两个值类型一样。
@@ -27,12 +27,15 @@ class InsertExecutor : public AbstractExecutor {
     int len_;
     std::vector<ColMeta> cols_;
    public:
+    /**
+     * @param values 要插入的各行数据，多行时按行依次连续存放
+     */
     InsertExecutor(SmManager *sm_manager, const std::string &tab_name, std::vector<Value> values, Context *context) {
         sm_manager_ = sm_manager;
         tab_ = sm_manager_->db_.get_table(tab_name);
         values_ = values;
         tab_name_ = tab_name;
-        if (values.size() != tab_.cols.size()) {
+        if (values.empty() || values.size() % tab_.cols.size() != 0) {
             throw InvalidValueCountError();
         }
         fh_ = sm_manager_->fhs_.at(tab_name).get();
@@ -53,53 +56,64 @@ class InsertExecutor : public AbstractExecutor {
     };
 
     std::unique_ptr<RmRecord> Next() override {
-        // Make record buffer
-        RmRecord rec(fh_->get_file_hdr().record_size);
-        for (size_t i = 0; i < values_.size(); i++) {
-            auto &col = tab_.cols[i];
-            auto &val = values_[i];
-            if (col.type != val.type) {
-                throw IncompatibleTypeError(coltype2str(col.type), coltype2str(val.type));
+        // Make record buffer，多行时各条记录首尾相接
+        int record_size = fh_->get_file_hdr().record_size;
+        size_t num_cols = tab_.cols.size();
+        int num_rows = static_cast<int>(values_.size() / num_cols);
+        std::vector<char> recs(static_cast<size_t>(num_rows) * record_size);
+        for (int r = 0; r < num_rows; r++) {
+            for (size_t i = 0; i < num_cols; i++) {
+                auto &col = tab_.cols[i];
+                auto &val = values_[r * num_cols + i];
+                if (col.type != val.type) {
+                    throw IncompatibleTypeError(coltype2str(col.type), coltype2str(val.type));
+                }
+                val.init_raw(col.len);
+                // 将Value数据存入rec中。
+                memcpy(recs.data() + r * record_size + col.offset, val.raw->data, col.len);
             }
-            val.init_raw(col.len);
-            // 将Value数据存入rec中。
-            memcpy(rec.data + col.offset, val.raw->data, col.len);
         }
 
         auto undo_next = context_->txn_->get_transaction_id();
-        // Insert into record file
-        rid_ = fh_->insert_record(rec.data, context_,&tab_name_);
+        // Insert into record file，多行时走批量插入，每个页面只写一条日志
+        std::vector<Rid> rids;
+        if (num_rows == 1) {
+            rids.push_back(fh_->insert_record(recs.data(), context_, &tab_name_));
+        } else {
+            rids = fh_->insert_records(recs.data(), num_rows, context_, &tab_name_);
+        }
         // Insert into index
-        for(size_t i = 0; i < tab_.indexes.size(); ++i) {
-            auto& index = tab_.indexes[i];
-            char* key = new char[index.col_tot_len];
-            int offset = 0;
-            for(size_t j = 0; j < index.col_num; ++j) {
-                memcpy(key + offset, rec.data + index.cols[j].offset, index.cols[j].len);
-                offset += index.cols[j].len;
-            }
-            try {
-                index_handlers.at(i)->insert_entry(key, rid_, context_->txn_);
-            } catch(IndexEntryDuplicateError &e) {
-                // 第i个索引发生重复key
-                // 需要将前i - 1个index回滚
-                for(int j = 0;j < i;j++) {
-                    index = tab_.indexes[j];
-                    key = new char[index.col_tot_len];
-                    offset = 0;
-                    for(size_t k = 0; k < index.col_num; ++k) {
-                        memcpy(key + offset, rec.data + index.cols[k].offset, index.cols[k].len);
-                        offset += index.cols[k].len;
+        std::vector<char> key;
+        for (int r = 0; r < num_rows; r++) {
+            const char *rec = recs.data() + r * record_size;
+            rid_ = rids[r];
+            for(size_t i = 0; i < tab_.indexes.size(); ++i) {
+                build_key(tab_.indexes[i], rec, &key);
+                try {
+                    index_handlers.at(i)->insert_entry(key.data(), rid_, context_->txn_);
+                } catch(IndexEntryDuplicateError &e) {
+                    // 第r行的第i个索引发生重复key，整条语句不生效：
+                    // 回滚第r行前i个索引和之前各行所有索引中的key，再删除本语句插入的全部记录
+                    for (int k = 0; k <= r; k++) {
+                        const char *inserted = recs.data() + k * record_size;
+                        size_t num_indexes = k < r ? tab_.indexes.size() : i;
+                        for (size_t j = 0; j < num_indexes; j++) {
+                            build_key(tab_.indexes[j], inserted, &key);
+                            index_handlers.at(j)->delete_entry(key.data(), context_->txn_);
+                        }
                     }
-                    index_handlers.at(j)->delete_entry(key,context_->txn_);
+                    // check(AntiO2) 这里是否需要是undo类型回滚
+                    for (auto &rid : rids) {
+                        fh_->delete_record(rid, context_, &tab_name_);
+                    }
+                    throw std::move(e);
                 }
-                // check(AntiO2) 这里是否需要是undo类型回滚
-                fh_->delete_record(rid_,context_, &tab_name_);
-                throw std::move(e);
             }
         }
-        auto* writeRecord = new WriteRecord(WType::INSERT_TUPLE,tab_name_,rid_, undo_next);
-        context_->txn_->append_write_record(writeRecord);
+        for (auto &rid : rids) {
+            auto* writeRecord = new WriteRecord(WType::INSERT_TUPLE,tab_name_,rid, undo_next);
+            context_->txn_->append_write_record(writeRecord);
+        }
         return nullptr;
     }
     size_t tupleLen() const override {
@@ -112,4 +126,17 @@ class InsertExecutor : public AbstractExecutor {
       true;
     }
     Rid &rid() override { return rid_; }
+
+   private:
+    /**
+     * @description: 从记录rec中取出索引index的key
+     */
+    static void build_key(const IndexMeta &index, const char *rec, std::vector<char> *key) {
+        key->resize(index.col_tot_len);
+        int offset = 0;
+        for (auto &col : index.cols) {
+            memcpy(key->data() + offset, rec + col.offset, col.len);
+            offset += col.len;
+        }
+    }
 };
\ No newline at end of file
@@ -41,7 +41,7 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
     std::unique_ptr<RmRecord> left_tuple_;
     std::vector<std::unique_ptr<RmRecord>> right_tuples_;
     std::vector<std::unique_ptr<RmRecord>>::const_iterator  right_tuples_iter_;
-    std::unique_ptr<RmRecord> rmRecord;
+    RmRecord join_record_;      // 当前连接结果，复用同一块缓冲区
     size_t left_len_;
     size_t right_len_;
 
@@ -53,6 +53,7 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
         left_len_ = left_->tupleLen();
         right_len_ = right_->tupleLen();
         len_ = left_len_ + right_len_;
+        join_record_ = RmRecord(len_);
         cols_ = left_->cols();
         auto right_cols = right_->cols();
         for (auto &col : right_cols) {
@@ -106,12 +107,8 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
             }
             // 比较当前是否满足join条件
             if(CheckConditions()) {
-                RmRecord rmRecord1(len_);
-                memcpy(rmRecord1.data,left_tuple_->data,left_len_);
-                memcpy(rmRecord1.data+left_len_,(*right_tuples_iter_)->data,right_len_);
-
-                rmRecord = std::make_unique<RmRecord>(rmRecord1);
-
+                memcpy(join_record_.data,left_tuple_->data,left_len_);
+                memcpy(join_record_.data+left_len_,(*right_tuples_iter_)->data,right_len_);
                 right_tuples_iter_++;
                 return;
             }
@@ -122,7 +119,11 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
         if(is_end_) {
             return nullptr;
         }
-        return std::move(rmRecord);
+        return std::make_unique<RmRecord>(join_record_);
+    }
+
+    RmTupleView NextView() override {
+        return is_end_ ? RmTupleView() : RmTupleView(join_record_);
     }
 
     Rid &rid() override { return _abstract_rid; }
@@ -21,6 +21,7 @@ class ProjectionExecutor : public AbstractExecutor {
     std::vector<ColMeta> cols_;                     // 需要投影的字段
     size_t len_;                                    // 字段总长度
     std::vector<size_t> sel_idxs_;                  
+    RmRecord proj_record_;                          // 投影结果，复用同一块缓冲区
     bool is_end_{false};
    public:
     ProjectionExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols) {
@@ -37,6 +38,12 @@ class ProjectionExecutor : public AbstractExecutor {
             cols_.push_back(col);
         }
         len_ = curr_offset;
+        proj_record_ = RmRecord(len_);
+        std::vector<ColMeta> needed_cols;
+        for (auto idx : sel_idxs_) {
+            needed_cols.push_back(prev_cols[idx]);
+        }
+        prev_->set_needed_cols(needed_cols);
     }
 
     void beginTuple() override {
@@ -57,8 +64,18 @@ class ProjectionExecutor : public AbstractExecutor {
         if(is_end()) {
             return nullptr;
         }
-        auto projection_record = prev_->Next();
-        return GetRecordFromKeys(projection_record.get());;
+        return NextView().materialize();
+    }
+
+    /**
+     * 从儿子节点的元组视图中直接投影到proj_record_，不复制儿子节点的元组
+     */
+    RmTupleView NextView() override {
+        if(is_end()) {
+            return {};
+        }
+        Project(prev_->NextView().data());
+        return RmTupleView(proj_record_);
     }
 
     Rid &rid() override { return _abstract_rid; }
@@ -66,9 +83,9 @@ class ProjectionExecutor : public AbstractExecutor {
     [[nodiscard]] bool is_end() const override {
         return is_end_;
     }
-    std::unique_ptr<RmRecord> GetRecordFromKeys(RmRecord* rm) {
+    void Project(const char* rm) {
         auto col_num = cols_.size();
-        auto rec = RmRecord(len_); // 通过rec大小，创建空的rmrecord;
+        auto &rec = proj_record_;
         for(decltype(col_num) i = 0; i < col_num; i++) {
 
             auto &col = cols_[i]; // 投影后的列
@@ -76,14 +93,13 @@ class ProjectionExecutor : public AbstractExecutor {
             if(col.type!=prev_col.type) {
                 throw IncompatibleTypeError(coltype2str(col.type), coltype2str(prev_col.type));
             }
-            memcpy(rec.data+col.offset, rm->data+prev_col.offset, col.len);
+            memcpy(rec.data+col.offset, rm+prev_col.offset, col.len);
 //            if (col.type != val.type) {
 //                throw IncompatibleTypeError(coltype2str(col.type), coltype2str(val.type));
 //            }
             //  val.init_raw(col.len);
             // 将Value数据存入rec中。
         }
-        return std::make_unique<RmRecord>(rec);
     }
 
     size_t tupleLen() const override {
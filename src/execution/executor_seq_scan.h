@@ -31,11 +31,15 @@ class SeqScanExecutor : public AbstractExecutor {
 //    AggregateOp op_;
 
     Rid rid_;
-    std::unique_ptr<RecScan> scan_;     // table_iterator
+    std::unique_ptr<BufferAccessStrategy> strategy_;    // 大表扫描使用的私有帧环，须在scan_之前声明(scan_先析构)
+    std::unique_ptr<RmScan> scan_;      // table_iterator，持有当前页面的pin
 
     SmManager *sm_manager_;
 
-    std::unique_ptr<RmRecord> rec_; // 存储下一个要返回的rec_
+    std::vector<char> decode_buf_;  // slotted page和PAX页面中的记录解码到这里
+    RmTupleView view_;              // 下一个要返回的元组，指向帧内或decode_buf_
+    RmColumnMask cond_cols_;        // conds_用到的字段，PAX表求值时只解码这些列
+    RmColumnMask read_cols_{RM_ALL_COLUMNS};    // 上层算子需要的字段和cond_cols_，PAX表只读取这些列
 
     bool is_end_{false}; // 指示是否完成了扫描
    public:
@@ -49,6 +53,21 @@ class SeqScanExecutor : public AbstractExecutor {
         len_ = cols_.back().offset + cols_.back().len; // 输出字段长度
         context_ = context;
         fed_conds_ = conds_;
+        decode_buf_.resize(fh_->getFileHdr().record_size);
+        cond_cols_ = 0;
+        for (auto &cond : conds_) {
+            cond_cols_ |= rm_column_bit(cols_, cond.lhs_col.tab_name, cond.lhs_col.col_name);
+            if (!cond.is_rhs_val) {
+                cond_cols_ |= rm_column_bit(cols_, cond.rhs_col.tab_name, cond.rhs_col.col_name);
+            }
+        }
+    }
+
+    void set_needed_cols(const std::vector<ColMeta> &cols) override {
+        read_cols_ = cond_cols_;
+        for (auto &col : cols) {
+            read_cols_ |= rm_column_bit(cols_, col.tab_name, col.name);
+        }
     }
 //    //liamY 重载了构造函数，使得对聚合函数有新的信息col_as_name_ 和 op_
 //    SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, Context *context,std::string col_as_name,AggregateOp op) {
@@ -68,32 +87,18 @@ class SeqScanExecutor : public AbstractExecutor {
     void beginTuple() override {
         // 首先初始化。
         is_end_ = false;
-        scan_ = std::make_unique<RmScan>(fh_); // 首先通过RmScan 获取对表的扫描
-        while(!scan_->is_end()) {
-            rid_ = scan_->rid();
-            // LOG_DEBUG("%s", fmt::format("rid page_no {} slot_no{}",rid_.page_no,rid_.slot_no).c_str());
-            if(CheckConditionByRid(rid_)) {
-                // 找到了满足条件的
-                is_end_ = false;
-                return;
-            }
-            scan_->next();
-        }
-        is_end_ = true;
+        scan_.reset();  // scan_持有的页面可能属于旧的帧环，先于strategy_释放
+        strategy_ = fh_->get_scan_strategy(); // 大表扫描不进入replacer，避免冲掉热页
+        // 首先通过RmScan 获取对表的扫描。条件在页面被pin住期间逐页求值，scan_只返回满足条件的记录
+        scan_ = std::make_unique<RmScan>(fh_, strategy_.get(),
+                                         [this](const char *rec) { return CheckConditions(rec, conds_); },
+                                         cond_cols_);
+        LoadTuple();
     }
 
     void nextTuple() override {
         scan_->next();
-        while(!scan_->is_end()) {
-            rid_ = scan_->rid();
-            // LOG_DEBUG("%s", fmt::format("rid page_no {} slot_no{}",rid_.page_no,rid_.slot_no).c_str());
-            if(CheckConditionByRid(rid_)) {
-                // 找到了满足条件的
-                return;
-            }
-            scan_->next();
-        }
-        is_end_ = true;
+        LoadTuple();
     }
 
     std::unique_ptr<RmRecord> Next() override {
@@ -101,7 +106,14 @@ class SeqScanExecutor : public AbstractExecutor {
             // check(AntiO2) 这里是否需要抛出异常
             return nullptr;
         }
-        return std::move(rec_);
+        return view_.materialize();
+    }
+
+    /**
+     * 直接返回指向帧内记录的视图，scan_保证页面在移动到下一个页面之前一直被pin住
+     */
+    RmTupleView NextView() override {
+        return view_;
     }
 
     Rid &rid() override { return rid_; }
@@ -110,10 +122,16 @@ class SeqScanExecutor : public AbstractExecutor {
       return is_end_;
     }
 
-    bool CheckConditionByRid(const Rid& rid) {
-        rec_ = fh_->get_record(rid,context_);
-        auto rec = rec_.get();
-        return CheckConditions(rec_.get(),conds_);
+    /**
+     * 读取scan_当前指向的记录，页面已经由scan_ pin住，不再访问buffer pool
+     */
+    void LoadTuple() {
+        if(scan_->is_end()) {
+            is_end_ = true;
+            return;
+        }
+        rid_ = scan_->rid();
+        view_ = fh_->get_record_view(rid_, scan_->page_guard(), decode_buf_.data(), nullptr, read_cols_);
     }
     /**
      * TODO(AntiO2) 这里可以考虑创建 Filter Executor， 从而在Seq Scan中不进行逻辑判断
@@ -122,7 +140,7 @@ class SeqScanExecutor : public AbstractExecutor {
      * @param conds
      * @return
      */
-    bool CheckConditions(RmRecord* rec, const std::vector<Condition>& conditions) {
+    bool CheckConditions(const char* rec, const std::vector<Condition>& conditions) {
         /**
          * 检查所有条件
          */
@@ -136,13 +154,13 @@ class SeqScanExecutor : public AbstractExecutor {
      * @param conditions
      * @return
      */
-    bool CheckCondition(RmRecord* rec, const Condition& condition) {
+    bool CheckCondition(const char* rec, const Condition& condition) {
             if(condition.is_always_false_) {
                 return false;
             }
             auto left_col = get_col(cols_,condition.lhs_col); // 首先根据condition中，左侧列的名字，来获取该列的数据
-            char* l_value = rec->data+left_col->offset; // 获得左值。CHECK(AntiO2) 这里左值一定是常量吗？有没有可能两边都是常数。
-            char* r_value;
+            const char* l_value = rec+left_col->offset; // 获得左值。CHECK(AntiO2) 这里左值一定是常量吗？有没有可能两边都是常数。
+            const char* r_value;
             ColType r_type{};
             if(condition.is_rhs_val) {
                 // 如果右值是一个常数
@@ -151,7 +169,7 @@ class SeqScanExecutor : public AbstractExecutor {
             } else {
                 // check(AntiO2) 这里只有同一张表上两个列比较的情况吗？
                auto r_col =  get_col(cols_,condition.rhs_col);
-               r_value = rec->data + r_col->offset;
+               r_value = rec + r_col->offset;
                r_type = r_col->type;
             }
              //  assert(left_col->type==r_type); // 保证两个值类型一样。
@@ -53,7 +53,7 @@ private:
   bool left_over{false}; // 左侧记录是否已经全部进入过buffer_pool_size
   bool right_over{false}; // 右侧记录是否已经遍历完？ 注意，right_over不一定等于right_.is_end_!
 
-  std::unique_ptr<RmRecord> emit_record_;
+  RmRecord emit_record_;     // 当前连接结果，复用同一块缓冲区
 
 public:
   StupidBlockNestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
@@ -69,6 +69,7 @@ public:
     right_num_per_page_ = PAGE_SIZE/right_len_;
 
     len_ = left_len_ + right_len_;
+    emit_record_ = RmRecord(len_);
 
     cols_ = left_->cols();
     auto right_cols = right_->cols();
@@ -103,6 +104,10 @@ public:
   }
 
   void nextTuple() override {
+    if(is_end_) {
+      // 结束时已经释放了join buffer，不能重复释放
+      return;
+    }
     // for(left buffer)
     //      for(right buffer )
     //              for(tuple in left buffer)         / 遍历左侧buffer中的tuple
@@ -110,14 +115,13 @@ public:
     while(!left_over) {
       while(!right_over) {
         while(left_buffer_page_iter_ < left_num_now_) {
-            RmRecord rm(len_);
+            RmRecord &rm = emit_record_;
             memcpy(rm.data, left_buffer_page_->get_data() + left_buffer_page_iter_*left_len_,left_len_);
             while(right_buffer_page_iter_ < right_num_now_) {
               memcpy(rm.data+left_len_, right_buffer_page_->get_data() + right_buffer_page_iter_*right_len_,
                      right_len_);
               right_buffer_page_iter_++;
               if(CheckConditions(rm.data)) {
-                emit_record_ = std::make_unique<RmRecord>(rm);
                 return;
               }
             }
@@ -152,7 +156,11 @@ public:
     if(is_end_) {
       return nullptr;
     }
-    return std::move(emit_record_);
+    return std::make_unique<RmRecord>(emit_record_);
+  }
+
+  RmTupleView NextView() override {
+    return is_end_ ? RmTupleView() : RmTupleView(emit_record_);
   }
 
   Rid &rid() override { return _abstract_rid; }
@@ -177,7 +185,7 @@ public:
     memset(right_buffer_page_->get_data(),0,PAGE_SIZE);
     right_num_now_ = 0;
     while(!right_->is_end()&&right_num_now_<right_num_per_page_) {
-      memcpy(right_buffer_page_->get_data()+right_num_now_*right_len_,right_->Next()->data,right_len_);
+      memcpy(right_buffer_page_->get_data()+right_num_now_*right_len_,right_->NextView().data(),right_len_);
       right_num_now_++;
       right_->nextTuple();
     }
@@ -200,7 +208,7 @@ public:
     memset(left_buffer_page_->get_data(),0,PAGE_SIZE);
     left_num_now_ = 0;
     while(!left_->is_end()&&left_num_now_<left_num_per_page_) {
-      memcpy(left_buffer_page_->get_data()+left_num_now_*left_len_,left_->Next()->data,left_len_);
+      memcpy(left_buffer_page_->get_data()+left_num_now_*left_len_,left_->NextView().data(),left_len_);
       left_num_now_++;
       left_->nextTuple();
     }
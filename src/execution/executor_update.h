@@ -89,8 +89,17 @@ class UpdateExecutor : public AbstractExecutor {
                     }
                 }
                 RmRecord update_record(*tuple);
-                auto* writeRecord = new WriteRecord(WType::UPDATE_TUPLE,tab_name_,rid,update_record,context_->txn_->get_prev_lsn());
-                fh_->update_record(rid,new_tuple.data,context_,&tab_name_);
+                auto undo_next = context_->txn_->get_prev_lsn();
+                Rid new_rid = fh_->update_record(rid,new_tuple.data,context_,&tab_name_);
+                if(new_rid != rid) {
+                    // 页面放不下变长后的记录，记录被移动到了其它页面，索引项指向新位置
+                    for(size_t i = 0; i < index_size; i++) {
+                        auto key = new_tuple.key_from_rec(tab_.indexes.at(i).cols);
+                        index_handlers.at(i)->delete_entry(key->data, context_->txn_);
+                        index_handlers.at(i)->insert_entry(key->data, new_rid, context_->txn_);
+                    }
+                }
+                auto* writeRecord = new WriteRecord(WType::UPDATE_TUPLE,tab_name_,new_rid,update_record,undo_next);
                 context_->txn_->append_write_record(writeRecord);
             }});
         // LOG_DEBUG("Update Complete");
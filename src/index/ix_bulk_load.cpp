@@ -0,0 +1,357 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_bulk_load.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <memory>
+
+namespace {
+
+constexpr size_t IX_SORT_IO_SIZE = 1024 * 1024;    // 写有序段和归并时每次读入的字节数
+
+void write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            throw UnixError();
+        }
+        data += n;
+        len -= n;
+    }
+}
+
+/* bulk_load中pin住的结点，析构时unpin并标记为脏页 */
+struct PinnedNode {
+    BufferPoolManager *bpm;
+    std::unique_ptr<IxNodeHandle> node;
+
+    PinnedNode(BufferPoolManager *bpm_, IxNodeHandle *node_) : bpm(bpm_), node(node_) {}
+
+    PinnedNode(PinnedNode &&) = default;
+
+    ~PinnedNode() {
+        if (node != nullptr) {
+            bpm->unpin_page(node->get_page_id(), true);
+        }
+    }
+};
+
+}  // namespace
+
+IxKeySorter::IxKeySorter(std::vector<ColType> col_types, std::vector<int> col_lens, size_t memory_limit)
+    : col_types_(std::move(col_types)), col_lens_(std::move(col_lens)), memory_limit_(memory_limit) {
+    key_len_ = 0;
+    for (int len : col_lens_) {
+        key_len_ += len;
+    }
+    entry_len_ = key_len_ + static_cast<int>(sizeof(Rid));
+    cur_.resize(entry_len_);
+}
+
+IxKeySorter::~IxKeySorter() {
+    for (auto &run : runs_) {
+        close(run.fd);
+    }
+}
+
+int IxKeySorter::compare(const char *a, const char *b) const {
+    return ix_compare(a, b, col_types_, col_lens_);
+}
+
+void IxKeySorter::add(const char *key, const Rid &rid) {
+    buf_.insert(buf_.end(), key, key + key_len_);
+    buf_.insert(buf_.end(), reinterpret_cast<const char *>(&rid), reinterpret_cast<const char *>(&rid) + sizeof(Rid));
+    num_entries_++;
+    if (buf_.size() >= memory_limit_) {
+        spill();
+    }
+}
+
+std::vector<size_t> IxKeySorter::sort_buffer() const {
+    std::vector<size_t> order(buf_.size() / entry_len_);
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    const char *entries = buf_.data();
+    ix_parallel_sort(&order, [&](size_t a, size_t b) {
+        return compare(entries + a * entry_len_, entries + b * entry_len_) < 0;
+    });
+    return order;
+}
+
+/**
+ * @description: 把buf_中的条目排序后写入一个新的有序段
+ */
+void IxKeySorter::spill() {
+    std::vector<size_t> order = sort_buffer();
+    char path[] = "ix_sort_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        throw UnixError();
+    }
+    unlink(path);
+    runs_.push_back(Run{.fd = fd, .num_entries = order.size()});
+    std::vector<char> out;
+    out.reserve(IX_SORT_IO_SIZE + entry_len_);
+    for (size_t idx : order) {
+        const char *entry = buf_.data() + idx * entry_len_;
+        out.insert(out.end(), entry, entry + entry_len_);
+        if (out.size() >= IX_SORT_IO_SIZE) {
+            write_all(fd, out.data(), out.size());
+            out.clear();
+        }
+    }
+    write_all(fd, out.data(), out.size());
+    buf_.clear();
+}
+
+/**
+ * @description: 读入有序段中接下来的一块条目
+ */
+void IxKeySorter::fill(Run *run) const {
+    size_t count = std::min(std::max<size_t>(1, IX_SORT_IO_SIZE / entry_len_), run->num_entries - run->next_entry);
+    run->buf.resize(count * entry_len_);
+    size_t done = 0;
+    off_t offset = static_cast<off_t>(run->next_entry) * entry_len_;
+    while (done < run->buf.size()) {
+        ssize_t n = pread(run->fd, run->buf.data() + done, run->buf.size() - done, offset + done);
+        if (n <= 0) {
+            throw UnixError();
+        }
+        done += n;
+    }
+    run->next_entry += count;
+    run->buf_pos = 0;
+    run->buf_count = count;
+}
+
+void IxKeySorter::finish() {
+    if (runs_.empty()) {
+        order_ = sort_buffer();
+        return;
+    }
+    if (!buf_.empty()) {
+        spill();
+    }
+    buf_.shrink_to_fit();
+    for (size_t i = 0; i < runs_.size(); i++) {
+        fill(&runs_[i]);
+        heap_.push_back(i);
+    }
+    std::make_heap(heap_.begin(), heap_.end(), [this](size_t a, size_t b) {
+        int res = compare(current(runs_[a]), current(runs_[b]));
+        return res != 0 ? res > 0 : a > b;
+    });
+}
+
+void IxKeySorter::next(const char **key, Rid *rid) {
+    if (runs_.empty()) {
+        const char *entry = buf_.data() + order_[next_pos_++] * entry_len_;
+        *key = entry;
+        memcpy(rid, entry + key_len_, sizeof(Rid));
+        return;
+    }
+    auto greater = [this](size_t a, size_t b) {
+        int res = compare(current(runs_[a]), current(runs_[b]));
+        return res != 0 ? res > 0 : a > b;
+    };
+    std::pop_heap(heap_.begin(), heap_.end(), greater);
+    Run &run = runs_[heap_.back()];
+    memcpy(cur_.data(), current(run), entry_len_);
+    if (++run.buf_pos == run.buf_count && run.next_entry < run.num_entries) {
+        fill(&run);
+    }
+    if (run.buf_pos < run.buf_count) {
+        std::push_heap(heap_.begin(), heap_.end(), greater);
+    } else {
+        heap_.pop_back();
+    }
+    *key = cur_.data();
+    memcpy(rid, cur_.data() + key_len_, sizeof(Rid));
+}
+
+bool IxIndexHandle::is_empty_tree() {
+    root_latch_.read_lock();
+    bool empty = is_empty();
+    if (!empty) {
+        IxNodeHandle *root = fetch_node(file_hdr_->root_page_);
+        empty = root->is_leaf_page() && root->get_size() == 0;
+        buffer_pool_manager_->unpin_page(root->get_page_id(), false);
+        delete root;
+    }
+    root_latch_.read_unlock();
+    return empty;
+}
+
+/**
+ * @description: 自底向上建树：按键的顺序把条目依次填入叶子，每个叶子填入btree_order * fill_factor个键值对
+ * (各结点的数量尽量平均)，再逐层为上一层的结点建立父结点，直到只剩一个根结点。内部结点保存相邻叶子之间最短的分隔键，
+ * 按占用的字节数填到最大字节数的fill_factor。叶子按顺序链接，
+ * 原有的空根结点作为第一个叶子。条目的键重复时抛出IndexEntryDuplicateError，此时索引恢复为空
+ * @param num_entries 条目数，next恰好被调用这么多次
+ * @param next 按键的升序依次给出条目
+ */
+void IxIndexHandle::bulk_load(size_t num_entries, const IxEntrySource &next, double fill_factor) {
+    if (!is_empty_tree()) {
+        throw InternalError("Bulk load into a non-empty index");
+    }
+    if (num_entries == 0) {
+        return;
+    }
+    root_latch_.write_lock();
+    int key_len = file_hdr_->col_tot_len_;
+    // 结点中的键值对数达到get_max_size()时分裂，因此最多保存btree_order个
+    int per_node = std::clamp(static_cast<int>(file_hdr_->btree_order_ * fill_factor), 2, file_hdr_->btree_order_);
+    page_id_t old_root = file_hdr_->root_page_;
+    std::vector<page_id_t> created;         // 新分配的页面，失败时释放
+    std::vector<char> level_keys;           // 当前层各结点在父结点中的分隔键，第一个结点为空键
+    std::vector<page_id_t> level_pages;     // 当前层各结点的页号
+    auto new_node = [&]() {
+        PinnedNode pinned(buffer_pool_manager_, create_node());
+        created.push_back(pinned.node->get_page_no());
+        return pinned;
+    };
+    try {
+        // 叶子层
+        size_t num_leaves = (num_entries + per_node - 1) / per_node;
+        std::vector<char> last_key(key_len);
+        std::vector<char> prev_last_key(key_len);
+        std::vector<char> ix_key(key_len);
+        std::unique_ptr<PinnedNode> prev;
+        size_t pos = 0;
+        for (size_t i = 0; i < num_leaves; i++) {
+            auto leaf = std::make_unique<PinnedNode>(i == 0 && old_root != IX_NO_PAGE
+                                                         ? PinnedNode(buffer_pool_manager_, fetch_node(old_root))
+                                                         : new_node());
+            IxNodeHandle *node = leaf->node.get();
+            node->init(IX_NO_PAGE, IX_NO_PAGE, true);
+            node->set_prev_leaf(prev == nullptr ? IX_LEAF_HEADER_PAGE : prev->node->get_page_no());
+            node->set_next_leaf(IX_LEAF_HEADER_PAGE);
+            size_t end = num_entries * (i + 1) / num_leaves;
+            int size = 0;
+            for (; pos < end; pos++, size++) {
+                const char *raw_key;
+                Rid rid;
+                next(&raw_key, &rid);
+                ix_normalize_key(raw_key, ix_key.data(), file_hdr_->col_types_, file_hdr_->col_lens_);
+                const char *key = ix_key.data();
+                if (pos > 0) {
+                    int res = memcmp(last_key.data(), key, key_len);
+                    if (res == 0) {
+                        throw IndexEntryDuplicateError();
+                    }
+                    if (res > 0) {
+                        throw InternalError("Bulk load entries are not sorted");
+                    }
+                }
+                memcpy(last_key.data(), key, key_len);
+                node->set_key(size, key);
+                node->set_rid(size, rid);
+            }
+            node->set_size(size);
+            if (prev != nullptr) {
+                prev->node->set_next_leaf(node->get_page_no());
+            } else {
+                file_hdr_->first_leaf_ = node->get_page_no();
+            }
+            std::vector<char> sep(key_len, 0);
+            if (prev != nullptr) {
+                ix_shortest_separator(prev_last_key.data(), node->get_key(0), sep.data(), key_len);
+            }
+            level_keys.insert(level_keys.end(), sep.begin(), sep.end());
+            prev_last_key = last_key;
+            level_pages.push_back(node->get_page_no());
+            prev = std::move(leaf);
+        }
+        file_hdr_->last_leaf_ = prev->node->get_page_no();
+        prev.reset();
+
+        // 逐层建立父结点。每个槽的大小随分隔键变化，按字节数平均分配：每个父结点至少装下三个最长的槽，
+        // 填满后再放入一个最长的槽也不超过最大字节数
+        int entry_bytes = static_cast<int>(sizeof(IxSlot)) + key_len;
+        int max_bytes = PAGE_SIZE - static_cast<int>(Page::OFFSET_PAGE_HDR + sizeof(IxPageHdr)) - entry_bytes;
+        size_t target = std::clamp(static_cast<int>(max_bytes * fill_factor), 3 * entry_bytes, max_bytes - entry_bytes);
+        while (level_pages.size() > 1) {
+            size_t total = 0;
+            for (size_t child = 0; child < level_pages.size(); child++) {
+                total += sizeof(IxSlot) + ix_key_size(level_keys.data() + child * key_len, key_len);
+            }
+            size_t num_parents = (total + target - 1) / target;
+            std::vector<char> parent_keys;
+            std::vector<page_id_t> parent_pages;
+            size_t child = 0;
+            size_t used = 0;
+            for (size_t i = 0; i < num_parents && child < level_pages.size(); i++) {
+                PinnedNode parent = new_node();
+                parent.node->init(IX_NO_PAGE, IX_NO_PAGE, false);
+                parent.node->set_prev_leaf(IX_NO_PAGE);
+                parent.node->set_next_leaf(IX_NO_PAGE);
+                size_t end = total * (i + 1) / num_parents;
+                do {
+                    const char *key = level_keys.data() + child * key_len;
+                    parent.node->insert_pair(parent.node->get_size(), key,
+                                             Rid{.page_no = level_pages[child], .slot_no = -1});
+                    used += sizeof(IxSlot) + ix_key_size(key, key_len);
+                    PinnedNode child_node(buffer_pool_manager_, fetch_node(level_pages[child]));
+                    child_node.node->set_parent_page_no(parent.node->get_page_no());
+                    child++;
+                } while (used < end && child < level_pages.size());
+                std::vector<char> first_key(key_len);
+                parent.node->read_key(0, first_key.data());
+                parent_keys.insert(parent_keys.end(), first_key.begin(), first_key.end());
+                parent_pages.push_back(parent.node->get_page_no());
+            }
+            level_keys = std::move(parent_keys);
+            level_pages = std::move(parent_pages);
+        }
+        file_hdr_->root_page_ = level_pages[0];
+    } catch (...) {
+        // 释放新分配的结点，索引恢复为空
+        for (page_id_t page_no : created) {
+            buffer_pool_manager_->delete_page(PageId{fd_, page_no});
+        }
+        page_id_t root = old_root;
+        if (root != IX_NO_PAGE) {
+            PinnedNode root_node(buffer_pool_manager_, fetch_node(root));
+            root_node.node->init(IX_NO_PAGE, IX_NO_PAGE, true);
+            root_node.node->set_prev_leaf(IX_LEAF_HEADER_PAGE);
+            root_node.node->set_next_leaf(IX_LEAF_HEADER_PAGE);
+        }
+        file_hdr_->root_page_ = root;
+        file_hdr_->first_leaf_ = root;
+        file_hdr_->last_leaf_ = root;
+        {
+            PinnedNode leaf_header(buffer_pool_manager_, fetch_node(IX_LEAF_HEADER_PAGE));
+            leaf_header.node->set_prev_leaf(root);
+            leaf_header.node->set_next_leaf(root);
+        }
+        root_latch_.write_unlock();
+        throw;
+    }
+    {
+        // leaf header可能已在buffer pool中，需通过buffer pool修改
+        PinnedNode leaf_header(buffer_pool_manager_, fetch_node(IX_LEAF_HEADER_PAGE));
+        leaf_header.node->set_prev_leaf(file_hdr_->last_leaf_);
+        leaf_header.node->set_next_leaf(file_hdr_->first_leaf_);
+    }
+    // 建树不记录日志，结点和空闲页面位图全部写盘，之前的索引日志不再重做
+    buffer_pool_manager_->flush_all_pages(fd_);
+    disk_manager_->flush_free_space_map(fd_);
+    if (log_manager_ != nullptr) {
+        file_hdr_->base_lsn_ = log_manager_->get_global_lsn();
+    }
+    std::vector<char> data(file_hdr_->tot_len_);
+    file_hdr_->serialize(data.data());
+    disk_manager_->write_page(fd_, IX_FILE_HDR_PAGE, data.data(), file_hdr_->tot_len_);
+    root_latch_.write_unlock();
+}
@@ -0,0 +1,108 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "ix_index_handle.h"
+
+/**
+ * @description: 多线程排序order：各线程分别排序一段，再两两归并。元素较少时只用一个线程
+ */
+template <typename Less>
+void ix_parallel_sort(std::vector<size_t> *order, const Less &less) {
+    size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::max<size_t>(1, std::min<size_t>(num_threads, order->size() / BULK_LOAD_MIN_SORT_RUN));
+    std::vector<size_t> runs;
+    for (size_t t = 0; t <= num_threads; t++) {
+        runs.push_back(order->size() * t / num_threads);
+    }
+    std::vector<std::thread> sorters;
+    for (size_t t = 1; t < num_threads; t++) {
+        sorters.emplace_back([&, t]() { std::sort(order->begin() + runs[t], order->begin() + runs[t + 1], less); });
+    }
+    std::sort(order->begin() + runs[0], order->begin() + runs[1], less);
+    for (auto &sorter : sorters) {
+        sorter.join();
+    }
+    for (size_t width = 1; width < num_threads; width *= 2) {
+        for (size_t t = 0; t + width < num_threads; t += 2 * width) {
+            size_t last = std::min(t + 2 * width, num_threads);
+            std::inplace_merge(order->begin() + runs[t], order->begin() + runs[t + width],
+                               order->begin() + runs[last], less);
+        }
+    }
+}
+
+/**
+ * @description: 建索引时对(key, rid)按键排序的外部排序。内存中的条目超过memory_limit字节时排序后写入一个临时文件
+ * (有序段)，finish之后用next按键的顺序逐个取出全部条目，有多个有序段时多路归并。
+ * 临时文件建在当前目录(数据库目录)下，创建后立即unlink，进程退出时自动回收
+ */
+class IxKeySorter {
+   public:
+    IxKeySorter(std::vector<ColType> col_types, std::vector<int> col_lens, size_t memory_limit = INDEX_SORT_MEMORY);
+
+    ~IxKeySorter();
+
+    IxKeySorter(const IxKeySorter &) = delete;
+    IxKeySorter &operator=(const IxKeySorter &) = delete;
+
+    void add(const char *key, const Rid &rid);
+
+    /**
+     * @description: 输入结束，之后不能再add
+     */
+    void finish();
+
+    size_t size() const { return num_entries_; }
+
+    /**
+     * @description: 取出下一个条目，共可调用size()次。*key在下一次调用next之前有效
+     */
+    void next(const char **key, Rid *rid);
+
+   private:
+    /** 一个有序段，按块读入 */
+    struct Run {
+        int fd;
+        size_t num_entries;
+        size_t next_entry{0};       // 下一个要读入的条目
+        std::vector<char> buf;
+        size_t buf_pos{0};          // 当前条目在buf中的下标
+        size_t buf_count{0};        // buf中的条目数
+    };
+
+    int compare(const char *a, const char *b) const;
+
+    std::vector<size_t> sort_buffer() const;
+
+    void spill();
+
+    void fill(Run *run) const;
+
+    const char *current(const Run &run) const { return run.buf.data() + run.buf_pos * entry_len_; }
+
+    std::vector<ColType> col_types_;
+    std::vector<int> col_lens_;
+    int key_len_;
+    int entry_len_;                 // key + Rid
+    size_t memory_limit_;
+    size_t num_entries_{0};
+    std::vector<char> buf_;         // 尚未写入有序段的条目
+    std::vector<Run> runs_;
+    std::vector<size_t> order_;     // 没有有序段时buf_中条目的顺序
+    size_t next_pos_{0};
+    std::vector<size_t> heap_;      // 多路归并：以当前条目为键的runs_下标的小根堆
+    std::vector<char> cur_;         // 最近一次next返回的条目
+};
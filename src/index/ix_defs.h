@@ -24,8 +24,8 @@ constexpr int IX_MAX_COL_LEN = 512;
 
 class IxFileHdr {
 public: 
-    page_id_t first_free_page_no_;      // 文件中第一个空闲的磁盘页面的页面号
-    int num_pages_;                     // 磁盘文件中页面的数量
+    page_id_t first_free_page_no_;      // 未使用，空闲页面记录在文件头页面的空闲页面位图中(见FreeSpaceMap)
+    int num_pages_;                     // 磁盘文件中页面的数量(含已释放、等待复用的页面)
     page_id_t root_page_;               // B+树根节点对应的页面号
     int col_num_;                       // 索引包含的字段数量
     std::vector<ColType> col_types_;    // 字段的类型
@@ -37,9 +37,15 @@ public:
     page_id_t first_leaf_;              // 首叶节点对应的页号，在上层IxManager的open函数进行初始化，初始化为root page_no
     page_id_t last_leaf_;               // 尾叶节点对应的页号
     int tot_len_;                       // 记录结构体的整体长度
+    lsn_t base_lsn_;                    // 索引文件内容整体写盘时的lsn，不大于它的索引日志不再重做
+    bool normalized_keys_;              // 结点中的键按ix_normalize_key编码，旧格式的索引在启动时重建
+    bool suffix_truncated_;             // 内部结点保存后缀截断的变长分隔键(见IxSlot)，旧格式的索引在启动时重建
 
     IxFileHdr() {
         tot_len_ = col_num_ = 0;
+        base_lsn_ = INVALID_LSN;
+        normalized_keys_ = false;
+        suffix_truncated_ = false;
     }
 
     IxFileHdr(page_id_t first_free_page_no, int num_pages, page_id_t root_page, int col_num,
@@ -47,12 +53,28 @@ public:
                 : first_free_page_no_(first_free_page_no), num_pages_(num_pages), root_page_(root_page), col_num_(col_num),
                 col_tot_len_(col_tot_len), btree_order_(btree_order), keys_size_(keys_size), first_leaf_(first_leaf), last_leaf_(last_leaf) {
                     tot_len_ = 0;
+                    base_lsn_ = INVALID_LSN;
+                    normalized_keys_ = true;
+                    suffix_truncated_ = true;
                 } 
 
     void update_tot_len() {
         tot_len_ = 0;
         tot_len_ += sizeof(page_id_t) * 4 + sizeof(int) * 6;
         tot_len_ += sizeof(ColType) * col_num_ + sizeof(int) * col_num_;
+        tot_len_ += sizeof(lsn_t) + sizeof(bool) * 2;
+    }
+
+    // 前col_num列(为0时为全部列)在键中占的字节数
+    int key_len(size_t col_num) const {
+        if (col_num == 0 || col_num >= static_cast<size_t>(col_num_)) {
+            return col_tot_len_;
+        }
+        int len = 0;
+        for (size_t i = 0; i < col_num; ++i) {
+            len += col_lens_[i];
+        }
+        return len;
     }
 
     void serialize(char* dest) {
@@ -85,6 +107,12 @@ public:
         offset += sizeof(page_id_t);
         memcpy(dest + offset, &last_leaf_, sizeof(page_id_t));
         offset += sizeof(page_id_t);
+        memcpy(dest + offset, &base_lsn_, sizeof(lsn_t));
+        offset += sizeof(lsn_t);
+        memcpy(dest + offset, &normalized_keys_, sizeof(bool));
+        offset += sizeof(bool);
+        memcpy(dest + offset, &suffix_truncated_, sizeof(bool));
+        offset += sizeof(bool);
         assert(offset == tot_len_);
     }
 
@@ -122,6 +150,22 @@ public:
         offset += sizeof(page_id_t);
         last_leaf_ = *reinterpret_cast<const page_id_t*>(src + offset);
         offset += sizeof(page_id_t);
+        // 旧格式的文件头没有base_lsn、normalized_keys和suffix_truncated
+        base_lsn_ = INVALID_LSN;
+        if (offset < tot_len_) {
+            base_lsn_ = *reinterpret_cast<const lsn_t*>(src + offset);
+            offset += sizeof(lsn_t);
+        }
+        normalized_keys_ = false;
+        if (offset < tot_len_) {
+            normalized_keys_ = *reinterpret_cast<const bool*>(src + offset);
+            offset += sizeof(bool);
+        }
+        suffix_truncated_ = false;
+        if (offset < tot_len_) {
+            suffix_truncated_ = *reinterpret_cast<const bool*>(src + offset);
+            offset += sizeof(bool);
+        }
         assert(offset == tot_len_);
     }
 };
@@ -134,6 +178,14 @@ public:
     bool is_leaf;                   // 是否为叶节点
     page_id_t prev_leaf;            // previous leaf node's page_no, effective only when is_leaf is true
     page_id_t next_leaf;            // next leaf node's page_no, effective only when is_leaf is true
+    int key_bytes;                  // 内部结点中分隔键占用的字节数，分隔键从页尾向前连续存放，effective only when is_leaf is false
+};
+
+/* 内部结点的槽，紧接IxPageHdr存放。分隔键是后缀截断的变长键，末尾的0字节不保存，比较时视为用0补齐到col_tot_len */
+struct IxSlot {
+    page_id_t child;                // 孩子结点的页号
+    uint16_t key_off;               // 分隔键在页面中的偏移
+    uint16_t key_len;               // 分隔键的长度
 };
 
 class Iid {
@@ -10,8 +10,32 @@ See the Mulan PSL v2 for more details. */
 
 #include "ix_index_handle.h"
 
+#include <algorithm>
+
 #include "ix_scan.h"
 
+/**
+ * @brief 第key_idx个键与target的前len个字节比较
+ * @note 内部结点的分隔键截去了末尾的0字节，截去的部分按0比较
+ */
+int IxNodeHandle::compare_key(int key_idx, const char *target, int len) const {
+    if (page_hdr->is_leaf) {
+        return memcmp(keys + key_idx * file_hdr->col_tot_len_, target, len);
+    }
+    const IxSlot &slot = slots[key_idx];
+    int size = std::min<int>(slot.key_len, len);
+    int res = memcmp(page->get_data() + slot.key_off, target, size);
+    if (res != 0) {
+        return res;
+    }
+    for (int i = size; i < len; i++) {
+        if (target[i] != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
 /**
  * @brief 在当前node中查找第一个>=target的key_idx
  *
@@ -20,14 +44,13 @@ See the Mulan PSL v2 for more details. */
  */
 int IxNodeHandle::lower_bound(const char *target, size_t col_num = 0) const {
     // 查找当前节点中第一个大于等于target的key，并返回key的位置给上层
-    // 提示: 可以采用多种查找方式，如顺序遍历、二分查找等；使用ix_compare()函数进行比较
+    // 结点中的键已按ix_normalize_key编码，前col_num列的比较就是一次memcmp(内部结点见compare_key)
 
     int l = 0, r = page_hdr->num_key, mid, flag;
-    auto& col_types = file_hdr->col_types_;
-    auto& col_lens = file_hdr->col_lens_;
+    int key_len = file_hdr->key_len(col_num);
     while(l < r){
         mid = (l+r)/2;
-        flag = ix_compare(get_key(mid), target, col_types, col_lens, col_num);
+        flag = compare_key(mid, target, key_len);
         if(flag < 0)
             l = mid + 1;
         else
@@ -40,17 +63,16 @@ int IxNodeHandle::lower_bound(const char *target, size_t col_num = 0) const {
  * @brief 在当前node中查找第一个>target的key_idx
  *
  * @return key_idx，范围为[1,num_key)，如果返回的key_idx=num_key，则表示target大于等于最后一个key
- * @note 注意此处的范围从1开始
+ * @note 内部结点的范围从1开始；叶子结点从0开始，按前缀查找时叶子的第一个键可能已大于target
  */
 int IxNodeHandle::upper_bound(const char *target, size_t col_num = 0) const {
     // 查找当前节点中第一个大于target的key，并返回key的位置给上层
     // 提示: 可以采用多种查找方式：顺序遍历、二分查找等；使用ix_compare()函数进行比较
-    int l = 1, r = page_hdr->num_key, mid, flag;
-    auto& col_types = file_hdr->col_types_;
-    auto& col_lens = file_hdr->col_lens_;
+    int l = page_hdr->is_leaf ? 0 : 1, r = page_hdr->num_key, mid, flag;
+    int key_len = file_hdr->key_len(col_num);
     while(l < r){ //use binary search
         mid = (l+r)/2;
-        flag = ix_compare(get_key(mid), target, col_types, col_lens, col_num);
+        flag = compare_key(mid, target, key_len);
         if(flag <= 0)
             l = mid + 1;
         else
@@ -73,11 +95,10 @@ bool IxNodeHandle::leaf_lookup(const char *key, Rid **value,size_t col_num,FIND_
     // 3. 如果存在，获取key对应的Rid，并赋值给传出参数value
     // 提示：可以调用lower_bound()和get_rid()函数。
     int l = 0, r = page_hdr->num_key, mid;
-    auto& col_types = file_hdr->col_types_;
-    auto& col_lens = file_hdr->col_lens_;
+    int key_len = file_hdr->key_len(col_num);
     while(l < r){ //use binary search
         mid = (l+r)/2;
-        int flag = ix_compare(get_key(mid), key, col_types, col_lens,col_num);
+        int flag = compare_key(mid, key, key_len);
         if(flag < 0)
             l = mid + 1;
         else
@@ -100,8 +121,7 @@ page_id_t IxNodeHandle::internal_lookup(const char *key,size_t col_num,FIND_TYPE
     // 1. 查找当前非叶子节点中目标key所在孩子节点（子树）的位置
     // 2. 获取该孩子节点（子树）所在页面的编号
     // 3. 返回页面编号
-    auto& col_types = file_hdr->col_types_;
-    auto& col_lens = file_hdr->col_lens_;
+    int key_len = file_hdr->key_len(col_num);
     auto pos = 0;
     int flag = 0;
     switch (findType) {
@@ -113,7 +133,7 @@ page_id_t IxNodeHandle::internal_lookup(const char *key,size_t col_num,FIND_TYPE
                 pos = pos - 1;
             }
             else {
-                flag = ix_compare(key, get_key(pos), col_types, col_lens, col_num); //
+                flag = -compare_key(pos, key, key_len);
                 if(flag <= 0&&pos!=0) {
                     pos = pos -1;
                 }
@@ -124,7 +144,7 @@ page_id_t IxNodeHandle::internal_lookup(const char *key,size_t col_num,FIND_TYPE
             int l = 1, r = page_hdr->num_key, mid;
             while(l < r){
                 mid = (l+r)/2;
-                flag = ix_compare(get_key(mid), key, col_types, col_lens,col_num);
+                flag = compare_key(mid, key, key_len);
                 if(flag <= 0)
                     l = mid + 1;
                 else
@@ -132,11 +152,10 @@ page_id_t IxNodeHandle::internal_lookup(const char *key,size_t col_num,FIND_TYPE
             }
             // 在内部结点中，首先找到第一个大于等于该key的
             pos = 0;
-            flag = ix_compare(get_key(l), key, col_types, col_lens);
             if(l==page_hdr->num_key) {
                 // 如果没找到这样的key
                 pos = l-1;
-            } else  if(flag==0){
+            } else  if(compare_key(l, key, file_hdr->col_tot_len_)==0){
                 // 如果刚好是这个key
                 pos = l;
             } else {
@@ -155,8 +174,7 @@ page_id_t IxNodeHandle::internal_lookup(const char *key,size_t col_num,FIND_TYPE
             }
             break;
     }
-    auto rid =  get_rid(pos);
-    return rid->page_no;
+    return value_at(pos);
 }
 
 /**
@@ -179,6 +197,14 @@ void IxNodeHandle::insert_pairs(int pos, const char *key, const Rid *rid, int n)
     // 3. 通过rid获取n个连续键值对的rid值，并把n个rid值插入到pos位置
     // 4. 更新当前节点的键数量
     assert(pos <= page_hdr->num_key && pos >= 0);
+    if (!is_leaf_page()) {
+        // 内部结点：每个分隔键去掉末尾的0字节后存放
+        for (int i = 0; i < n; i++) {
+            const char *sep = key + i * file_hdr->col_tot_len_;
+            insert_slot(pos + i, sep, ix_key_size(sep, file_hdr->col_tot_len_), rid[i].page_no);
+        }
+        return;
+    }
     assert(n+page_hdr->num_key<=file_hdr->btree_order_+1);
     int num = page_hdr->num_key - pos; // 需要移动的键值对个数
     auto key_len = file_hdr->col_tot_len_;
@@ -194,6 +220,65 @@ void IxNodeHandle::insert_pairs(int pos, const char *key, const Rid *rid, int n)
     set_size(get_size()+ n);
 }
 
+/**
+ * @brief 把src中从begin开始的n个键值对插入到本结点的pos位置，src与本结点同为叶子结点或同为内部结点
+ */
+void IxNodeHandle::insert_pairs_from(int pos, const IxNodeHandle &src, int begin, int n) {
+    if (is_leaf_page()) {
+        insert_pairs(pos, src.get_key(begin), src.get_rid(begin), n);
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        insert_slot(pos + i, src.get_key(begin + i), src.get_key_size(begin + i), src.value_at(begin + i));
+    }
+}
+
+/**
+ * @brief 在内部结点的pos位置插入一个槽，分隔键key的len个字节放在已有分隔键之前
+ */
+void IxNodeHandle::insert_slot(int pos, const char *key, int len, page_id_t child) {
+    assert(pos <= page_hdr->num_key && pos >= 0);
+    assert(get_used_bytes() + static_cast<int>(sizeof(IxSlot)) + len <= get_max_bytes() + get_max_entry_bytes());
+    page_hdr->key_bytes += len;
+    int key_off = PAGE_SIZE - page_hdr->key_bytes;
+    memcpy(page->get_data() + key_off, key, len);
+    memmove(slots + pos + 1, slots + pos, (page_hdr->num_key - pos) * sizeof(IxSlot));
+    slots[pos] = IxSlot{.child = child, .key_off = static_cast<uint16_t>(key_off), .key_len = static_cast<uint16_t>(len)};
+    page_hdr->num_key++;
+}
+
+/**
+ * @brief 内部结点删除槽之后，把剩下的分隔键按槽的顺序重新连续存放到页尾
+ */
+void IxNodeHandle::compact_keys() {
+    char buf[MAX_PAGE_SIZE];
+    int bytes = 0;
+    for (int i = 0; i < page_hdr->num_key; i++) {
+        memcpy(buf + bytes, page->get_data() + slots[i].key_off, slots[i].key_len);
+        bytes += slots[i].key_len;
+    }
+    int key_off = PAGE_SIZE - bytes;
+    memcpy(page->get_data() + key_off, buf, bytes);
+    for (int i = 0; i < page_hdr->num_key; i++) {
+        slots[i].key_off = static_cast<uint16_t>(key_off);
+        key_off += slots[i].key_len;
+    }
+    page_hdr->key_bytes = bytes;
+}
+
+/**
+ * @brief 替换第key_idx个键，内部结点中新的分隔键可能比原来的长
+ */
+void IxNodeHandle::set_key(int key_idx, const char *key) {
+    if (is_leaf_page()) {
+        memcpy(keys + key_idx * file_hdr->col_tot_len_, key, file_hdr->col_tot_len_);
+        return;
+    }
+    page_id_t child = value_at(key_idx);
+    erase_pair(key_idx);
+    insert_slot(key_idx, key, ix_key_size(key, file_hdr->col_tot_len_), child);
+}
+
 /**
  * @brief 用于在结点中插入单个键值对。
  * 函数返回插入后的键值对数量
@@ -209,9 +294,8 @@ int IxNodeHandle::insert(const char *key, const Rid &value) {
     if(pos == size) {
         insert_pair(pos,key, value);
     } else{
-        auto old_key = get_key(pos);
         // 3. 如果key不重复则插入键值对
-        if(ix_compare(old_key,key,file_hdr->col_types_,file_hdr->col_lens_)!=0) {
+        if(compare_key(pos, key, file_hdr->col_tot_len_) != 0) {
             insert_pair(pos, key, value);
         }
     }
@@ -220,26 +304,32 @@ int IxNodeHandle::insert(const char *key, const Rid &value) {
 }
 
 /**
- * @brief 用于在结点中的指定位置删除单个键值对
+ * @brief 用于在结点中的指定位置删除连续n个键值对
  *
- * @param pos 要删除键值对的位置
+ * @param pos 要删除键值对的起始位置
  */
-void IxNodeHandle::erase_pair(int pos) {
-    // 1. 删除该位置的key
+void IxNodeHandle::erase_pairs(int pos, int n) {
+    // 1. 删除这些位置的key
     auto size = get_size();
-    assert(pos>=0&&pos<size);
-    // 2. 删除该位置的rid
-    auto following_num = size - pos -1;// 在pos之后的key数量
-
+    assert(pos>=0&&n>0&&pos+n<=size);
+    auto following_num = size - pos - n;// 在删除的键值对之后的key数量
+    if (!is_leaf_page()) {
+        // 内部结点删除槽，再把剩下的分隔键重新连续存放
+        memmove(slots + pos, slots + pos + n, following_num * sizeof(IxSlot));
+        set_size(size - n);
+        compact_keys();
+        return;
+    }
+    // 2. 删除这些位置的rid
     auto key_addr = get_key(pos);
     auto rid_addr = get_rid(pos);
 
     auto key_len = file_hdr->col_tot_len_;
     auto rid_len = sizeof(Rid);
-    memmove(key_addr,key_addr+key_len, key_len*following_num);
-    memmove(rid_addr,rid_addr+1, rid_len*following_num);
+    memmove(key_addr,key_addr+key_len*n, key_len*following_num);
+    memmove(rid_addr,rid_addr+n, rid_len*following_num);
     // 3. 更新结点的键值对数量
-    set_size(size-1);
+    set_size(size-n);
 }
 
 /**
@@ -253,13 +343,64 @@ int IxNodeHandle::remove(const char *key) {
     int pos = lower_bound(key, file_hdr->col_num_);
     // 2. 如果要删除的键值对存在，删除键值对
     auto size = get_size();
-    if(pos!=size&&!ix_compare(get_key(pos), key, file_hdr->col_types_, file_hdr->col_lens_)) {
+    if(pos!=size&&!compare_key(pos, key, file_hdr->col_tot_len_)) {
         erase_pair(pos);
     }
-    // 3. 返回完成删除操作后的键值对数量
-    size-=1;
-    set_size(size);
-    return size;
+    // 3. 返回完成删除操作后的键值对数量，key不存在时结点不变
+    return get_size();
+}
+
+/**
+ * @description: 把结点写成日志中的映像，header_only时只包含页头
+ */
+void IxNodeHandle::serialize_image(char *dest, bool header_only) const {
+    memcpy(dest, &header_only, sizeof(bool));
+    memcpy(dest + sizeof(bool), page_hdr, sizeof(IxPageHdr));
+    if (header_only) {
+        return;
+    }
+    int offset = sizeof(bool) + sizeof(IxPageHdr);
+    if (!is_leaf_page()) {
+        int slots_len = get_size() * sizeof(IxSlot);
+        memcpy(dest + offset, slots, slots_len);
+        offset += slots_len;
+        memcpy(dest + offset, page->get_data() + PAGE_SIZE - page_hdr->key_bytes, page_hdr->key_bytes);
+        return;
+    }
+    int keys_len = get_size() * file_hdr->col_tot_len_;
+    memcpy(dest + offset, keys, keys_len);
+    offset += keys_len;
+    memcpy(dest + offset, rids, get_size() * sizeof(Rid));
+}
+
+/**
+ * @description: 用日志中的映像重做结点。只含页头的映像只修改父结点和叶子链表指针，结点中的键值对保持不变
+ */
+void IxNodeHandle::load_image(const char *src) {
+    bool header_only;
+    IxPageHdr hdr;
+    memcpy(&header_only, src, sizeof(bool));
+    memcpy(&hdr, src + sizeof(bool), sizeof(IxPageHdr));
+    if (header_only) {
+        page_hdr->parent = hdr.parent;
+        page_hdr->prev_leaf = hdr.prev_leaf;
+        page_hdr->next_leaf = hdr.next_leaf;
+        return;
+    }
+    *page_hdr = hdr;
+    int offset = sizeof(bool) + sizeof(IxPageHdr);
+    if (!is_leaf_page()) {
+        // 内部结点的分隔键连续存放在页尾，槽中的偏移与记录映像时相同
+        int slots_len = get_size() * sizeof(IxSlot);
+        memcpy(slots, src + offset, slots_len);
+        offset += slots_len;
+        memcpy(page->get_data() + PAGE_SIZE - page_hdr->key_bytes, src + offset, page_hdr->key_bytes);
+        return;
+    }
+    int keys_len = get_size() * file_hdr->col_tot_len_;
+    memcpy(keys, src + offset, keys_len);
+    offset += keys_len;
+    memcpy(rids, src + offset, get_size() * sizeof(Rid));
 }
 
 
@@ -267,6 +408,8 @@ int IxNodeHandle::remove(const char *key) {
 
 IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd)
     : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), fd_(fd) {
+    log_manager_ = buffer_pool_manager_->get_log_manager();
+    index_name_ = disk_manager_->get_file_name(fd);
     // init file_hdr_
     disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
     char* buf = new char[PAGE_SIZE];
@@ -277,7 +420,13 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffe
     
     // disk_manager管理的fd对应的文件中，设置从file_hdr_->num_pages开始分配page_no
     int now_page_no = disk_manager_->get_fd2pageno(fd);
-    disk_manager_->set_fd2pageno(fd, now_page_no + 1);
+    disk_manager_->set_fd2pageno(fd, std::max(now_page_no + 1, file_hdr_->num_pages_));
+    // 删除结点释放的页面记录在文件头页面的空闲页面位图中，create_node优先复用
+    if (file_hdr_->tot_len_ <= FREE_SPACE_MAP_OFFSET) {
+        disk_manager_->open_free_space_map(fd);
+    }
+    // 结点页面写回时填入校验和，读入时校验
+    disk_manager_->set_page_checksums(fd, true);
 }
 
 /**
@@ -300,16 +449,18 @@ IxIndexHandle::find_leaf_page(const char *key, Operation operation, Transaction
 
     auto current_page = current->page;
     if(operation==Operation::FIND) {
-         root_latch_.read_unlock();
-         current_page->RLock();
+        // 先锁住根结点再释放root_latch_，否则根结点可能在两者之间被替换
+        current_page->RLock();
+        root_latch_.read_unlock();
     } else {
         current_page->WLock();
         if(operation==Operation::INSERT) {
-            if(root->get_size() < root->get_max_size() - 1) {
+            if(root->is_insert_safe()) {
                 release_ancestors(transaction);   // 释放所有祖先page latch
             }
         }
-        if(operation==Operation::DELETE&&root->get_size() > 2) {
+        // 内部结点的根还须保证替换分隔键后不会分裂
+        if(operation==Operation::DELETE&&root->get_size() > 2&&(root->is_leaf_page()||root->is_insert_safe())) {
             release_ancestors(transaction);   // 释放所有祖先page latch
         }
     }
@@ -317,9 +468,9 @@ IxIndexHandle::find_leaf_page(const char *key, Operation operation, Transaction
         page_id_t child_page_id;
         if(left_most) {
             // 如果是在找最左边的点
-            child_page_id = current->get_rid(0) -> page_no;
+            child_page_id = current->value_at(0);
         } else if(right_most) {
-            child_page_id = current->get_rid(current->get_size() - 1) -> page_no;
+            child_page_id = current->value_at(current->get_size() - 1);
         } else {
             child_page_id = current->internal_lookup(key, col_cnt,find_type);
         }
@@ -338,7 +489,7 @@ IxIndexHandle::find_leaf_page(const char *key, Operation operation, Transaction
             case Operation::INSERT: {
                  child_node_page->WLock();
                 transaction->append_index_latch_page_set(current_page);
-                if(child_node->get_size() < child_node->get_max_size() -1) {
+                if(child_node->is_insert_safe()) {
                     release_ancestors(transaction);   // 释放所有祖先page latch
                 }
                 break;
@@ -346,7 +497,7 @@ IxIndexHandle::find_leaf_page(const char *key, Operation operation, Transaction
             case Operation::DELETE: {
                  child_node_page->WLock();
                 transaction->append_index_latch_page_set(current_page);
-                if(child_node->get_size() > child_node->get_min_size()) {
+                if(child_node->is_delete_safe()) {
                     release_ancestors(transaction);   // 释放所有祖先page latch
                 }
                 break;
@@ -357,6 +508,40 @@ IxIndexHandle::find_leaf_page(const char *key, Operation operation, Transaction
     }
     return std::make_pair(current, false); // Check(AntiO2) 这里第二个返回值有点意义不明
 }
+
+/**
+ * @brief 乐观地查找key所在的叶子结点：持有root_latch_的读锁取得根结点，内部结点只加读锁逐层下降，只对叶子结点加写锁
+ * @return 加了写锁的叶子结点，树为空时返回nullptr
+ * @note 插入和删除先走这条路径，叶子结点的修改不会引起分裂或合并时无需锁住任何祖先结点，也不持有root_latch_的写锁；
+ * 否则调用者放弃叶子结点，再按find_leaf_page加写锁重新下降。父结点的读锁保证孩子不会被合并释放，孩子的类型可以不加锁读取
+ */
+IxNodeHandle *IxIndexHandle::find_leaf_page_optimistic(const char *key) {
+    root_latch_.read_lock();
+    if (is_empty()) {
+        root_latch_.read_unlock();
+        return nullptr;
+    }
+    IxNodeHandle *current = fetch_node(file_hdr_->root_page_);
+    if (current->is_leaf_page()) {
+        current->page->WLock();
+    } else {
+        current->page->RLock();
+    }
+    root_latch_.read_unlock();
+    while (!current->is_leaf_page()) {
+        IxNodeHandle *child = fetch_node(current->internal_lookup(key, file_hdr_->col_num_, FIND_TYPE::COMMON));
+        if (child->is_leaf_page()) {
+            child->page->WLock();
+        } else {
+            child->page->RLock();
+        }
+        current->page->RUnlock();
+        buffer_pool_manager_->unpin_page(current->get_page_id(), false);
+        delete current;
+        current = child;
+    }
+    return current;
+}
 /**
  * @brief 用于查找指定键在叶子结点中的对应的值result
  *
@@ -367,19 +552,22 @@ IxIndexHandle::find_leaf_page(const char *key, Operation operation, Transaction
  */
 bool IxIndexHandle::get_value(const char *key, std::vector<Rid> *result, Transaction *transaction) {
     // 1. 获取目标key值所在的叶子结点
-
+    char ix_key[IX_MAX_COL_LEN];
+    ix_normalize_key(key, ix_key, file_hdr_->col_types_, file_hdr_->col_lens_);
+    key = ix_key;
     root_latch_.read_lock();
     auto leaf_page_hdr = find_leaf_page(key, Operation::FIND, transaction, file_hdr_->col_num_, FIND_TYPE::COMMON, false,
                                         false).first;
     // 2. 在叶子节点中查找目标key值的位置，并读取key对应的rid
     Rid* rid;
     auto found = leaf_page_hdr->leaf_lookup(key,&rid, file_hdr_->col_num_);
-    leaf_page_hdr->page->RUnlock();
-    buffer_pool_manager_->unpin_page(leaf_page_hdr->get_page_id(), false);
-    // 3. 把rid存入result参数中
+    // 3. 把rid存入result参数中，须在释放读锁之前拷贝，之后结点中的键值对可能被并发的插入删除移动
     if(found) {
         result->push_back(*rid);
     }
+    leaf_page_hdr->page->RUnlock();
+    buffer_pool_manager_->unpin_page(leaf_page_hdr->get_page_id(), false);
+    delete leaf_page_hdr;
     // 提示：使用完buffer_pool提供的page之后，记得unpin page；记得处理并发的上锁
     return found;
 }
@@ -391,7 +579,7 @@ bool IxIndexHandle::get_value(const char *key, std::vector<Rid> *result, Transac
  * @note need to unpin the new node outside
  * 注意：本函数执行完毕后，原node和new node都需要在函数外面进行unpin
  */
-IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
+IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node, Transaction *transaction) {
     // 1. 将原结点的键值对平均分配，右半部分分裂为新的右兄弟结点
     //    需要初始化新节点的page_hdr内容
 
@@ -401,28 +589,45 @@ IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
     auto node_page_hdr = node->page_hdr;
     new_page_hdr->is_leaf = node_page_hdr->is_leaf;
     new_page_hdr->num_key = 0;
+    new_page_hdr->key_bytes = 0;
     new_page_hdr->parent = node->get_parent_page_no();
     new_page_hdr->next_free_page_no = node_page_hdr->next_free_page_no;
+    smo_add_node(node, transaction);
+    smo_add_node(new_node, transaction);
 
+    // 2. 为新节点分配键值对，更新旧节点的键值对数记录。新结点填好后才接入叶子链表，反向扫描不会读到未填好的结点
+    //    内部结点的分隔键不等长，按字节数平分
+    auto mid = node_page_hdr->num_key/2;
+    if (!node->is_leaf_page()) {
+        int bytes = 0;
+        for (mid = 0; mid < node->get_size() - 1 && bytes * 2 < node->get_used_bytes(); mid++) {
+            bytes += sizeof(IxSlot) + node->get_key_size(mid);
+        }
+        mid = std::max(mid, 1);
+    }
+    auto num = node->get_size() - mid;
+    new_node->insert_pairs_from(0, *node, mid, num);
+    node->erase_pairs(mid, num);
     if (node->is_leaf_page()) {
-        // 2. 如果新的右兄弟结点是叶子结点，更新新旧节点的prev_leaf和next_leaf指针
-        //    为新节点分配键值对，更新旧节点的键值对数记录
+        //    如果新的右兄弟结点是叶子结点，更新新旧节点的prev_leaf和next_leaf指针
         new_page_hdr->prev_leaf = node->get_page_no();
         new_page_hdr->next_leaf = node_page_hdr->next_leaf;
         node_page_hdr->next_leaf = new_node->get_page_no();
 
+        // 原来的右兄弟可能不在同一父结点下，正被乐观路径上的写者修改，须先加写锁。
+        // 持有node的写锁再锁右兄弟，加锁顺序从左到右，不会死锁
         auto next_node = fetch_node(new_page_hdr->next_leaf);
+        next_node->page->WLock();
         next_node->page_hdr->prev_leaf=new_node->get_page_no();
+        smo_add_node(next_node, transaction, true);
+        next_node->page->WUnlock();
         buffer_pool_manager_->unpin_page(next_node->get_page_id(), true);
+        delete next_node;
     }
-    auto mid = node_page_hdr->num_key/2;
-    auto num = node->get_size() - mid;
-    new_node->insert_pairs(0,node->get_key(mid), node->get_rid(mid), num);
-    node->page_hdr->num_key = mid;
     // 3. 如果新的右兄弟结点不是叶子结点，更新该结点的所有孩子结点的父节点信息(使用IxIndexHandle::maintain_child())
     if(!node->is_leaf_page()) {
     for(auto i = 0; i < num; i++) {
-        maintain_child(new_node, i);
+        maintain_child(new_node, i, transaction);
         }
     }
     return new_node;
@@ -436,7 +641,7 @@ IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
  * 直到找到的old_node为根结点时，结束递归（此时将会新建一个根R，关键字为key，old_node和new_node为其孩子）
  *
  * @param (old_node, new_node) 原结点为old_node，old_node被分裂之后产生了新的右兄弟结点new_node
- * @param key 要插入parent的key
+ * @param key 要插入parent的分隔键(col_tot_len个字节)，不大于new_node中的键且大于old_node中的键
  * @note 一个结点插入了键值对之后需要分裂，分裂后左半部分的键值对保留在原结点，在参数中称为old_node，
  * 右半部分的键值对分裂为新的右兄弟节点，在参数中称为new_node（参考Split函数来理解old_node和new_node）
  * @note 本函数执行完毕后，new node和old node都需要在函数外面进行unpin
@@ -450,15 +655,19 @@ void IxIndexHandle::insert_into_parent(IxNodeHandle *old_node, const char *key,
             throw RunOutMemError();
         }
         new_root->init();
-        new_root->insert_pair(0, old_node->get_key(0),Rid{.page_no=old_node->get_page_no(),.slot_no=-1}); // 将old_node的key和page_no插入
-        new_root->insert_pair(1,new_node->get_key(0),Rid{.page_no=new_node->get_page_no(),.slot_no=-1});
+        // 最左孩子的分隔键不参与查找，存为空键
+        char min_key[IX_MAX_COL_LEN] = {};
+        new_root->insert_pair(0, min_key, Rid{.page_no=old_node->get_page_no(),.slot_no=-1}); // 将old_node的page_no插入
+        new_root->insert_pair(1, key, Rid{.page_no=new_node->get_page_no(),.slot_no=-1});
         auto new_root_id = new_root->get_page_id().page_no;
         file_hdr_->root_page_ = new_root_id;
         old_node->page_hdr->parent = new_root_id;
         new_node->page_hdr->parent = new_root_id;
+        smo_add_node(new_root, transaction);
 
         buffer_pool_manager_->unpin_page(new_root->get_page_id(), true);
 
+        smo_log(LogType::IX_SPLIT, transaction);
         release_ancestors(transaction);   // 释放所有祖先page latch
         return;
     }
@@ -468,14 +677,19 @@ void IxIndexHandle::insert_into_parent(IxNodeHandle *old_node, const char *key,
         auto pos = parent_node->find_child(old_node);
         // 3. 获取key对应的rid，并将(key, rid)插入到父亲结点
         parent_node->insert_pair(pos+1, key, Rid{.page_no=new_node->get_page_no(),.slot_no=IX_NO_PAGE});
+        smo_add_node(parent_node, transaction);
 
 
         // 4. 如果父亲结点仍需要继续分裂，则进行递归插入
-        if(parent_node->get_size()==parent_node->get_max_size()) {
-            auto new_parent = split(parent_node);
-            insert_into_parent(parent_node, new_parent->get_key(0), new_parent, transaction);
+        if(parent_node->is_full()) {
+            auto new_parent = split(parent_node, transaction);
+            // 新结点的第一个分隔键就是它在父结点中的分隔键
+            char new_key[IX_MAX_COL_LEN];
+            new_parent->read_key(0, new_key);
+            insert_into_parent(parent_node, new_key, new_parent, transaction);
             buffer_pool_manager_->unpin_page(new_parent->get_page_id(), true);
         } else {
+            smo_log(LogType::IX_SPLIT, transaction);
             release_ancestors(transaction);   // 释放所有祖先page latch
         }
         buffer_pool_manager_->unpin_page(parent_node->get_page_id(), true);
@@ -488,57 +702,71 @@ void IxIndexHandle::insert_into_parent(IxNodeHandle *old_node, const char *key,
  * @brief 将指定键值对插入到B+树中
  * @param (key, value) 要插入的键值对
  * @param transaction 事务指针
+ * @param log_op 回滚事务时为UNDO，记录补偿日志IX_CLR_INSERT，其下一条要撤销的日志为undo_next
  * @return page_id_t 插入到的叶结点的page_no
  */
-page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transaction *transaction) {
+page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transaction *transaction, LogOperation log_op,
+                                      lsn_t undo_next) {
+    auto log_type = log_op == LogOperation::REDO ? LogType::IX_INSERT : LogType::IX_CLR_INSERT;
+    // 日志中记录调用者给出的原始键，结点中保存编码后的键
+    const char *raw_key = key;
+    char ix_key[IX_MAX_COL_LEN];
+    ix_normalize_key(key, ix_key, file_hdr_->col_types_, file_hdr_->col_lens_);
+    key = ix_key;
+    // 0. 乐观插入：叶子结点插入后不会分裂时只需锁住叶子结点
+    if (auto leaf = find_leaf_page_optimistic(key)) {
+        page_id_t page_no = leaf->get_page_no();
+        bool safe = leaf->get_size() < leaf->get_max_size() - 1;
+        bool inserted = false;
+        if (safe) {
+            auto old_size = leaf->get_size();
+            inserted = leaf->insert(key, value) != old_size;
+            if (inserted) {
+                log_entry(log_type, leaf, raw_key, value, transaction, undo_next);
+            }
+        }
+        leaf->page->WUnlock();
+        buffer_pool_manager_->unpin_page(leaf->get_page_id(), inserted);
+        delete leaf;
+        if (safe) {
+            if (!inserted) {
+                throw IndexEntryDuplicateError();
+            }
+            return page_no;
+        }
+    }
     // 1. 查找key值应该插入到哪个叶子节点
     root_latch_.write_lock();
     transaction->append_index_latch_page_set(nullptr);
     if(is_empty()) {
         auto root_node = create_node();
+        // 新结点的页面可能是复用的已释放页面，也可能是新分配的全0页面，都需要显式初始化为没有父结点的叶子
+        root_node->init(IX_NO_PAGE, IX_NO_PAGE, true);
         file_hdr_->first_leaf_=root_node->get_page_no();
         file_hdr_->last_leaf_=root_node->get_page_no();
-        root_node->page_hdr->is_leaf = true;
         file_hdr_->root_page_=root_node->get_page_no();
         root_node->page_hdr->next_leaf=IX_LEAF_HEADER_PAGE,
-        root_node->page_hdr->prev_leaf = IX_LEAF_HEADER_PAGE,
-        root_node->insert_pair(0,key,value);
+        root_node->page_hdr->prev_leaf = IX_LEAF_HEADER_PAGE;
 
-        char* data = new char[file_hdr_->tot_len_];
-        file_hdr_->serialize(data); // 将fhdr的数据结构化，存储到data中
-        disk_manager_->write_page(fd_, IX_FILE_HDR_PAGE, data, file_hdr_->tot_len_);
-
-        char page_buf[PAGE_SIZE];  // 在内存中初始化page_buf中的内容，然后将其写入磁盘
-        memset(page_buf, 0, PAGE_SIZE);
-        // 注意leaf header页号为1，也标记为叶子结点，其前一个/后一个叶子均指向root node
-        // Create leaf list header page and write to file
-        {
-            memset(page_buf, 0, PAGE_SIZE);
-            auto phdr = reinterpret_cast<IxPageHdr *>(page_buf);
-            *phdr = {
-                    .next_free_page_no = IX_NO_PAGE,
-                    .parent = IX_NO_PAGE,
-                    .num_key = 0,
-                    .is_leaf = true,
-                    .prev_leaf = root_node->get_page_no(),
-                    .next_leaf = root_node->get_page_no(),
-            };
-            disk_manager_->write_page(fd_, IX_LEAF_HEADER_PAGE, page_buf, PAGE_SIZE);
-        }
-        {
-            memset(page_buf, 0, PAGE_SIZE);
-            auto phdr = reinterpret_cast<IxPageHdr *>(page_buf);
-            *phdr = {
-                    .next_free_page_no = IX_NO_PAGE,
-                    .parent = IX_NO_PAGE,
-                    .num_key = 0,
-                    .is_leaf = true,
-                    .prev_leaf = IX_LEAF_HEADER_PAGE,
-                    .next_leaf = IX_LEAF_HEADER_PAGE,
-            };
-            // Must write PAGE_SIZE here in case of future fetch_node()
-            disk_manager_->write_page(fd_, root_node->get_page_no(), page_buf, PAGE_SIZE);
+        if (!is_logging(transaction)) {
+            // 记录日志时文件头的修改由结构修改日志重做，在关闭索引时写盘
+            char* data = new char[file_hdr_->tot_len_];
+            file_hdr_->serialize(data); // 将fhdr的数据结构化，存储到data中
+            disk_manager_->write_page(fd_, IX_FILE_HDR_PAGE, data, file_hdr_->tot_len_);
         }
+
+        // 注意leaf header页号为1，其前一个/后一个叶子均指向root node；
+        // leaf header可能已在buffer pool中，需通过buffer pool修改，直接写盘会被缓存中的旧内容覆盖
+        auto leaf_header = fetch_node(IX_LEAF_HEADER_PAGE);
+        leaf_header->set_prev_leaf(root_node->get_page_no());
+        leaf_header->set_next_leaf(root_node->get_page_no());
+        // 新建空的根结点作为一次结构修改，之后再插入键值对
+        smo_add_node(root_node, transaction);
+        smo_add_node(leaf_header, transaction, true);
+        smo_log(LogType::IX_SPLIT, transaction);
+        root_node->insert_pair(0,key,value);
+        log_entry(log_type, root_node, raw_key, value, transaction, undo_next);
+        buffer_pool_manager_->unpin_page(leaf_header->get_page_id(), true);
         buffer_pool_manager_->unpin_page(root_node->get_page_id(),true);
         release_ancestors(transaction);
         return true;
@@ -556,6 +784,7 @@ page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transac
         throw IndexEntryDuplicateError();
         return IX_NO_PAGE;
     }
+    log_entry(log_type, leaf_page, raw_key, value, transaction, undo_next);
 
     if(new_size<leaf_page->get_max_size()) {
         release_ancestors(transaction);   // 释放所有祖先page latch
@@ -565,11 +794,15 @@ page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transac
         return page_id.page_no;
     }
     // 3. 如果结点已满，分裂结点，并把新结点的相关信息插入父节点
-    auto new_node = split(leaf_page);
+    auto new_node = split(leaf_page, transaction);
     if(leaf_page->get_page_no()==file_hdr_->last_leaf_) {
         file_hdr_->last_leaf_ = new_node->get_page_no();
     }
-    insert_into_parent(leaf_page,new_node->get_key(0), new_node, transaction);
+    // 后缀截断：父结点中只需能区分两个叶子的最短分隔键
+    char sep[IX_MAX_COL_LEN];
+    ix_shortest_separator(leaf_page->get_key(leaf_page->get_size() - 1), new_node->get_key(0), sep,
+                          file_hdr_->col_tot_len_);
+    insert_into_parent(leaf_page, sep, new_node, transaction);
     // 提示：记得unpin page；若当前叶子节点是最右叶子节点，则需要更新file_hdr_.last_leaf；记得处理并发的上锁
     leaf_page->page->WUnlock();
     buffer_pool_manager_->unpin_page(leaf_page->get_page_id(), true);
@@ -582,8 +815,34 @@ page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transac
  * @brief 用于删除B+树中含有指定key的键值对
  * @param key 要删除的key值
  * @param transaction 事务指针
+ * @param log_op 回滚事务时为UNDO，记录补偿日志IX_CLR_DELETE，其下一条要撤销的日志为undo_next
  */
-bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
+bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction, LogOperation log_op, lsn_t undo_next) {
+    auto log_type = log_op == LogOperation::REDO ? LogType::IX_DELETE : LogType::IX_CLR_DELETE;
+    const char *raw_key = key;
+    char ix_key[IX_MAX_COL_LEN];
+    ix_normalize_key(key, ix_key, file_hdr_->col_types_, file_hdr_->col_lens_);
+    key = ix_key;
+    // 0. 乐观删除：叶子结点删除后不会合并或重分配时只需锁住叶子结点
+    if (auto leaf = find_leaf_page_optimistic(key)) {
+        int size = leaf->get_size();
+        bool safe = leaf->is_root_page() ? size > 1 : size > leaf->get_min_size();
+        bool removed = false;
+        if (safe) {
+            int pos = leaf->lower_bound(key, file_hdr_->col_num_);
+            Rid rid = pos < size ? *leaf->get_rid(pos) : Rid{.page_no = INVALID_PAGE_ID, .slot_no = -1};
+            removed = leaf->remove(key) != size;
+            if (removed) {
+                log_entry(log_type, leaf, raw_key, rid, transaction, undo_next);
+            }
+        }
+        leaf->page->WUnlock();
+        buffer_pool_manager_->unpin_page(leaf->get_page_id(), removed);
+        delete leaf;
+        if (safe) {
+            return removed;
+        }
+    }
     // 1. 获取该键值对所在的叶子结点
     root_latch_.write_lock();
     transaction->append_index_latch_page_set(nullptr);
@@ -594,6 +853,9 @@ bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
     auto leaf_node = find_leaf_page(key, Operation::DELETE, transaction, file_hdr_->col_num_, FIND_TYPE::COMMON, false,
                                     false).first;
     int size = leaf_node->get_size();
+    // 日志中记录被删除的rid，撤销时重新插入
+    int pos = leaf_node->lower_bound(key, file_hdr_->col_num_);
+    Rid rid = pos < size ? *leaf_node->get_rid(pos) : Rid{.page_no = INVALID_PAGE_ID, .slot_no = -1};
     // 2. 在该叶子结点中删除键值对
     if(leaf_node->remove(key)==size) {
         release_ancestors(transaction);   // 释放所有祖先page latch
@@ -601,6 +863,7 @@ bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
         buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), false);
         return false;
     } else {
+        log_entry(log_type, leaf_node, raw_key, rid, transaction, undo_next);
         bool root_is_latched; // check(AntiO2) 好像没有用这个
         // 3. 如果删除成功需要调用CoalesceOrRedistribute来进行合并或重分配操作，并根据函数返回结果判断是否有结点需要删除
         auto need_delete = coalesce_or_redistribute(leaf_node, transaction, &root_is_latched);
@@ -610,6 +873,7 @@ bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
             transaction->append_index_deleted_page(leaf_node->page);
         }
         buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), true);
+        // 被删除的结点已从树和叶子链表中摘除并记录在结构修改日志中，delete_page丢弃其帧并释放页号，之后create_node可复用
         for(auto page:*(transaction->get_index_deleted_page_set())) {
             buffer_pool_manager_->delete_page(page->get_page_id());
         }
@@ -633,14 +897,20 @@ bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
 bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *transaction, bool *root_is_latched) {
     // 1. 判断node结点是否为根节点
     //    1.1 如果是根节点，需要调用AdjustRoot() 函数来进行处理，返回根节点是否需要被删除
+    //    合并或重分配到此结束，在释放祖先结点的latch之前记录结构修改日志
     if(node->is_root_page()) {
-        auto root_deleted = adjust_root(node);
+        auto root_deleted = adjust_root(node, transaction);
+        if(root_deleted) {
+            transaction->append_index_deleted_page(node->page);
+        }
+        smo_log(LogType::IX_MERGE, transaction);
         release_ancestors(transaction);
         return root_deleted;
     }
 
     //    1.2 如果不是根节点，并且不需要执行合并或重分配操作，则直接返回false，否则执行2
-    if (node->get_size() >= node->get_min_size()) {
+    if (!node->is_underflow()) {
+        smo_log(LogType::IX_MERGE, transaction);
         release_ancestors(transaction);
         return false;
     }
@@ -651,13 +921,15 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
     // 3. 寻找node结点的兄弟结点（优先选取前驱结点）
     if(pos>0) {
         // note pos>0才能找前驱
-        auto sibling_node = fetch_node(parent_node->get_rid(pos-1)->page_no);
+        auto sibling_node = fetch_node(parent_node->value_at(pos-1));
         auto sibling_page = sibling_node->page;
          sibling_page->WLock();
         // 4. 如果node结点和兄弟结点的键值对数量之和，能够支撑两个B+树结点（即node.size+neighbor.size >=
         // NodeMinSize*2)，则只需要重新分配键值对（调用Redistribute函数）
-        if(sibling_node->get_size() > sibling_node->get_min_size()) {
-            redistribute(sibling_node, node ,parent_node,pos);
+        //    内部结点的分隔键不等长，兄弟结点没有富余但合并后放不下时，也重新分配
+        if(sibling_node->has_spare() || !sibling_node->can_merge(*node)) {
+            redistribute(sibling_node, node ,parent_node,pos, transaction);
+            smo_log(LogType::IX_MERGE, transaction);
             release_ancestors(transaction);
             buffer_pool_manager_->unpin_page(parent_page->get_page_id(), true);
              sibling_page->WUnlock();
@@ -675,11 +947,12 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
         return true;
     }
     if(pos!=parent_node->get_size()-1) {
-        auto sibling_node = fetch_node(parent_node->get_rid(pos+1)->page_no);
+        auto sibling_node = fetch_node(parent_node->value_at(pos+1));
         auto sibling_page = sibling_node->page;
         sibling_page->WLock();
-        if(sibling_node->get_size() > sibling_node->get_min_size()) {
-            redistribute(sibling_node, node, parent_node, pos);
+        if(sibling_node->has_spare() || !sibling_node->can_merge(*node)) {
+            redistribute(sibling_node, node, parent_node, pos, transaction);
+            smo_log(LogType::IX_MERGE, transaction);
             release_ancestors(transaction);
 
             buffer_pool_manager_->unpin_page(parent_page->get_page_id(), true);
@@ -699,6 +972,8 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
         buffer_pool_manager_->unpin_page(sibling_page->get_page_id(), true);
         return false;
     }
+    smo_log(LogType::IX_MERGE, transaction);
+    release_ancestors(transaction);
     return false;
 }
 
@@ -708,12 +983,13 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
  * @return bool 根结点是否需要被删除
  * @note size of root page can be less than min size and this method is only called within coalesce_or_redistribute()
  */
-bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node) {
+bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node, Transaction *transaction) {
     // 1. 如果old_root_node是内部结点，并且大小为1，则直接把它的孩子更新成新的根结点
     if (!old_root_node->is_leaf_page() && old_root_node->get_size() == 1) {
-        auto child_node = fetch_node(old_root_node->get_rid(0)->page_no);
+        auto child_node = fetch_node(old_root_node->value_at(0));
         auto child_page = child_node->page;
        child_node->set_parent_page_no(INVALID_PAGE_ID);
+        smo_add_node(child_node, transaction, true);
 
         auto root_page_id_ = child_node->get_page_id();
         file_hdr_->root_page_ = root_page_id_.page_no;
@@ -745,9 +1021,10 @@ bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node) {
  * index>0，则neighbor是node前驱结点，表示：neighbor(left)  node(right)
  * 注意更新parent结点的相关kv对
  */
-void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index) {
-
-
+void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index,
+                                 Transaction *transaction) {
+    smo_add_node(neighbor_node, transaction);
+    smo_add_node(node, transaction);
 
     // 注意：neighbor_node的位置不同，需要移动的键值对不同，需要分类讨论
     // 1. 通过index判断neighbor_node是否为node的前驱结点
@@ -755,16 +1032,16 @@ void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node
         // 如果index!=0, 说明是邻居在左侧
         int pos = neighbor_node->get_size() - 1;
         // 2. 从neighbor_node中移动一个键值对到node结点中
-        node->insert_pair(0, neighbor_node->get_key(pos), *neighbor_node->get_rid(pos));
+        node->insert_pairs_from(0, *neighbor_node, pos, 1);
         neighbor_node->erase_pair(pos);
         // 3. 更新父节点中的相关信息，并且修改移动键值对对应孩字结点的父结点信息（maintain_child函数）
-        maintain_child(node, 0);
-        maintain_parent(node);
+        maintain_child(node, 0, transaction);
+        update_separator(parent, index, neighbor_node, node, transaction);
     } else {
-        node->insert_pair(node->get_size(), neighbor_node->get_key(0), *neighbor_node->get_rid(0));
+        node->insert_pairs_from(node->get_size(), *neighbor_node, 0, 1);
         neighbor_node->erase_pair(0);
-        maintain_child(node, node->get_size() - 1);
-        maintain_parent(neighbor_node);
+        maintain_child(node, node->get_size() - 1, transaction);
+        update_separator(parent, index + 1, node, neighbor_node, transaction);
     }
 }
 
@@ -790,11 +1067,13 @@ bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
         index++;
     }
     // 2. 把node结点的键值对移动到neighbor_node中，并更新node结点孩子结点的父节点信息（调用maintain_child函数）
+    smo_add_node(*neighbor_node, transaction);
+    smo_add_node(*parent, transaction);
     auto prev_num = (*neighbor_node)->get_size();
-    (*neighbor_node)->insert_pairs(prev_num,(*node)->get_key(0),(*node)->get_rid(0),(*node)->get_size());
+    (*neighbor_node)->insert_pairs_from(prev_num, **node, 0, (*node)->get_size());
     auto next_num = (*neighbor_node)->get_size();
     for(auto i = prev_num; i < next_num; i++) {
-        maintain_child(*neighbor_node,i); // 维护更新后的子结点信息
+        maintain_child(*neighbor_node,i, transaction); // 维护更新后的子结点信息
     }
     // 3. 释放和删除node结点，并删除parent中node结点的信息，返回parent是否需要被删除
 
@@ -804,7 +1083,7 @@ bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
     }
     // 提示：如果是叶子结点且为最右叶子结点，需要更新file_hdr_.last_leaf
     if((*node)->is_leaf_page()) {
-        erase_leaf(*node);
+        erase_leaf(*node, transaction);
     }
     release_node_handle(**node);
     (*parent)->erase_pair(index);
@@ -824,12 +1103,15 @@ bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
 Rid IxIndexHandle::get_rid(const Iid &iid) const {
     IxNodeHandle *node = fetch_node(iid.page_no);
     node->page->RLock();
-    if (iid.slot_no >= node->get_size()) {
-        throw IndexEntryNotFoundError();
-    }
+    bool found = iid.slot_no < node->get_size();
+    Rid rid = found ? *node->get_rid(iid.slot_no) : Rid{};
     node->page->RUnlock();
     buffer_pool_manager_->unpin_page(node->get_page_id(), false);
-    return *node->get_rid(iid.slot_no);
+    delete node;
+    if (!found) {
+        throw IndexEntryNotFoundError();
+    }
+    return rid;
 }
 
 /**
@@ -850,11 +1132,13 @@ Rid IxIndexHandle::get_rid(const Iid &iid) const {
 Iid IxIndexHandle::leaf_end()  {
 
     root_latch_.read_lock();
-    auto leaf_end_node = find_leaf_page(nullptr,Operation::FIND, nullptr,file_hdr_->col_num_, FIND_TYPE::COMMON, true,
-                                         false);
+    auto leaf_end_node = find_leaf_page(nullptr,Operation::FIND, nullptr,file_hdr_->col_num_, FIND_TYPE::COMMON, false,
+                                         true);
     auto page_no = leaf_end_node.first->get_page_no();
     Iid iid = {.page_no = page_no, .slot_no=leaf_end_node.first->get_size()};
+    leaf_end_node.first->page->RUnlock();
     buffer_pool_manager_->unpin_page(leaf_end_node.first->get_page_id(), false);
+    delete leaf_end_node.first;
     return iid;
 }
 
@@ -869,7 +1153,9 @@ Iid IxIndexHandle::leaf_begin()  {
     auto leaf_begin_node = find_leaf_page(nullptr,Operation::FIND, nullptr,file_hdr_->col_num_, FIND_TYPE::COMMON, true,
                                          false);
     Iid iid = {.page_no = leaf_begin_node.first->get_page_no(), .slot_no = 0};
+    leaf_begin_node.first->page->RUnlock();
     buffer_pool_manager_->unpin_page(leaf_begin_node.first->get_page_id(), false);
+    delete leaf_begin_node.first;
     return iid;
 }
 
@@ -898,36 +1184,40 @@ IxNodeHandle *IxIndexHandle::fetch_node(int page_no) const  {
  */
 IxNodeHandle *IxIndexHandle::create_node() {
     IxNodeHandle *node;
-    file_hdr_->num_pages_++;
 
     PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
     // 从3开始分配page_no，第一次分配之后，new_page_id.page_no=3，file_hdr_.num_pages=4
+    // 有被删除结点释放的页面时复用其中页号最小的，num_pages只在文件变长时增加
     Page *page = buffer_pool_manager_->new_page(&new_page_id);
+    file_hdr_->num_pages_ = std::max(file_hdr_->num_pages_, new_page_id.page_no + 1);
     node = new IxNodeHandle(file_hdr_, page);
     return node;
 }
 
 /**
- * @brief 从node开始更新其父节点的第一个key，一直向上更新直到根节点
+ * @brief 重分配之后更新父结点中right的分隔键。right是叶子结点时取两个叶子之间最短的分隔键，
+ * 是内部结点时取right的第一个分隔键
  *
- * @param node
+ * @param rank right在parent中的rid_idx，rank>0，left是其前驱结点
+ * @note 新的分隔键可能更长，父结点放不下时分裂，再插入祖父结点。父结点不满足is_delete_safe时祖先结点仍被锁住
  */
-void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
-    IxNodeHandle *curr = node;
-    while (curr->get_parent_page_no() != IX_NO_PAGE) {
-        // Load its parent
-        IxNodeHandle *parent = fetch_node(curr->get_parent_page_no());
-        int rank = parent->find_child(curr);
-        char *parent_key = parent->get_key(rank);
-        char *child_first_key = curr->get_key(0);
-        if (memcmp(parent_key, child_first_key, file_hdr_->col_tot_len_) == 0) {
-            assert(buffer_pool_manager_->unpin_page(parent->get_page_id(), true));
-            break;
-        }
-        memcpy(parent_key, child_first_key, file_hdr_->col_tot_len_);  // 修改了parent node
-        curr = parent;
-
-        assert(buffer_pool_manager_->unpin_page(parent->get_page_id(), true));
+void IxIndexHandle::update_separator(IxNodeHandle *parent, int rank, IxNodeHandle *left, IxNodeHandle *right,
+                                     Transaction *transaction) {
+    char sep[IX_MAX_COL_LEN];
+    if (right->is_leaf_page()) {
+        ix_shortest_separator(left->get_key(left->get_size() - 1), right->get_key(0), sep, file_hdr_->col_tot_len_);
+    } else {
+        right->read_key(0, sep);
+    }
+    smo_add_node(parent, transaction);
+    parent->set_key(rank, sep);
+    if (parent->is_full()) {
+        auto new_parent = split(parent, transaction);
+        char new_key[IX_MAX_COL_LEN];
+        new_parent->read_key(0, new_key);
+        insert_into_parent(parent, new_key, new_parent, transaction);
+        buffer_pool_manager_->unpin_page(new_parent->get_page_id(), true);
+        delete new_parent;
     }
 }
 
@@ -936,36 +1226,42 @@ void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
  *
  * @param leaf 要删除的leaf
  */
-void IxIndexHandle::erase_leaf(IxNodeHandle *leaf) {
+void IxIndexHandle::erase_leaf(IxNodeHandle *leaf, Transaction *transaction) {
     assert(leaf->is_leaf_page());
 
     IxNodeHandle *prev = fetch_node(leaf->get_prev_leaf());
     prev->set_next_leaf(leaf->get_next_leaf());
+    smo_add_node(prev, transaction, true);
     buffer_pool_manager_->unpin_page(prev->get_page_id(), true);
 
+    // prev是合并的目标结点，调用者已持有其写锁；后继结点可能不在同一父结点下，与split相同，从左到右加写锁后再修改
     IxNodeHandle *next = fetch_node(leaf->get_next_leaf());
+    next->page->WLock();
     next->set_prev_leaf(leaf->get_prev_leaf());  // 注意此处是SetPrevLeaf()
+    smo_add_node(next, transaction, true);
+    next->page->WUnlock();
     buffer_pool_manager_->unpin_page(next->get_page_id(), true);
 }
 
 /**
- * @brief 删除node时，更新file_hdr_.num_pages
+ * @brief 删除node时调用。num_pages是文件的页面个数，不随结点删除减少；
+ * 结点的页面在delete_entry结束时由buffer_pool_manager_->delete_page释放到空闲页面位图
  *
  * @param node
  */
 void IxIndexHandle::release_node_handle(IxNodeHandle &node) {
-    file_hdr_->num_pages_--;
 }
 
 /**
  * @brief 将node的第child_idx个孩子结点的父节点置为node
  */
-void IxIndexHandle::maintain_child(IxNodeHandle *node, int child_idx) {
+void IxIndexHandle::maintain_child(IxNodeHandle *node, int child_idx, Transaction *transaction) {
     if (!node->is_leaf_page()) {
         //  Current node is inner node, load its child and set its parent to current node
         int child_page_no = node->value_at(child_idx);
         IxNodeHandle *child = fetch_node(child_page_no);
         child->set_parent_page_no(node->get_page_no());
+        smo_add_node(child, transaction, true);
         buffer_pool_manager_->unpin_page(child->get_page_id(), true);
     }
 }
@@ -984,23 +1280,31 @@ void IxIndexHandle::release_ancestors(Transaction *transaction) {
 }
 
 Iid IxIndexHandle::lower_bound_cnt(const char *key, size_t cnt) {
+    char ix_key[IX_MAX_COL_LEN];
+    ix_normalize_key(key, ix_key, file_hdr_->col_types_, file_hdr_->col_lens_, cnt);
+    key = ix_key;
     root_latch_.read_lock();
     auto node = find_leaf_page(key,Operation::FIND, nullptr, cnt, FIND_TYPE::LOWER, false, false).first;
     auto idx = node->lower_bound(key,cnt);
     Iid iid = {.page_no = node->get_page_no(),.slot_no=idx};
     if(idx==node->get_size()&&node->get_page_no()!=file_hdr_->last_leaf_) {
-        if(ix_compare(node->get_key(idx -1 ),key,node->file_hdr->col_types_,node->file_hdr->col_lens_,cnt) < 0) {
+        if(idx == 0 || memcmp(node->get_key(idx -1 ), key, file_hdr_->key_len(cnt)) < 0) {
             // 说明在第一个key之前
             iid.page_no=node->get_next_leaf();
             iid.slot_no=0;
         }
     }
 
+    node->page->RUnlock();
     buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+    delete node;
     return iid;
 }
 
 Iid IxIndexHandle::upper_bound_cnt(const char *key, size_t cnt) {
+    char ix_key[IX_MAX_COL_LEN];
+    ix_normalize_key(key, ix_key, file_hdr_->col_types_, file_hdr_->col_lens_, cnt);
+    key = ix_key;
     root_latch_.read_lock();
     auto node = find_leaf_page(key,Operation::FIND, nullptr, cnt, FIND_TYPE::UPPER, false, false).first;
     auto idx = node->upper_bound(key,cnt);
@@ -1009,7 +1313,9 @@ Iid IxIndexHandle::upper_bound_cnt(const char *key, size_t cnt) {
         iid.page_no=node->get_next_leaf();
         iid.slot_no=0;
     }
+    node->page->RUnlock();
     buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+    delete node;
     return iid;
 }
 
@@ -1044,3 +1350,183 @@ int IxIndexHandle::getFd() const {
 IxFileHdr *IxIndexHandle::getFileHdr() const {
     return file_hdr_;
 }
+
+/**
+ * @description: 在叶子结点中插入或删除键值对之后记录IX_INSERT/IX_DELETE(或补偿日志)，加入事务的日志链并更新结点的page_lsn
+ */
+void IxIndexHandle::log_entry(LogType log_type, IxNodeHandle *leaf, const char *key, const Rid &rid,
+                              Transaction *transaction, lsn_t undo_next) {
+    if (!is_logging(transaction)) {
+        return;
+    }
+    IxEntryLogRecord log_record(log_type, transaction->get_transaction_id(), index_name_, leaf->get_page_no(), key,
+                                file_hdr_->col_tot_len_, rid, transaction->get_prev_lsn(), undo_next);
+    log_manager_->add_log_to_buffer(&log_record);
+    transaction->set_prev_lsn(log_record.lsn_);
+    log_manager_->active_txn_table_[transaction->get_transaction_id()] = log_record.lsn_;
+    log_manager_->add_dirty_page(leaf->get_page_id(), log_record.lsn_);
+    leaf->page->set_page_lsn(log_record.lsn_);
+}
+
+/**
+ * @description: 把结构修改中被修改的结点加入事务的smo页面集合，并额外pin住页面直到smo_log记录日志，
+ * 保证页面不会在记录日志之前被淘汰写回
+ * @param header_only 结点只修改了父结点或叶子链表指针，日志中只记录页头
+ */
+void IxIndexHandle::smo_add_node(IxNodeHandle *node, Transaction *transaction, bool header_only) {
+    if (!is_logging(transaction)) {
+        return;
+    }
+    auto smo_pages = transaction->get_index_smo_page_set();
+    for (auto &smo_page : *smo_pages) {
+        if (smo_page.first == node->page) {
+            smo_page.second = smo_page.second && header_only;
+            return;
+        }
+    }
+    buffer_pool_manager_->fetch_page(node->get_page_id());
+    smo_pages->emplace_back(node->page, header_only);
+}
+
+/**
+ * @description: 一次分裂或合并(含重分配)完成后、释放祖先结点的latch之前调用，记录IX_SPLIT/IX_MERGE：
+ * smo页面集合中仍在树中的结点记录修改后的映像，事务删除的结点记录为释放。结构修改日志不加入事务的日志链，
+ * 回滚事务时不撤销，事务对键值对的修改由IX_INSERT/IX_DELETE在整棵树上逻辑撤销
+ */
+void IxIndexHandle::smo_log(LogType log_type, Transaction *transaction) {
+    if (!is_logging(transaction)) {
+        return;
+    }
+    auto smo_pages = transaction->get_index_smo_page_set();
+    auto deleted_pages = transaction->get_index_deleted_page_set();
+    if (smo_pages->empty() && deleted_pages->empty()) {
+        return;
+    }
+    IxSmoLogRecord log_record(log_type, transaction->get_transaction_id(), index_name_);
+    std::vector<char> image;
+    for (auto &smo_page : *smo_pages) {
+        if (std::find(deleted_pages->begin(), deleted_pages->end(), smo_page.first) != deleted_pages->end()) {
+            continue;
+        }
+        IxNodeHandle node(file_hdr_, smo_page.first);
+        image.resize(node.image_size(smo_page.second));
+        node.serialize_image(image.data(), smo_page.second);
+        log_record.add_node(node.get_page_no(), image.data(), static_cast<int>(image.size()));
+    }
+    for (auto it = deleted_pages->begin(); it != deleted_pages->end(); ++it) {
+        if (std::find(deleted_pages->begin(), it, *it) == it) {
+            log_record.add_freed_page((*it)->get_page_id().page_no);
+        }
+    }
+    log_record.set_file_hdr(file_hdr_->root_page_, file_hdr_->first_leaf_, file_hdr_->last_leaf_,
+                            file_hdr_->num_pages_);
+    log_manager_->add_log_to_buffer(&log_record);
+    for (auto &smo_page : *smo_pages) {
+        smo_page.first->set_page_lsn(log_record.lsn_);
+        log_manager_->add_dirty_page(smo_page.first->get_page_id(), log_record.lsn_);
+        buffer_pool_manager_->unpin_page(smo_page.first->get_page_id(), true);
+    }
+    smo_pages->clear();
+}
+
+/**
+ * @description: 重做叶子结点page_no中键值对的插入，调用者已确认结点的page_lsn小于lsn
+ */
+void IxIndexHandle::insert_entry_recover(int page_no, const char *key, const Rid &rid, lsn_t lsn) {
+    char ix_key[IX_MAX_COL_LEN];
+    ix_normalize_key(key, ix_key, file_hdr_->col_types_, file_hdr_->col_lens_);
+    IxNodeHandle *node = fetch_node(page_no);
+    node->insert(ix_key, rid);
+    node->page->set_page_lsn(lsn);
+    buffer_pool_manager_->unpin_page(node->get_page_id(), true);
+    delete node;
+}
+
+/**
+ * @description: 重做叶子结点page_no中键值对的删除，调用者已确认结点的page_lsn小于lsn
+ */
+void IxIndexHandle::delete_entry_recover(int page_no, const char *key, lsn_t lsn) {
+    char ix_key[IX_MAX_COL_LEN];
+    ix_normalize_key(key, ix_key, file_hdr_->col_types_, file_hdr_->col_lens_);
+    IxNodeHandle *node = fetch_node(page_no);
+    node->remove(ix_key);
+    node->page->set_page_lsn(lsn);
+    buffer_pool_manager_->unpin_page(node->get_page_id(), true);
+    delete node;
+}
+
+/**
+ * @description: 分析阶段重放结构修改后的文件头，文件头只在关闭索引时写盘
+ */
+void IxIndexHandle::smo_analyze(const IxSmoLogRecord &log) {
+    file_hdr_->root_page_ = log.root_page_;
+    file_hdr_->first_leaf_ = log.first_leaf_;
+    file_hdr_->last_leaf_ = log.last_leaf_;
+    file_hdr_->num_pages_ = std::max(file_hdr_->num_pages_, log.num_pages_);
+}
+
+/**
+ * @description: 重做一次结构修改：按日志顺序重放页面的分配和释放，使空闲页面位图与崩溃前一致，
+ * 再把page_lsn小于lsn的结点载入日志中的映像。释放的页面可能在之前的重做中被读入，delete_page同时丢弃其帧
+ */
+void IxIndexHandle::smo_recover(const IxSmoLogRecord &log, lsn_t lsn) {
+    for (int i = 0; i < log.num_nodes(); i++) {
+        disk_manager_->reserve_page(fd_, log.page_nos_[i]);
+        IxNodeHandle *node = fetch_node(log.page_nos_[i]);
+        bool redo = node->page->get_page_lsn() < lsn;
+        if (redo) {
+            node->load_image(log.node(i));
+            node->page->set_page_lsn(lsn);
+        }
+        buffer_pool_manager_->unpin_page(node->get_page_id(), redo);
+        delete node;
+    }
+    for (int page_no : log.freed_pages_) {
+        buffer_pool_manager_->delete_page(PageId{.fd = fd_, .page_no = page_no});
+    }
+}
+
+/**
+ * @description: 检查索引是否完整：键为编码后的格式，内部结点为后缀截断的变长格式，文件头中的页号在文件范围内，根结点没有父结点，叶子链表的首尾与文件头和leaf header一致。
+ * 只读取常数个结点，用于启动时决定是否需要从表中重建索引
+ * @return {bool} 检查通过
+ */
+bool IxIndexHandle::verify() {
+    if (!file_hdr_->normalized_keys_ || !file_hdr_->suffix_truncated_ || file_hdr_->num_pages_ < IX_INIT_NUM_PAGES || file_hdr_->btree_order_ < 2) {
+        return false;
+    }
+    if (is_empty()) {
+        return true;
+    }
+    auto in_file = [&](page_id_t page_no) { return page_no > IX_LEAF_HEADER_PAGE && page_no < file_hdr_->num_pages_; };
+    if (!in_file(file_hdr_->root_page_) || !in_file(file_hdr_->first_leaf_) || !in_file(file_hdr_->last_leaf_)) {
+        return false;
+    }
+    auto check_node = [&](page_id_t page_no, const std::function<bool(IxNodeHandle &)> &check) {
+        Page *page = buffer_pool_manager_->fetch_page(PageId{.fd = fd_, .page_no = page_no});
+        IxNodeHandle node(file_hdr_, page);
+        bool ok = check(node);
+        buffer_pool_manager_->unpin_page(page->get_page_id(), false);
+        return ok;
+    };
+    try {
+        return check_node(file_hdr_->root_page_, [&](IxNodeHandle &root) {
+                   return root.get_parent_page_no() == IX_NO_PAGE && root.get_size() >= 0 &&
+                          !root.is_full() &&
+                          (!root.is_leaf_page() || (file_hdr_->first_leaf_ == file_hdr_->root_page_ &&
+                                                    file_hdr_->last_leaf_ == file_hdr_->root_page_));
+               }) &&
+               check_node(IX_LEAF_HEADER_PAGE, [&](IxNodeHandle &leaf_header) {
+                   return leaf_header.get_next_leaf() == file_hdr_->first_leaf_ &&
+                          leaf_header.get_prev_leaf() == file_hdr_->last_leaf_;
+               }) &&
+               check_node(file_hdr_->first_leaf_, [&](IxNodeHandle &first) {
+                   return first.is_leaf_page() && first.get_prev_leaf() == IX_LEAF_HEADER_PAGE;
+               }) &&
+               check_node(file_hdr_->last_leaf_, [&](IxNodeHandle &last) {
+                   return last.is_leaf_page() && last.get_next_leaf() == IX_LEAF_HEADER_PAGE;
+               });
+    } catch (RMDBError &) {
+        return false;
+    }
+}
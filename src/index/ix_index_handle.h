@@ -10,12 +10,17 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <functional>
+
 #include "ix_defs.h"
 #include "transaction/transaction.h"
 #include "common/common.h"
 #include "common/rwlatch.h"
+#include "recovery/log_manager.h"
 enum class Operation { FIND = 0, INSERT, DELETE };  // 三种操作：查找、插入、删除
 enum class FIND_TYPE {LOWER,UPPER,COMMON};
+/* 按键的升序依次给出(key, rid)，用于自底向上建树 */
+using IxEntrySource = std::function<void(const char **key, Rid *rid)>;
 static const bool binary_search = false;
 
 inline int ix_compare(const char* a, const char* b, const std::vector<ColType>& col_types, const std::vector<int>& col_lens, size_t col_num = 0) {
@@ -31,6 +36,112 @@ inline int ix_compare(const char* a, const char* b, const std::vector<ColType>&
     return 0;
 }
 
+/**
+ * @description: 把键的前col_num列(为0时为全部列)编码为可以直接memcmp比较的形式，编码后每列长度不变。
+ * 整数和日期按大端存储并翻转符号位；浮点数为非负时翻转符号位、为负时翻转所有位，-0.0与0.0编码相同；字符串原样保存
+ */
+inline void ix_normalize_key(const char *key, char *dest, const std::vector<ColType> &col_types,
+                             const std::vector<int> &col_lens, size_t col_num = 0) {
+    if (col_num == 0 || col_num > col_types.size()) {
+        col_num = col_types.size();
+    }
+    for (size_t i = 0; i < col_num; ++i) {
+        uint64_t bits;
+        int width;
+        switch (col_types[i]) {
+            case TYPE_INT: {
+                uint32_t v;
+                memcpy(&v, key, sizeof(v));
+                bits = v ^ 0x80000000u;
+                width = 4;
+                break;
+            }
+            case TYPE_FLOAT: {
+                float f;
+                memcpy(&f, key, sizeof(f));
+                f = f == 0.0f ? 0.0f : f;
+                uint32_t v;
+                memcpy(&v, &f, sizeof(v));
+                bits = (v & 0x80000000u) ? ~v : (v | 0x80000000u);
+                width = 4;
+                break;
+            }
+            case TYPE_BIGINT:
+            case TYPE_DATETIME: {
+                memcpy(&bits, key, sizeof(bits));
+                bits ^= 0x8000000000000000ull;
+                width = 8;
+                break;
+            }
+            default:
+                memcpy(dest, key, col_lens[i]);
+                width = 0;
+        }
+        for (int b = 0; b < width; b++) {
+            dest[b] = static_cast<char>(bits >> ((width - 1 - b) * 8));
+        }
+        key += col_lens[i];
+        dest += col_lens[i];
+    }
+}
+
+/**
+ * @description: ix_normalize_key的逆变换，把结点中的键还原为记录中的格式
+ */
+inline void ix_denormalize_key(const char *key, char *dest, const std::vector<ColType> &col_types,
+                               const std::vector<int> &col_lens) {
+    for (size_t i = 0; i < col_types.size(); ++i) {
+        int width = col_types[i] == TYPE_INT || col_types[i] == TYPE_FLOAT ? 4
+                    : col_types[i] == TYPE_BIGINT || col_types[i] == TYPE_DATETIME ? 8 : 0;
+        if (width == 0) {
+            memcpy(dest, key, col_lens[i]);
+        } else {
+            uint64_t bits = 0;
+            for (int b = 0; b < width; b++) {
+                bits = (bits << 8) | static_cast<unsigned char>(key[b]);
+            }
+            if (width == 8) {
+                bits ^= 0x8000000000000000ull;
+                memcpy(dest, &bits, sizeof(bits));
+            } else {
+                auto v = static_cast<uint32_t>(bits);
+                if (col_types[i] == TYPE_INT) {
+                    v ^= 0x80000000u;
+                } else {
+                    v = (v & 0x80000000u) ? (v & ~0x80000000u) : ~v;
+                }
+                memcpy(dest, &v, sizeof(v));
+            }
+        }
+        key += col_lens[i];
+        dest += col_lens[i];
+    }
+}
+
+/**
+ * @description: 键去掉末尾0字节后的长度，内部结点的分隔键只保存这么多字节
+ */
+inline int ix_key_size(const char *key, int len) {
+    while (len > 0 && key[len - 1] == 0) {
+        len--;
+    }
+    return len;
+}
+
+/**
+ * @description: 后缀截断：求大于left且不大于right的最短分隔键，即right截取到与left第一个不同的字节为止，其后补0，
+ * 共len个字节写入dest。要求left < right，right在该字节上大于left，因此不为0，补0后的分隔键仍大于left
+ */
+inline void ix_shortest_separator(const char *left, const char *right, char *dest, int len) {
+    int prefix = 0;
+    while (prefix < len && left[prefix] == right[prefix]) {
+        prefix++;
+    }
+    assert(prefix < len);
+    memcpy(dest, right, prefix + 1);
+    memset(dest + prefix + 1, 0, len - prefix - 1);
+}
+
 /* 管理B+树中的每个节点 */
 class IxNodeHandle {
     friend class IxIndexHandle;
@@ -40,30 +151,74 @@ class IxNodeHandle {
     const IxFileHdr *file_hdr;      // 节点所在文件的头部信息
     Page *page;                     // 存储节点的页面
     IxPageHdr *page_hdr;            // page->data的第一部分，指针指向首地址，长度为sizeof(IxPageHdr)
-    char *keys;                     // page->data的第二部分，指针指向首地址，长度为file_hdr->keys_size，每个key的长度为file_hdr->col_len
-    Rid *rids;                      // page->data的第三部分，指针指向首地址
+    char *keys;                     // 叶子结点：page->data的第二部分，指针指向首地址，长度为file_hdr->keys_size，每个key的长度为file_hdr->col_len
+    Rid *rids;                      // 叶子结点：page->data的第三部分，指针指向首地址
+    IxSlot *slots;                  // 内部结点：page->data的第二部分，num_key个槽，槽中的分隔键从页尾向前存放
 
    public:
     IxNodeHandle() = default;
-    // 存储结构： page_hdr| keys| rids
+    // 存储结构： lsn| checksum| page_hdr| keys| rids                     (叶子结点)
+    //           lsn| checksum| page_hdr| slots| 空闲空间| 分隔键         (内部结点)
     IxNodeHandle(const IxFileHdr *file_hdr_, Page *page_) : file_hdr(file_hdr_), page(page_) {
-        page_hdr = reinterpret_cast<IxPageHdr *>(page->get_data());
-        keys = page->get_data() + sizeof(IxPageHdr);
+        page_hdr = reinterpret_cast<IxPageHdr *>(page->get_data() + Page::OFFSET_PAGE_HDR);
+        keys = page->get_data() + Page::OFFSET_PAGE_HDR + sizeof(IxPageHdr);
         rids = reinterpret_cast<Rid *>(keys + file_hdr->keys_size_);
+        slots = reinterpret_cast<IxSlot *>(keys);
     }
 
     [[nodiscard]] int get_size() const { return page_hdr->num_key; }
 
     void set_size(int size) const { page_hdr->num_key = size; }
 
+    // 叶子结点按键值对个数判断是否满或不足，内部结点按槽和分隔键占用的字节数判断
     int get_max_size() const { return file_hdr->btree_order_ + 1; }
 
-    int get_min_size() { return get_max_size() / 2; }
+    int get_min_size() const { return get_max_size() / 2; }
+
+    int get_max_entry_bytes() const { return static_cast<int>(sizeof(IxSlot)) + file_hdr->col_tot_len_; }
+
+    /* 内部结点结构修改完成后最多占用的字节数，留出一个最长的槽，再插入一个分隔键或把一个分隔键换成更长的都放得下 */
+    int get_max_bytes() const {
+        return PAGE_SIZE - static_cast<int>(Page::OFFSET_PAGE_HDR + sizeof(IxPageHdr)) - get_max_entry_bytes();
+    }
+
+    int get_min_bytes() const { return get_max_bytes() / 2; }
+
+    int get_used_bytes() const { return get_size() * static_cast<int>(sizeof(IxSlot)) + page_hdr->key_bytes; }
+
+    /* 插入之后需要分裂 */
+    bool is_full() const { return is_leaf_page() ? get_size() >= get_max_size() : get_used_bytes() > get_max_bytes(); }
+
+    /* 删除之后需要合并或重分配 */
+    bool is_underflow() const {
+        return is_leaf_page() ? get_size() < get_min_size() : get_used_bytes() < get_min_bytes();
+    }
+
+    /* 移走一个键值对后仍不会不足，可以借给兄弟结点 */
+    bool has_spare() const {
+        return is_leaf_page() ? get_size() > get_min_size()
+                              : get_used_bytes() - get_max_entry_bytes() >= get_min_bytes();
+    }
+
+    /* 再插入一个键值对后不会分裂 */
+    bool is_insert_safe() const {
+        return is_leaf_page() ? get_size() < get_max_size() - 1
+                              : get_used_bytes() + get_max_entry_bytes() <= get_max_bytes();
+    }
+
+    /* 删除时孩子结点的合并或重分配不会波及父结点。孩子重分配时内部结点中的分隔键会被替换，可能变长而分裂 */
+    bool is_delete_safe() const { return has_spare() && (is_leaf_page() || is_insert_safe()); }
+
+    /* 与同一父结点下的兄弟结点合并后放得下 */
+    bool can_merge(const IxNodeHandle &other) const {
+        return is_leaf_page() ? get_size() + other.get_size() < get_max_size()
+                              : get_used_bytes() + other.get_used_bytes() <= get_max_bytes();
+    }
 
     int key_at(int i) { return *(int *)get_key(i); }
     int key_2nd(int i) {return *(int *)(get_key(i)+4);}
     /* 得到第i个孩子结点的page_no */
-    page_id_t value_at(int i) { return get_rid(i)->page_no; }
+    page_id_t value_at(int i) const { return page_hdr->is_leaf ? rids[i].page_no : slots[i].child; }
 
     page_id_t get_page_no() { return page->get_page_id().page_no; }
 
@@ -75,7 +230,7 @@ class IxNodeHandle {
 
     page_id_t get_parent_page_no() { return page_hdr->parent; }
 
-    bool is_leaf_page() { return page_hdr->is_leaf; }
+    bool is_leaf_page() const { return page_hdr->is_leaf; }
 
     bool is_root_page() { return get_parent_page_no() == INVALID_PAGE_ID; }
 
@@ -86,14 +241,31 @@ class IxNodeHandle {
     void set_parent_page_no(page_id_t parent) { page_hdr->parent = parent; }
 
     char *get_key(int key_idx) const {
+        if (!page_hdr->is_leaf) {
+            return page->get_data() + slots[key_idx].key_off;
+        }
         return keys + key_idx * file_hdr->col_tot_len_;
     }
 
+    /* 第key_idx个键保存的字节数，内部结点的分隔键不含末尾的0字节 */
+    int get_key_size(int key_idx) const { return page_hdr->is_leaf ? file_hdr->col_tot_len_ : slots[key_idx].key_len; }
+
+    /* 把第key_idx个键补齐为col_tot_len个字节写入dest */
+    void read_key(int key_idx, char *dest) const {
+        int size = get_key_size(key_idx);
+        memcpy(dest, get_key(key_idx), size);
+        memset(dest + size, 0, file_hdr->col_tot_len_ - size);
+    }
+
+    int compare_key(int key_idx, const char *target, int len) const;
+
+    /* 叶子结点中的rid，内部结点的孩子用value_at获取 */
     Rid *get_rid(int rid_idx) const {
+        assert(page_hdr->is_leaf);
         return &rids[rid_idx];
     }
 
-    void set_key(int key_idx, const char *key) { memcpy(keys + key_idx * file_hdr->col_tot_len_, key, file_hdr->col_tot_len_); }
+    void set_key(int key_idx, const char *key);
 
     void set_rid(int rid_idx, const Rid &rid) { rids[rid_idx] = rid; }
 
@@ -101,6 +273,8 @@ class IxNodeHandle {
     int upper_bound(const char *target,  size_t col_num) const;
     void insert_pairs(int pos, const char *key, const Rid *rid, int n);
 
+    void insert_pairs_from(int pos, const IxNodeHandle &src, int begin, int n);
+
     page_id_t internal_lookup(const char *key, size_t col_num,FIND_TYPE findType=FIND_TYPE::COMMON);
 
     bool leaf_lookup(const char *key, Rid **value,  size_t col_num,FIND_TYPE findType=FIND_TYPE::COMMON);
@@ -110,12 +284,34 @@ class IxNodeHandle {
     // 用于在结点中的指定位置插入单个键值对
     void insert_pair(int pos, const char *key, const Rid &rid) { insert_pairs(pos, key, &rid, 1); }
 
-    void erase_pair(int pos);
+    void erase_pairs(int pos, int n);
+
+    void erase_pair(int pos) { erase_pairs(pos, 1); }
 
     int remove(const char *key);
 
+    /**
+     * @description: 结点映像的长度。映像依次为：是否只含页头(bool)、IxPageHdr，完整映像之后叶子结点是num_key个键和num_key个rid，
+     * 内部结点是num_key个槽和全部分隔键
+     */
+    int image_size(bool header_only) const {
+        int size = sizeof(bool) + sizeof(IxPageHdr);
+        if (header_only) {
+            return size;
+        }
+        if (!is_leaf_page()) {
+            return size + get_used_bytes();
+        }
+        return size + get_size() * (file_hdr->col_tot_len_ + static_cast<int>(sizeof(Rid)));
+    }
+
+    void serialize_image(char *dest, bool header_only) const;
+
+    void load_image(const char *src);
+
     void init(page_id_t parent_page_id = INVALID_PAGE_ID, page_id_t next_free_page_no = IX_NO_PAGE, bool is_leaf = false ) {
         page_hdr->num_key = 0;
+        page_hdr->key_bytes = 0;
         page_hdr->parent = parent_page_id;
         page_hdr->next_free_page_no = next_free_page_no;
         page_hdr->is_leaf = is_leaf;
@@ -141,7 +337,7 @@ class IxNodeHandle {
     int find_child(IxNodeHandle *child) {
         int rid_idx;
         for (rid_idx = 0; rid_idx < page_hdr->num_key; rid_idx++) {
-            if (get_rid(rid_idx)->page_no == child->get_page_no()) {
+            if (value_at(rid_idx) == child->get_page_no()) {
                 break;
             }
         }
@@ -150,7 +346,9 @@ class IxNodeHandle {
     }
 
 private:
+    void insert_slot(int pos, const char *key, int len, page_id_t child);
 
+    void compact_keys();
 };
 
 /* B+树 */
@@ -165,6 +363,8 @@ class IxIndexHandle {
     IxFileHdr* file_hdr_;                       // 存了root_page，但其初始化为2（第0页存FILE_HDR_PAGE，第1页存LEAF_HEADER_PAGE）
     // std::mutex root_latch_;
     RWLatch root_latch_;
+    LogManager *log_manager_;                   // 为空时不记录索引日志(如单元测试)
+    std::string index_name_;                    // 索引文件名，日志中据此找到索引
    public:
     IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd);
 
@@ -181,25 +381,35 @@ class IxIndexHandle {
 
     std::pair<IxNodeHandle *, bool> find_leaf_page(const char *key, Operation operation, Transaction *transaction,
                                                    size_t col_cnt,FIND_TYPE find_type,bool left_most, bool right_most);
+
+    IxNodeHandle *find_leaf_page_optimistic(const char *key);
     // for insert
-    page_id_t insert_entry(const char *key, const Rid &value, Transaction *transaction);
+    page_id_t insert_entry(const char *key, const Rid &value, Transaction *transaction,
+                           LogOperation log_op = LogOperation::REDO, lsn_t undo_next = INVALID_LSN);
 
-    IxNodeHandle *split(IxNodeHandle *node);
+    IxNodeHandle *split(IxNodeHandle *node, Transaction *transaction);
 
     void insert_into_parent(IxNodeHandle *old_node, const char *key, IxNodeHandle *new_node, Transaction *transaction);
 
     // for delete
-    bool delete_entry(const char *key, Transaction *transaction);
+    bool delete_entry(const char *key, Transaction *transaction,
+                      LogOperation log_op = LogOperation::REDO, lsn_t undo_next = INVALID_LSN);
 
     bool coalesce_or_redistribute(IxNodeHandle *node, Transaction *transaction = nullptr,
                                 bool *root_is_latched = nullptr);
-    bool adjust_root(IxNodeHandle *old_root_node);
+    bool adjust_root(IxNodeHandle *old_root_node, Transaction *transaction);
 
-    void redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index);
+    void redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index,
+                      Transaction *transaction);
 
     bool coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node, IxNodeHandle **parent, int index,
                   Transaction *transaction, bool *root_is_latched);
 
+    // for bulk load (见ix_bulk_load.cpp)
+    bool is_empty_tree();
+
+    void bulk_load(size_t num_entries, const IxEntrySource &next, double fill_factor = INDEX_BULK_LOAD_FILL_FACTOR);
+
     Iid lower_bound(const char *key);
     Iid lower_bound_cnt(const char *key, size_t cnt);
     Iid upper_bound(const char *key);
@@ -207,6 +417,17 @@ class IxIndexHandle {
     Iid leaf_end();
     Iid leaf_begin();
 
+    // for recovery
+    void insert_entry_recover(int page_no, const char *key, const Rid &rid, lsn_t lsn);
+
+    void delete_entry_recover(int page_no, const char *key, lsn_t lsn);
+
+    void smo_analyze(const IxSmoLogRecord &log);
+
+    void smo_recover(const IxSmoLogRecord &log, lsn_t lsn);
+
+    bool verify();
+
    private:
     // 辅助函数
     void update_root_page_no(page_id_t root) { file_hdr_->root_page_ = root; }
@@ -219,14 +440,25 @@ class IxIndexHandle {
     IxNodeHandle *create_node();
 
     // for maintain data structure
-    void maintain_parent(IxNodeHandle *node);
+    void update_separator(IxNodeHandle *parent, int rank, IxNodeHandle *left, IxNodeHandle *right,
+                          Transaction *transaction);
 
-    void erase_leaf(IxNodeHandle *leaf);
+    void erase_leaf(IxNodeHandle *leaf, Transaction *transaction);
 
     void release_node_handle(IxNodeHandle &node);
 
-    void maintain_child(IxNodeHandle *node, int child_idx);
+    void maintain_child(IxNodeHandle *node, int child_idx, Transaction *transaction);
     void release_ancestors(Transaction*transaction);
+
+    // for logging
+    bool is_logging(Transaction *transaction) const { return log_manager_ != nullptr && transaction != nullptr; }
+
+    void log_entry(LogType log_type, IxNodeHandle *leaf, const char *key, const Rid &rid, Transaction *transaction,
+                   lsn_t undo_next);
+
+    void smo_add_node(IxNodeHandle *node, Transaction *transaction, bool header_only = false);
+
+    void smo_log(LogType log_type, Transaction *transaction);
     // for index test
     Rid get_rid(const Iid &iid) const;
 };
\ No newline at end of file
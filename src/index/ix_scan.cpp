@@ -22,13 +22,18 @@ void IxScan::next() {
     assert(iid_.slot_no < node->get_size());
     // increment slot no
     iid_.slot_no++;
+    if (iid_.page_no != ih_->file_hdr_->last_leaf_ && iid_.slot_no == 1 && end_.page_no != iid_.page_no) {
+        // 刚进入一个叶子结点且扫描不在此结束，预读下一个叶子结点，与处理本结点的记录重叠
+        bpm_->prefetch_pages(ih_->fd_, node->get_next_leaf(), 1);
+    }
     if (iid_.page_no != ih_->file_hdr_->last_leaf_ && iid_.slot_no == node->get_size()) {
         // go to next leaf
         iid_.slot_no = 0;
-        node->page->RUnlock();
-        bpm_->unpin_page(node->get_page_id(), false);
         iid_.page_no = node->get_next_leaf();
     }
+    node->page->RUnlock();
+    bpm_->unpin_page(node->get_page_id(), false);
+    delete node;
 }
 
 Rid IxScan::rid() const {
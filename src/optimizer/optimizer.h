@@ -56,6 +56,9 @@ class Optimizer {
         } else if (auto x = std::dynamic_pointer_cast<ast::TxnRollback>(query->parse)) {
             // rollback;
             return std::make_shared<OtherPlan>(T_Transaction_rollback, std::string());
+        } else if (auto x = std::dynamic_pointer_cast<ast::LoadStmt>(query->parse)) {
+            // load 'file' into table;
+            return std::make_shared<LoadPlan>(x->file_name, x->tab_name);
         } else {
             return planner_->do_planner(query, context);
         }
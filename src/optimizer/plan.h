@@ -42,7 +42,8 @@ typedef enum PlanTag{
     T_IndexScan,
     T_NestLoop,
     T_Sort,
-    T_Projection
+    T_Projection,
+    T_Load
 } PlanTag;
 
 // 查询执行计划
@@ -192,6 +193,7 @@ class DDLPlan : public Plan
         std::string tab_name_;
         std::vector<std::string> tab_col_names_;
         std::vector<ColDef> cols_;
+        bool pax_{false};   // create table: 数据文件使用PAX页面
 };
 
 // help; show tables; desc tables; begin; abort; commit; rollback语句对应的plan
@@ -207,6 +209,21 @@ class OtherPlan : public Plan
         std::string tab_name_;
 };
 
+// load语句对应的plan
+class LoadPlan : public Plan
+{
+    public:
+        LoadPlan(std::string file_name, std::string tab_name)
+        {
+            Plan::tag = T_Load;
+            file_name_ = std::move(file_name);
+            tab_name_ = std::move(tab_name);
+        }
+        ~LoadPlan(){}
+        std::string file_name_;
+        std::string tab_name_;
+};
+
 class plannerInfo{
     public:
     std::shared_ptr<ast::SelectStmt> parse;
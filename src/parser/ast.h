@@ -19,7 +19,7 @@ enum JoinType {
 namespace ast {
 
 enum SvType {
-    SV_TYPE_INT, SV_TYPE_FLOAT, SV_TYPE_STRING, SV_TYPE_BIGINT, SV_TYPE_DATETIME
+    SV_TYPE_INT, SV_TYPE_FLOAT, SV_TYPE_STRING, SV_TYPE_BIGINT, SV_TYPE_DATETIME, SV_TYPE_VARCHAR
 };
 
 enum SvCompOp {
@@ -85,9 +85,10 @@ struct ColDef : public Field {
 struct CreateTable : public TreeNode {
     std::string tab_name;
     std::vector<std::shared_ptr<Field>> fields;
+    bool pax;   // USING PAX：数据文件按列存放
 
-    CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_) :
-            tab_name(std::move(tab_name_)), fields(std::move(fields_)) {}
+    CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_, bool pax_ = false) :
+            tab_name(std::move(tab_name_)), fields(std::move(fields_)), pax(pax_) {}
 };
 
 struct DropTable : public TreeNode {
@@ -208,10 +209,19 @@ struct OrderBy : public TreeNode
 
 struct InsertStmt : public TreeNode {
     std::string tab_name;
-    std::vector<std::shared_ptr<Value>> vals;
+    std::vector<std::vector<std::shared_ptr<Value>>> rows;   // 每个元素是VALUES中的一行
 
-    InsertStmt(std::string tab_name_, std::vector<std::shared_ptr<Value>> vals_) :
-            tab_name(std::move(tab_name_)), vals(std::move(vals_)) {}
+    InsertStmt(std::string tab_name_, std::vector<std::vector<std::shared_ptr<Value>>> rows_) :
+            tab_name(std::move(tab_name_)), rows(std::move(rows_)) {}
+};
+
+// load 'file_name' into tab_name; 把CSV文件导入表中，文件第一行是列名
+struct LoadStmt : public TreeNode {
+    std::string file_name;
+    std::string tab_name;
+
+    LoadStmt(std::string file_name_, std::string tab_name_) :
+            file_name(std::move(file_name_)), tab_name(std::move(tab_name_)) {}
 };
 
 struct DeleteStmt : public TreeNode {
@@ -303,6 +313,7 @@ struct SemValue {
 
     std::shared_ptr<Value> sv_val;
     std::vector<std::shared_ptr<Value>> sv_vals;
+    std::vector<std::vector<std::shared_ptr<Value>>> sv_rows;
 
     std::shared_ptr<Col> sv_col;
     std::vector<std::shared_ptr<Col>> sv_cols;
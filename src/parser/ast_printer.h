@@ -48,6 +48,7 @@ private:
                 {SV_TYPE_STRING, "STRING"},
                 {SV_TYPE_BIGINT,"BIGINT"},
                 {SV_TYPE_DATETIME,"DATETIME"},
+                {SV_TYPE_VARCHAR,"VARCHAR"},
         };
         return m.at(type);
     }
@@ -107,6 +108,9 @@ private:
             std::cout << "CREATE_TABLE\n";
             print_val(x->tab_name, offset);
             print_node_list(x->fields, offset);
+            if (x->pax) {
+                print_val("USING PAX", offset);
+            }
         } else if (auto x = std::dynamic_pointer_cast<DropTable>(node)) {
             std::cout << "DROP_TABLE\n";
             print_val(x->tab_name, offset);
@@ -170,7 +174,13 @@ private:
         } else if (auto x = std::dynamic_pointer_cast<InsertStmt>(node)) {
             std::cout << "INSERT\n";
             print_val(x->tab_name, offset);
-            print_node_list(x->vals, offset);
+            for (auto &row : x->rows) {
+                print_node_list(row, offset);
+            }
+        } else if (auto x = std::dynamic_pointer_cast<LoadStmt>(node)) {
+            std::cout << "LOAD\n";
+            print_val(x->file_name, offset);
+            print_val(x->tab_name, offset);
         } else if (auto x = std::dynamic_pointer_cast<DeleteStmt>(node)) {
             std::cout << "DELETE\n";
             print_val(x->tab_name, offset);
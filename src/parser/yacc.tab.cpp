@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -34,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -41,14 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
-
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.5.1"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -66,10 +67,11 @@
 
 
 /* First part of user prologue.  */
-#line 1 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+#line 1 "/root/repo/src/parser/yacc.y"
 
 #include "ast.h"
 #include "yacc.tab.h"
+#include <strings.h>
 #include <iostream>
 #include <memory>
 
@@ -81,7 +83,7 @@ void yyerror(YYLTYPE *locp, const char* s) {
 
 using namespace ast;
 
-#line 85 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 87 "/root/repo/src/parser/yacc.tab.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -104,104 +106,111 @@ using namespace ast;
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 1
-#endif
-
-/* Use api.header.include to #include this header
-   instead of duplicating it here.  */
-#ifndef YY_YY_TMP_TMP_XSXJMU6B7R_SRC_PARSER_YACC_TAB_H_INCLUDED
-# define YY_YY_TMP_TMP_XSXJMU6B7R_SRC_PARSER_YACC_TAB_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    SHOW = 258,
-    TABLES = 259,
-    CREATE = 260,
-    TABLE = 261,
-    DROP = 262,
-    DESC = 263,
-    INSERT = 264,
-    INTO = 265,
-    VALUES = 266,
-    DELETE = 267,
-    FROM = 268,
-    ASC = 269,
-    ORDER = 270,
-    BY = 271,
-    WHERE = 272,
-    UPDATE = 273,
-    SET = 274,
-    SELECT = 275,
-    INT = 276,
-    CHAR = 277,
-    FLOAT = 278,
-    BIGINT = 279,
-    DATETIME = 280,
-    INDEX = 281,
-    AND = 282,
-    JOIN = 283,
-    EXIT = 284,
-    HELP = 285,
-    TXN_BEGIN = 286,
-    TXN_COMMIT = 287,
-    TXN_ABORT = 288,
-    TXN_ROLLBACK = 289,
-    ORDER_BY = 290,
-    COUNT = 291,
-    MAX = 292,
-    MIN = 293,
-    SUM = 294,
-    AS = 295,
-    LIMIT = 296,
-    LEQ = 297,
-    NEQ = 298,
-    GEQ = 299,
-    T_EOF = 300,
-    IDENTIFIER = 301,
-    VALUE_STRING = 302,
-    VALUE_INT = 303,
-    VALUE_FLOAT = 304,
-    VALUE_BIGINT = 305,
-    VALUE_DATETIME = 306
-  };
-#endif
-
-/* Value type.  */
-
-/* Location type.  */
-#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE YYLTYPE;
-struct YYLTYPE
+#include "yacc.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-  int first_line;
-  int first_column;
-  int last_line;
-  int last_column;
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_SHOW = 3,                       /* SHOW  */
+  YYSYMBOL_TABLES = 4,                     /* TABLES  */
+  YYSYMBOL_CREATE = 5,                     /* CREATE  */
+  YYSYMBOL_TABLE = 6,                      /* TABLE  */
+  YYSYMBOL_DROP = 7,                       /* DROP  */
+  YYSYMBOL_DESC = 8,                       /* DESC  */
+  YYSYMBOL_INSERT = 9,                     /* INSERT  */
+  YYSYMBOL_INTO = 10,                      /* INTO  */
+  YYSYMBOL_VALUES = 11,                    /* VALUES  */
+  YYSYMBOL_DELETE = 12,                    /* DELETE  */
+  YYSYMBOL_FROM = 13,                      /* FROM  */
+  YYSYMBOL_ASC = 14,                       /* ASC  */
+  YYSYMBOL_ORDER = 15,                     /* ORDER  */
+  YYSYMBOL_BY = 16,                        /* BY  */
+  YYSYMBOL_WHERE = 17,                     /* WHERE  */
+  YYSYMBOL_UPDATE = 18,                    /* UPDATE  */
+  YYSYMBOL_SET = 19,                       /* SET  */
+  YYSYMBOL_SELECT = 20,                    /* SELECT  */
+  YYSYMBOL_INT = 21,                       /* INT  */
+  YYSYMBOL_CHAR = 22,                      /* CHAR  */
+  YYSYMBOL_FLOAT = 23,                     /* FLOAT  */
+  YYSYMBOL_BIGINT = 24,                    /* BIGINT  */
+  YYSYMBOL_DATETIME = 25,                  /* DATETIME  */
+  YYSYMBOL_INDEX = 26,                     /* INDEX  */
+  YYSYMBOL_AND = 27,                       /* AND  */
+  YYSYMBOL_JOIN = 28,                      /* JOIN  */
+  YYSYMBOL_EXIT = 29,                      /* EXIT  */
+  YYSYMBOL_HELP = 30,                      /* HELP  */
+  YYSYMBOL_TXN_BEGIN = 31,                 /* TXN_BEGIN  */
+  YYSYMBOL_TXN_COMMIT = 32,                /* TXN_COMMIT  */
+  YYSYMBOL_TXN_ABORT = 33,                 /* TXN_ABORT  */
+  YYSYMBOL_TXN_ROLLBACK = 34,              /* TXN_ROLLBACK  */
+  YYSYMBOL_ORDER_BY = 35,                  /* ORDER_BY  */
+  YYSYMBOL_COUNT = 36,                     /* COUNT  */
+  YYSYMBOL_MAX = 37,                       /* MAX  */
+  YYSYMBOL_MIN = 38,                       /* MIN  */
+  YYSYMBOL_SUM = 39,                       /* SUM  */
+  YYSYMBOL_AS = 40,                        /* AS  */
+  YYSYMBOL_LIMIT = 41,                     /* LIMIT  */
+  YYSYMBOL_LEQ = 42,                       /* LEQ  */
+  YYSYMBOL_NEQ = 43,                       /* NEQ  */
+  YYSYMBOL_GEQ = 44,                       /* GEQ  */
+  YYSYMBOL_T_EOF = 45,                     /* T_EOF  */
+  YYSYMBOL_IDENTIFIER = 46,                /* IDENTIFIER  */
+  YYSYMBOL_VALUE_STRING = 47,              /* VALUE_STRING  */
+  YYSYMBOL_VALUE_INT = 48,                 /* VALUE_INT  */
+  YYSYMBOL_VALUE_FLOAT = 49,               /* VALUE_FLOAT  */
+  YYSYMBOL_VALUE_BIGINT = 50,              /* VALUE_BIGINT  */
+  YYSYMBOL_VALUE_DATETIME = 51,            /* VALUE_DATETIME  */
+  YYSYMBOL_52_ = 52,                       /* ';'  */
+  YYSYMBOL_53_ = 53,                       /* '('  */
+  YYSYMBOL_54_ = 54,                       /* ')'  */
+  YYSYMBOL_55_ = 55,                       /* ','  */
+  YYSYMBOL_56_ = 56,                       /* '.'  */
+  YYSYMBOL_57_ = 57,                       /* '='  */
+  YYSYMBOL_58_ = 58,                       /* '<'  */
+  YYSYMBOL_59_ = 59,                       /* '>'  */
+  YYSYMBOL_60_ = 60,                       /* '*'  */
+  YYSYMBOL_YYACCEPT = 61,                  /* $accept  */
+  YYSYMBOL_start = 62,                     /* start  */
+  YYSYMBOL_stmt = 63,                      /* stmt  */
+  YYSYMBOL_txnStmt = 64,                   /* txnStmt  */
+  YYSYMBOL_dbStmt = 65,                    /* dbStmt  */
+  YYSYMBOL_ddl = 66,                       /* ddl  */
+  YYSYMBOL_dml = 67,                       /* dml  */
+  YYSYMBOL_fieldList = 68,                 /* fieldList  */
+  YYSYMBOL_colNameList = 69,               /* colNameList  */
+  YYSYMBOL_field = 70,                     /* field  */
+  YYSYMBOL_type = 71,                      /* type  */
+  YYSYMBOL_valueRows = 72,                 /* valueRows  */
+  YYSYMBOL_valueList = 73,                 /* valueList  */
+  YYSYMBOL_value = 74,                     /* value  */
+  YYSYMBOL_condition = 75,                 /* condition  */
+  YYSYMBOL_optWhereClause = 76,            /* optWhereClause  */
+  YYSYMBOL_whereClause = 77,               /* whereClause  */
+  YYSYMBOL_col = 78,                       /* col  */
+  YYSYMBOL_colList = 79,                   /* colList  */
+  YYSYMBOL_op = 80,                        /* op  */
+  YYSYMBOL_expr = 81,                      /* expr  */
+  YYSYMBOL_setClauses = 82,                /* setClauses  */
+  YYSYMBOL_setClause = 83,                 /* setClause  */
+  YYSYMBOL_selector = 84,                  /* selector  */
+  YYSYMBOL_aggregator = 85,                /* aggregator  */
+  YYSYMBOL_aggre_sum = 86,                 /* aggre_sum  */
+  YYSYMBOL_aggre_max = 87,                 /* aggre_max  */
+  YYSYMBOL_aggre_min = 88,                 /* aggre_min  */
+  YYSYMBOL_aggre_count = 89,               /* aggre_count  */
+  YYSYMBOL_tableList = 90,                 /* tableList  */
+  YYSYMBOL_opt_order_clause = 91,          /* opt_order_clause  */
+  YYSYMBOL_order_clauses = 92,             /* order_clauses  */
+  YYSYMBOL_order_clause = 93,              /* order_clause  */
+  YYSYMBOL_opt_asc_desc = 94,              /* opt_asc_desc  */
+  YYSYMBOL_tbName = 95,                    /* tbName  */
+  YYSYMBOL_colName = 96                    /* colName  */
 };
-# define YYLTYPE_IS_DECLARED 1
-# define YYLTYPE_IS_TRIVIAL 1
-#endif
-
-
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-int yyparse (void);
-
-#endif /* !YY_YY_TMP_TMP_XSXJMU6B7R_SRC_PARSER_YACC_TAB_H_INCLUDED  */
 
 
 
@@ -242,6 +251,18 @@ typedef int_least16_t yytype_int16;
 typedef short yytype_int16;
 #endif
 
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
 #if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST8_TYPE__ yytype_uint8;
 #elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
@@ -301,6 +322,7 @@ typedef int yytype_uint16;
 
 #define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
 
+
 /* Stored state numbers (used for stacks). */
 typedef yytype_uint8 yy_state_t;
 
@@ -319,6 +341,7 @@ typedef int yy_state_fast_t;
 # endif
 #endif
 
+
 #ifndef YY_ATTRIBUTE_PURE
 # if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
 #  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
@@ -337,17 +360,23 @@ typedef int yy_state_fast_t;
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && ! defined __ICC && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                            \
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
     _Pragma ("GCC diagnostic push")                                     \
     _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
 # define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
@@ -376,7 +405,7 @@ typedef int yy_state_fast_t;
 
 #define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if 1
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -441,8 +470,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* 1 */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -508,27 +536,29 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  49
+#define YYFINAL  51
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   164
+#define YYLAST   179
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  61
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  35
+#define YYNNTS  36
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  87
+#define YYNRULES  92
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  175
+#define YYNSTATES  190
 
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   306
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex, with out-of-bounds checking.  */
-#define YYTRANSLATE(YYX)                                                \
-  (0 <= (YYX) && (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex.  */
@@ -568,242 +598,249 @@ static const yytype_int8 yytranslate[] =
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,    62,    62,    67,    72,    77,    85,    86,    87,    88,
-      92,    96,   100,   104,   111,   115,   122,   126,   130,   134,
-     138,   145,   149,   153,   157,   161,   168,   172,   179,   183,
-     190,   197,   201,   205,   209,   213,   220,   224,   231,   235,
-     239,   243,   247,   254,   261,   262,   269,   273,   280,   284,
-     291,   295,   302,   306,   310,   314,   318,   322,   329,   333,
-     340,   344,   351,   358,   362,   366,   370,   374,   378,   382,
-     389,   396,   403,   410,   417,   421,   425,   432,   436,   440,
-     444,   448,   455,   462,   463,   464,   467,   469
+       0,    64,    64,    69,    74,    79,    87,    88,    89,    90,
+      94,    98,   102,   106,   113,   117,   124,   128,   142,   146,
+     150,   154,   161,   165,   174,   178,   182,   186,   193,   197,
+     204,   208,   215,   222,   226,   230,   234,   238,   242,   254,
+     258,   265,   269,   276,   280,   284,   288,   292,   299,   306,
+     307,   314,   318,   325,   329,   336,   340,   347,   351,   355,
+     359,   363,   367,   374,   378,   385,   389,   396,   403,   407,
+     411,   415,   419,   423,   427,   434,   441,   448,   455,   462,
+     466,   470,   477,   481,   485,   489,   493,   500,   507,   508,
+     509,   512,   514
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 1
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "SHOW", "TABLES", "CREATE", "TABLE",
-  "DROP", "DESC", "INSERT", "INTO", "VALUES", "DELETE", "FROM", "ASC",
-  "ORDER", "BY", "WHERE", "UPDATE", "SET", "SELECT", "INT", "CHAR",
-  "FLOAT", "BIGINT", "DATETIME", "INDEX", "AND", "JOIN", "EXIT", "HELP",
-  "TXN_BEGIN", "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK", "ORDER_BY",
-  "COUNT", "MAX", "MIN", "SUM", "AS", "LIMIT", "LEQ", "NEQ", "GEQ",
-  "T_EOF", "IDENTIFIER", "VALUE_STRING", "VALUE_INT", "VALUE_FLOAT",
+  "\"end of file\"", "error", "\"invalid token\"", "SHOW", "TABLES",
+  "CREATE", "TABLE", "DROP", "DESC", "INSERT", "INTO", "VALUES", "DELETE",
+  "FROM", "ASC", "ORDER", "BY", "WHERE", "UPDATE", "SET", "SELECT", "INT",
+  "CHAR", "FLOAT", "BIGINT", "DATETIME", "INDEX", "AND", "JOIN", "EXIT",
+  "HELP", "TXN_BEGIN", "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK",
+  "ORDER_BY", "COUNT", "MAX", "MIN", "SUM", "AS", "LIMIT", "LEQ", "NEQ",
+  "GEQ", "T_EOF", "IDENTIFIER", "VALUE_STRING", "VALUE_INT", "VALUE_FLOAT",
   "VALUE_BIGINT", "VALUE_DATETIME", "';'", "'('", "')'", "','", "'.'",
   "'='", "'<'", "'>'", "'*'", "$accept", "start", "stmt", "txnStmt",
   "dbStmt", "ddl", "dml", "fieldList", "colNameList", "field", "type",
-  "valueList", "value", "condition", "optWhereClause", "whereClause",
-  "col", "colList", "op", "expr", "setClauses", "setClause", "selector",
-  "aggregator", "aggre_sum", "aggre_max", "aggre_min", "aggre_count",
-  "tableList", "opt_order_clause", "order_clauses", "order_clause",
-  "opt_asc_desc", "tbName", "colName", YY_NULLPTR
+  "valueRows", "valueList", "value", "condition", "optWhereClause",
+  "whereClause", "col", "colList", "op", "expr", "setClauses", "setClause",
+  "selector", "aggregator", "aggre_sum", "aggre_max", "aggre_min",
+  "aggre_count", "tableList", "opt_order_clause", "order_clauses",
+  "order_clause", "opt_asc_desc", "tbName", "colName", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_int16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,    59,    40,    41,    44,    46,    61,    60,    62,
-      42
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF (-98)
+#define YYPACT_NINF (-89)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-87)
+#define YYTABLE_NINF (-92)
 
 #define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-      62,    11,    14,    19,   -20,    24,    31,   -20,    -7,   -98,
-     -98,   -98,   -98,   -98,   -98,   -98,    46,     0,   -98,   -98,
-     -98,   -98,   -98,    34,   -20,   -20,   -20,   -20,   -98,   -98,
-     -20,   -20,    37,   -98,   -98,   -98,   -98,     3,   -98,   -98,
-       9,    53,    55,    20,    25,    28,    44,    16,   -98,   -98,
-     -98,   -20,    72,    73,   -98,    75,    95,   103,    38,    83,
-     -20,   -20,    38,    38,    38,   -27,    38,   -98,    38,    38,
-      38,    77,    83,   -98,   -98,    -6,   -98,    74,   -98,   -12,
-     -98,   103,    78,    79,    80,    81,    82,   -98,   -37,   -98,
-      87,    64,   -98,    67,    66,   -98,   110,    18,    38,   -98,
-      66,   -20,   -20,   123,   -98,    99,   100,   101,   102,   104,
-     -98,    38,   -98,    90,   -98,   -98,   -98,   -98,   -98,    38,
-     -98,   -98,   -98,   -98,   -98,   -98,    69,   -98,    83,   -98,
-     -98,   -98,   -98,   -98,   -98,    54,   -98,   -98,   -98,   -98,
-     129,   -98,    38,    38,    38,    38,    38,   -98,    98,   -98,
-     -98,    66,   -98,   -98,   -98,   -98,    83,   -98,   -98,   -98,
-     -98,   -98,    93,   -98,    27,    -5,   -98,   -98,   -98,   -98,
-     -98,   105,    83,   -98,   -98
+      68,    16,    20,    30,   -35,    17,     6,   -35,     1,   -89,
+     -89,   -89,   -89,   -89,   -89,   -89,     2,    44,    -1,   -89,
+     -89,   -89,   -89,   -89,    39,   -35,   -35,   -35,   -35,   -89,
+     -89,   -35,   -35,    38,   -89,   -89,   -89,   -89,    18,   -89,
+     -89,     8,    83,    95,    28,    29,    34,    57,    56,   -89,
+     118,   -89,   -89,   -35,    76,    77,   -89,    78,   121,   116,
+      89,    90,   -35,   -35,    89,    89,    89,   -25,    89,   -35,
+     -89,    89,    89,    89,    84,    90,   -89,   -89,   -14,   -89,
+      81,   -89,   -12,   -89,   116,    85,    86,    87,    88,    91,
+     -89,   -89,    10,   -89,     9,    24,   -89,    35,    74,    92,
+     -89,   117,    26,    89,   -89,    74,   -35,   -35,   128,   -89,
+     106,   108,   109,   110,   111,   107,    89,   -89,    99,   -89,
+     -89,   -89,   101,   -89,   -89,    89,   -89,   -89,   -89,   -89,
+     -89,   -89,    52,   -89,   102,    90,   -89,   -89,   -89,   -89,
+     -89,   -89,    69,   -89,   -89,   -89,   -89,   140,   -89,    89,
+      89,    89,    89,    89,   113,   -89,   112,   114,   -89,   -89,
+      74,    74,   -89,   -89,   -89,   -89,    90,   -89,   -89,   -89,
+     -89,   -89,   -89,   103,   115,   -89,    72,     4,     7,   -89,
+     -89,   -89,   -89,   -89,   -89,   -89,   119,    90,   -89,   -89
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
        0,     0,     0,     0,     0,     0,     0,     0,     0,     4,
-       3,    10,    11,    12,    13,     5,     0,     0,     9,     6,
-       7,     8,    14,     0,     0,     0,     0,     0,    86,    18,
-       0,     0,     0,    73,    71,    72,    70,    87,    63,    50,
-      64,     0,     0,     0,     0,     0,     0,     0,    49,     1,
-       2,     0,     0,     0,    17,     0,     0,    44,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,    15,     0,     0,
-       0,     0,     0,    22,    87,    44,    60,     0,    51,    44,
-      74,    44,     0,     0,     0,     0,     0,    48,     0,    26,
-       0,     0,    28,     0,     0,    46,    45,     0,     0,    23,
-       0,     0,     0,    79,    25,     0,     0,     0,     0,     0,
-      16,     0,    31,     0,    33,    34,    35,    30,    19,     0,
-      20,    40,    38,    39,    41,    42,     0,    36,     0,    56,
-      55,    57,    52,    53,    54,     0,    61,    62,    76,    75,
-       0,    24,     0,     0,     0,     0,     0,    27,     0,    29,
-      21,     0,    47,    58,    59,    43,     0,    65,    66,    67,
-      68,    69,     0,    37,    85,    77,    80,    32,    84,    83,
-      82,     0,     0,    78,    81
+       3,    10,    11,    12,    13,     5,     0,     0,     0,     9,
+       6,     7,     8,    14,     0,     0,     0,     0,     0,    91,
+      19,     0,     0,     0,    78,    76,    77,    75,    92,    68,
+      55,    69,     0,     0,     0,     0,     0,     0,     0,    54,
+       0,     1,     2,     0,     0,     0,    18,     0,     0,    49,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+      15,     0,     0,     0,     0,     0,    24,    92,    49,    65,
+       0,    56,    49,    79,    49,     0,     0,     0,     0,     0,
+      53,    23,     0,    28,     0,     0,    30,     0,     0,    22,
+      51,    50,     0,     0,    25,     0,     0,     0,    84,    27,
+       0,     0,     0,     0,     0,    16,     0,    33,     0,    35,
+      36,    37,     0,    32,    20,     0,    21,    45,    43,    44,
+      46,    47,     0,    41,     0,     0,    61,    60,    62,    57,
+      58,    59,     0,    66,    67,    81,    80,     0,    26,     0,
+       0,     0,     0,     0,     0,    29,     0,     0,    31,    39,
+       0,     0,    52,    63,    64,    48,     0,    70,    71,    72,
+      73,    74,    17,     0,     0,    42,     0,    90,    82,    85,
+      34,    38,    40,    89,    88,    87,     0,     0,    83,    86
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
-     -98,   -98,   -98,   -98,   -98,   -98,   -98,   -98,    84,    39,
-     -98,   -98,   -97,    21,     4,   -98,    -8,   -98,   -98,   -98,
-     -98,    57,   -98,   -98,   -98,   -98,   -98,   -98,   -98,   -98,
-     -98,   -21,   -98,    -3,   -56
+     -89,   -89,   -89,   -89,   -89,   -89,   -89,   -89,    93,    45,
+     -89,   -89,     3,   -88,    33,    27,   -89,    -8,   -89,   -89,
+     -89,   -89,    60,   -89,   -89,   -89,   -89,   -89,   -89,   -89,
+     -89,   -89,   -22,   -89,    -3,   -58
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int16 yydefgoto[] =
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
 {
-      -1,    16,    17,    18,    19,    20,    21,    88,    91,    89,
-     117,   126,   127,    95,    73,    96,    97,    40,   135,   155,
-      75,    76,    41,    42,    43,    44,    45,    46,    79,   141,
-     165,   166,   170,    47,    48
+       0,    17,    18,    19,    20,    21,    22,    92,    95,    93,
+     123,    99,   132,   133,   100,    76,   101,   102,    41,   142,
+     165,    78,    79,    42,    43,    44,    45,    46,    47,    82,
+     148,   178,   179,   185,    48,    49
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      39,    29,    77,   137,    32,    72,    82,    83,    84,    86,
-      87,    72,    90,    92,    92,    22,   101,   110,   111,    74,
-      24,    52,    53,    54,    55,    26,    28,    56,    57,    33,
-      34,    35,    36,    85,    30,   168,   171,    23,   153,    37,
-      25,   169,    77,   102,    31,    27,    49,    51,    67,    98,
-     172,    78,    50,    38,   163,    90,    58,    80,    81,   -86,
-     129,   130,   131,   149,    59,     1,    60,     2,    61,     3,
-       4,     5,    66,    62,     6,   132,   133,   134,    63,    99,
-       7,    64,     8,   103,    74,   104,   157,   158,   159,   160,
-     161,     9,    10,    11,    12,    13,    14,    65,   138,   139,
-      37,   121,   122,   123,   124,   125,    71,    15,   112,   113,
-     114,   115,   116,   121,   122,   123,   124,   125,   118,   119,
-      72,   120,   119,   150,   151,    68,    69,   154,    70,    37,
-      94,   100,   105,   106,   107,   108,   109,   128,   140,   142,
-     143,   144,   145,   148,   146,   156,   162,   167,   164,   152,
-     147,   174,     0,   173,    93,   136,     0,     0,     0,     0,
-       0,     0,     0,     0,   164
+      40,    30,    80,    75,    33,    75,    85,    86,    87,    89,
+      90,    29,   183,    94,    96,    96,   106,   144,   184,    32,
+      23,    77,    54,    55,    56,    57,    25,    31,    58,    59,
+     117,   118,   119,   120,   121,    88,    27,    34,    35,    36,
+      37,   103,    24,   107,    51,    80,    26,    38,   186,    50,
+      70,    52,    53,    81,   163,   122,    28,    60,    94,    83,
+      84,    39,   187,    61,   115,   116,    91,   158,   136,   137,
+     138,     1,   175,     2,   -91,     3,     4,     5,   124,   125,
+       6,    64,    65,   139,   140,   141,     7,    66,     8,   126,
+     125,   167,   168,   169,   170,   171,    62,     9,    10,    11,
+      12,    13,    14,   145,   146,   104,   159,   160,    63,   108,
+      67,   109,    68,    15,    16,    38,   127,   128,   129,   130,
+     131,   127,   128,   129,   130,   131,   182,   160,    69,    71,
+      72,    73,    74,    75,   164,    77,    38,    98,   105,   110,
+     111,   112,   113,   147,   135,   114,   149,   134,   150,   151,
+     152,   153,   156,   154,   157,   161,   166,   180,   177,   172,
+     173,   155,   174,   143,   176,   189,    97,   188,   162,   181,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,   177
 };
 
 static const yytype_int16 yycheck[] =
 {
-       8,     4,    58,   100,     7,    17,    62,    63,    64,    65,
-      66,    17,    68,    69,    70,     4,    28,    54,    55,    46,
-       6,    24,    25,    26,    27,     6,    46,    30,    31,    36,
-      37,    38,    39,    60,    10,     8,    41,    26,   135,    46,
-      26,    14,    98,    55,    13,    26,     0,    13,    51,    55,
-      55,    59,    52,    60,   151,   111,    19,    60,    61,    56,
-      42,    43,    44,   119,    55,     3,    13,     5,    13,     7,
-       8,     9,    56,    53,    12,    57,    58,    59,    53,    75,
-      18,    53,    20,    79,    46,    81,   142,   143,   144,   145,
-     146,    29,    30,    31,    32,    33,    34,    53,   101,   102,
-      46,    47,    48,    49,    50,    51,    11,    45,    21,    22,
-      23,    24,    25,    47,    48,    49,    50,    51,    54,    55,
-      17,    54,    55,    54,    55,    53,    53,   135,    53,    46,
-      53,    57,    54,    54,    54,    54,    54,    27,    15,    40,
-      40,    40,    40,    53,    40,    16,    48,    54,   156,   128,
-     111,   172,    -1,    48,    70,    98,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,   172
+       8,     4,    60,    17,     7,    17,    64,    65,    66,    67,
+      68,    46,     8,    71,    72,    73,    28,   105,    14,    13,
+       4,    46,    25,    26,    27,    28,     6,    10,    31,    32,
+      21,    22,    23,    24,    25,    60,     6,    36,    37,    38,
+      39,    55,    26,    55,     0,   103,    26,    46,    41,    47,
+      53,    52,    13,    61,   142,    46,    26,    19,   116,    62,
+      63,    60,    55,    55,    54,    55,    69,   125,    42,    43,
+      44,     3,   160,     5,    56,     7,     8,     9,    54,    55,
+      12,    53,    53,    57,    58,    59,    18,    53,    20,    54,
+      55,   149,   150,   151,   152,   153,    13,    29,    30,    31,
+      32,    33,    34,   106,   107,    78,    54,    55,    13,    82,
+      53,    84,    56,    45,    46,    46,    47,    48,    49,    50,
+      51,    47,    48,    49,    50,    51,    54,    55,    10,    53,
+      53,    53,    11,    17,   142,    46,    46,    53,    57,    54,
+      54,    54,    54,    15,    27,    54,    40,    55,    40,    40,
+      40,    40,    53,    46,    53,    53,    16,    54,   166,    46,
+      48,   116,    48,   103,   161,   187,    73,    48,   135,    54,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,   187
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
        0,     3,     5,     7,     8,     9,    12,    18,    20,    29,
-      30,    31,    32,    33,    34,    45,    62,    63,    64,    65,
-      66,    67,     4,    26,     6,    26,     6,    26,    46,    94,
-      10,    13,    94,    36,    37,    38,    39,    46,    60,    77,
-      78,    83,    84,    85,    86,    87,    88,    94,    95,     0,
-      52,    13,    94,    94,    94,    94,    94,    94,    19,    55,
-      13,    13,    53,    53,    53,    53,    56,    94,    53,    53,
-      53,    11,    17,    75,    46,    81,    82,    95,    77,    89,
-      94,    94,    95,    95,    95,    60,    95,    95,    68,    70,
-      95,    69,    95,    69,    53,    74,    76,    77,    55,    75,
-      57,    28,    55,    75,    75,    54,    54,    54,    54,    54,
-      54,    55,    21,    22,    23,    24,    25,    71,    54,    55,
-      54,    47,    48,    49,    50,    51,    72,    73,    27,    42,
-      43,    44,    57,    58,    59,    79,    82,    73,    94,    94,
-      15,    90,    40,    40,    40,    40,    40,    70,    53,    95,
-      54,    55,    74,    73,    77,    80,    16,    95,    95,    95,
-      95,    95,    48,    73,    77,    91,    92,    54,     8,    14,
-      93,    41,    55,    48,    92
+      30,    31,    32,    33,    34,    45,    46,    62,    63,    64,
+      65,    66,    67,     4,    26,     6,    26,     6,    26,    46,
+      95,    10,    13,    95,    36,    37,    38,    39,    46,    60,
+      78,    79,    84,    85,    86,    87,    88,    89,    95,    96,
+      47,     0,    52,    13,    95,    95,    95,    95,    95,    95,
+      19,    55,    13,    13,    53,    53,    53,    53,    56,    10,
+      95,    53,    53,    53,    11,    17,    76,    46,    82,    83,
+      96,    78,    90,    95,    95,    96,    96,    96,    60,    96,
+      96,    95,    68,    70,    96,    69,    96,    69,    53,    72,
+      75,    77,    78,    55,    76,    57,    28,    55,    76,    76,
+      54,    54,    54,    54,    54,    54,    55,    21,    22,    23,
+      24,    25,    46,    71,    54,    55,    54,    47,    48,    49,
+      50,    51,    73,    74,    55,    27,    42,    43,    44,    57,
+      58,    59,    80,    83,    74,    95,    95,    15,    91,    40,
+      40,    40,    40,    40,    46,    70,    53,    53,    96,    54,
+      55,    53,    75,    74,    78,    81,    16,    96,    96,    96,
+      96,    96,    46,    48,    48,    74,    73,    78,    92,    93,
+      54,    54,    54,     8,    14,    94,    41,    55,    48,    93
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
        0,    61,    62,    62,    62,    62,    63,    63,    63,    63,
       64,    64,    64,    64,    65,    65,    66,    66,    66,    66,
-      66,    67,    67,    67,    67,    67,    68,    68,    69,    69,
-      70,    71,    71,    71,    71,    71,    72,    72,    73,    73,
-      73,    73,    73,    74,    75,    75,    76,    76,    77,    77,
-      78,    78,    79,    79,    79,    79,    79,    79,    80,    80,
-      81,    81,    82,    83,    83,    84,    84,    84,    84,    84,
-      85,    86,    87,    88,    89,    89,    89,    90,    90,    90,
-      91,    91,    92,    93,    93,    93,    94,    95
+      66,    66,    67,    67,    67,    67,    67,    67,    68,    68,
+      69,    69,    70,    71,    71,    71,    71,    71,    71,    72,
+      72,    73,    73,    74,    74,    74,    74,    74,    75,    76,
+      76,    77,    77,    78,    78,    79,    79,    80,    80,    80,
+      80,    80,    80,    81,    81,    82,    82,    83,    84,    84,
+      85,    85,    85,    85,    85,    86,    87,    88,    89,    90,
+      90,    90,    91,    91,    91,    92,    92,    93,    94,    94,
+      94,    95,    96
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     2,     4,     6,     3,     2,     6,
-       6,     7,     4,     5,     6,     5,     1,     3,     1,     3,
-       2,     1,     4,     1,     1,     1,     1,     3,     1,     1,
-       1,     1,     1,     3,     0,     2,     1,     3,     3,     1,
-       1,     3,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     3,     3,     1,     1,     6,     6,     6,     6,     6,
-       1,     1,     1,     1,     1,     3,     3,     3,     5,     0,
-       1,     3,     2,     1,     1,     0,     1,     1
+       1,     1,     1,     1,     2,     4,     6,     8,     3,     2,
+       6,     6,     5,     4,     4,     5,     6,     5,     1,     3,
+       1,     3,     2,     1,     4,     1,     1,     1,     4,     3,
+       5,     1,     3,     1,     1,     1,     1,     1,     3,     0,
+       2,     1,     3,     3,     1,     1,     3,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     3,     3,     1,     1,
+       6,     6,     6,     6,     6,     1,     1,     1,     1,     1,
+       3,     3,     3,     5,     0,     1,     3,     2,     1,     1,
+       0,     1,     1
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
@@ -825,10 +862,9 @@ static const yytype_int8 yyr2[] =
       }                                                           \
   while (0)
 
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
@@ -872,12 +908,19 @@ do {                                            \
 } while (0)
 
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
+/* YYLOCATION_PRINT -- Print the location on the stream.
    This macro was not mandated originally: define only if we know
    we won't break user code: when these are the locations we know.  */
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
 
 /* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
 
@@ -905,24 +948,32 @@ yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
         res += YYFPRINTF (yyo, "-%d", end_col);
     }
   return res;
- }
+}
 
-#  define YY_LOCATION_PRINT(File, Loc)          \
-  yy_location_print_ (File, &(Loc))
+#   define YYLOCATION_PRINT  yy_location_print_
 
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value, Location); \
+                  Kind, Value, Location); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -933,19 +984,16 @@ do {                                                                      \
 `-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
 {
   FILE *yyoutput = yyo;
-  YYUSE (yyoutput);
-  YYUSE (yylocationp);
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyo, yytoknum[yytype], *yyvaluep);
-# endif
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -955,14 +1003,15 @@ yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YY
 `---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
 {
   YYFPRINTF (yyo, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  YY_LOCATION_PRINT (yyo, *yylocationp);
+  YYLOCATION_PRINT (yyo, yylocationp);
   YYFPRINTF (yyo, ": ");
-  yy_symbol_value_print (yyo, yytype, yyvaluep, yylocationp);
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp);
   YYFPRINTF (yyo, ")");
 }
 
@@ -995,7 +1044,8 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -1007,9 +1057,9 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[+yyssp[yyi + 1 - yynrhs]],
-                       &yyvsp[(yyi + 1) - (yynrhs)]
-                       , &(yylsp[(yyi + 1) - (yynrhs)])                       );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]));
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1024,8 +1074,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -1048,12 +1098,61 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
-#  else
+
+
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
 static YYPTRDIFF_T
 yystrlen (const char *yystr)
@@ -1063,13 +1162,13 @@ yystrlen (const char *yystr)
     continue;
   return yylen;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
 static char *
@@ -1083,10 +1182,10 @@ yystpcpy (char *yydest, const char *yysrc)
 
   return yyd - 1;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yytnamerr
+#ifndef yytnamerr
 /* Copy to YYRES the contents of YYSTR after stripping away unnecessary
    quotes and backslashes, so that it's suitable for yyerror.  The
    heuristic is that double-quoting is unnecessary unless the string
@@ -1101,7 +1200,6 @@ yytnamerr (char *yyres, const char *yystr)
     {
       YYPTRDIFF_T yyn = 0;
       char const *yyp = yystr;
-
       for (;;)
         switch (*++yyp)
           {
@@ -1135,31 +1233,15 @@ yytnamerr (char *yyres, const char *yystr)
   else
     return yystrlen (yystr);
 }
-# endif
+#endif
 
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
 
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
 static int
-yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
-                yy_state_t *yyssp, int yytoken)
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
 {
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat: reported tokens (one for the "unexpected",
-     one per "expected"). */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
   /* Actual size of YYARG. */
   int yycount = 0;
-  /* Cumulated lengths of YYARG.  */
-  YYPTRDIFF_T yysize = 0;
-
   /* There are many possibilities here to consider:
      - If this state is a consistent state with a default action, then
        the only way this function was invoked is if the default action
@@ -1183,52 +1265,54 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
        one exception: it will still contain any token that will not be
        accepted due to an error action in a later state.
   */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[+*yyssp];
-      YYPTRDIFF_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-      yysize = yysize0;
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYPTRDIFF_T yysize1
-                    = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-                    yysize = yysize1;
-                  else
-                    return 2;
-                }
-              }
-        }
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
     }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
 
   switch (yycount)
     {
-# define YYCASE_(N, S)                      \
+#define YYCASE_(N, S)                       \
       case N:                               \
         yyformat = S;                       \
-      break
+        break
     default: /* Avoid compiler warnings. */
       YYCASE_(0, YY_("syntax error"));
       YYCASE_(1, YY_("syntax error, unexpected %s"));
@@ -1236,17 +1320,23 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
       YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
       YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
       YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
+#undef YYCASE_
     }
 
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
   {
-    /* Don't count the "%s"s in the final size, but reserve room for
-       the terminator.  */
-    YYPTRDIFF_T yysize1 = yysize + (yystrlen (yyformat) - 2 * yycount) + 1;
-    if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-      yysize = yysize1;
-    else
-      return 2;
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
   }
 
   if (*yymsg_alloc < yysize)
@@ -1255,7 +1345,7 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
       if (! (yysize <= *yymsg_alloc
              && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
         *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
+      return -1;
     }
 
   /* Avoid sprintf, as that infringes on the user's name space.
@@ -1267,7 +1357,7 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
     while ((*yyp = *yyformat) != '\0')
       if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
         {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
           yyformat += 2;
         }
       else
@@ -1278,29 +1368,32 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
   }
   return 0;
 }
-#endif /* YYERROR_VERBOSE */
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
 {
-  YYUSE (yyvaluep);
-  YYUSE (yylocationp);
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1308,7 +1401,7 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocatio
 int
 yyparse (void)
 {
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 
@@ -1327,55 +1420,50 @@ static YYLTYPE yyloc_default
 YYLTYPE yylloc = yyloc_default;
 
     /* Number of syntax errors so far.  */
-    int yynerrs;
+    int yynerrs = 0;
 
-    yy_state_fast_t yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
-
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-       'yyls': related to locations.
+    int yyerrstatus = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
     yy_state_t yyssa[YYINITDEPTH];
-    yy_state_t *yyss;
-    yy_state_t *yyssp;
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-    /* The location stack.  */
+    /* The location stack: array, bottom, top.  */
     YYLTYPE yylsa[YYINITDEPTH];
-    YYLTYPE *yyls;
-    YYLTYPE *yylsp;
-
-    /* The locations where the error started and ended.  */
-    YYLTYPE yyerror_range[3];
-
-    YYPTRDIFF_T yystacksize;
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
   YYLTYPE yyloc;
 
-#if YYERROR_VERBOSE
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
   /* Buffer for error messages, and its allocated size.  */
   char yymsgbuf[128];
   char *yymsg = yymsgbuf;
   YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
-#endif
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
 
@@ -1383,17 +1471,10 @@ YYLTYPE yylloc = yyloc_default;
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yylsp = yyls = yylsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   yylsp[0] = yylloc;
   goto yysetstate;
 
@@ -1416,10 +1497,11 @@ yysetstate:
   YY_IGNORE_USELESS_CAST_BEGIN
   *yyssp = YY_CAST (yy_state_t, yystate);
   YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
 #if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+    YYNOMEM;
 #else
     {
       /* Get the current used size of the three stacks, in elements.  */
@@ -1450,7 +1532,7 @@ yysetstate:
 # else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
@@ -1461,11 +1543,11 @@ yysetstate:
           YY_CAST (union yyalloc *,
                    YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
         YYSTACK_RELOCATE (yyls_alloc, yyls);
-# undef YYSTACK_RELOCATE
+#  undef YYSTACK_RELOCATE
         if (yyss1 != yyssa)
           YYSTACK_FREE (yyss1);
       }
@@ -1485,6 +1567,7 @@ yysetstate:
     }
 #endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
+
   if (yystate == YYFINAL)
     YYACCEPT;
 
@@ -1505,18 +1588,30 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex (&yylval, &yylloc);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1588,634 +1683,694 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-  case 2:
-#line 63 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 2: /* start: stmt ';'  */
+#line 65 "/root/repo/src/parser/yacc.y"
     {
         parse_tree = (yyvsp[-1].sv_node);
         YYACCEPT;
     }
-#line 1598 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1693 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 3:
-#line 68 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 3: /* start: HELP  */
+#line 70 "/root/repo/src/parser/yacc.y"
     {
         parse_tree = std::make_shared<Help>();
         YYACCEPT;
     }
-#line 1607 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1702 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 4:
-#line 73 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 4: /* start: EXIT  */
+#line 75 "/root/repo/src/parser/yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1616 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1711 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 5:
-#line 78 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 5: /* start: T_EOF  */
+#line 80 "/root/repo/src/parser/yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1625 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1720 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 10:
-#line 93 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 10: /* txnStmt: TXN_BEGIN  */
+#line 95 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnBegin>();
     }
-#line 1633 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1728 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 11:
-#line 97 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 11: /* txnStmt: TXN_COMMIT  */
+#line 99 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnCommit>();
     }
-#line 1641 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1736 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 12:
-#line 101 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 12: /* txnStmt: TXN_ABORT  */
+#line 103 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnAbort>();
     }
-#line 1649 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1744 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 13:
-#line 105 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 13: /* txnStmt: TXN_ROLLBACK  */
+#line 107 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnRollback>();
     }
-#line 1657 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1752 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 14:
-#line 112 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 14: /* dbStmt: SHOW TABLES  */
+#line 114 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowTables>();
     }
-#line 1665 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1760 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 15:
-#line 116 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 15: /* dbStmt: SHOW INDEX FROM tbName  */
+#line 118 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowIndex>((yyvsp[0].sv_str));
     }
-#line 1673 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1768 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 16:
-#line 123 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 16: /* ddl: CREATE TABLE tbName '(' fieldList ')'  */
+#line 125 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-3].sv_str), (yyvsp[-1].sv_fields));
     }
-#line 1681 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1776 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 17:
-#line 127 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 17: /* ddl: CREATE TABLE tbName '(' fieldList ')' IDENTIFIER IDENTIFIER  */
+#line 129 "/root/repo/src/parser/yacc.y"
+    {
+        // USING PAX / USING ROW选择数据文件的页面格式，USING和PAX都不是保留字
+        if (strcasecmp((yyvsp[-1].sv_str).c_str(), "USING") != 0) {
+            yyerror(&(yylsp[-1]), "syntax error, unexpected IDENTIFIER");
+            YYERROR;
+        }
+        bool pax = strcasecmp((yyvsp[0].sv_str).c_str(), "PAX") == 0;
+        if (!pax && strcasecmp((yyvsp[0].sv_str).c_str(), "ROW") != 0) {
+            yyerror(&(yylsp[0]), ("unknown table format " + (yyvsp[0].sv_str)).c_str());
+            YYERROR;
+        }
+        (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-5].sv_str), (yyvsp[-3].sv_fields), pax);
+    }
+#line 1794 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 18: /* ddl: DROP TABLE tbName  */
+#line 143 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropTable>((yyvsp[0].sv_str));
     }
-#line 1689 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1802 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 18:
-#line 131 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 19: /* ddl: DESC tbName  */
+#line 147 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DescTable>((yyvsp[0].sv_str));
     }
-#line 1697 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1810 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 19:
-#line 135 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 20: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
+#line 151 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1705 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1818 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 20:
-#line 139 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 21: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
+#line 155 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1713 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1826 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 21:
-#line 146 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 22: /* dml: INSERT INTO tbName VALUES valueRows  */
+#line 162 "/root/repo/src/parser/yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<InsertStmt>((yyvsp[-4].sv_str), (yyvsp[-1].sv_vals));
+        (yyval.sv_node) = std::make_shared<InsertStmt>((yyvsp[-2].sv_str), (yyvsp[0].sv_rows));
     }
-#line 1721 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1834 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 22:
-#line 150 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 23: /* dml: IDENTIFIER VALUE_STRING INTO tbName  */
+#line 166 "/root/repo/src/parser/yacc.y"
+    {
+        // LOAD不是保留字，按语句开头的标识符识别
+        if (strcasecmp((yyvsp[-3].sv_str).c_str(), "LOAD") != 0) {
+            yyerror(&(yylsp[-3]), "syntax error, unexpected IDENTIFIER");
+            YYERROR;
+        }
+        (yyval.sv_node) = std::make_shared<LoadStmt>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
+    }
+#line 1847 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 24: /* dml: DELETE FROM tbName optWhereClause  */
+#line 175 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DeleteStmt>((yyvsp[-1].sv_str), (yyvsp[0].sv_conds));
     }
-#line 1729 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1855 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 23:
-#line 154 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 25: /* dml: UPDATE tbName SET setClauses optWhereClause  */
+#line 179 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<UpdateStmt>((yyvsp[-3].sv_str), (yyvsp[-1].sv_set_clauses), (yyvsp[0].sv_conds));
     }
-#line 1737 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1863 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 24:
-#line 158 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 26: /* dml: SELECT selector FROM tableList optWhereClause opt_order_clause  */
+#line 183 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-4].sv_cols), (yyvsp[-2].sv_strs), (yyvsp[-1].sv_conds), (yyvsp[0].sv_opt_orders));
     }
-#line 1745 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1871 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 25:
-#line 162 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 27: /* dml: SELECT aggregator FROM tbName optWhereClause  */
+#line 187 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<AggregateStmt>((yyvsp[-3].sv_aggregate), (yyvsp[-1].sv_str), (yyvsp[0].sv_conds));
     }
-#line 1753 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1879 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 26:
-#line 169 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 28: /* fieldList: field  */
+#line 194 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_fields) = std::vector<std::shared_ptr<Field>>{(yyvsp[0].sv_field)};
     }
-#line 1761 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1887 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 27:
-#line 173 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 29: /* fieldList: fieldList ',' field  */
+#line 198 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_fields).push_back((yyvsp[0].sv_field));
     }
-#line 1769 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1895 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 28:
-#line 180 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 30: /* colNameList: colName  */
+#line 205 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 1777 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1903 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 29:
-#line 184 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 31: /* colNameList: colNameList ',' colName  */
+#line 209 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 1785 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1911 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 30:
-#line 191 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 32: /* field: colName type  */
+#line 216 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_field) = std::make_shared<ColDef>((yyvsp[-1].sv_str), (yyvsp[0].sv_type_len));
     }
-#line 1793 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1919 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 31:
-#line 198 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 33: /* type: INT  */
+#line 223 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_INT, sizeof(int));
     }
-#line 1801 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1927 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 32:
-#line 202 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 34: /* type: CHAR '(' VALUE_INT ')'  */
+#line 227 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_STRING, (yyvsp[-1].sv_int));
     }
-#line 1809 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1935 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 33:
-#line 206 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 35: /* type: FLOAT  */
+#line 231 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_FLOAT, sizeof(float));
     }
-#line 1817 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1943 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 34:
-#line 210 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 36: /* type: BIGINT  */
+#line 235 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_BIGINT, sizeof(int64_t));
     }
-#line 1825 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1951 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 35:
-#line 214 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 37: /* type: DATETIME  */
+#line 239 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_DATETIME, sizeof(int64_t));
     }
-#line 1833 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1959 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 38: /* type: IDENTIFIER '(' VALUE_INT ')'  */
+#line 243 "/root/repo/src/parser/yacc.y"
+    {
+        // VARCHAR不是保留字，按类型名识别，不影响以varchar为名的表和列
+        if (strcasecmp((yyvsp[-3].sv_str).c_str(), "VARCHAR") != 0) {
+            yyerror(&(yylsp[-3]), ("unknown type " + (yyvsp[-3].sv_str)).c_str());
+            YYERROR;
+        }
+        (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_VARCHAR, (yyvsp[-1].sv_int));
+    }
+#line 1972 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 39: /* valueRows: '(' valueList ')'  */
+#line 255 "/root/repo/src/parser/yacc.y"
+    {
+        (yyval.sv_rows) = std::vector<std::vector<std::shared_ptr<Value>>>{(yyvsp[-1].sv_vals)};
+    }
+#line 1980 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 36:
-#line 221 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 40: /* valueRows: valueRows ',' '(' valueList ')'  */
+#line 259 "/root/repo/src/parser/yacc.y"
+    {
+        (yyval.sv_rows).push_back((yyvsp[-1].sv_vals));
+    }
+#line 1988 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 41: /* valueList: value  */
+#line 266 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_vals) = std::vector<std::shared_ptr<Value>>{(yyvsp[0].sv_val)};
     }
-#line 1841 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 1996 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 37:
-#line 225 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 42: /* valueList: valueList ',' value  */
+#line 270 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_vals).push_back((yyvsp[0].sv_val));
     }
-#line 1849 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2004 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 38:
-#line 232 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 43: /* value: VALUE_INT  */
+#line 277 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<IntLit>((yyvsp[0].sv_int));
     }
-#line 1857 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2012 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 39:
-#line 236 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 44: /* value: VALUE_FLOAT  */
+#line 281 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<FloatLit>((yyvsp[0].sv_float));
     }
-#line 1865 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2020 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 40:
-#line 240 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 45: /* value: VALUE_STRING  */
+#line 285 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<StringLit>((yyvsp[0].sv_str));
     }
-#line 1873 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2028 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 41:
-#line 244 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 46: /* value: VALUE_BIGINT  */
+#line 289 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<BigintLit>((yyvsp[0].sv_str));
     }
-#line 1881 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2036 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 42:
-#line 248 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 47: /* value: VALUE_DATETIME  */
+#line 293 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<DateTimeLit>((yyvsp[0].sv_str));
     }
-#line 1889 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2044 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 43:
-#line 255 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 48: /* condition: col op expr  */
+#line 300 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_cond) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_col), (yyvsp[-1].sv_comp_op), (yyvsp[0].sv_expr));
     }
-#line 1897 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2052 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 44:
-#line 261 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 49: /* optWhereClause: %empty  */
+#line 306 "/root/repo/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 1903 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2058 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 45:
-#line 263 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 50: /* optWhereClause: WHERE whereClause  */
+#line 308 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_conds) = (yyvsp[0].sv_conds);
     }
-#line 1911 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2066 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 46:
-#line 270 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 51: /* whereClause: condition  */
+#line 315 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_conds) = std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)};
     }
-#line 1919 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2074 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 47:
-#line 274 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 52: /* whereClause: whereClause AND condition  */
+#line 319 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_conds).push_back((yyvsp[0].sv_cond));
     }
-#line 1927 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2082 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 48:
-#line 281 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 53: /* col: tbName '.' colName  */
+#line 326 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
     }
-#line 1935 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2090 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 49:
-#line 285 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 54: /* col: colName  */
+#line 330 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[0].sv_str));
     }
-#line 1943 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2098 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 50:
-#line 292 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 55: /* colList: col  */
+#line 337 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{(yyvsp[0].sv_col)};
     }
-#line 1951 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2106 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 51:
-#line 296 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 56: /* colList: colList ',' col  */
+#line 341 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_cols).push_back((yyvsp[0].sv_col));
     }
-#line 1959 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2114 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 52:
-#line 303 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 57: /* op: '='  */
+#line 348 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_EQ;
     }
-#line 1967 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2122 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 53:
-#line 307 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 58: /* op: '<'  */
+#line 352 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LT;
     }
-#line 1975 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2130 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 54:
-#line 311 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 59: /* op: '>'  */
+#line 356 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GT;
     }
-#line 1983 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2138 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 55:
-#line 315 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 60: /* op: NEQ  */
+#line 360 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_NE;
     }
-#line 1991 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2146 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 56:
-#line 319 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 61: /* op: LEQ  */
+#line 364 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LE;
     }
-#line 1999 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2154 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 57:
-#line 323 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 62: /* op: GEQ  */
+#line 368 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GE;
     }
-#line 2007 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2162 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 58:
-#line 330 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 63: /* expr: value  */
+#line 375 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_val));
     }
-#line 2015 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2170 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 59:
-#line 334 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 64: /* expr: col  */
+#line 379 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_col));
     }
-#line 2023 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2178 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 60:
-#line 341 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 65: /* setClauses: setClause  */
+#line 386 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clauses) = std::vector<std::shared_ptr<SetClause>>{(yyvsp[0].sv_set_clause)};
     }
-#line 2031 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2186 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 61:
-#line 345 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 66: /* setClauses: setClauses ',' setClause  */
+#line 390 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clauses).push_back((yyvsp[0].sv_set_clause));
     }
-#line 2039 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2194 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 62:
-#line 352 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 67: /* setClause: colName '=' value  */
+#line 397 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-2].sv_str), (yyvsp[0].sv_val));
     }
-#line 2047 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2202 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 63:
-#line 359 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 68: /* selector: '*'  */
+#line 404 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_cols) = {};
     }
-#line 2055 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2210 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 65:
-#line 367 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 70: /* aggregator: aggre_sum '(' colName ')' AS colName  */
+#line 412 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_aggregate) = std::make_shared<AggregateCol>((yyvsp[-5].sv_aggregate_type), (yyvsp[-3].sv_str), (yyvsp[0].sv_str));
     }
-#line 2063 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2218 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 66:
-#line 371 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 71: /* aggregator: aggre_max '(' colName ')' AS colName  */
+#line 416 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_aggregate) = std::make_shared<AggregateCol>((yyvsp[-5].sv_aggregate_type), (yyvsp[-3].sv_str), (yyvsp[0].sv_str));
     }
-#line 2071 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2226 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 67:
-#line 375 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 72: /* aggregator: aggre_min '(' colName ')' AS colName  */
+#line 420 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_aggregate) = std::make_shared<AggregateCol>((yyvsp[-5].sv_aggregate_type), (yyvsp[-3].sv_str), (yyvsp[0].sv_str));
     }
-#line 2079 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2234 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 68:
-#line 379 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 73: /* aggregator: aggre_count '(' '*' ')' AS colName  */
+#line 424 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_aggregate) = std::make_shared<AggregateCol>((yyvsp[-5].sv_aggregate_type), "*", (yyvsp[0].sv_str));
     }
-#line 2087 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2242 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 69:
-#line 383 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 74: /* aggregator: aggre_count '(' colName ')' AS colName  */
+#line 428 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_aggregate) = std::make_shared<AggregateCol>((yyvsp[-5].sv_aggregate_type), (yyvsp[-3].sv_str), (yyvsp[0].sv_str));
     }
-#line 2095 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2250 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 70:
-#line 390 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 75: /* aggre_sum: SUM  */
+#line 435 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_aggregate_type) = SV_SUM;
     }
-#line 2103 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2258 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 71:
-#line 397 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 76: /* aggre_max: MAX  */
+#line 442 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_aggregate_type) = SV_MAX;
     }
-#line 2111 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2266 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 72:
-#line 404 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 77: /* aggre_min: MIN  */
+#line 449 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_aggregate_type) = SV_MIN;
     }
-#line 2119 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2274 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 73:
-#line 411 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 78: /* aggre_count: COUNT  */
+#line 456 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_aggregate_type) = SV_COUNT;
     }
-#line 2127 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2282 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 74:
-#line 418 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 79: /* tableList: tbName  */
+#line 463 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 2135 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2290 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 75:
-#line 422 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 80: /* tableList: tableList ',' tbName  */
+#line 467 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 2143 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2298 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 76:
-#line 426 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 81: /* tableList: tableList JOIN tbName  */
+#line 471 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 2151 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2306 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 77:
-#line 433 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 82: /* opt_order_clause: ORDER BY order_clauses  */
+#line 478 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_opt_orders) = std::pair<std::vector<std::shared_ptr<OrderBy>>, int>{(yyvsp[0].sv_orderbys), -1};
     }
-#line 2159 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2314 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 78:
-#line 437 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 83: /* opt_order_clause: ORDER BY order_clauses LIMIT VALUE_INT  */
+#line 482 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_opt_orders) = std::pair<std::vector<std::shared_ptr<OrderBy>>, int>{(yyvsp[-2].sv_orderbys), (yyvsp[0].sv_int)};
     }
-#line 2167 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2322 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 79:
-#line 440 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 84: /* opt_order_clause: %empty  */
+#line 485 "/root/repo/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 2173 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2328 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 80:
-#line 445 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 85: /* order_clauses: order_clause  */
+#line 490 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_orderbys) = std::vector<std::shared_ptr<OrderBy>>{ (yyvsp[0].sv_orderby) };
     }
-#line 2181 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2336 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 81:
-#line 449 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 86: /* order_clauses: order_clauses ',' order_clause  */
+#line 494 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_orderbys).push_back((yyvsp[0].sv_orderby));
     }
-#line 2189 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2344 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 82:
-#line 456 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 87: /* order_clause: col opt_asc_desc  */
+#line 501 "/root/repo/src/parser/yacc.y"
     { 
         (yyval.sv_orderby) = std::make_shared<OrderBy>((yyvsp[-1].sv_col), (yyvsp[0].sv_orderby_dir));
     }
-#line 2197 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2352 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 83:
-#line 462 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 88: /* opt_asc_desc: ASC  */
+#line 507 "/root/repo/src/parser/yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_ASC;     }
-#line 2203 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2358 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 84:
-#line 463 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 89: /* opt_asc_desc: DESC  */
+#line 508 "/root/repo/src/parser/yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_DESC;    }
-#line 2209 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2364 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 85:
-#line 464 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+  case 90: /* opt_asc_desc: %empty  */
+#line 509 "/root/repo/src/parser/yacc.y"
             { (yyval.sv_orderby_dir) = OrderBy_DEFAULT; }
-#line 2215 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2370 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
 
-#line 2219 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.tab.cpp"
+#line 2374 "/root/repo/src/parser/yacc.tab.cpp"
 
       default: break;
     }
@@ -2230,11 +2385,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
   *++yylsp = yyloc;
@@ -2259,50 +2413,45 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (&yylloc, YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
       {
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
         char const *yymsgp = YY_("syntax error");
         int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
         if (yysyntax_error_status == 0)
           yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
+        else if (yysyntax_error_status == -1)
           {
             if (yymsg != yymsgbuf)
               YYSTACK_FREE (yymsg);
-            yymsg = YY_CAST (char *, YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
-            if (!yymsg)
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
               {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
               }
             else
               {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
               }
           }
         yyerror (&yylloc, yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
   yyerror_range[1] = yylloc;
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2335,6 +2484,7 @@ yyerrorlab:
      label yyerrorlab therefore never appears in user code.  */
   if (0)
     YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2351,13 +2501,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2371,7 +2522,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2382,13 +2533,11 @@ yyerrlab1:
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
   yyerror_range[2] = yylloc;
-  /* Using YYLLOC is tempting, but would change the location of
-     the lookahead.  YYLOC is available though.  */
-  YYLLOC_DEFAULT (yyloc, yyerror_range, 2);
-  *++yylsp = yyloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2399,7 +2548,7 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
 /*-----------------------------------.
@@ -2407,24 +2556,22 @@ yyacceptlab:
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (&yylloc, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
 
-/*-----------------------------------------------------.
-| yyreturn -- parsing is finished, return the result.  |
-`-----------------------------------------------------*/
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2440,18 +2587,17 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[+*yyssp], yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
     YYSTACK_FREE (yymsg);
-#endif
   return yyresult;
 }
-#line 470 "/tmp/tmp.xSxJmu6b7R/src/parser/yacc.y"
+
+#line 515 "/root/repo/src/parser/yacc.y"
 
@@ -1,6 +1,7 @@
 %{
 #include "ast.h"
 #include "yacc.tab.h"
+#include <strings.h>
 #include <iostream>
 #include <memory>
 
@@ -42,6 +43,7 @@ WHERE UPDATE SET SELECT INT CHAR FLOAT BIGINT DATETIME INDEX AND JOIN EXIT HELP
 %type <sv_expr> expr
 %type <sv_val> value
 %type <sv_vals> valueList
+%type <sv_rows> valueRows
 %type <sv_str> tbName colName
 %type <sv_strs> tableList colNameList
 %type <sv_col> col
@@ -123,6 +125,20 @@ ddl:
     {
         $$ = std::make_shared<CreateTable>($3, $5);
     }
+    |   CREATE TABLE tbName '(' fieldList ')' IDENTIFIER IDENTIFIER
+    {
+        // USING PAX / USING ROW选择数据文件的页面格式，USING和PAX都不是保留字
+        if (strcasecmp($7.c_str(), "USING") != 0) {
+            yyerror(&@7, "syntax error, unexpected IDENTIFIER");
+            YYERROR;
+        }
+        bool pax = strcasecmp($8.c_str(), "PAX") == 0;
+        if (!pax && strcasecmp($8.c_str(), "ROW") != 0) {
+            yyerror(&@8, ("unknown table format " + $8).c_str());
+            YYERROR;
+        }
+        $$ = std::make_shared<CreateTable>($3, $5, pax);
+    }
     |   DROP TABLE tbName
     {
         $$ = std::make_shared<DropTable>($3);
@@ -142,9 +158,18 @@ ddl:
     ;
 
 dml:
-        INSERT INTO tbName VALUES '(' valueList ')'
+        INSERT INTO tbName VALUES valueRows
+    {
+        $$ = std::make_shared<InsertStmt>($3, $5);
+    }
+    |   IDENTIFIER VALUE_STRING INTO tbName
     {
-        $$ = std::make_shared<InsertStmt>($3, $6);
+        // LOAD不是保留字，按语句开头的标识符识别
+        if (strcasecmp($1.c_str(), "LOAD") != 0) {
+            yyerror(&@1, "syntax error, unexpected IDENTIFIER");
+            YYERROR;
+        }
+        $$ = std::make_shared<LoadStmt>($2, $4);
     }
     |   DELETE FROM tbName optWhereClause
     {
@@ -214,6 +239,26 @@ type:
     {
         $$ = std::make_shared<TypeLen>(SV_TYPE_DATETIME, sizeof(int64_t));
     }
+    |   IDENTIFIER '(' VALUE_INT ')'
+    {
+        // VARCHAR不是保留字，按类型名识别，不影响以varchar为名的表和列
+        if (strcasecmp($1.c_str(), "VARCHAR") != 0) {
+            yyerror(&@1, ("unknown type " + $1).c_str());
+            YYERROR;
+        }
+        $$ = std::make_shared<TypeLen>(SV_TYPE_VARCHAR, $3);
+    }
+    ;
+
+valueRows:
+        '(' valueList ')'
+    {
+        $$ = std::vector<std::vector<std::shared_ptr<Value>>>{$2};
+    }
+    |   valueRows ',' '(' valueList ')'
+    {
+        $$.push_back($4);
+    }
     ;
 
 valueList:
@@ -13,6 +13,10 @@ See the Mulan PSL v2 for more details. */
 #include <cinttypes>
 #include <cstring>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 static constexpr int BITMAP_WIDTH = 8;
 static constexpr unsigned BITMAP_HIGHEST_BIT = 0x80u;  // 128 (2^7)
 
@@ -31,7 +35,8 @@ class Bitmap {
     static bool is_set(const char *bm, int pos) { return (bm[get_bucket(pos)] & get_bit(pos)) != 0; }
 
     /**
-     * @brief 找下一个为0 or 1的位
+     * @brief 找下一个为0 or 1的位。按64位字扫描：字节序翻转后位号递增的方向即字的高位到低位，用clz定位；
+     * 位图较大时先用AVX2整块跳过全0(找1时)或全1(找0时)的32字节
      * @param bit false表示要找下一个为0的位，true表示要找下一个为1的位
      * @param bm 要找的起始地址为bm
      * @param max_n 要找的从起始地址开始的偏移为[curr+1,max_n)
@@ -39,12 +44,33 @@ class Bitmap {
      * @return 找到了就返回偏移位置，没找到就返回max_n
      */
     static int next_bit(bool bit, const char *bm, int max_n, int curr) {
-        for (int i = curr + 1; i < max_n; i++) {
-            if (is_set(bm, i) == bit) {
-                return i;
+        int start = curr + 1;
+        if (start >= max_n) {
+            return max_n;
+        }
+        int num_bytes = (max_n + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+        int byte = start / BITMAP_WIDTH;
+        uint64_t flip = bit ? 0 : ~uint64_t{0};
+        // 第一个字去掉start之前的位
+        uint64_t word = (load_word(bm, byte, num_bytes) ^ flip) & (~uint64_t{0} >> (start % BITMAP_WIDTH));
+        while (word == 0) {
+            byte += WORD_BYTES;
+            if (byte >= num_bytes) {
+                return max_n;
+            }
+#if defined(__x86_64__)
+            if (num_bytes - byte >= AVX2_MIN_BYTES && has_avx2()) {
+                byte = skip_blocks_avx2(bit, bm, byte, num_bytes);
+                if (byte >= num_bytes) {
+                    return max_n;
+                }
             }
+#endif
+            word = load_word(bm, byte, num_bytes) ^ flip;
         }
-        return max_n;
+        // 最后一个字节中max_n之后的位可能被当作结果，截断到max_n
+        int pos = byte * BITMAP_WIDTH + __builtin_clzll(word);
+        return pos < max_n ? pos : max_n;
     }
 
     // 找第一个为0 or 1的位
@@ -54,7 +80,83 @@ class Bitmap {
     // rid_.slot_no = Bitmap::next_bit(true, page_handle.bitmap, file_handle_->file_hdr_.num_records_per_page,
     // rid_.slot_no); int slot_no = Bitmap::first_bit(false, page_handle.bitmap, file_hdr_.num_records_per_page);
 
+    /**
+     * @brief 依次取出位图中所有为1的位，每个字只读取一次；适合一次取出整个页面的记录
+     */
+    class SetBitIterator {
+       public:
+        SetBitIterator(const char *bm, int max_n)
+            : bm_(bm), max_n_(max_n), num_bytes_((max_n + BITMAP_WIDTH - 1) / BITMAP_WIDTH),
+              word_(load_word(bm, 0, num_bytes_)) {}
+
+        /**
+         * @return 下一个为1的位，没有时返回max_n
+         */
+        int next() {
+            while (word_ == 0) {
+                byte_ += WORD_BYTES;
+                if (byte_ >= num_bytes_) {
+                    return max_n_;
+                }
+                word_ = load_word(bm_, byte_, num_bytes_);
+            }
+            int lz = __builtin_clzll(word_);
+            word_ &= ~(HIGHEST_WORD_BIT >> lz);
+            int pos = byte_ * BITMAP_WIDTH + lz;
+            return pos < max_n_ ? pos : max_n_;
+        }
+
+       private:
+        const char *bm_;
+        int max_n_;
+        int num_bytes_;
+        int byte_{0};
+        uint64_t word_;
+    };
+
    private:
+    static constexpr int WORD_BYTES = 8;
+    static constexpr uint64_t HIGHEST_WORD_BIT = uint64_t{1} << 63;
+    static constexpr int AVX2_BLOCK_BYTES = 32;
+    static constexpr int AVX2_MIN_BYTES = 4 * AVX2_BLOCK_BYTES;  // 剩余部分较短时逐字扫描更快
+
+    /**
+     * @brief 从第byte个字节开始读取至多8个字节(不越过位图末尾，不足的补0)，位号较小的位在高位
+     */
+    static uint64_t load_word(const char *bm, int byte, int num_bytes) {
+        uint64_t word = 0;
+        if (num_bytes - byte >= WORD_BYTES) {
+            memcpy(&word, bm + byte, WORD_BYTES);
+        } else {
+            memcpy(&word, bm + byte, num_bytes - byte);
+        }
+        return __builtin_bswap64(word);
+    }
+
+#if defined(__x86_64__)
+    static bool has_avx2() {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+
+    /**
+     * @brief 从第byte个字节开始，跳过不含目标位的完整32字节块
+     * @return 第一个可能含有目标位的字节位置
+     */
+    __attribute__((target("avx2"))) static int skip_blocks_avx2(bool bit, const char *bm, int byte, int num_bytes) {
+        const __m256i ones = _mm256_set1_epi8(-1);
+        for (; byte + AVX2_BLOCK_BYTES <= num_bytes; byte += AVX2_BLOCK_BYTES) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bm + byte));
+            // 找1时块全0、找0时块全1才可以跳过
+            bool skip = bit ? _mm256_testz_si256(block, block) : _mm256_testc_si256(block, ones);
+            if (!skip) {
+                break;
+            }
+        }
+        return byte;
+    }
+#endif
+
     static int get_bucket(int pos) { return pos / BITMAP_WIDTH; }
 
     static char get_bit(int pos) { return BITMAP_HIGHEST_BIT >> static_cast<char>(pos % BITMAP_WIDTH); }
@@ -19,15 +19,62 @@ constexpr int RM_NO_PAGE = -1;
 constexpr int RM_FILE_HDR_PAGE = 0;
 constexpr int RM_FIRST_RECORD_PAGE = 1;
 constexpr int RM_MAX_RECORD_SIZE = 512;
+constexpr int RM_MAX_VAR_COLS = 64;
+constexpr int RM_MAX_PAX_COLS = 64;
+
+/* 按列读取记录时需要的字段，第i位对应表的第i列 */
+using RmColumnMask = uint64_t;
+constexpr RmColumnMask RM_ALL_COLUMNS = ~RmColumnMask{0};
+
+/* tab_cols(表的全部字段)中字段tab_name.col_name对应的位，不是该表的字段时为0 */
+inline RmColumnMask rm_column_bit(const std::vector<ColMeta> &tab_cols, const std::string &tab_name,
+                                  const std::string &col_name) {
+    for (size_t i = 0; i < tab_cols.size() && i < RM_MAX_PAX_COLS; i++) {
+        if (tab_cols[i].tab_name == tab_name && tab_cols[i].name == col_name) {
+            return RmColumnMask{1} << i;
+        }
+    }
+    return 0;
+}
+
+/* 数据文件中页面的组织方式 */
+enum RmPageFormat {
+    RM_FIXED_SLOT = 0,  // 定长槽位 + bitmap，每条记录占record_size字节
+    RM_SLOTTED = 1,     // 槽目录 + 变长记录(见RmSlottedPage)，含VARCHAR字段的表使用
+    RM_PAX = 2,         // 定长槽位 + bitmap，槽位区按列划分为minipage，同一列的值连续存放(CREATE TABLE ... USING PAX)
+};
+
+/* VARCHAR字段在定长记录中的位置，slotted page中只存储其去掉末尾0之后的部分 */
+struct RmVarCol {
+    int offset;
+    int len;
+};
+
+/* PAX页面中一列在定长记录中的位置，该列的minipage位于槽位区的offset * num_records_per_page处 */
+struct RmPaxCol {
+    uint16_t offset;
+    uint16_t len;
+};
 
 /* 文件头，记录表数据文件的元信息，写入磁盘中文件的第0号页面 */
 struct RmFileHdr {
-    int record_size{};            // 表中每条记录的大小，由于不包含变长字段，因此当前字段初始化后保持不变
+    int record_size{};            // 表中每条记录(内存中定长形式)的大小，初始化后保持不变
     int num_pages{1};              // 文件中分配的页面个数（初始化为1）
-    int num_records_per_page{};   // 每个页面最多能存储的元组个数
+    int num_records_per_page{};   // 每个页面最多能存储的元组个数，slotted page中不使用
     int first_free_page_no{-1};     // 文件中当前第一个包含空闲空间的页面号（初始化为-1）
-    int bitmap_size{};            // 每个页面bitmap大小
+    int bitmap_size{};            // 每个页面bitmap大小，slotted page中不使用
+    int page_format{RM_FIXED_SLOT};   // 页面组织方式RmPageFormat
+    int max_tuple_size{};         // slotted page中一条记录编码后的最大长度
+    int num_var_cols{};           // VARCHAR字段的个数
+    RmVarCol var_cols[RM_MAX_VAR_COLS]{};   // VARCHAR字段，按offset升序
+    int num_pax_cols{};           // PAX页面中的列数
+    RmPaxCol pax_cols[RM_MAX_PAX_COLS]{};   // PAX页面中的各列，按offset升序
+
+    bool is_slotted() const { return page_format == RM_SLOTTED; }
+
+    bool is_pax() const { return page_format == RM_PAX; }
 };
+static_assert(sizeof(RmFileHdr) <= FREE_SPACE_MAP_OFFSET, "RmFileHdr overlaps the free space map");
 
 /* 表数据文件中每个页面的页头，记录每个页面的元信息 */
 struct RmPageHdr {
@@ -115,3 +162,26 @@ struct RmRecord {
         return std::make_unique<RmRecord>(rm);
     }
 };
+
+/**
+ * 记录的只读视图，不拥有数据：指向被pin住的帧中的记录或执行器内部的缓冲区，
+ * 由产生它的一方保证数据在约定的期间内有效。需要保存更久时用materialize()复制一份
+ */
+class RmTupleView {
+   public:
+    RmTupleView() = default;
+
+    RmTupleView(const char *data, int size) : data_(data), size_(size) {}
+
+    explicit RmTupleView(const RmRecord &rec) : data_(rec.data), size_(rec.size) {}
+
+    const char *data() const { return data_; }
+
+    int size() const { return size_; }
+
+    std::unique_ptr<RmRecord> materialize() const { return std::make_unique<RmRecord>(size_, const_cast<char *>(data_)); }
+
+   private:
+    const char *data_{nullptr};
+    int size_{0};
+};
@@ -17,6 +17,9 @@ See the Mulan PSL v2 for more details. */
  * @return {unique_ptr<RmRecord>} rid对应的记录对象指针
  */
 std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid& rid, Context* context) const {
+    if (file_hdr_.is_slotted()) {
+        return get_record_slotted(rid);
+    }
     // Todo: v
     // 1. 获取指定记录所在的page handle
     // 2. 初始化一个指向RmRecord的指针（赋值其内部的data和size）
@@ -28,7 +31,7 @@ std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid& rid, Context* cont
     int size = pageHandle.file_hdr->record_size;
     std::unique_ptr<RmRecord> record = std::make_unique<RmRecord>(size);
     record->size = size;
-    memcpy(record->data, pageHandle.get_slot(rid.slot_no),size);
+    pageHandle.read_slot(rid.slot_no, record->data);
 
     buffer_pool_manager_->unpin_page(PageId{fd_,rid.page_no}, false); // check(AntiO2) 这里是否需要unpin
 
@@ -42,6 +45,9 @@ std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid& rid, Context* cont
  * @return {Rid} 插入的记录的记录号（位置）
  */
 Rid RmFileHandle::insert_record(char* buf, Context* context, std::string* table_name,  LogOperation log_op, lsn_t undo_next) {
+    if (file_hdr_.is_slotted()) {
+        return insert_record_slotted(buf, context, table_name, log_op, undo_next);
+    }
     // 1. 获取当前未满的page handle
     // 2. 在page handle中找到空闲slot位置
     // 3. 将buf复制到空闲slot位置
@@ -58,7 +64,6 @@ Rid RmFileHandle::insert_record(char* buf, Context* context, std::string* table_
         assert(false);
     }
     Bitmap::set(pageHandle.bitmap,slot_no);
-    char* addr_slot = pageHandle.get_slot(slot_no);
 
     RmRecord insert_value(file_hdr_.record_size, buf);
 
@@ -77,7 +82,7 @@ Rid RmFileHandle::insert_record(char* buf, Context* context, std::string* table_
     auto page_id = PageId{fd_,rid.page_no};
 
     // 3. 将buf复制到空闲slot位置
-    memcpy(addr_slot,buf,pageHandle.file_hdr->record_size);
+    pageHandle.write_slot(slot_no, buf);
 
     // 4. 更新page_handle.page_hdr中的数据结构
     pageHandle.page_hdr->num_records++;
@@ -88,13 +93,11 @@ Rid RmFileHandle::insert_record(char* buf, Context* context, std::string* table_
         //next_free_page_no怎么更新? v不更新了，等create_page_handle()自己调
         file_hdr_.first_free_page_no = pageHandle.page_hdr->next_free_page_no;
         pageHandle.page_hdr->next_free_page_no=RM_NO_PAGE;
-        disk_manager_->write_page(fd_, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
+        write_file_hdr();
     }
 
 
-    if(log_mgr->dirty_page_table_.find(PageId{fd_,rid.page_no})==log_mgr->dirty_page_table_.end()) {
-        log_mgr->dirty_page_table_.emplace(page_id, log_record->lsn_);
-    }
+    log_mgr->add_dirty_page(page_id, log_record->lsn_);
 
     pageHandle.page->set_page_lsn(log_record->lsn_);
     //该页面结束使用，取消对该页面的固定,并标记为dirty
@@ -102,6 +105,80 @@ Rid RmFileHandle::insert_record(char* buf, Context* context, std::string* table_
     return rid;
 }
 
+/**
+ * @description: 批量插入记录。每次取空闲页面链表的第一个页面，把后续记录尽量放入该页面后再写一条日志，
+ * 页面满时移出链表；期间文件头的修改只保存在内存中，全部插入后写回一次
+ * @param {char*} bufs num_records条定长记录，首尾相接
+ * @return {vector<Rid>} 各记录的位置
+ */
+std::vector<Rid> RmFileHandle::insert_records(const char *bufs, int num_records, Context *context,
+                                              std::string *table_name) {
+    std::vector<Rid> rids;
+    rids.reserve(num_records);
+    char tuple[RM_MAX_RECORD_SIZE + RM_MAX_VAR_COLS * sizeof(uint16_t)];
+    int tuple_len = -1;    // slotted page中当前记录编码后的长度，-1表示尚未编码
+    auto txn = context->txn_;
+    auto log_mgr = context->log_mgr_;
+    defer_hdr_write_ = true;
+    try {
+        int i = 0;
+        while (i < num_records) {
+            RmPageHandle page_handle = create_page_handle();
+            int page_no = page_handle.page->get_page_id().page_no;
+            InsertBatchLogRecord log_record(txn->getTxnId(), page_no, *table_name, txn->get_prev_lsn(),
+                                            file_hdr_.first_free_page_no, file_hdr_.num_pages);
+            if (file_hdr_.is_slotted()) {
+                RmSlottedPage page(page_handle.page->get_data());
+                for (; i < num_records; i++, tuple_len = -1) {
+                    if (tuple_len < 0) {
+                        tuple_len = RmTupleCodec::encode(file_hdr_, bufs + i * file_hdr_.record_size, tuple);
+                    }
+                    if (!page.can_insert(tuple_len)) {
+                        break;
+                    }
+                    int slot_no = page.insert(tuple, tuple_len);
+                    log_record.add_tuple(slot_no, tuple, tuple_len);
+                    rids.push_back(Rid{page_no, slot_no});
+                }
+                if (!page.can_insert(file_hdr_.max_tuple_size)) {
+                    remove_from_free_list(page);
+                }
+            } else {
+                int slot_no = -1;
+                while (i < num_records && page_handle.page_hdr->num_records < file_hdr_.num_records_per_page) {
+                    slot_no = Bitmap::next_bit(false, page_handle.bitmap, file_hdr_.num_records_per_page, slot_no);
+                    const char *buf = bufs + i * file_hdr_.record_size;
+                    Bitmap::set(page_handle.bitmap, slot_no);
+                    page_handle.write_slot(slot_no, buf);
+                    page_handle.page_hdr->num_records++;
+                    log_record.add_tuple(slot_no, buf, file_hdr_.record_size);
+                    rids.push_back(Rid{page_no, slot_no});
+                    i++;
+                }
+                if (page_handle.page_hdr->num_records >= file_hdr_.num_records_per_page) {
+                    file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
+                    page_handle.page_hdr->next_free_page_no = RM_NO_PAGE;
+                }
+            }
+            if (log_record.num_tuples() > 0) {
+                log_mgr->add_log_to_buffer(&log_record);
+                txn->set_prev_lsn(log_record.lsn_);
+                log_mgr->active_txn_table_[txn->getTxnId()] = log_record.lsn_;
+                log_mgr->add_dirty_page(page_handle.page->get_page_id(), log_record.lsn_);
+                page_handle.page->set_page_lsn(log_record.lsn_);
+            }
+            buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+        }
+    } catch (...) {
+        defer_hdr_write_ = false;
+        write_file_hdr();
+        throw;
+    }
+    defer_hdr_write_ = false;
+    write_file_hdr();
+    return rids;
+}
+
 /**
  * @description: 在当前表中的指定位置插入一条记录
  * @param {Rid&} rid 要插入记录的位置
@@ -113,20 +190,35 @@ void RmFileHandle::insert_record_recover(const Rid &rid, char *buf, lsn_t lsn, i
     file_hdr_.num_pages = num_pages;
     //1. 拿到pageHandle
     RmPageHandle pageHandle = fetch_page_handle(rid.page_no);
+    if (file_hdr_.is_slotted()) {
+        // buf是编码后的记录
+        RmSlottedPage page(pageHandle.page->get_data());
+        if (page.hdr()->data_begin == 0) {
+            // 插入前新建的页面没有写回过，读出的是全0页面
+            page.init();
+            page.hdr()->in_free_list = 1;
+        }
+        page.insert_at(rid.slot_no, buf, RmTupleCodec::size(file_hdr_, buf));
+        if (!page.can_insert(file_hdr_.max_tuple_size)) {
+            remove_from_free_list(page);
+        }
+        pageHandle.page->set_page_lsn(lsn);
+        buffer_pool_manager_->unpin_page(pageHandle.page->get_page_id(), true);
+        return;
+    }
 
     //2. 判断并更新位图
     assert(!Bitmap::is_set(pageHandle.bitmap,rid.slot_no));
     Bitmap::set(pageHandle.bitmap,rid.slot_no);
     pageHandle.page_hdr->num_records++;
     //3. 复制数据
-    char* addr_slot = pageHandle.get_slot(rid.slot_no);
-    memcpy(addr_slot,buf,pageHandle.file_hdr->record_size);
+    pageHandle.write_slot(rid.slot_no, buf);
     if(pageHandle.page_hdr->num_records >= pageHandle.file_hdr->num_records_per_page)
     {
         //next_free_page_no怎么更新? v不更新了，等create_page_handle()自己调
         file_hdr_.first_free_page_no = pageHandle.page_hdr->next_free_page_no;
         pageHandle.page_hdr->next_free_page_no=RM_NO_PAGE;
-        disk_manager_->write_page(fd_, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
+        write_file_hdr();
     }
     pageHandle.page->set_page_lsn(lsn);
 
@@ -134,12 +226,62 @@ void RmFileHandle::insert_record_recover(const Rid &rid, char *buf, lsn_t lsn, i
     buffer_pool_manager_->unpin_page(pageHandle.page->get_page_id(),true);
 }
 
+/**
+ * @description: 重做批量插入：页面只fetch一次，按日志中的槽号放回各条记录
+ */
+void RmFileHandle::insert_records_recover(int page_no, const InsertBatchLogRecord &log, lsn_t lsn) {
+    file_hdr_.first_free_page_no = log.first_free_page_no_;
+    file_hdr_.num_pages = log.num_pages_;
+    RmPageHandle page_handle = fetch_page_handle(page_no);
+    if (file_hdr_.is_slotted()) {
+        RmSlottedPage page(page_handle.page->get_data());
+        if (page.hdr()->data_begin == 0) {
+            page.init();
+            page.hdr()->in_free_list = 1;
+        }
+        for (int i = 0; i < log.num_tuples(); i++) {
+            page.insert_at(log.slot_nos_[i], log.tuple(i), log.lens_[i]);
+        }
+        if (!page.can_insert(file_hdr_.max_tuple_size)) {
+            remove_from_free_list(page);
+        }
+    } else {
+        for (int i = 0; i < log.num_tuples(); i++) {
+            int slot_no = log.slot_nos_[i];
+            assert(!Bitmap::is_set(page_handle.bitmap, slot_no));
+            Bitmap::set(page_handle.bitmap, slot_no);
+            page_handle.write_slot(slot_no, log.tuple(i));
+            page_handle.page_hdr->num_records++;
+        }
+        if (page_handle.page_hdr->num_records >= file_hdr_.num_records_per_page) {
+            file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
+            page_handle.page_hdr->next_free_page_no = RM_NO_PAGE;
+            write_file_hdr();
+        }
+    }
+    page_handle.page->set_page_lsn(lsn);
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+}
+
+void RmFileHandle::ensure_num_pages(int num_pages) {
+    if (num_pages <= file_hdr_.num_pages) {
+        return;
+    }
+    file_hdr_.num_pages = num_pages;
+    disk_manager_->set_fd2pageno(fd_, num_pages);
+    write_file_hdr();
+}
+
 /**
  * @description: 删除记录文件中记录号为rid的记录
  * @param {Rid&} rid 要删除的记录的记录号（位置）
  * @param {Context*} context
  */
 void RmFileHandle::delete_record(const Rid& rid, Context* context, std::string* table_name,  LogOperation log_op, lsn_t undo_next) {
+    if (file_hdr_.is_slotted()) {
+        delete_record_slotted(rid, context, table_name, log_op, undo_next);
+        return;
+    }
     // Todo: v
     // 1. 获取指定记录所在的page handle
     // 2. 更新page_handle.page_hdr中的数据结构
@@ -151,8 +293,8 @@ void RmFileHandle::delete_record(const Rid& rid, Context* context, std::string*
     //位图判断及更新
     if(!Bitmap::is_set(pageHandle.bitmap,rid.slot_no))
         throw RecordNotFoundError(rid.page_no,rid.slot_no);
-    char* addr_slot = pageHandle.get_slot(rid.slot_no);
-    RmRecord delete_value(file_hdr_.record_size, addr_slot);
+    RmRecord delete_value(file_hdr_.record_size);
+    pageHandle.read_slot(rid.slot_no, delete_value.data);
 
     auto txn = context->txn_;
     auto log_mgr = context->log_mgr_;
@@ -167,9 +309,7 @@ void RmFileHandle::delete_record(const Rid& rid, Context* context, std::string*
     log_mgr->add_log_to_buffer(log_record);
     txn->set_prev_lsn(log_record->lsn_);
     log_mgr->active_txn_table_[txn->getTxnId()] = log_record->lsn_;
-    if(log_mgr->dirty_page_table_.find(PageId{fd_,rid.page_no})==log_mgr->dirty_page_table_.end()) {
-        log_mgr->dirty_page_table_.emplace(page_id,log_record->lsn_);
-    }
+    log_mgr->add_dirty_page(page_id, log_record->lsn_);
 
     Bitmap::reset(pageHandle.bitmap,rid.slot_no);
     // 2. 更新page_handle.page_hdr中的数据结构
@@ -193,6 +333,18 @@ void RmFileHandle::delete_record_recover(const Rid& rid,lsn_t lsn, int first_fre
     file_hdr_.first_free_page_no = first_free_page;
     file_hdr_.num_pages = num_pages;
     RmPageHandle pageHandle = fetch_page_handle(rid.page_no);
+    if (file_hdr_.is_slotted()) {
+        RmSlottedPage page(pageHandle.page->get_data());
+        if (!page.is_record(rid.slot_no)) {
+            buffer_pool_manager_->unpin_page(pageHandle.page->get_page_id(), false);
+            throw RecordNotFoundError(rid.page_no, rid.slot_no);
+        }
+        page.erase(rid.slot_no);
+        add_to_free_list(page, rid.page_no);
+        pageHandle.page->set_page_lsn(lsn);
+        buffer_pool_manager_->unpin_page(pageHandle.page->get_page_id(), true);
+        return;
+    }
     //位图判断及更新
     if(!Bitmap::is_set(pageHandle.bitmap,rid.slot_no))
         throw RecordNotFoundError(rid.page_no,rid.slot_no);
@@ -214,7 +366,10 @@ void RmFileHandle::delete_record_recover(const Rid& rid,lsn_t lsn, int first_fre
  * @param {char*} buf 新记录的数据
  * @param {Context*} context
  */
-void RmFileHandle::update_record(const Rid& rid, char* buf, Context* context, std::string* table_name,  LogOperation log_op, lsn_t undo_next) {
+Rid RmFileHandle::update_record(const Rid& rid, char* buf, Context* context, std::string* table_name,  LogOperation log_op, lsn_t undo_next) {
+    if (file_hdr_.is_slotted()) {
+        return update_record_slotted(rid, buf, context, table_name, log_op, undo_next);
+    }
 
     // 1. 获取指定记录所在的page handle
     // 2. 更新记录
@@ -229,9 +384,9 @@ void RmFileHandle::update_record(const Rid& rid, char* buf, Context* context, st
     }
     // 2. 更新记录
 
-    char* addr_slot = pageHandle.get_slot(rid.slot_no);
     auto size = pageHandle.file_hdr->record_size;
-    RmRecord before_value(size, addr_slot);
+    RmRecord before_value(size);
+    pageHandle.read_slot(rid.slot_no, before_value.data);
     RmRecord after_value(size, buf);
 
     auto tid = context->txn_->getTxnId();
@@ -247,15 +402,13 @@ void RmFileHandle::update_record(const Rid& rid, char* buf, Context* context, st
     context->txn_->set_prev_lsn(log_record->lsn_);
     log_mgr->active_txn_table_[tid] = log_record->lsn_; // 维护att中的last lsn
     auto page_id = PageId{fd_,rid.page_no};
-    auto table_iter = log_mgr->dirty_page_table_.find(page_id);
-    if(table_iter==log_mgr->dirty_page_table_.end()) {
-        // 维护rec lsn
-        log_mgr->dirty_page_table_.emplace(page_id, log_record->lsn_);
-    }
+    // 维护rec lsn
+    log_mgr->add_dirty_page(page_id, log_record->lsn_);
 
-    memcpy(addr_slot,buf,size);
+    pageHandle.write_slot(rid.slot_no, buf);
     pageHandle.page->set_page_lsn(log_record->lsn_);
     buffer_pool_manager_->unpin_page(PageId{fd_,rid.page_no}, true);
+    return rid;
 }
 /**
  * @description: 更新记录文件中记录号为rid的记录
@@ -273,13 +426,25 @@ void RmFileHandle::update_record_recover(const Rid& rid, char* buf,lsn_t lsn, in
 
     // 1. 获取指定记录所在的page handle
     RmPageHandle pageHandle = fetch_page_handle(rid.page_no);
+    if (file_hdr_.is_slotted()) {
+        // buf是编码后的记录，重做时页面状态与原操作时相同，一定能容纳
+        RmSlottedPage page(pageHandle.page->get_data());
+        if (!page.is_record(rid.slot_no)) {
+            buffer_pool_manager_->unpin_page(pageHandle.page->get_page_id(), false);
+            throw RecordNotFoundError(rid.page_no, rid.slot_no);
+        }
+        page.update(rid.slot_no, buf, RmTupleCodec::size(file_hdr_, buf));
+        add_to_free_list(page, rid.page_no);
+        pageHandle.page->set_page_lsn(lsn);
+        buffer_pool_manager_->unpin_page(pageHandle.page->get_page_id(), true);
+        return;
+    }
     //判断位图
     if (!Bitmap::is_set(pageHandle.bitmap, rid.slot_no)) {
         throw RecordNotFoundError(rid.page_no, rid.slot_no);
     }
     // 2. 更新记录
-    char* addr_slot = pageHandle.get_slot(rid.slot_no);
-    memcpy(addr_slot,buf,pageHandle.file_hdr->record_size);
+    pageHandle.write_slot(rid.slot_no, buf);
     pageHandle.page->set_page_lsn(lsn);
     buffer_pool_manager_->unpin_page(PageId{fd_,rid.page_no}, true);
 }
@@ -289,9 +454,10 @@ void RmFileHandle::update_record_recover(const Rid& rid, char* buf,lsn_t lsn, in
 /**
  * @description: 获取指定页面的页面句柄
  * @param {int} page_no 页面号
+ * @param {BufferAccessStrategy*} strategy 大范围扫描使用的缓冲区访问策略，为nullptr时按普通方式访问
  * @return {RmPageHandle} 指定页面的句柄
  */
-RmPageHandle RmFileHandle::fetch_page_handle(int page_no) const {
+RmPageHandle RmFileHandle::fetch_page_handle(int page_no, BufferAccessStrategy *strategy) const {
     // Todo: v
     // 使用缓冲池获取指定页面，并生成page_handle返回给上层
     // if page_no is invalid, throw PageNotExistError exception
@@ -301,7 +467,7 @@ RmPageHandle RmFileHandle::fetch_page_handle(int page_no) const {
         throw PageNotExistError("",page_no);
 
     //使用缓冲池获取指定页面
-    Page* page = buffer_pool_manager_->fetch_page(PageId{fd_,page_no});
+    Page* page = buffer_pool_manager_->fetch_page(PageId{fd_,page_no}, strategy);
     //如果page是null
     if(page == nullptr)
         throw PageNotExistError("",page_no);
@@ -329,14 +495,20 @@ RmPageHandle RmFileHandle::create_new_page_handle() {
 
     // 2.更新page handle中的相关信息
     RmPageHandle pageHandle = RmPageHandle(&file_hdr_,page);
-    pageHandle.page_hdr->num_records = 0;
-    pageHandle.page_hdr->next_free_page_no = RM_NO_PAGE;
-    Bitmap::init(pageHandle.bitmap,pageHandle.file_hdr->bitmap_size);
+    if (file_hdr_.is_slotted()) {
+        RmSlottedPage slotted_page(page->get_data());
+        slotted_page.init();
+        slotted_page.hdr()->in_free_list = 1;
+    } else {
+        pageHandle.page_hdr->num_records = 0;
+        pageHandle.page_hdr->next_free_page_no = RM_NO_PAGE;
+        Bitmap::init(pageHandle.bitmap,pageHandle.file_hdr->bitmap_size);
+    }
 
     // 3.更新file_hdr_
     file_hdr_.num_pages++;
     file_hdr_.first_free_page_no = pageHandle.page->get_page_id().page_no;
-    disk_manager_->write_page(fd_, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_)); // 更新之后，需要立即写回磁盘
+    write_file_hdr(); // 更新之后，需要立即写回磁盘
     return pageHandle;
 }
 
@@ -378,5 +550,271 @@ void RmFileHandle::release_page_handle(RmPageHandle&page_handle) {
     }
     page_handle.page_hdr->next_free_page_no = file_hdr_.first_free_page_no;
     file_hdr_.first_free_page_no = page_handle.page->get_page_id().page_no;
-    disk_manager_->write_page(fd_, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_)); // 更新之后，需要立即写回磁盘
-}
\ No newline at end of file
+    write_file_hdr(); // 更新之后，需要立即写回磁盘
+}
+
+/**
+ * @description: 读取记录的视图，页面由guard保持pin住，定长记录不复制
+ */
+RmTupleView RmFileHandle::get_record_view(const Rid &rid, PageGuard *guard, char *decode_buf,
+                                          BufferAccessStrategy *strategy, RmColumnMask cols) const {
+    if (!guard->holds(fd_, rid.page_no)) {
+        // 先释放原页面，扫描的私有帧环中始终只有一个帧被视图占用
+        guard->reset();
+        *guard = PageGuard(buffer_pool_manager_, fetch_page_handle(rid.page_no, strategy).page);
+    }
+    RmPageHandle page_handle(&file_hdr_, guard->get());
+    if (file_hdr_.is_slotted()) {
+        RmSlottedPage page(page_handle.page->get_data());
+        if (!page.is_record(rid.slot_no)) {
+            throw RecordNotFoundError(rid.page_no, rid.slot_no);
+        }
+        int len;
+        RmTupleCodec::decode(file_hdr_, page.get_record(rid.slot_no, &len), decode_buf);
+        return {decode_buf, file_hdr_.record_size};
+    }
+    if (!Bitmap::is_set(page_handle.bitmap, rid.slot_no)) {
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    if (file_hdr_.is_pax()) {
+        page_handle.read_slot(rid.slot_no, decode_buf, cols);
+        return {decode_buf, file_hdr_.record_size};
+    }
+    return {page_handle.get_slot(rid.slot_no), file_hdr_.record_size};
+}
+
+/**
+ * @description: 在一次pin期间取出页面中所有(满足pred的)记录的槽号
+ */
+void RmFileHandle::get_page_slots(int page_no, PageGuard *guard, std::vector<int> *slots,
+                                  const RmRecordPredicate &pred, char *decode_buf,
+                                  BufferAccessStrategy *strategy, RmColumnMask cols) const {
+    slots->clear();
+    if (!guard->holds(fd_, page_no)) {
+        guard->reset();
+        *guard = PageGuard(buffer_pool_manager_, fetch_page_handle(page_no, strategy).page);
+    }
+    RmPageHandle page_handle(&file_hdr_, guard->get());
+    if (file_hdr_.is_slotted()) {
+        RmSlottedPage page(page_handle.page->get_data());
+        for (int slot_no = page.next_record(-1); slot_no < page.num_slots(); slot_no = page.next_record(slot_no)) {
+            if (pred) {
+                int len;
+                RmTupleCodec::decode(file_hdr_, page.get_record(slot_no, &len), decode_buf);
+                if (!pred(decode_buf)) {
+                    continue;
+                }
+            }
+            slots->push_back(slot_no);
+        }
+        return;
+    }
+    int max_n = file_hdr_.num_records_per_page;
+    Bitmap::SetBitIterator iter(page_handle.bitmap, max_n);
+    for (int slot_no = iter.next(); slot_no < max_n; slot_no = iter.next()) {
+        if (pred) {
+            const char *rec = page_handle.get_slot(slot_no);
+            if (file_hdr_.is_pax()) {
+                page_handle.read_slot(slot_no, decode_buf, cols);
+                rec = decode_buf;
+            }
+            if (!pred(rec)) {
+                continue;
+            }
+        }
+        slots->push_back(slot_no);
+    }
+}
+
+/**
+ * @description: 把日志中保存的记录还原为定长记录
+ */
+std::unique_ptr<RmRecord> RmFileHandle::unpack_record(const RmRecord &stored) const {
+    if (!file_hdr_.is_slotted()) {
+        return std::make_unique<RmRecord>(stored);
+    }
+    auto record = std::make_unique<RmRecord>(file_hdr_.record_size);
+    RmTupleCodec::decode(file_hdr_, stored.data, record->data);
+    return record;
+}
+
+/**
+ * @description: 从slotted page中读出记录并还原为定长记录
+ */
+std::unique_ptr<RmRecord> RmFileHandle::get_record_slotted(const Rid &rid) const {
+    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    RmSlottedPage page(page_handle.page->get_data());
+    if (!page.is_record(rid.slot_no)) {
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    int len;
+    char *tuple = page.get_record(rid.slot_no, &len);
+    auto record = std::make_unique<RmRecord>(file_hdr_.record_size);
+    RmTupleCodec::decode(file_hdr_, tuple, record->data);
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+    return record;
+}
+
+/**
+ * @description: 在slotted page中插入一条记录。记录编码后存放在空闲页面链表的第一个页面中，
+ * 链表中的页面能容纳任意一条记录，但记录被更新变长后页面的空间可能不足，这样的页面移出链表
+ */
+Rid RmFileHandle::insert_record_slotted(char *buf, Context *context, std::string *table_name, LogOperation log_op,
+                                        lsn_t undo_next) {
+    char tuple[RM_MAX_RECORD_SIZE + RM_MAX_VAR_COLS * sizeof(uint16_t)];
+    int len = RmTupleCodec::encode(file_hdr_, buf, tuple);
+
+    RmPageHandle page_handle = create_page_handle();
+    RmSlottedPage page(page_handle.page->get_data());
+    while (!page.can_insert(len)) {
+        remove_from_free_list(page);
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+        page_handle = create_page_handle();
+        page = RmSlottedPage(page_handle.page->get_data());
+    }
+    int page_no = page_handle.page->get_page_id().page_no;
+    // 先记录插入前的空闲页面链表，重做时据此恢复文件头
+    int first_free_page_no = file_hdr_.first_free_page_no;
+    int slot_no = page.insert(tuple, len);
+    assert(slot_no >= 0);
+    if (!page.can_insert(file_hdr_.max_tuple_size)) {
+        remove_from_free_list(page);
+    }
+
+    // 日志中保存编码后的记录
+    RmRecord insert_value(len, tuple);
+    auto rid = Rid{page_no, slot_no};
+    auto log_mgr = context->log_mgr_;
+    LogRecord *log_record = nullptr;
+    if (log_op == LogOperation::REDO) {
+        log_record = new InsertLogRecord(context->txn_->getTxnId(), insert_value, rid, *table_name,
+                                         context->txn_->get_prev_lsn(), first_free_page_no, file_hdr_.num_pages);
+    } else {
+        log_record = new CLR_Insert_Record(context->txn_->getTxnId(), insert_value, rid, *table_name,
+                                           context->txn_->get_prev_lsn(), undo_next, first_free_page_no,
+                                           file_hdr_.num_pages);
+    }
+    log_mgr->add_log_to_buffer(log_record);
+    context->txn_->set_prev_lsn(log_record->lsn_);
+    log_mgr->active_txn_table_[context->txn_->getTxnId()] = log_record->lsn_;
+    log_mgr->add_dirty_page(page_handle.page->get_page_id(), log_record->lsn_);
+
+    page_handle.page->set_page_lsn(log_record->lsn_);
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+    return rid;
+}
+
+/**
+ * @description: 删除slotted page中的记录，页面重新能容纳任意一条记录时加入空闲页面链表
+ */
+void RmFileHandle::delete_record_slotted(const Rid &rid, Context *context, std::string *table_name,
+                                         LogOperation log_op, lsn_t undo_next) {
+    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    RmSlottedPage page(page_handle.page->get_data());
+    if (!page.is_record(rid.slot_no)) {
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    int len;
+    char *tuple = page.get_record(rid.slot_no, &len);
+    RmRecord delete_value(len, tuple);
+
+    auto txn = context->txn_;
+    auto log_mgr = context->log_mgr_;
+    LogRecord *log_record = nullptr;
+    if (log_op == LogOperation::REDO) {
+        log_record = new DeleteLogRecord(txn->getTxnId(), delete_value, rid, *table_name, txn->getPrevLsn(),
+                                         file_hdr_.first_free_page_no, file_hdr_.num_pages);
+    } else {
+        log_record = new CLR_Delete_Record(txn->getTxnId(), rid, *table_name, txn->get_prev_lsn(), undo_next,
+                                           file_hdr_.first_free_page_no, file_hdr_.num_pages);
+    }
+    log_mgr->add_log_to_buffer(log_record);
+    txn->set_prev_lsn(log_record->lsn_);
+    log_mgr->active_txn_table_[txn->getTxnId()] = log_record->lsn_;
+    log_mgr->add_dirty_page(page_handle.page->get_page_id(), log_record->lsn_);
+
+    page.erase(rid.slot_no);
+    add_to_free_list(page, rid.page_no);
+    page_handle.page->set_page_lsn(log_record->lsn_);
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+}
+
+/**
+ * @description: 更新slotted page中的记录。页面放不下变长后的记录时，删除原记录并把新记录插入其它页面
+ */
+Rid RmFileHandle::update_record_slotted(const Rid &rid, char *buf, Context *context, std::string *table_name,
+                                        LogOperation log_op, lsn_t undo_next) {
+    char tuple[RM_MAX_RECORD_SIZE + RM_MAX_VAR_COLS * sizeof(uint16_t)];
+    int len = RmTupleCodec::encode(file_hdr_, buf, tuple);
+
+    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    RmSlottedPage page(page_handle.page->get_data());
+    if (!page.is_record(rid.slot_no)) {
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    if (!page.can_update(rid.slot_no, len)) {
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+        delete_record_slotted(rid, context, table_name, log_op, undo_next);
+        return insert_record_slotted(buf, context, table_name, log_op, undo_next);
+    }
+    int old_len;
+    char *old_tuple = page.get_record(rid.slot_no, &old_len);
+    RmRecord before_value(old_len, old_tuple);
+    RmRecord after_value(len, tuple);
+
+    auto tid = context->txn_->getTxnId();
+    LogRecord *log_record = nullptr;
+    if (log_op == LogOperation::REDO) {
+        log_record = new UpdateLogRecord(tid, before_value, after_value, rid, *table_name,
+                                         context->txn_->getPrevLsn(), file_hdr_.first_free_page_no,
+                                         file_hdr_.num_pages);
+    } else {
+        log_record = new CLR_UPDATE_RECORD(tid, before_value, after_value, rid, *table_name,
+                                           context->txn_->getPrevLsn(), undo_next, file_hdr_.first_free_page_no,
+                                           file_hdr_.num_pages);
+    }
+    auto log_mgr = context->log_mgr_;
+    log_mgr->add_log_to_buffer(log_record);
+    context->txn_->set_prev_lsn(log_record->lsn_);
+    log_mgr->active_txn_table_[tid] = log_record->lsn_;
+    log_mgr->add_dirty_page(page_handle.page->get_page_id(), log_record->lsn_);
+
+    page.update(rid.slot_no, tuple, len);
+    add_to_free_list(page, rid.page_no);
+    page_handle.page->set_page_lsn(log_record->lsn_);
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+    return rid;
+}
+
+/**
+ * @description: 把空闲页面链表的第一个页面移出链表
+ */
+void RmFileHandle::remove_from_free_list(RmSlottedPage &page) {
+    file_hdr_.first_free_page_no = page.hdr()->next_free_page_no;
+    page.hdr()->next_free_page_no = RM_NO_PAGE;
+    page.hdr()->in_free_list = 0;
+    write_file_hdr();
+}
+
+/**
+ * @description: 页面不在空闲页面链表中、且已能容纳任意一条记录时，把它加入链表头部
+ */
+void RmFileHandle::add_to_free_list(RmSlottedPage &page, int page_no) {
+    if (page.hdr()->in_free_list || !page.can_insert(file_hdr_.max_tuple_size)) {
+        return;
+    }
+    page.hdr()->next_free_page_no = file_hdr_.first_free_page_no;
+    page.hdr()->in_free_list = 1;
+    file_hdr_.first_free_page_no = page_no;
+    write_file_hdr();
+}
+
+void RmFileHandle::write_file_hdr() {
+    if (defer_hdr_write_) {
+        return;
+    }
+    disk_manager_->write_page(fd_, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
+}
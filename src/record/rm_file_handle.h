@@ -12,15 +12,22 @@ See the Mulan PSL v2 for more details. */
 
 #include <assert.h>
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "bitmap.h"
 #include "common/context.h"
 #include "rm_defs.h"
+#include "rm_slotted_page.h"
 #include "storage/buffer_pool_manager.h"
+#include "storage/page_guard.h"
 
 class RmManager;
 
+/* 在定长形式的记录上求值的谓词，用于在页面被pin住期间筛选记录 */
+using RmRecordPredicate = std::function<bool(const char *)>;
+
 /* 对表数据文件中的页面进行封装 */
 struct RmPageHandle {
     const RmFileHdr *file_hdr;  // 当前页面所在文件的文件头指针
@@ -39,6 +46,43 @@ struct RmPageHandle {
     char* get_slot(int slot_no) const {
         return slots + slot_no * file_hdr->record_size;  // slots的首地址 + slot个数 * 每个slot的大小(每个record的大小)
     }
+
+    // PAX页面中第col列的minipage，各槽位中该列的值按槽号连续存放
+    char* get_minipage(int col) const {
+        return slots + file_hdr->pax_cols[col].offset * file_hdr->num_records_per_page;
+    }
+
+    /**
+     * @description: 把定长记录写入slot_no，PAX页面中各字段分别写入所在列的minipage
+     */
+    void write_slot(int slot_no, const char *buf) const {
+        if (!file_hdr->is_pax()) {
+            memcpy(get_slot(slot_no), buf, file_hdr->record_size);
+            return;
+        }
+        for (int i = 0; i < file_hdr->num_pax_cols; i++) {
+            const RmPaxCol &col = file_hdr->pax_cols[i];
+            memcpy(get_minipage(i) + slot_no * col.len, buf + col.offset, col.len);
+        }
+    }
+
+    /**
+     * @description: 把slot_no中的记录读为定长记录。PAX页面中只读取cols中的字段，buf中其余字段保持原值
+     */
+    void read_slot(int slot_no, char *buf, RmColumnMask cols = RM_ALL_COLUMNS) const {
+        if (!file_hdr->is_pax()) {
+            memcpy(buf, get_slot(slot_no), file_hdr->record_size);
+            return;
+        }
+        if (file_hdr->num_pax_cols < RM_MAX_PAX_COLS) {
+            cols &= (RmColumnMask{1} << file_hdr->num_pax_cols) - 1;
+        }
+        for (; cols != 0; cols &= cols - 1) {
+            int i = __builtin_ctzll(cols);
+            const RmPaxCol &col = file_hdr->pax_cols[i];
+            memcpy(buf + col.offset, get_minipage(i) + slot_no * col.len, col.len);
+        }
+    }
 };
 
 /* 每个RmFileHandle对应一个表的数据文件，里面有多个page，每个page的数据封装在RmPageHandle中 */
@@ -51,6 +95,7 @@ class RmFileHandle {
     BufferPoolManager *buffer_pool_manager_;
     int fd_;        // 打开文件后产生的文件句柄
     RmFileHdr file_hdr_;    // 文件头，维护当前表文件的元数据
+    bool defer_hdr_write_{false};   // 批量插入期间文件头只在结束时写回一次
 
    public:
     RmFileHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd)
@@ -61,6 +106,8 @@ class RmFileHandle {
         disk_manager_->read_page(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
         // disk_manager管理的fd对应的文件中，设置从file_hdr_.num_pages开始分配page_no
         disk_manager_->set_fd2pageno(fd, file_hdr_.num_pages);
+        // 数据页面写回时填入校验和，读入时校验
+        disk_manager_->set_page_checksums(fd, true);
     }
 
     RmFileHdr get_file_hdr() { return file_hdr_; }
@@ -78,22 +125,70 @@ class RmFileHandle {
         return file_hdr_;
     }
 
-    /* 判断指定位置上是否已经存在一条记录，通过Bitmap来判断 */
+    /**
+     * @description: 全表扫描使用的缓冲区访问策略，表相对buffer pool较小时返回nullptr(其页面值得缓存)
+     */
+    std::unique_ptr<BufferAccessStrategy> get_scan_strategy() const {
+        if (!buffer_pool_manager_->should_use_access_strategy(file_hdr_.num_pages)) {
+            return nullptr;
+        }
+        return buffer_pool_manager_->get_access_strategy();
+    }
+
+    /* 判断指定位置上是否已经存在一条记录，通过Bitmap(slotted page中通过槽目录)来判断 */
     bool is_record(const Rid &rid) const {
         RmPageHandle page_handle = fetch_page_handle(rid.page_no);
-        return Bitmap::is_set(page_handle.bitmap, rid.slot_no);  // page的slot_no位置上是否有record
+        bool exists = file_hdr_.is_slotted() ? RmSlottedPage(page_handle.page->get_data()).is_record(rid.slot_no)
+                                             : Bitmap::is_set(page_handle.bitmap, rid.slot_no);  // page的slot_no位置上是否有record
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+        return exists;
     }
 
     std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context) const;
 
+    /**
+     * @description: 不复制地读取记录：guard已经持有rid所在页面时直接使用，否则改为pin该页面。
+     * 定长页面返回指向帧内记录的视图，slotted page和PAX页面中的记录解码到decode_buf(至少record_size字节)。
+     * 视图在guard改为持有其它页面(或decode_buf被覆盖)之前有效
+     * @param strategy 缺页时使用的缓冲区访问策略
+     * @param cols PAX页面中只解码这些字段，视图中其余字段的内容无意义
+     */
+    RmTupleView get_record_view(const Rid &rid, PageGuard *guard, char *decode_buf,
+                                BufferAccessStrategy *strategy = nullptr, RmColumnMask cols = RM_ALL_COLUMNS) const;
+
+    /**
+     * @description: 只访问一次buffer pool，取出页面page_no中所有记录的槽号(按槽号升序)。pred不为空时只保留满足pred的记录，
+     * slotted page和PAX页面中的记录先解码到decode_buf再求值(PAX页面只解码cols中的字段)。
+     * 返回后guard持有该页面，之后用get_record_view读取这些记录不必再次访问buffer pool
+     */
+    void get_page_slots(int page_no, PageGuard *guard, std::vector<int> *slots, const RmRecordPredicate &pred = nullptr,
+                        char *decode_buf = nullptr, BufferAccessStrategy *strategy = nullptr,
+                        RmColumnMask cols = RM_ALL_COLUMNS) const;
+
+    /**
+     * @description: 把日志中保存的记录还原为定长记录：slotted page的日志中保存的是编码后的记录
+     */
+    std::unique_ptr<RmRecord> unpack_record(const RmRecord &stored) const;
+
     Rid insert_record(char *buf, Context *context, std::string* table_name= nullptr,
                       LogOperation log_op = LogOperation::REDO, lsn_t undo_next = INVALID_LSN);
 
+    /**
+     * @description: 批量插入num_records条定长记录(首尾相接存放在bufs中)。逐页填满空闲页面，每个页面只写一条
+     * InsertBatchLogRecord，文件头在全部插入后写回一次
+     * @return {vector<Rid>} 各记录的位置，与bufs中的顺序相同
+     */
+    std::vector<Rid> insert_records(const char *bufs, int num_records, Context *context, std::string *table_name);
+
     void delete_record(const Rid &rid, Context *context, std::string* table_name,
                        LogOperation log_op = LogOperation::REDO, lsn_t undo_next = INVALID_LSN);
 
-    void update_record(const Rid &rid, char *buf, Context *context, std::string* table_name= nullptr,
-                       LogOperation log_op = LogOperation::REDO, lsn_t undo_next = INVALID_LSN);
+    /**
+     * @return {Rid} 更新后记录的位置。slotted page放不下变长后的记录时，记录被删除后重新插入到其它页面，
+     * 返回新的位置；其余情况下与rid相同
+     */
+    Rid update_record(const Rid &rid, char *buf, Context *context, std::string* table_name= nullptr,
+                      LogOperation log_op = LogOperation::REDO, lsn_t undo_next = INVALID_LSN);
 
     /**
      * recover用于redo已有的log(包括clr类型)
@@ -106,13 +201,43 @@ class RmFileHandle {
     void insert_record_recover(const Rid &rid, char *buf, lsn_t lsn, int first_free_page, int num_pages);
     void delete_record_recover(const Rid &rid,lsn_t lsn, int first_free_page, int num_pages);
     void update_record_recover(const Rid &rid, char *buf, lsn_t lsn, int first_free_page, int num_pages);
+    /**
+     * @description: 重做一条InsertBatchLogRecord：把其中的记录插入页面page_no的指定槽中
+     */
+    void insert_records_recover(int page_no, const InsertBatchLogRecord &log, lsn_t lsn);
+
+    /**
+     * @description: 批量插入的文件头在语句结束时才写回，崩溃时磁盘上的num_pages可能小于已写回的页面数，
+     * 重做时据日志补齐，保证撤销时能访问这些页面
+     */
+    void ensure_num_pages(int num_pages);
 
     RmPageHandle create_new_page_handle();
 
-    RmPageHandle fetch_page_handle(int page_no) const;
+    RmPageHandle fetch_page_handle(int page_no, BufferAccessStrategy *strategy = nullptr) const;
 
    private:
     RmPageHandle create_page_handle();
 
     void release_page_handle(RmPageHandle &page_handle);
+
+    std::unique_ptr<RmRecord> get_record_slotted(const Rid &rid) const;
+
+    Rid insert_record_slotted(char *buf, Context *context, std::string *table_name, LogOperation log_op,
+                              lsn_t undo_next);
+
+    void delete_record_slotted(const Rid &rid, Context *context, std::string *table_name, LogOperation log_op,
+                               lsn_t undo_next);
+
+    Rid update_record_slotted(const Rid &rid, char *buf, Context *context, std::string *table_name,
+                              LogOperation log_op, lsn_t undo_next);
+
+    void remove_from_free_list(RmSlottedPage &page);
+
+    void add_to_free_list(RmSlottedPage &page, int page_no);
+
+    /**
+     * @description: 把文件头写回磁盘，批量插入期间推迟到插入结束
+     */
+    void write_file_hdr();
 };
\ No newline at end of file
@@ -30,11 +30,20 @@ class RmManager {
      * @description: 创建表的数据文件并初始化相关信息
      * @param {string&} filename 要创建的文件名称
      * @param {int} record_size 表中记录的大小
+     * @param {vector<RmVarCol>&} var_cols 记录中的VARCHAR字段，不为空时数据文件使用slotted page
+     * @param {vector<RmPaxCol>&} pax_cols 记录中的全部字段(按offset升序)，不为空时数据文件使用PAX页面，此时忽略var_cols
      */ 
-    void create_file(const std::string& filename, int record_size) {
+    void create_file(const std::string& filename, int record_size, const std::vector<RmVarCol>& var_cols = {},
+                     const std::vector<RmPaxCol>& pax_cols = {}) {
         if (record_size < 1 || record_size > RM_MAX_RECORD_SIZE) {
             throw InvalidRecordSizeError(record_size);
         }
+        if (var_cols.size() > RM_MAX_VAR_COLS) {
+            throw InternalError("Too many VARCHAR columns");
+        }
+        if (pax_cols.size() > RM_MAX_PAX_COLS) {
+            throw InternalError("Too many columns for PAX table");
+        }
         disk_manager_->create_file(filename);
         int fd = disk_manager_->open_file(filename);
 
@@ -43,13 +52,28 @@ class RmManager {
         file_hdr.record_size = record_size;
         file_hdr.num_pages = 1;
         file_hdr.first_free_page_no = RM_NO_PAGE;
-        // We have: sizeof(hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
+        // We have: OFFSET_PAGE_HDR + sizeof(hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
+        int page_hdr_size = static_cast<int>(Page::OFFSET_PAGE_HDR + sizeof(RmPageHdr));
         file_hdr.num_records_per_page =
-            (BITMAP_WIDTH * (PAGE_SIZE - 1 - (int)sizeof(RmFileHdr)) + 1) / (1 + record_size * BITMAP_WIDTH); // check(AntiO2) 是否正确
+            (BITMAP_WIDTH * (PAGE_SIZE - 1 - page_hdr_size) + 1) / (1 + record_size * BITMAP_WIDTH);
         file_hdr.bitmap_size = (file_hdr.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+        if (!pax_cols.empty()) {
+            // 槽位区按列划分，页面容量与定长槽位相同
+            file_hdr.page_format = RM_PAX;
+            file_hdr.num_pax_cols = static_cast<int>(pax_cols.size());
+            std::copy(pax_cols.begin(), pax_cols.end(), file_hdr.pax_cols);
+        } else if (!var_cols.empty()) {
+            // 记录按实际长度存放在slotted page中，每页能存放的记录数不固定
+            file_hdr.page_format = RM_SLOTTED;
+            file_hdr.num_records_per_page = 0;
+            file_hdr.bitmap_size = 0;
+            file_hdr.num_var_cols = static_cast<int>(var_cols.size());
+            std::copy(var_cols.begin(), var_cols.end(), file_hdr.var_cols);
+            file_hdr.max_tuple_size = record_size + file_hdr.num_var_cols * static_cast<int>(sizeof(uint16_t));
+        }
         // 将file header写入磁盘文件（名为file name，文件描述符为fd）中的第0页
         // head page直接写入磁盘，没有经过缓冲区的NewPage，那么也就不需要FlushPage
-        disk_manager_->write_page(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr, PAGE_SIZE);
+        disk_manager_->write_page(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr, sizeof(file_hdr));
         disk_manager_->close_file(fd);
     }
 
@@ -9,13 +9,25 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "rm_scan.h"
+
+#include <algorithm>
+
 #include "rm_file_handle.h"
 
 /**
  * @brief 初始化file_handle和rid
  * @param file_handle
+ * @param strategy 大表扫描使用的缓冲区访问策略，扫描的页面只占用其私有帧环
+ * @param pred 不为空时只返回满足pred的记录
+ * @param cols pred用到的字段
  */
-RmScan::RmScan(const RmFileHandle *file_handle) : file_handle_(file_handle) {
+RmScan::RmScan(const RmFileHandle *file_handle, BufferAccessStrategy *strategy, RmRecordPredicate pred,
+               RmColumnMask cols)
+    : file_handle_(file_handle), strategy_(strategy), prefetched_until_(RM_FIRST_RECORD_PAGE), pred_(std::move(pred)),
+      cols_(cols) {
+    if (pred_ && (file_handle_->file_hdr_.is_slotted() || file_handle_->file_hdr_.is_pax())) {
+        decode_buf_.resize(file_handle_->file_hdr_.record_size);
+    }
     // 初始化file_handle和rid（指向第一个存放了记录的位置）
 
     //初始化
@@ -27,30 +39,47 @@ RmScan::RmScan(const RmFileHandle *file_handle) : file_handle_(file_handle) {
 }
 
 /**
- * @brief 找到文件中下一个存放了记录的位置
+ * @brief 找到文件中下一个存放了(满足条件的)记录的位置。进入一个页面时pin住页面并一次取出其中所有记录的槽号，
+ * 之后在同一页面内前进不必再访问buffer pool
  */
 void RmScan::next() {
-    // 找到文件中下一个存放了记录的非空闲位置，用rid_来指向这个位置
-
-    //遍历页
-    for(int page_no = rid_.page_no; page_no < file_handle_->file_hdr_.num_pages;page_no++)
-    {
-        RmPageHandle pageHandle = file_handle_->fetch_page_handle(page_no);
-        int ret = Bitmap::next_bit(true, pageHandle.bitmap, file_handle_->file_hdr_.num_records_per_page,rid_.slot_no);
-        if(ret != file_handle_->file_hdr_.num_records_per_page)
-        {
-            rid_.page_no = page_no;
-            rid_.slot_no = ret;
-            file_handle_->buffer_pool_manager_->unpin_page(PageId{file_handle_->fd_,page_no}, false);
+    if (rid_.page_no == RM_NO_PAGE) {
+        return;
+    }
+    if (slot_idx_ + 1 < slots_.size()) {
+        rid_.slot_no = slots_[++slot_idx_];
+        return;
+    }
+    // 当前页面已经扫描完，遍历之后的页面
+    int page_no = rid_.slot_no == -1 ? rid_.page_no : rid_.page_no + 1;
+    for (; page_no < file_handle_->file_hdr_.num_pages; page_no++) {
+        prefetch(page_no);
+        file_handle_->get_page_slots(page_no, &page_guard_, &slots_, pred_, decode_buf_.data(), strategy_, cols_);
+        if (!slots_.empty()) {
+            slot_idx_ = 0;
+            rid_ = Rid{page_no, slots_[0]};
             return;
         }
-        file_handle_->buffer_pool_manager_->unpin_page(PageId{file_handle_->fd_,page_no}, false);
-        //下一轮又是从-1开始
-        rid_.slot_no = -1;
     }
     //未找到存放记录的非空闲位置
     rid_.page_no = RM_NO_PAGE;
     rid_.slot_no = -1;
+    page_guard_.reset();
+}
+
+/**
+ * @brief 扫描到page_no时，若已预读的页面不足READAHEAD_PAGES/2，则预读之后的READAHEAD_PAGES个页面
+ */
+void RmScan::prefetch(int page_no) {
+    if (prefetched_until_ - page_no > READAHEAD_PAGES / 2) {
+        return;
+    }
+    int start = std::max(prefetched_until_, page_no + 1);
+    int end = std::min(file_handle_->file_hdr_.num_pages, page_no + 1 + READAHEAD_PAGES);
+    if (start < end) {
+        file_handle_->buffer_pool_manager_->prefetch_pages(file_handle_->fd_, start, end - start, strategy_);
+    }
+    prefetched_until_ = std::max(prefetched_until_, end);
 }
 
 /**
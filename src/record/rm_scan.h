@@ -10,19 +10,40 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
-#include "rm_defs.h"
+#include <vector>
 
-class RmFileHandle;
+#include "rm_defs.h"
+#include "rm_file_handle.h"
 
 class RmScan : public RecScan {
     const RmFileHandle *file_handle_;
     Rid rid_;
+    BufferAccessStrategy *strategy_;    // 缺页时使用的访问策略，为nullptr时按普通方式访问
+    int prefetched_until_;              // [.., prefetched_until_)之间的页面已经发出了预读请求
+    std::vector<int> slots_;            // 当前页面中(满足pred_的)记录的槽号，进入页面时一次取出
+    size_t slot_idx_{0};                // rid_在slots_中的下标
+    RmRecordPredicate pred_;            // 记录需要满足的条件，为空时返回所有记录
+    std::vector<char> decode_buf_;      // slotted page和PAX页面中的记录解码到这里再对pred_求值
+    RmColumnMask cols_;                 // PAX页面中对pred_求值时需要解码的字段
+    PageGuard page_guard_;              // 扫描到的当前页面保持pin住，直到进入下一个页面
+
+    void prefetch(int page_no);
 public:
-    RmScan(const RmFileHandle *file_handle);
+    /**
+     * @param pred 不为空时只返回满足pred的记录，在页面被pin住期间一次求值
+     * @param cols pred用到的字段，PAX页面中只解码这些字段
+     */
+    RmScan(const RmFileHandle *file_handle, BufferAccessStrategy *strategy = nullptr, RmRecordPredicate pred = nullptr,
+           RmColumnMask cols = RM_ALL_COLUMNS);
 
     void next() override;
 
     bool is_end() const override;
 
     Rid rid() const override;
+
+    /**
+     * @description: 持有当前记录所在页面的guard，传给RmFileHandle::get_record_view可以不再访问buffer pool
+     */
+    PageGuard *page_guard() { return &page_guard_; }
 };
@@ -0,0 +1,266 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "rm_defs.h"
+#include "storage/page.h"
+
+/* slotted page的页头，位于Page::OFFSET_PAGE_HDR处，前两个字段与RmPageHdr相同 */
+struct RmSlottedPageHdr {
+    int next_free_page_no{-1};  // 空闲页面链表中的下一个页面
+    int num_records{0};         // 页面中的记录个数
+    uint16_t num_slots{0};      // 槽目录中的槽数(包括空槽)，末尾的空槽会被回收
+    uint16_t data_begin{0};     // 记录区的起始偏移，记录从页尾向前存放
+    uint16_t frag_size{0};      // 记录区中被删除或缩短的记录留下的空洞总大小，整理页面后可回收
+    uint16_t in_free_list{0};   // 页面是否在文件的空闲页面链表中
+};
+
+/* 槽目录项，offset为0表示空槽 */
+struct RmSlot {
+    uint16_t offset;
+    uint16_t len;
+};
+
+/**
+ * @description: slotted page：页头之后是向后增长的槽目录，记录从页尾向前存放，两者之间是空闲空间。
+ * 记录号(Rid.slot_no)是槽号，记录在页内移动(整理碎片)时只修改槽中的offset，因此Rid保持不变。
+ * 只操作页面数据，不负责pin/unpin和日志
+ */
+class RmSlottedPage {
+   public:
+    explicit RmSlottedPage(char *data)
+        : data_(data),
+          hdr_(reinterpret_cast<RmSlottedPageHdr *>(data + Page::OFFSET_PAGE_HDR)),
+          slots_(reinterpret_cast<RmSlot *>(data + Page::OFFSET_PAGE_HDR + sizeof(RmSlottedPageHdr))) {}
+
+    void init() {
+        *hdr_ = RmSlottedPageHdr{};
+        hdr_->data_begin = static_cast<uint16_t>(PAGE_SIZE);
+    }
+
+    RmSlottedPageHdr *hdr() const { return hdr_; }
+
+    int num_slots() const { return hdr_->num_slots; }
+
+    bool is_record(int slot_no) const {
+        return slot_no >= 0 && slot_no < hdr_->num_slots && slots_[slot_no].offset != 0;
+    }
+
+    char *get_record(int slot_no, int *len) const {
+        *len = slots_[slot_no].len;
+        return data_ + slots_[slot_no].offset;
+    }
+
+    /**
+     * @description: 槽号大于slot_no的第一条记录，没有时返回num_slots()
+     */
+    int next_record(int slot_no) const {
+        for (int i = slot_no + 1; i < hdr_->num_slots; i++) {
+            if (slots_[i].offset != 0) {
+                return i;
+            }
+        }
+        return hdr_->num_slots;
+    }
+
+    /**
+     * @description: 能否再插入一条长度为len的记录(需要时先整理碎片)
+     */
+    bool can_insert(int len) const { return free_space() >= len + static_cast<int>(sizeof(RmSlot)); }
+
+    /**
+     * @description: 插入一条记录，优先复用槽号最小的空槽
+     * @return {int} 槽号，空间不足时返回-1
+     */
+    int insert(const char *buf, int len) {
+        int slot_no = 0;
+        while (slot_no < hdr_->num_slots && slots_[slot_no].offset != 0) {
+            slot_no++;
+        }
+        int need = len + (slot_no == hdr_->num_slots ? static_cast<int>(sizeof(RmSlot)) : 0);
+        if (free_space() < need) {
+            return -1;
+        }
+        insert_at(slot_no, buf, len);
+        return slot_no;
+    }
+
+    /**
+     * @description: 在指定的空槽插入记录，用于重做日志；调用者保证空间足够
+     */
+    void insert_at(int slot_no, const char *buf, int len) {
+        int new_slots = std::max(slot_no + 1, static_cast<int>(hdr_->num_slots));
+        int need = len + (new_slots - hdr_->num_slots) * static_cast<int>(sizeof(RmSlot));
+        if (contiguous_space() < need) {
+            compact();
+        }
+        for (int i = hdr_->num_slots; i < new_slots; i++) {
+            slots_[i] = RmSlot{0, 0};
+        }
+        hdr_->num_slots = static_cast<uint16_t>(new_slots);
+        place(slot_no, buf, len);
+        hdr_->num_records++;
+    }
+
+    /**
+     * @description: 删除记录，其空间成为空洞；末尾的空槽从槽目录中回收
+     */
+    void erase(int slot_no) {
+        hdr_->frag_size = static_cast<uint16_t>(hdr_->frag_size + slots_[slot_no].len);
+        slots_[slot_no] = RmSlot{0, 0};
+        while (hdr_->num_slots > 0 && slots_[hdr_->num_slots - 1].offset == 0) {
+            hdr_->num_slots--;
+        }
+        hdr_->num_records--;
+    }
+
+    /**
+     * @description: 把记录更新为长度为len的新值后页面能否容纳
+     */
+    bool can_update(int slot_no, int len) const { return len <= slots_[slot_no].len + free_space(); }
+
+    /**
+     * @description: 更新记录，新值不比原值长时原地覆盖，否则释放原值后重新存放；调用者先用can_update检查
+     */
+    void update(int slot_no, const char *buf, int len) {
+        RmSlot &slot = slots_[slot_no];
+        if (len <= slot.len) {
+            memcpy(data_ + slot.offset, buf, len);
+            hdr_->frag_size = static_cast<uint16_t>(hdr_->frag_size + slot.len - len);
+            slot.len = static_cast<uint16_t>(len);
+            return;
+        }
+        hdr_->frag_size = static_cast<uint16_t>(hdr_->frag_size + slot.len);
+        slot = RmSlot{0, 0};
+        if (contiguous_space() < len) {
+            compact();
+        }
+        place(slot_no, buf, len);
+    }
+
+    /**
+     * @description: 页面中可用的空间，包括空洞
+     */
+    int free_space() const { return contiguous_space() + hdr_->frag_size; }
+
+    /**
+     * @description: 整理碎片：把所有记录按原有顺序紧密地移动到页尾，空洞并入中间的空闲空间
+     */
+    void compact() {
+        std::vector<int> order;
+        order.reserve(hdr_->num_slots);
+        for (int i = 0; i < hdr_->num_slots; i++) {
+            if (slots_[i].offset != 0) {
+                order.push_back(i);
+            }
+        }
+        // 从位于最后的记录开始向页尾移动，目标区域不会覆盖尚未移动的记录
+        std::sort(order.begin(), order.end(),
+                  [this](int a, int b) { return slots_[a].offset > slots_[b].offset; });
+        int end = PAGE_SIZE;
+        for (int slot_no : order) {
+            RmSlot &slot = slots_[slot_no];
+            end -= slot.len;
+            memmove(data_ + end, data_ + slot.offset, slot.len);
+            slot.offset = static_cast<uint16_t>(end);
+        }
+        hdr_->data_begin = static_cast<uint16_t>(end);
+        hdr_->frag_size = 0;
+    }
+
+   private:
+    int contiguous_space() const {
+        int dir_end = static_cast<int>(Page::OFFSET_PAGE_HDR + sizeof(RmSlottedPageHdr) +
+                                       hdr_->num_slots * sizeof(RmSlot));
+        return hdr_->data_begin - dir_end;
+    }
+
+    void place(int slot_no, const char *buf, int len) {
+        hdr_->data_begin = static_cast<uint16_t>(hdr_->data_begin - len);
+        memcpy(data_ + hdr_->data_begin, buf, len);
+        slots_[slot_no] = RmSlot{hdr_->data_begin, static_cast<uint16_t>(len)};
+    }
+
+    char *data_;
+    RmSlottedPageHdr *hdr_;
+    RmSlot *slots_;
+};
+
+/**
+ * @description: 记录在slotted page中的编码：定长字段原样保存，每个VARCHAR字段保存为
+ * 2字节长度 + 去掉末尾0之后的内容。编码后最长为record_size + 2 * num_var_cols
+ */
+struct RmTupleCodec {
+    /**
+     * @return {int} 编码后的长度
+     */
+    static int encode(const RmFileHdr &hdr, const char *rec, char *out) {
+        int pos = 0;
+        int out_len = 0;
+        for (int i = 0; i < hdr.num_var_cols; i++) {
+            const RmVarCol &col = hdr.var_cols[i];
+            memcpy(out + out_len, rec + pos, col.offset - pos);
+            out_len += col.offset - pos;
+            uint16_t len = static_cast<uint16_t>(col.len);
+            while (len > 0 && rec[col.offset + len - 1] == 0) {
+                len--;
+            }
+            memcpy(out + out_len, &len, sizeof(len));
+            memcpy(out + out_len + sizeof(len), rec + col.offset, len);
+            out_len += static_cast<int>(sizeof(len)) + len;
+            pos = col.offset + col.len;
+        }
+        memcpy(out + out_len, rec + pos, hdr.record_size - pos);
+        return out_len + hdr.record_size - pos;
+    }
+
+    /**
+     * @description: 把编码后的记录还原为record_size字节的定长记录，VARCHAR字段以0补齐
+     */
+    static void decode(const RmFileHdr &hdr, const char *tuple, char *rec) {
+        int pos = 0;
+        int in_pos = 0;
+        for (int i = 0; i < hdr.num_var_cols; i++) {
+            const RmVarCol &col = hdr.var_cols[i];
+            memcpy(rec + pos, tuple + in_pos, col.offset - pos);
+            in_pos += col.offset - pos;
+            uint16_t len;
+            memcpy(&len, tuple + in_pos, sizeof(len));
+            memcpy(rec + col.offset, tuple + in_pos + sizeof(len), len);
+            memset(rec + col.offset + len, 0, col.len - len);
+            in_pos += static_cast<int>(sizeof(len)) + len;
+            pos = col.offset + col.len;
+        }
+        memcpy(rec + pos, tuple + in_pos, hdr.record_size - pos);
+    }
+
+    /**
+     * @description: 编码后记录的长度
+     */
+    static int size(const RmFileHdr &hdr, const char *tuple) {
+        int pos = 0;
+        int in_pos = 0;
+        for (int i = 0; i < hdr.num_var_cols; i++) {
+            const RmVarCol &col = hdr.var_cols[i];
+            in_pos += col.offset - pos;
+            uint16_t len;
+            memcpy(&len, tuple + in_pos, sizeof(len));
+            in_pos += static_cast<int>(sizeof(len)) + len;
+            pos = col.offset + col.len;
+        }
+        return in_pos + hdr.record_size - pos;
+    }
+};
@@ -54,7 +54,7 @@ void LogManager::flush_log_to_disk() {
     // 将日志缓冲区中的内容写入磁盘中
     disk_manager_->write_log(log_buffer_.buffer_, log_buffer_.offset_);
     // 更新 flushed_lsn_
-    flushed_lsn_ = global_lsn_;
+    flushed_lsn_ = global_lsn_.load();
     // 重置日志缓冲区
     log_buffer_.offset_ = 0;
     memset(log_buffer_.buffer_, 0, sizeof(log_buffer_.buffer_));
@@ -173,10 +173,38 @@ std::list<std::unique_ptr<LogRecord>> LogManager::get_records() {
                     records.emplace_back(std::make_unique<CkptEndLogRecord>(record));
                     break;
                 }
+                case INSERT_BATCH: {
+                    InsertBatchLogRecord record(log_buffer_.buffer_+current_offset);
+                    record.format_print();
+                    current_offset += record.log_tot_len_;
+                    records.emplace_back(std::make_unique<InsertBatchLogRecord>(record));
+                    break;
+                }
+                case IX_INSERT:
+                case IX_DELETE:
+                case IX_CLR_INSERT:
+                case IX_CLR_DELETE: {
+                    IxEntryLogRecord record(log_buffer_.buffer_+current_offset);
+                    record.format_print();
+                    current_offset += record.log_tot_len_;
+                    records.emplace_back(std::make_unique<IxEntryLogRecord>(record));
+                    break;
+                }
+                case IX_SPLIT:
+                case IX_MERGE: {
+                    IxSmoLogRecord record(log_buffer_.buffer_+current_offset);
+                    record.format_print();
+                    current_offset += record.log_tot_len_;
+                    records.emplace_back(std::make_unique<IxSmoLogRecord>(record));
+                    break;
+                }
             }
         }
         current_offset_ = prev_offset_ + current_offset;
     }
+    // 缓冲区中还留着最后读出的日志，清空后恢复期间新写的日志才不会把它们重复追加到日志文件
+    log_buffer_.offset_ = 0;
+    memset(log_buffer_.buffer_, 0, sizeof(log_buffer_.buffer_));
 
     return records;
 }
@@ -32,7 +32,14 @@ enum LogType: int {
     CLR_DELETE,
     CLR_UPDATE,
     CKPT_BEGIN,
-    CKPT_END // fuzzy checkpoint end
+    CKPT_END, // fuzzy checkpoint end
+    INSERT_BATCH, // 同一页面上的多条insert
+    IX_INSERT,    // 在索引叶子结点中插入一个键值对
+    IX_DELETE,    // 在索引叶子结点中删除一个键值对
+    IX_CLR_INSERT, // 撤销IX_DELETE时写的补偿记录
+    IX_CLR_DELETE, // 撤销IX_INSERT时写的补偿记录
+    IX_SPLIT,     // 索引结点分裂(及空树上建立根结点)，只需重做
+    IX_MERGE      // 索引结点合并、重分配或根结点下降，只需重做
 };
 static std::string LogTypeStr[] = {
     "UPDATE",
@@ -45,7 +52,14 @@ static std::string LogTypeStr[] = {
     "CLR_DELETE",
     "CLR_UPDATE",
     "CKPT_BEGIN",
-    "CKPT_END"
+    "CKPT_END",
+    "INSERT_BATCH",
+    "IX_INSERT",
+    "IX_DELETE",
+    "IX_CLR_INSERT",
+    "IX_CLR_DELETE",
+    "IX_SPLIT",
+    "IX_MERGE"
 };
 enum LogOperation {
     REDO,
@@ -738,6 +752,363 @@ public:
         }
     }
 };
+/**
+ * @description: 批量插入时一个页面上的所有插入合并为一条日志，依次保存各记录的槽号、长度和数据。
+ * 撤销时逐条删除，产生的CLR与单条插入相同
+ */
+class InsertBatchLogRecord: public LogRecord {
+public:
+    InsertBatchLogRecord() {
+        log_type_ = LogType::INSERT_BATCH;
+        lsn_ = INVALID_LSN;
+        log_tot_len_ = LOG_HEADER_SIZE;
+        log_tid_ = INVALID_TXN_ID;
+        prev_lsn_ = INVALID_LSN;
+        table_name_ = nullptr;
+    }
+    InsertBatchLogRecord(char *src) {
+        deserialize(src);
+    }
+    InsertBatchLogRecord(txn_id_t txn_id, int page_no, const std::string& table_name, lsn_t prev_lsn, int first_free_page_no, int num_page)
+        : InsertBatchLogRecord() {
+        log_tid_ = txn_id;
+        prev_lsn_ = prev_lsn;
+        page_no_ = page_no;
+        log_tot_len_ += sizeof(int) * 2;    // page_no和记录条数
+
+        table_name_size_ = table_name.length();
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, table_name.c_str(), table_name_size_);
+        log_tot_len_ += sizeof(size_t) + table_name_size_;
+
+        first_free_page_no_ = first_free_page_no;
+        log_tot_len_ += sizeof(first_free_page_no);
+        num_pages_ = num_page;
+        log_tot_len_ += sizeof(num_page);
+    }
+
+    /**
+     * @description: 追加一条插入到槽slot_no中的记录
+     */
+    void add_tuple(int slot_no, const char *data, int len) {
+        slot_nos_.push_back(slot_no);
+        offsets_.push_back(static_cast<int>(data_.size()));
+        lens_.push_back(len);
+        data_.insert(data_.end(), data, data + len);
+        log_tot_len_ += sizeof(int) * 2 + len;
+    }
+
+    int num_tuples() const { return static_cast<int>(slot_nos_.size()); }
+
+    const char *tuple(int i) const { return data_.data() + offsets_[i]; }
+
+    // 把批量insert日志记录序列化到dest中
+    void serialize(char* dest) const override {
+        LogRecord::serialize(dest);
+        int offset = OFFSET_LOG_DATA;
+        int num = num_tuples();
+        memcpy(dest + offset, &page_no_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &num, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, slot_nos_.data(), num * sizeof(int));
+        offset += num * sizeof(int);
+        memcpy(dest + offset, lens_.data(), num * sizeof(int));
+        offset += num * sizeof(int);
+        memcpy(dest + offset, data_.data(), data_.size());
+        offset += data_.size();
+        memcpy(dest + offset, &table_name_size_, sizeof(size_t));
+        offset += sizeof(size_t);
+        memcpy(dest + offset, table_name_, table_name_size_);
+
+        offset += table_name_size_;
+        memcpy(dest + offset, &first_free_page_no_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &num_pages_, sizeof(int));
+    }
+    // 从src中反序列化出一条批量insert日志记录
+    void deserialize(const char* src) override {
+        LogRecord::deserialize(src);
+        int offset = OFFSET_LOG_DATA;
+        page_no_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        int num = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        slot_nos_.assign(reinterpret_cast<const int*>(src + offset), reinterpret_cast<const int*>(src + offset) + num);
+        offset += num * sizeof(int);
+        lens_.assign(reinterpret_cast<const int*>(src + offset), reinterpret_cast<const int*>(src + offset) + num);
+        offset += num * sizeof(int);
+        offsets_.clear();
+        int data_size = 0;
+        for (int len : lens_) {
+            offsets_.push_back(data_size);
+            data_size += len;
+        }
+        data_.assign(src + offset, src + offset + data_size);
+        offset += data_size;
+        table_name_size_ = *reinterpret_cast<const size_t*>(src + offset);
+        offset += sizeof(size_t);
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, src + offset, table_name_size_);
+
+        offset += table_name_size_;
+        first_free_page_no_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        num_pages_ = *reinterpret_cast<const int*>(src + offset);
+    }
+    void format_print() override {
+        if(ARIES_DEBUG_MODE) {
+            LogRecord::format_print();
+            LOG_DEBUG("%s", fmt::format("table name: {}\n"
+                                        "insert page: {}\n"
+                                        "num_tuples: {}\n"
+                                        "first_free_page: {}\n"
+                                        "num_pages:{}", std::string(table_name_, table_name_size_), page_no_,
+                                        num_tuples(), first_free_page_no_, num_pages_).c_str());
+        }
+    }
+
+    int page_no_;                   // 记录插入的页面
+    std::vector<int> slot_nos_;     // 各记录的槽号
+    std::vector<int> lens_;         // 各记录的长度
+    std::vector<int> offsets_;      // 各记录在data_中的偏移
+    std::vector<char> data_;        // 各记录的数据，首尾相接
+    char* table_name_;              // 插入记录的表名称
+    size_t table_name_size_;        // 表名称的大小
+
+    /**
+     * file_hdr的内容
+     */
+    int first_free_page_no_;
+    int num_pages_;
+};
+/**
+ * @description: 索引叶子结点中一个键值对的插入或删除(IX_INSERT/IX_DELETE)。重做时在page_no结点中按键定位后插入或删除；
+ * 撤销时在整棵树上删除或插入该键，此时结点可能已经分裂或合并。撤销时写的补偿记录类型为IX_CLR_INSERT/IX_CLR_DELETE，
+ * undo_next_指向下一条要撤销的日志
+ */
+class IxEntryLogRecord: public LogRecord {
+public:
+    IxEntryLogRecord() {
+        log_type_ = LogType::IX_INSERT;
+        lsn_ = INVALID_LSN;
+        log_tot_len_ = LOG_HEADER_SIZE;
+        log_tid_ = INVALID_TXN_ID;
+        prev_lsn_ = INVALID_LSN;
+        undo_next_ = INVALID_LSN;
+    }
+    IxEntryLogRecord(char *src) {
+        deserialize(src);
+    }
+    IxEntryLogRecord(LogType log_type, txn_id_t txn_id, const std::string& index_name, int page_no, const char *key,
+                     int key_len, const Rid& rid, lsn_t prev_lsn, lsn_t undo_next)
+        : IxEntryLogRecord() {
+        log_type_ = log_type;
+        log_tid_ = txn_id;
+        prev_lsn_ = prev_lsn;
+        page_no_ = page_no;
+        rid_ = rid;
+        undo_next_ = undo_next;
+        log_tot_len_ += sizeof(int) + sizeof(Rid) + sizeof(lsn_t);
+
+        key_.assign(key, key + key_len);
+        log_tot_len_ += sizeof(int) + key_len;
+
+        index_name_ = index_name;
+        log_tot_len_ += sizeof(size_t) + index_name_.size();
+    }
+    // 把索引键值对日志记录序列化到dest中
+    void serialize(char* dest) const override {
+        LogRecord::serialize(dest);
+        int offset = OFFSET_LOG_DATA;
+        memcpy(dest + offset, &page_no_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &rid_, sizeof(Rid));
+        offset += sizeof(Rid);
+        memcpy(dest + offset, &undo_next_, sizeof(lsn_t));
+        offset += sizeof(lsn_t);
+        int key_len = static_cast<int>(key_.size());
+        memcpy(dest + offset, &key_len, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, key_.data(), key_len);
+        offset += key_len;
+        size_t index_name_size = index_name_.size();
+        memcpy(dest + offset, &index_name_size, sizeof(size_t));
+        offset += sizeof(size_t);
+        memcpy(dest + offset, index_name_.data(), index_name_size);
+    }
+    // 从src中反序列化出一条索引键值对日志记录
+    void deserialize(const char* src) override {
+        LogRecord::deserialize(src);
+        int offset = OFFSET_LOG_DATA;
+        page_no_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        rid_ = *reinterpret_cast<const Rid*>(src + offset);
+        offset += sizeof(Rid);
+        undo_next_ = *reinterpret_cast<const lsn_t*>(src + offset);
+        offset += sizeof(lsn_t);
+        int key_len = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        key_.assign(src + offset, src + offset + key_len);
+        offset += key_len;
+        size_t index_name_size = *reinterpret_cast<const size_t*>(src + offset);
+        offset += sizeof(size_t);
+        index_name_.assign(src + offset, index_name_size);
+    }
+    void format_print() override {
+        if(ARIES_DEBUG_MODE) {
+            LogRecord::format_print();
+            LOG_DEBUG("%s", fmt::format("index name: {}\n"
+                                        "page: {}\n"
+                                        "rid: {} {}\n"
+                                        "undo_next: {}", index_name_, page_no_,
+                                        rid_.page_no, rid_.slot_no, undo_next_).c_str());
+        }
+    }
+
+    int page_no_;                   // 插入或删除键值对的叶子结点
+    std::vector<char> key_;         // 索引键
+    Rid rid_;                       // 键对应的记录位置
+    lsn_t undo_next_;               // 补偿记录中下一条要撤销的日志，其余类型为INVALID_LSN
+    std::string index_name_;        // 索引文件名
+};
+
+/**
+ * @description: 索引的一次结构修改(IX_SPLIT/IX_MERGE)，记录修改后各结点的映像和释放的结点，以及文件头中的根结点、
+ * 首尾叶子和页面个数。结点映像由IxPageHdr和结点中的有效键值对组成，只修改了父结点等页头字段的结点只记录IxPageHdr。
+ * 结构修改与事务的提交或回滚无关，不加入事务的日志链，只重做不撤销
+ */
+class IxSmoLogRecord: public LogRecord {
+public:
+    IxSmoLogRecord() {
+        log_type_ = LogType::IX_SPLIT;
+        lsn_ = INVALID_LSN;
+        log_tot_len_ = LOG_HEADER_SIZE;
+        log_tid_ = INVALID_TXN_ID;
+        prev_lsn_ = INVALID_LSN;
+    }
+    IxSmoLogRecord(char *src) {
+        deserialize(src);
+    }
+    IxSmoLogRecord(LogType log_type, txn_id_t txn_id, const std::string& index_name) : IxSmoLogRecord() {
+        log_type_ = log_type;
+        log_tid_ = txn_id;
+        log_tot_len_ += sizeof(int) * 6;    // 文件头的4个字段，结点个数和释放的结点个数
+
+        index_name_ = index_name;
+        log_tot_len_ += sizeof(size_t) + index_name_.size();
+    }
+
+    /**
+     * @description: 追加页号为page_no的结点修改后的映像
+     */
+    void add_node(int page_no, const char *image, int len) {
+        page_nos_.push_back(page_no);
+        offsets_.push_back(static_cast<int>(data_.size()));
+        lens_.push_back(len);
+        data_.insert(data_.end(), image, image + len);
+        log_tot_len_ += sizeof(int) * 2 + len;
+    }
+
+    void add_freed_page(int page_no) {
+        freed_pages_.push_back(page_no);
+        log_tot_len_ += sizeof(int);
+    }
+
+    void set_file_hdr(int root_page, int first_leaf, int last_leaf, int num_pages) {
+        root_page_ = root_page;
+        first_leaf_ = first_leaf;
+        last_leaf_ = last_leaf;
+        num_pages_ = num_pages;
+    }
+
+    int num_nodes() const { return static_cast<int>(page_nos_.size()); }
+
+    const char *node(int i) const { return data_.data() + offsets_[i]; }
+
+    // 把索引结构修改日志记录序列化到dest中
+    void serialize(char* dest) const override {
+        LogRecord::serialize(dest);
+        int offset = OFFSET_LOG_DATA;
+        int hdr[4] = {root_page_, first_leaf_, last_leaf_, num_pages_};
+        memcpy(dest + offset, hdr, sizeof(hdr));
+        offset += sizeof(hdr);
+        int num = num_nodes();
+        memcpy(dest + offset, &num, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, page_nos_.data(), num * sizeof(int));
+        offset += num * sizeof(int);
+        memcpy(dest + offset, lens_.data(), num * sizeof(int));
+        offset += num * sizeof(int);
+        memcpy(dest + offset, data_.data(), data_.size());
+        offset += data_.size();
+        int num_freed = static_cast<int>(freed_pages_.size());
+        memcpy(dest + offset, &num_freed, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, freed_pages_.data(), num_freed * sizeof(int));
+        offset += num_freed * sizeof(int);
+        size_t index_name_size = index_name_.size();
+        memcpy(dest + offset, &index_name_size, sizeof(size_t));
+        offset += sizeof(size_t);
+        memcpy(dest + offset, index_name_.data(), index_name_size);
+    }
+    // 从src中反序列化出一条索引结构修改日志记录
+    void deserialize(const char* src) override {
+        LogRecord::deserialize(src);
+        int offset = OFFSET_LOG_DATA;
+        int hdr[4];
+        memcpy(hdr, src + offset, sizeof(hdr));
+        offset += sizeof(hdr);
+        set_file_hdr(hdr[0], hdr[1], hdr[2], hdr[3]);
+        int num = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        page_nos_.assign(reinterpret_cast<const int*>(src + offset), reinterpret_cast<const int*>(src + offset) + num);
+        offset += num * sizeof(int);
+        lens_.assign(reinterpret_cast<const int*>(src + offset), reinterpret_cast<const int*>(src + offset) + num);
+        offset += num * sizeof(int);
+        offsets_.clear();
+        int data_size = 0;
+        for (int len : lens_) {
+            offsets_.push_back(data_size);
+            data_size += len;
+        }
+        data_.assign(src + offset, src + offset + data_size);
+        offset += data_size;
+        int num_freed = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        freed_pages_.assign(reinterpret_cast<const int*>(src + offset),
+                            reinterpret_cast<const int*>(src + offset) + num_freed);
+        offset += num_freed * sizeof(int);
+        size_t index_name_size = *reinterpret_cast<const size_t*>(src + offset);
+        offset += sizeof(size_t);
+        index_name_.assign(src + offset, index_name_size);
+    }
+    void format_print() override {
+        if(ARIES_DEBUG_MODE) {
+            LogRecord::format_print();
+            LOG_DEBUG("%s", fmt::format("index name: {}\n"
+                                        "num_nodes: {}\n"
+                                        "num_freed: {}\n"
+                                        "root_page: {}", index_name_, num_nodes(),
+                                        freed_pages_.size(), root_page_).c_str());
+        }
+    }
+
+    std::vector<int> page_nos_;     // 各结点的页号
+    std::vector<int> lens_;         // 各结点映像的长度
+    std::vector<int> offsets_;      // 各结点映像在data_中的偏移
+    std::vector<char> data_;        // 各结点的映像，首尾相接
+    std::vector<int> freed_pages_;  // 被删除的结点
+    std::string index_name_;        // 索引文件名
+
+    /**
+     * 修改后file_hdr的内容
+     */
+    int root_page_;
+    int first_leaf_;
+    int last_leaf_;
+    int num_pages_;
+};
 /* 日志缓冲区，只有一个buffer，因此需要阻塞地去把日志写入缓冲区中 */
 
 class LogBuffer {
@@ -773,7 +1144,26 @@ public:
     void set_global_lsn(lsn_t lsn) {
         global_lsn_ = lsn;
     }
+    lsn_t get_global_lsn() const {
+        return global_lsn_.load();
+    }
     std::list<std::unique_ptr<LogRecord>> get_records();
+
+    /**
+     * @description: 若page_id不在脏页表中，则记录其rec_lsn (第一个使该页面变脏的log)
+     */
+    void add_dirty_page(const PageId &page_id, lsn_t rec_lsn) {
+        std::scoped_lock lock(dpt_latch_);
+        dirty_page_table_.emplace(page_id, rec_lsn);
+    }
+
+    /**
+     * @description: 页面刷盘后将其从脏页表中移除，buffer pool的多个分片会并发调用
+     */
+    void remove_dirty_page(const PageId &page_id) {
+        std::scoped_lock lock(dpt_latch_);
+        dirty_page_table_.erase(page_id);
+    }
 private:    
     std::atomic<lsn_t> global_lsn_{0};  // 全局lsn，递增，用于为每条记录分发lsn
     std::mutex latch_;                  // 用于对log_buffer_的互斥访问
@@ -781,8 +1171,9 @@ private:
     DiskManager* disk_manager_;
     int current_offset_; // 当前在log文件中的偏移量
     int prev_offset_; // 在flush之前的偏移量
+    std::mutex dpt_latch_;              // 用于对dirty_page_table_的互斥访问
 public:
     dirty_page_table_t dirty_page_table_;
     active_txn_table_t active_txn_table_;
-    lsn_t flushed_lsn_;                 // 记录已经持久化到磁盘中的最后一条日志的日志号
+    std::atomic<lsn_t> flushed_lsn_{INVALID_LSN};  // 记录已经持久化到磁盘中的最后一条日志的日志号
 };
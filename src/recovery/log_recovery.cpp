@@ -77,6 +77,17 @@ void RecoveryManager::analyze() {
                 log_manager_->active_txn_table_[txn_id] = lsn;  // 更新该事务的last lsn
                 break;
             }
+            case INSERT_BATCH: {
+                auto batch_record = dynamic_cast<InsertBatchLogRecord *>(log_record->get());
+                std::string table_name(batch_record->table_name_, batch_record->table_name_size_);
+                auto table = sm_manager_->fhs_[table_name].get();
+                auto page_id = PageId{.fd=table->GetFd(), .page_no=batch_record->page_no_};
+                if ( log_manager_->dirty_page_table_.find(page_id) ==  log_manager_->dirty_page_table_.end()) {
+                     log_manager_->dirty_page_table_[page_id] = lsn; // 记录第一个使该页面变脏的log (reclsn)
+                }
+                log_manager_->active_txn_table_[txn_id] = lsn;  // 更新该事务的last lsn
+                break;
+            }
             case BEGIN: {
                 log_manager_->active_txn_table_[txn_id] = lsn;  // 更新该事务的last lsn
                 break;
@@ -122,6 +133,37 @@ void RecoveryManager::analyze() {
                 log_manager_->active_txn_table_[txn_id] = lsn;  // 更新该事务的last lsn
                 break;
             }
+            case IX_INSERT:
+            case IX_DELETE:
+            case IX_CLR_INSERT:
+            case IX_CLR_DELETE: {
+                auto entry_record = dynamic_cast<IxEntryLogRecord *>(log_record->get());
+                auto ih = get_index_to_redo(entry_record->index_name_, lsn);
+                if (ih != nullptr) {
+                    auto page_id = PageId{.fd=ih->getFd(), .page_no=entry_record->page_no_};
+                    if ( log_manager_->dirty_page_table_.find(page_id) ==  log_manager_->dirty_page_table_.end()) {
+                         log_manager_->dirty_page_table_[page_id] = lsn; // 记录第一个使该页面变脏的log (reclsn)
+                    }
+                }
+                log_manager_->active_txn_table_[txn_id] = lsn;  // 更新该事务的last lsn
+                break;
+            }
+            case IX_SPLIT:
+            case IX_MERGE: {
+                // 结构修改不属于事务的日志链，只重放文件头并记录涉及的页面
+                auto smo_record = dynamic_cast<IxSmoLogRecord *>(log_record->get());
+                auto ih = get_index_to_redo(smo_record->index_name_, lsn);
+                if (ih != nullptr) {
+                    ih->smo_analyze(*smo_record);
+                    for (int page_no : smo_record->page_nos_) {
+                        auto page_id = PageId{.fd=ih->getFd(), .page_no=page_no};
+                        if ( log_manager_->dirty_page_table_.find(page_id) ==  log_manager_->dirty_page_table_.end()) {
+                             log_manager_->dirty_page_table_[page_id] = lsn;
+                        }
+                    }
+                }
+                break;
+            }
             case CKPT_BEGIN: {
                 // 无事发生
                 break;
@@ -215,6 +257,26 @@ void RecoveryManager::redo() {
                 buffer_pool_manager_->unpin_page(page_id, true);
                 break;
             }
+            case INSERT_BATCH: {
+                auto batch_log = dynamic_cast<InsertBatchLogRecord*>(log);
+                std::string table_name(batch_log->table_name_, batch_log->table_name_size_);
+                auto fh = sm_manager_->fhs_.at(table_name).get();
+                fh->ensure_num_pages(batch_log->num_pages_);
+                auto page_id = PageId{.fd = fh->GetFd(), .page_no = batch_log->page_no_};
+                if ( log_manager_->dirty_page_table_.find(page_id) ==  log_manager_->dirty_page_table_.end()) {
+                    // 如果不在脏页表中，不需要重做
+                    break;
+                }
+                auto page = buffer_pool_manager_->fetch_page(page_id);
+                if(page->get_page_lsn() >= lsn) {
+                    // 如果已经被持久化，不需要更新
+                    buffer_pool_manager_->unpin_page(page_id, false);
+                    break;
+                }
+                fh->insert_records_recover(batch_log->page_no_, *batch_log, lsn);
+                buffer_pool_manager_->unpin_page(page_id, true);
+                break;
+            }
             case CLR_INSERT:{
                 auto insert_log = dynamic_cast<CLR_Insert_Record*>(log);
                 std::string table_name(insert_log->table_name_, insert_log->table_name_size_);
@@ -276,6 +338,52 @@ void RecoveryManager::redo() {
                 buffer_pool_manager_->unpin_page(page_id, true);
                 break;
             }
+            case IX_INSERT:
+            case IX_DELETE:
+            case IX_CLR_INSERT:
+            case IX_CLR_DELETE: {
+                auto entry_log = dynamic_cast<IxEntryLogRecord*>(log);
+                auto ih = get_index_to_redo(entry_log->index_name_, lsn);
+                if (ih == nullptr) {
+                    break;
+                }
+                auto page_id = PageId{.fd = ih->getFd(), .page_no = entry_log->page_no_};
+                if ( log_manager_->dirty_page_table_.find(page_id) ==  log_manager_->dirty_page_table_.end()) {
+                    // 如果不在脏页表中，不需要重做
+                    break;
+                }
+                try {
+                    auto page = buffer_pool_manager_->fetch_page(page_id);
+                    if(page->get_page_lsn() >= lsn) {
+                        // 如果已经被持久化，不需要更新
+                        buffer_pool_manager_->unpin_page(page_id, false);
+                        break;
+                    }
+                    if (log->log_type_ == IX_INSERT || log->log_type_ == IX_CLR_INSERT) {
+                        ih->insert_entry_recover(entry_log->page_no_, entry_log->key_.data(), entry_log->rid_, lsn);
+                    } else {
+                        ih->delete_entry_recover(entry_log->page_no_, entry_log->key_.data(), lsn);
+                    }
+                    buffer_pool_manager_->unpin_page(page_id, true);
+                } catch (RMDBError &) {
+                    broken_indexes_.insert(entry_log->index_name_);
+                }
+                break;
+            }
+            case IX_SPLIT:
+            case IX_MERGE: {
+                auto smo_log = dynamic_cast<IxSmoLogRecord*>(log);
+                auto ih = get_index_to_redo(smo_log->index_name_, lsn);
+                if (ih == nullptr) {
+                    break;
+                }
+                try {
+                    ih->smo_recover(*smo_log, lsn);
+                } catch (RMDBError &) {
+                    broken_indexes_.insert(smo_log->index_name_);
+                }
+                break;
+            }
 //            case CKPT_BEGIN:
 //                break;
 //            case CKPT_END:
@@ -327,9 +435,12 @@ void RecoveryManager::undo() {
                     auto update_log = dynamic_cast<UpdateLogRecord *>(log);
                     std::string table_name(update_log->table_name_, update_log->table_name_size_);
                     auto table = sm_manager_->fhs_[table_name].get();
-                    auto page_id = PageId{.fd = table->GetFd(), .page_no = update_log->rid_.page_no};
                     auto fh = sm_manager_->fhs_.at(table_name).get();
-                    fh->update_record(update_log->rid_,update_log->before_update_value_.data, context,&table_name, LogOperation::UNDO, update_log->prev_lsn_);
+                    // slotted page放不下更新前的记录时记录会移动，之后撤销的索引删除要用新位置
+                    auto rid = fh->update_record(undo_rid(table_name, update_log->rid_),
+                                                 fh->unpack_record(update_log->before_update_value_)->data, context,
+                                                 &table_name, LogOperation::UNDO, update_log->prev_lsn_);
+                    set_undo_rid(table_name, update_log->rid_, rid);
                     undo_list.pop();
                     undo_list.emplace(log->prev_lsn_,context);
                     break;
@@ -337,9 +448,10 @@ void RecoveryManager::undo() {
                 case INSERT: {
                     auto insert_log = dynamic_cast<InsertLogRecord *>(log);
                     std::string table_name(insert_log->table_name_, insert_log->table_name_size_);
-                    auto table = sm_manager_->fhs_[table_name].get();
                     auto fh = sm_manager_->fhs_.at(table_name).get();
-                    fh->delete_record(insert_log->rid_,context,&table_name, LogOperation::UNDO,insert_log->prev_lsn_);
+                    fh->delete_record(undo_rid(table_name, insert_log->rid_), context, &table_name, LogOperation::UNDO,
+                                      insert_log->prev_lsn_);
+                    undo_rids_[table_name].erase(insert_log->rid_);
                     undo_list.pop();
                     undo_list.emplace(log->prev_lsn_,context);
                     break;
@@ -347,14 +459,87 @@ void RecoveryManager::undo() {
                 case DELETE: {
                     auto delete_log = dynamic_cast<DeleteLogRecord*>(log);
                     std::string table_name(delete_log->table_name_, delete_log->table_name_size_);
-                    auto table = sm_manager_->fhs_[table_name].get();
                     auto fh = sm_manager_->fhs_.at(table_name).get();
-                    fh->insert_record(delete_log->delete_value_.data, context, &table_name, LogOperation::UNDO, delete_log->prev_lsn_);
+                    // 记录被插入到第一个空闲位置，不一定是删除前的位置，之后撤销的索引删除要用新位置
+                    auto rid = fh->insert_record(fh->unpack_record(delete_log->delete_value_)->data, context,
+                                                 &table_name, LogOperation::UNDO, delete_log->prev_lsn_);
+                    set_undo_rid(table_name, delete_log->rid_, rid);
                     undo_list.pop();
                     undo_list.emplace(log->prev_lsn_,context);
                     break;
                 }
 
+                case INSERT_BATCH: {
+                    // 逆序删除各条记录；除最后一条外CLR的undo_next仍指向本日志，中途崩溃后再次撤销时跳过已删除的记录
+                    auto batch_log = dynamic_cast<InsertBatchLogRecord *>(log);
+                    std::string table_name(batch_log->table_name_, batch_log->table_name_size_);
+                    auto fh = sm_manager_->fhs_.at(table_name).get();
+                    for (int i = batch_log->num_tuples() - 1; i >= 0; i--) {
+                        Rid logged_rid{batch_log->page_no_, batch_log->slot_nos_[i]};
+                        Rid rid = undo_rid(table_name, logged_rid);
+                        if (!fh->is_record(rid)) {
+                            continue;
+                        }
+                        fh->delete_record(rid, context, &table_name, LogOperation::UNDO,
+                                          i == 0 ? batch_log->prev_lsn_ : batch_log->lsn_);
+                        undo_rids_[table_name].erase(logged_rid);
+                    }
+                    // LOAD向空索引批量建树时不写索引日志，base_lsn_不早于本日志的索引可能含有这些记录的键，
+                    // 撤销不会删除它们，交给rebuild从表重建
+                    for (auto &index : sm_manager_->db_.get_table_indexes(table_name)) {
+                        auto index_name = IxManager::get_index_name(table_name, index.cols);
+                        auto ih = get_index_to_undo(index_name);
+                        if (ih != nullptr && batch_log->lsn_ <= ih->getFileHdr()->base_lsn_) {
+                            broken_indexes_.insert(index_name);
+                        }
+                    }
+                    undo_list.pop();
+                    undo_list.emplace(log->prev_lsn_,context);
+                    break;
+                }
+
+                case IX_INSERT: {
+                    // 在整棵树上删除插入的键，结点可能已经分裂或合并
+                    auto entry_log = dynamic_cast<IxEntryLogRecord *>(log);
+                    auto ih = get_index_to_undo(entry_log->index_name_);
+                    if (ih != nullptr) {
+                        try {
+                            ih->delete_entry(entry_log->key_.data(), context->txn_, LogOperation::UNDO,
+                                             entry_log->prev_lsn_);
+                        } catch (RMDBError &) {
+                            broken_indexes_.insert(entry_log->index_name_);
+                        }
+                    }
+                    undo_list.pop();
+                    undo_list.emplace(log->prev_lsn_,context);
+                    break;
+                }
+                case IX_DELETE: {
+                    auto entry_log = dynamic_cast<IxEntryLogRecord *>(log);
+                    auto ih = get_index_to_undo(entry_log->index_name_);
+                    if (ih != nullptr) {
+                        try {
+                            auto rid = undo_rid(index_table(entry_log->index_name_), entry_log->rid_);
+                            ih->insert_entry(entry_log->key_.data(), rid, context->txn_, LogOperation::UNDO,
+                                             entry_log->prev_lsn_);
+                        } catch (IndexEntryDuplicateError &) {
+                            // 崩溃前已经撤销过
+                        } catch (RMDBError &) {
+                            broken_indexes_.insert(entry_log->index_name_);
+                        }
+                    }
+                    undo_list.pop();
+                    undo_list.emplace(log->prev_lsn_,context);
+                    break;
+                }
+                case IX_CLR_INSERT:
+                case IX_CLR_DELETE: {
+                    auto clr_log = dynamic_cast<IxEntryLogRecord*>(log);
+                    undo_list.pop();
+                    undo_list.emplace( clr_log->undo_next_, context);
+                    break;
+                }
+
                 case CLR_INSERT: {
                     auto clr_log = dynamic_cast<CLR_Insert_Record*>(log);
                     undo_list.pop();
@@ -406,16 +591,66 @@ LogRecord *RecoveryManager::get_log_by_lsn(lsn_t lsn) {
     return logs_.at(idx).get();
 }
 
-void RecoveryManager::rebuild() {
-    if(!INDEX_REBUILD_MODE) {
-        return;
+IxIndexHandle *RecoveryManager::get_index_to_redo(const std::string &index_name, lsn_t lsn) {
+    auto ih = get_index_to_undo(index_name);
+    if (ih == nullptr || lsn <= ih->getFileHdr()->base_lsn_) {
+        return nullptr;
     }
+    return ih;
+}
+
+IxIndexHandle *RecoveryManager::get_index_to_undo(const std::string &index_name) {
+    auto ih_iter = sm_manager_->ihs_.find(index_name);
+    if (ih_iter == sm_manager_->ihs_.end() || broken_indexes_.count(index_name) != 0) {
+        return nullptr;
+    }
+    return ih_iter->second.get();
+}
+
+Rid RecoveryManager::undo_rid(const std::string &table_name, const Rid &rid) {
+    auto table_iter = undo_rids_.find(table_name);
+    if (table_iter == undo_rids_.end()) {
+        return rid;
+    }
+    auto rid_iter = table_iter->second.find(rid);
+    return rid_iter == table_iter->second.end() ? rid : rid_iter->second;
+}
+
+void RecoveryManager::set_undo_rid(const std::string &table_name, const Rid &logged_rid, const Rid &rid) {
+    if (rid == logged_rid) {
+        undo_rids_[table_name].erase(logged_rid);
+    } else {
+        undo_rids_[table_name][logged_rid] = rid;
+    }
+}
+
+std::string RecoveryManager::index_table(const std::string &index_name) {
+    for (auto &table_iter : sm_manager_->fhs_) {
+        for (auto &index : sm_manager_->db_.get_table_indexes(table_iter.first)) {
+            if (IxManager::get_index_name(table_iter.first, index.cols) == index_name) {
+                return table_iter.first;
+            }
+        }
+    }
+    return "";
+}
+
+/**
+ * @description: 索引由日志恢复，只重建文件缺失、恢复过程中出错或校验失败的索引；INDEX_REBUILD_MODE时重建全部索引
+ */
+void RecoveryManager::rebuild() {
     auto txn = std::make_unique<Transaction>(INVALID_TXN_ID);
     auto lock_mgr = std::make_unique<LockManager>();
     auto context = new Context(lock_mgr.get(),log_manager_, txn.get());
     for(auto &table_iter:sm_manager_->fhs_) {
         auto indexes = sm_manager_->db_.get_table_indexes(table_iter.first);
         for(auto &index: indexes) {
+            auto index_name = IxManager::get_index_name(table_iter.first, index.cols);
+            auto ih = get_index_to_undo(index_name);
+            if (!INDEX_REBUILD_MODE && ih != nullptr && ih->verify()) {
+                continue;
+            }
+            LOG_DEBUG("%s", fmt::format("rebuild index {}", index_name).c_str());
             sm_manager_->rebuild_index(table_iter.first, index,context);
         }
     }
@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include "log_manager.h"
 #include "storage/disk_manager.h"
 #include "system/sm_manager.h"
@@ -43,6 +44,21 @@ public:
      */
     LogRecord* get_log_by_lsn(lsn_t lsn);
 private:
+    /**
+     * 索引日志需要重做时返回对应的索引：索引已打开、未在恢复中出错，且日志在索引文件整体写盘(base_lsn)之后
+     */
+    IxIndexHandle* get_index_to_redo(const std::string &index_name, lsn_t lsn);
+    IxIndexHandle* get_index_to_undo(const std::string &index_name);
+
+    /**
+     * 撤销时记录的当前位置：撤销删除或更新时记录可能被放到与日志中不同的位置，之后撤销同一记录的操作都要用新位置
+     */
+    Rid undo_rid(const std::string &table_name, const Rid &rid);
+    void set_undo_rid(const std::string &table_name, const Rid &logged_rid, const Rid &rid);
+
+    /** 索引所在的表名 */
+    std::string index_table(const std::string &index_name);
+
     LogBuffer buffer_;                                              // 读入日志
     DiskManager* disk_manager_;                                     // 用来读写文件
     BufferPoolManager* buffer_pool_manager_;                        // 对页面进行读写
@@ -50,4 +66,6 @@ private:
     LogManager* log_manager_;
     std::vector<std::unique_ptr<LogRecord>> logs_; // 在系统重启时的log
     lsn_t log_offset_{0}; // log的偏移量 log_offset = (log idx in logs_) - lsn。也就是说通过lsn+log_offset可以获取在logs_数组中的下标
+    std::unordered_set<std::string> broken_indexes_;  // 重做或撤销时出错的索引，在rebuild中从表重建
+    std::unordered_map<std::string, std::unordered_map<Rid, Rid, RidHash>> undo_rids_;  // 表名 -> 日志中的位置 -> 撤销后的位置
 };
\ No newline at end of file
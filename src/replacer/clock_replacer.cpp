@@ -0,0 +1,108 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "clock_replacer.h"
+
+ClockReplacer::ClockReplacer(size_t num_pages) : max_size_(num_pages) {
+    states_ = std::make_unique<std::atomic<uint8_t>[]>(max_size_);
+    for (size_t i = 0; i < max_size_; ++i) {
+        states_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+ClockReplacer::~ClockReplacer() = default;
+
+/**
+ * @description: 推进时钟指针，淘汰第一个可被淘汰且REFERENCED位为0的帧，扫过的帧清除REFERENCED位
+ * @param {frame_id_t*} frame_id 被移除的frame的id
+ * @return {bool} 如果成功淘汰了一个页面则返回true，否则返回false
+ */
+bool ClockReplacer::victim(frame_id_t* frame_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (size_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    // 最多扫两圈：第一圈清除所有REFERENCED位，第二圈一定能找到可淘汰的帧(除非它们同时被pin)
+    for (size_t step = 0; step < 2 * max_size_ + 1; ++step) {
+        auto &state = states_[hand_];
+        uint8_t s = state.load(std::memory_order_acquire);
+        if (s & IN_CLOCK) {
+            if (s & REFERENCED) {
+                state.compare_exchange_strong(s, s & ~REFERENCED, std::memory_order_acq_rel);
+            } else if (state.compare_exchange_strong(s, 0, std::memory_order_acq_rel)) {
+                size_.fetch_sub(1, std::memory_order_acq_rel);
+                *frame_id = static_cast<frame_id_t>(hand_);
+                hand_ = (hand_ + 1) % max_size_;
+                return true;
+            } else {
+                // 状态被并发修改，重新检查当前帧
+                continue;
+            }
+        }
+        hand_ = (hand_ + 1) % max_size_;
+    }
+    return false;
+}
+
+/**
+ * @description: 固定指定的frame，即该页面无法被淘汰
+ * @param {frame_id_t} 需要固定的frame的id
+ */
+void ClockReplacer::pin(frame_id_t frame_id) {
+    uint8_t prev = states_[frame_id].fetch_and(static_cast<uint8_t>(~IN_CLOCK), std::memory_order_acq_rel);
+    if (prev & IN_CLOCK) {
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+/**
+ * @description: 取消固定一个frame，代表该页面可以被淘汰，刚被使用过的帧带有REFERENCED位
+ * @param {frame_id_t} frame_id 取消固定的frame的id
+ */
+void ClockReplacer::unpin(frame_id_t frame_id) {
+    uint8_t prev = states_[frame_id].fetch_or(IN_CLOCK | REFERENCED, std::memory_order_acq_rel);
+    if (!(prev & IN_CLOCK)) {
+        size_.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+/**
+ * @description: 记录一次访问，只置REFERENCED位；已置位时不再写，避免热点帧的cache line来回失效
+ * @param {frame_id_t} frame_id 被访问的frame的id
+ */
+void ClockReplacer::record_access(frame_id_t frame_id) {
+    auto &state = states_[frame_id];
+    if (!(state.load(std::memory_order_relaxed) & REFERENCED)) {
+        state.fetch_or(REFERENCED, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @description: 从时钟指针开始列出即将被淘汰的帧：第一圈中REFERENCED位为0的帧，然后是第二圈中其余的帧
+ * @param {size_t} n 最多列出的帧数
+ * @param {vector<frame_id_t>*} frames 列出的帧
+ */
+void ClockReplacer::peek_victims(size_t n, std::vector<frame_id_t>* frames) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    size_t start = frames->size();
+    for (uint8_t want : {IN_CLOCK, static_cast<uint8_t>(IN_CLOCK | REFERENCED)}) {
+        for (size_t step = 0; step < max_size_ && frames->size() - start < n; ++step) {
+            size_t frame = (hand_ + step) % max_size_;
+            if (states_[frame].load(std::memory_order_relaxed) == want) {
+                frames->emplace_back(static_cast<frame_id_t>(frame));
+            }
+        }
+    }
+}
+
+/**
+ * @description: 获取当前replacer中可以被淘汰的页面数量
+ */
+size_t ClockReplacer::Size() { return size_.load(std::memory_order_acquire); }
@@ -0,0 +1,57 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/config.h"
+#include "replacer/replacer.h"
+
+/*
+ClockReplacer实现了CLOCK(second chance)替换策略
+每个帧只有两个状态位：是否可被淘汰、最近是否被访问。pin/unpin/record_access都是对状态位的原子操作，
+不分配内存也不加锁；只有victim需要加锁推进时钟指针。
+*/
+class ClockReplacer : public Replacer {
+   public:
+    /**
+     * @description: 创建一个新的ClockReplacer
+     * @param {size_t} num_pages ClockReplacer最多需要存储的page数量
+     */
+    explicit ClockReplacer(size_t num_pages);
+
+    ~ClockReplacer();
+
+    bool victim(frame_id_t *frame_id);
+
+    void pin(frame_id_t frame_id);
+
+    void unpin(frame_id_t frame_id);
+
+    void record_access(frame_id_t frame_id);
+
+    void peek_victims(size_t n, std::vector<frame_id_t> *frames);
+
+    size_t Size();
+
+   private:
+    static constexpr uint8_t IN_CLOCK = 1;      // 帧可以被淘汰
+    static constexpr uint8_t REFERENCED = 2;    // 帧最近被访问过，指针扫过时先清除该位
+
+    std::mutex latch_;                          // 只保护时钟指针hand_
+    std::unique_ptr<std::atomic<uint8_t>[]> states_;    // 每个帧的状态位
+    std::atomic<size_t> size_{0};               // 可以被淘汰的帧数
+    size_t hand_{0};                            // 时钟指针
+    size_t max_size_;                           // 最大容量（与缓冲池的容量相同）
+};
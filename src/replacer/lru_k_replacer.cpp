@@ -0,0 +1,185 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "lru_k_replacer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k) : max_size_(num_pages), k_(k == 0 ? 1 : k) {
+    evictable_ = std::make_unique<std::atomic<bool>[]>(max_size_);
+    history_ = std::make_unique<std::atomic<uint64_t>[]>(max_size_ * k_);
+    next_ = std::make_unique<std::atomic<uint32_t>[]>(max_size_);
+    gen_.assign(max_size_, 0);
+    heap_.reserve(max_size_);
+    for (size_t i = 0; i < max_size_; ++i) {
+        evictable_[i].store(false, std::memory_order_relaxed);
+        reset_history(i);
+    }
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+void LRUKReplacer::reset_history(size_t frame_id) {
+    for (size_t j = 0; j < k_; ++j) {
+        history_[frame_id * k_ + j].store(NO_ACCESS, std::memory_order_relaxed);
+    }
+    next_[frame_id].store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @description: 计算帧的淘汰键。访问满K次的帧最高位置1，低位为倒数第K次访问的时间戳；
+ * 不足K次的帧为最早一次访问的时间戳，从未访问过的帧为0。键越小越先淘汰
+ */
+uint64_t LRUKReplacer::eviction_key(size_t frame_id) const {
+    uint64_t oldest = UINT64_MAX;
+    bool infinite = false;
+    for (size_t j = 0; j < k_; ++j) {
+        uint64_t ts = history_[frame_id * k_ + j].load(std::memory_order_relaxed);
+        if (ts == NO_ACCESS) {
+            infinite = true;
+            continue;
+        }
+        oldest = std::min(oldest, ts);
+    }
+    if (oldest == UINT64_MAX) {
+        return 0;
+    }
+    return infinite ? oldest : (oldest | (uint64_t(1) << 63));
+}
+
+void LRUKReplacer::push_entry(const HeapEntry& entry) {
+    heap_.push_back(entry);
+    std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+}
+
+/**
+ * @description: 弹出当前淘汰键最小的可淘汰帧，调用时须持有latch_。
+ * 过时世代或已被pin的堆项直接丢弃；淘汰键已经变大的帧以新键放回后继续
+ * @return {bool} 没有可淘汰的帧时返回false
+ */
+bool LRUKReplacer::pop_candidate(HeapEntry* entry) {
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+        HeapEntry top = heap_.back();
+        heap_.pop_back();
+        auto [key, gen, frame_id] = top;
+        if (gen != gen_[frame_id] || !evictable_[frame_id].load(std::memory_order_acquire)) {
+            continue;
+        }
+        uint64_t current = eviction_key(frame_id);
+        if (current > key) {
+            push_entry({current, gen, frame_id});
+            continue;
+        }
+        *entry = top;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @description: 选择backward K-distance最大的可淘汰帧，并清空其访问历史(该帧将装入新的页面)
+ * @param {frame_id_t*} frame_id 被移除的frame的id
+ * @return {bool} 如果成功淘汰了一个页面则返回true，否则返回false
+ */
+bool LRUKReplacer::victim(frame_id_t* frame_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    HeapEntry entry;
+    while (pop_candidate(&entry)) {
+        frame_id_t best = std::get<2>(entry);
+        bool expected = true;
+        // 与并发的pin竞争，失败则丢弃该堆项，帧再次unpin时会重新入堆
+        if (evictable_[best].compare_exchange_strong(expected, false, std::memory_order_acq_rel)) {
+            size_.fetch_sub(1, std::memory_order_acq_rel);
+            reset_history(best);
+            *frame_id = best;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @description: 固定指定的frame，即该页面无法被淘汰
+ * @param {frame_id_t} 需要固定的frame的id
+ */
+void LRUKReplacer::pin(frame_id_t frame_id) {
+    if (evictable_[frame_id].exchange(false, std::memory_order_acq_rel)) {
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+/**
+ * @description: 取消固定一个frame，代表该页面可以被淘汰
+ * @param {frame_id_t} frame_id 取消固定的frame的id
+ */
+void LRUKReplacer::unpin(frame_id_t frame_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (!evictable_[frame_id].exchange(true, std::memory_order_acq_rel)) {
+        size_.fetch_add(1, std::memory_order_acq_rel);
+        push_entry({eviction_key(frame_id), ++gen_[frame_id], frame_id});
+        // 过时的堆项过多时按可淘汰的帧重建堆
+        if (heap_.size() > 2 * max_size_) {
+            heap_.clear();
+            for (size_t i = 0; i < max_size_; ++i) {
+                if (evictable_[i].load(std::memory_order_acquire)) {
+                    heap_.emplace_back(eviction_key(i), gen_[i], static_cast<frame_id_t>(i));
+                }
+            }
+            std::make_heap(heap_.begin(), heap_.end(), std::greater<>());
+        }
+    }
+}
+
+/**
+ * @description: 帧被放回free_list_时调用：移出replacer并清空访问历史，之后装入的页面不会继承旧页面的访问记录
+ * @param {frame_id_t} frame_id 放回free_list_的帧
+ */
+void LRUKReplacer::remove(frame_id_t frame_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    pin(frame_id);
+    reset_history(frame_id);
+}
+
+/**
+ * @description: 记录一次访问的逻辑时间戳，覆盖环形历史中最旧的一项
+ * @param {frame_id_t} frame_id 被访问的frame的id
+ */
+void LRUKReplacer::record_access(frame_id_t frame_id) {
+    uint64_t ts = current_timestamp_.fetch_add(1, std::memory_order_relaxed);
+    uint32_t pos = next_[frame_id].fetch_add(1, std::memory_order_relaxed) % k_;
+    history_[frame_id * k_ + pos].store(ts, std::memory_order_relaxed);
+}
+
+/**
+ * @description: 按victim的淘汰顺序列出backward K-distance最大的n个可淘汰帧
+ * @param {size_t} n 最多列出的帧数
+ * @param {vector<frame_id_t>*} frames 列出的帧
+ */
+void LRUKReplacer::peek_victims(size_t n, std::vector<frame_id_t>* frames) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    // 依次弹出n个候选帧，列出后原样放回
+    std::vector<HeapEntry> popped;
+    HeapEntry entry;
+    while (popped.size() < n && pop_candidate(&entry)) {
+        popped.push_back(entry);
+        frames->emplace_back(std::get<2>(entry));
+    }
+    for (auto& e : popped) {
+        push_entry(e);
+    }
+}
+
+/**
+ * @description: 获取当前replacer中可以被淘汰的页面数量
+ */
+size_t LRUKReplacer::Size() { return size_.load(std::memory_order_acquire); }
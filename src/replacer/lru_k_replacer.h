@@ -0,0 +1,79 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "common/config.h"
+#include "replacer/replacer.h"
+
+/*
+LRUKReplacer实现了LRU-K替换策略
+淘汰backward K-distance(当前时刻与倒数第K次访问的时间差)最大的帧；访问不足K次的帧K-distance视为无穷大，
+它们之间按最早一次访问的时间淘汰。只被顺序扫描访问过一次的页面因此总是先于反复访问的索引页面被淘汰。
+每个帧保存最近K次访问的逻辑时间戳，record_access只做原子操作。
+可淘汰的帧按淘汰键放在小根堆中，淘汰键只会随访问增大，所以堆中的键允许过时：victim弹出堆顶时重新计算淘汰键，
+变大了就以新键放回，只有键仍然最小的帧才被淘汰。帧每次进入replacer时递增世代号，旧世代的堆项在弹出时丢弃。
+*/
+class LRUKReplacer : public Replacer {
+   public:
+    /**
+     * @description: 创建一个新的LRUKReplacer
+     * @param {size_t} num_pages LRUKReplacer最多需要存储的page数量
+     * @param {size_t} k 计算backward K-distance时使用的K
+     */
+    explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K);
+
+    ~LRUKReplacer();
+
+    bool victim(frame_id_t *frame_id);
+
+    void pin(frame_id_t frame_id);
+
+    void unpin(frame_id_t frame_id);
+
+    void remove(frame_id_t frame_id);
+
+    void record_access(frame_id_t frame_id);
+
+    void peek_victims(size_t n, std::vector<frame_id_t> *frames);
+
+    size_t Size();
+
+   private:
+    static constexpr uint64_t NO_ACCESS = 0;    // 时间戳从1开始，0表示该位置没有访问记录
+
+    // 堆项：(淘汰键, 世代号, 帧号)，淘汰键小的先淘汰
+    using HeapEntry = std::tuple<uint64_t, uint32_t, frame_id_t>;
+
+    void reset_history(size_t frame_id);
+
+    uint64_t eviction_key(size_t frame_id) const;
+
+    bool pop_candidate(HeapEntry *entry);
+
+    void push_entry(const HeapEntry &entry);
+
+    std::mutex latch_;                                  // 保护heap_与gen_
+    std::vector<HeapEntry> heap_;                       // 可淘汰的帧，std::greater排序的小根堆
+    std::vector<uint32_t> gen_;                         // 每个帧的世代号，与之不同的堆项已过时
+    std::unique_ptr<std::atomic<bool>[]> evictable_;    // 每个帧是否可以被淘汰
+    std::unique_ptr<std::atomic<uint64_t>[]> history_;  // 每个帧最近k_次访问的时间戳，环形存放，长度max_size_*k_
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;     // 每个帧下一次访问写入history_的位置
+    std::atomic<uint64_t> current_timestamp_{1};        // 逻辑时钟
+    std::atomic<size_t> size_{0};                       // 可以被淘汰的帧数
+    size_t max_size_;                                   // 最大容量（与缓冲池的容量相同）
+    size_t k_;
+};
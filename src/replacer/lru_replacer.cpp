@@ -10,7 +10,13 @@ See the Mulan PSL v2 for more details. */
 
 #include "lru_replacer.h"
 
-LRUReplacer::LRUReplacer(size_t num_pages) { max_size_ = num_pages; }
+LRUReplacer::LRUReplacer(size_t num_pages) {
+    max_size_ = num_pages;
+    referenced_ = std::make_unique<std::atomic<bool>[]>(max_size_);
+    for (size_t i = 0; i < max_size_; ++i) {
+        referenced_[i].store(false, std::memory_order_relaxed);
+    }
+}
 
 LRUReplacer::~LRUReplacer() = default;  
 
@@ -32,6 +38,14 @@ bool LRUReplacer::victim(frame_id_t* frame_id) {
         return false;
     }
 
+    // buffer pool命中时不经过replacer，被record_access置位的帧视为最近被访问，移到首部
+    size_t second_chances = 0;
+    while (referenced_[LRUlist_.back()].exchange(false, std::memory_order_acq_rel) &&
+           second_chances < LRUlist_.size()) {
+        LRUlist_.splice(LRUlist_.begin(), LRUlist_, std::prev(LRUlist_.end()));
+        ++second_chances;
+    }
+
     auto victim_frame_id  = LRUlist_.back();
     LRUlist_.pop_back(); // 删除最先加入的那个页
     LRUhash_.erase(victim_frame_id);
@@ -73,6 +87,36 @@ void LRUReplacer::unpin(frame_id_t frame_id) {
     // CHECK(AntiO2) 考虑用满报错的情况？
 }
 
+/**
+ * @description: 记录一次访问，只置位不加锁，已置位时不再写
+ * @param {frame_id_t} frame_id 被访问的frame的id
+ */
+void LRUReplacer::record_access(frame_id_t frame_id) {
+    if (!referenced_[frame_id].load(std::memory_order_relaxed)) {
+        referenced_[frame_id].store(true, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @description: 从链表尾部开始列出即将被淘汰的帧，带有访问标记的帧会获得second chance，排在其他帧之后
+ * @param {size_t} n 最多列出的帧数
+ * @param {vector<frame_id_t>*} frames 列出的帧
+ */
+void LRUReplacer::peek_victims(size_t n, std::vector<frame_id_t>* frames) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    size_t start = frames->size();
+    for (auto it = LRUlist_.rbegin(); it != LRUlist_.rend() && frames->size() - start < n; ++it) {
+        if (!referenced_[*it].load(std::memory_order_relaxed)) {
+            frames->emplace_back(*it);
+        }
+    }
+    for (auto it = LRUlist_.rbegin(); it != LRUlist_.rend() && frames->size() - start < n; ++it) {
+        if (referenced_[*it].load(std::memory_order_relaxed)) {
+            frames->emplace_back(*it);
+        }
+    }
+}
+
 /**
  * @description: 获取当前replacer中可以被淘汰的页面数量
  */
@@ -10,7 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <mutex>  
 #include <vector>
 #include <set>
@@ -38,6 +40,10 @@ class LRUReplacer : public Replacer {
 
     void unpin(frame_id_t frame_id);
 
+    void record_access(frame_id_t frame_id);
+
+    void peek_victims(size_t n, std::vector<frame_id_t> *frames);
+
     size_t Size();
 
    private:
@@ -45,4 +51,5 @@ class LRUReplacer : public Replacer {
     std::list<frame_id_t> LRUlist_;     // 按加入的时间顺序存放unpinned pages的frame id，首部表示最近被访问
     std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> LRUhash_;   // frame_id_t -> unpinned pages的frame id
     size_t max_size_;   // 最大容量（与缓冲池的容量相同）
+    std::unique_ptr<std::atomic<bool>[]> referenced_;  // 命中时不加锁置位，victim时被置位的帧移到首部，获得一次second chance
 };
@@ -10,8 +10,33 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <cctype>
+#include <string>
+#include <vector>
+
 #include "common/config.h"
 
+/** buffer pool使用的置换策略，由启动参数选择 */
+enum class ReplacerType { LRU, CLOCK, LRU_K };
+
+/**
+ * @description: 把启动参数中的置换策略名称(lru/clock/lru-k，不区分大小写)解析为ReplacerType
+ * @return {bool} 名称是否合法
+ */
+inline bool parse_replacer_type(std::string name, ReplacerType *type) {
+    for (auto &ch : name) ch = static_cast<char>(tolower(ch));
+    if (name == "lru") {
+        *type = ReplacerType::LRU;
+    } else if (name == "clock") {
+        *type = ReplacerType::CLOCK;
+    } else if (name == "lru-k" || name == "lruk" || name == "lru_k") {
+        *type = ReplacerType::LRU_K;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -39,6 +64,28 @@ class Replacer {
      */
     virtual void unpin(frame_id_t frame_id) = 0;
 
+    /**
+     * Removes a frame that is going back to the buffer pool's free list, dropping any access history,
+     * so the next page loaded into it starts fresh.
+     * @param frame_id the id of the frame to remove
+     */
+    virtual void remove(frame_id_t frame_id) { pin(frame_id); }
+
+    /**
+     * Records an access to a frame. Buffer pool hits do not pin/unpin through the replacer,
+     * so policies that need access history (second chance, LRU-K) get it here. Must not block.
+     * @param frame_id the id of the frame that was accessed
+     */
+    virtual void record_access(frame_id_t frame_id) {}
+
+    /**
+     * Lists, without removing them, up to n frames in roughly the order victim() would return them.
+     * The background writer uses this to clean dirty pages before they are evicted.
+     * @param n the maximum number of frames to list
+     * @param[out] frames the listed frames are appended here
+     */
+    virtual void peek_victims(size_t n, std::vector<frame_id_t> *frames) {}
+
     /** @return the number of elements in the replacer that can be victimized */
     virtual size_t Size() = 0;
 };
@@ -29,21 +29,149 @@ See the Mulan PSL v2 for more details. */
 
 static bool should_exit = false;
 
-// 构建全局所需的管理器对象
-auto disk_manager = std::make_unique<DiskManager>();
-auto lock_manager = std::make_unique<LockManager>();
-auto log_manager = std::make_unique<LogManager>(disk_manager.get());
-auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get(), log_manager.get());
-auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
-auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
-auto sm_manager = std::make_unique<SmManager>(disk_manager.get(), buffer_pool_manager.get(), rm_manager.get(), ix_manager.get());
-auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), sm_manager.get());
-auto ql_manager = std::make_unique<QlManager>(sm_manager.get(), txn_manager.get());
-auto recovery = std::make_unique<RecoveryManager>(disk_manager.get(), buffer_pool_manager.get(), sm_manager.get(), log_manager.get());
-auto planner = std::make_unique<Planner>(sm_manager.get());
-auto optimizer = std::make_unique<Optimizer>(sm_manager.get(), planner.get());
-auto portal = std::make_unique<Portal>(sm_manager.get());
-auto analyze = std::make_unique<Analyze>(sm_manager.get());
+// 全局所需的管理器对象，在main中解析完启动参数后由init_managers构建
+std::unique_ptr<DiskManager> disk_manager;
+std::unique_ptr<LockManager> lock_manager;
+std::unique_ptr<LogManager> log_manager;
+std::unique_ptr<BufferPoolManager> buffer_pool_manager;
+std::unique_ptr<RmManager> rm_manager;
+std::unique_ptr<IxManager> ix_manager;
+std::unique_ptr<SmManager> sm_manager;
+std::unique_ptr<TransactionManager> txn_manager;
+std::unique_ptr<QlManager> ql_manager;
+std::unique_ptr<RecoveryManager> recovery;
+std::unique_ptr<Planner> planner;
+std::unique_ptr<Optimizer> optimizer;
+std::unique_ptr<Portal> portal;
+std::unique_ptr<Analyze> analyze;
+
+/** 启动参数，来自配置文件(-c)和命令行，命令行中的设置优先 */
+struct StartupOptions {
+    ReplacerType replacer_type = ReplacerType::LRU;                 // buffer pool的置换策略
+    IoBackendType io_backend_type = IoBackendType::SYNC;            // 批量页面I/O(写回、预读)使用的后端
+    bool direct_io = false;                                         // 数据文件是否使用O_DIRECT
+    size_t buffer_pool_bytes = static_cast<size_t>(BUFFER_POOL_SIZE) * DEFAULT_PAGE_SIZE;  // buffer pool的总字节数
+    int page_size = DEFAULT_PAGE_SIZE;                              // 新建数据库的页面大小
+    bool page_size_set = false;                                     // 是否显式指定了页面大小
+};
+
+/**
+ * @description: 解析字节数，可带K/M/G后缀(不区分大小写)，如512M
+ */
+static bool parse_size(const std::string &value, size_t *size) {
+    char *end = nullptr;
+    unsigned long long num = strtoull(value.c_str(), &end, 10);
+    if (end == value.c_str()) {
+        return false;
+    }
+    std::string suffix(end);
+    if (suffix == "k" || suffix == "K") {
+        num <<= 10;
+    } else if (suffix == "m" || suffix == "M") {
+        num <<= 20;
+    } else if (suffix == "g" || suffix == "G") {
+        num <<= 30;
+    } else if (!suffix.empty()) {
+        return false;
+    }
+    *size = num;
+    return true;
+}
+
+/**
+ * @description: 设置一项启动参数，key与配置文件中的名称相同
+ * @return {bool} key未知或value非法时返回false
+ */
+static bool set_startup_option(StartupOptions *options, const std::string &key, const std::string &value) {
+    if (key == "replacer") {
+        return parse_replacer_type(value, &options->replacer_type);
+    }
+    if (key == "io_backend") {
+        return parse_io_backend_type(value, &options->io_backend_type);
+    }
+    if (key == "direct_io") {
+        if (value == "true" || value == "on" || value == "1") {
+            options->direct_io = true;
+        } else if (value == "false" || value == "off" || value == "0") {
+            options->direct_io = false;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    if (key == "buffer_pool_size") {
+        return parse_size(value, &options->buffer_pool_bytes) && options->buffer_pool_bytes > 0;
+    }
+    if (key == "page_size") {
+        // 页面大小须为MIN_PAGE_SIZE到MAX_PAGE_SIZE之间的2的幂
+        size_t page_size;
+        if (!parse_size(value, &page_size) || page_size < MIN_PAGE_SIZE || page_size > MAX_PAGE_SIZE ||
+            (page_size & (page_size - 1)) != 0) {
+            return false;
+        }
+        options->page_size = static_cast<int>(page_size);
+        options->page_size_set = true;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @description: 读取配置文件，每行一项"key = value"，#之后为注释
+ * @return {bool} 文件无法打开或某一项非法时输出错误并返回false
+ */
+static bool load_config_file(const std::string &path, StartupOptions *options) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        std::cerr << "Cannot open config file " << path << std::endl;
+        return false;
+    }
+    auto trim = [](const std::string &str) {
+        size_t begin = str.find_first_not_of(" \t\r");
+        size_t end = str.find_last_not_of(" \t\r");
+        return begin == std::string::npos ? std::string() : str.substr(begin, end - begin + 1);
+    };
+    std::string line;
+    for (int line_no = 1; std::getline(ifs, line); ++line_no) {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (eq == std::string::npos || !set_startup_option(options, trim(line.substr(0, eq)), trim(line.substr(eq + 1)))) {
+            std::cerr << path << ":" << line_no << ": invalid option: " << line << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @description: 根据启动参数构建全局的管理器对象，调用前PAGE_SIZE已经设置为要打开的数据库的页面大小
+ * @param {StartupOptions&} options 启动参数
+ */
+void init_managers(const StartupOptions &options) {
+    disk_manager = std::make_unique<DiskManager>();
+    disk_manager->set_io_backend(options.io_backend_type);
+    disk_manager->set_direct_io(options.direct_io);
+    lock_manager = std::make_unique<LockManager>();
+    log_manager = std::make_unique<LogManager>(disk_manager.get());
+    // buffer pool的总字节数不变，帧数随页面大小变化
+    size_t pool_size = std::max<size_t>(options.buffer_pool_bytes / PAGE_SIZE, BUFFER_POOL_MIN_INSTANCE_SIZE);
+    buffer_pool_manager = std::make_unique<BufferPoolManager>(pool_size, disk_manager.get(), log_manager.get(),
+                                                              options.replacer_type);
+    rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    sm_manager = std::make_unique<SmManager>(disk_manager.get(), buffer_pool_manager.get(), rm_manager.get(), ix_manager.get());
+    txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), sm_manager.get());
+    ql_manager = std::make_unique<QlManager>(sm_manager.get(), txn_manager.get());
+    recovery = std::make_unique<RecoveryManager>(disk_manager.get(), buffer_pool_manager.get(), sm_manager.get(), log_manager.get());
+    planner = std::make_unique<Planner>(sm_manager.get());
+    optimizer = std::make_unique<Optimizer>(sm_manager.get(), planner.get());
+    portal = std::make_unique<Portal>(sm_manager.get());
+    analyze = std::make_unique<Analyze>(sm_manager.get());
+}
+
 pthread_mutex_t *buffer_mutex;
 pthread_mutex_t *sockfd_mutex;
 
@@ -257,17 +385,60 @@ void start_server() {
     int ret = shutdown(sockfd_server, SHUT_WR);  // shut down the all or part of a full-duplex connection.
     if(ret == -1) { printf("%s\n", strerror(errno)); }
 //    assert(ret != -1);
+    buffer_pool_manager->stop_background_writer();
     sm_manager->close_db();
     std::cout << " DB has been closed.\n";
     std::cout << "Server shuts down." << std::endl;
 }
 
 int main(int argc, char **argv) {
-    if (argc != 2) {
-        // 需要指定数据库名称
-        std::cerr << "Usage: " << argv[0] << " <database>" << std::endl;
+    // 解析启动参数: -r 指定buffer pool的置换策略(lru/clock/lru-k)，默认为lru；
+    // -i 指定批量页面I/O的后端(sync/io_uring)，默认为sync；-d 数据文件使用O_DIRECT，绕过内核page cache；
+    // -b 指定buffer pool的大小(如512M、8G)；-p 指定新建数据库的页面大小(4K/8K/16K/32K)；
+    // -c 指定配置文件，其中的项与命令行参数同名(replacer、io_backend、direct_io、buffer_pool_size、page_size)，命令行优先
+    StartupOptions options;
+    std::string config_path;
+    std::vector<std::pair<std::string, std::string>> cli_options;
+    bool valid = true;
+    int opt;
+    while (valid && (opt = getopt(argc, argv, "r:i:db:p:c:")) != -1) {
+        switch (opt) {
+            case 'r': cli_options.emplace_back("replacer", optarg); break;
+            case 'i': cli_options.emplace_back("io_backend", optarg); break;
+            case 'd': cli_options.emplace_back("direct_io", "true"); break;
+            case 'b': cli_options.emplace_back("buffer_pool_size", optarg); break;
+            case 'p': cli_options.emplace_back("page_size", optarg); break;
+            case 'c': config_path = optarg; break;
+            default: valid = false;
+        }
+    }
+    if (valid && !config_path.empty()) {
+        valid = load_config_file(config_path, &options);
+    }
+    for (auto &[key, value] : cli_options) {
+        valid = valid && set_startup_option(&options, key, value);
+    }
+    if (!valid || optind != argc - 1) {
+        // 参数非法或没有指定数据库名称
+        std::cerr << "Usage: " << argv[0]
+                  << " [-c config] [-r lru|clock|lru-k] [-i sync|io_uring] [-d] [-b pool_size] [-p 4K|8K|16K|32K]"
+                     " <database>"
+                  << std::endl;
         exit(1);
     }
+
+    // 已有数据库使用创建时记录的页面大小，新数据库使用参数指定的页面大小
+    std::string db_name = argv[optind];
+    PAGE_SIZE = options.page_size;
+    int db_page_size;
+    if (SmManager::read_db_page_size(db_name, &db_page_size)) {
+        if (options.page_size_set && db_page_size != options.page_size) {
+            std::cerr << "Database " << db_name << " was created with page size " << db_page_size
+                      << ", ignoring page size " << options.page_size << std::endl;
+        }
+        PAGE_SIZE = db_page_size;
+    }
+    init_managers(options);
     signal(SIGINT, sigint_handler);
     try {
         std::cout << "\n"
@@ -281,8 +452,6 @@ int main(int argc, char **argv) {
                      "Welcome to RMDB!\n"
                      "Type 'help;' for help.\n"
                      "\n";
-        // Database name is passed by args
-        std::string db_name = argv[1];
         if (!sm_manager->is_dir(db_name)) {
             // Database not found, create a new one
             sm_manager->create_db(db_name);
@@ -296,6 +465,9 @@ int main(int argc, char **argv) {
         recovery->undo();
         recovery->rebuild();
 
+        // 恢复完成后再开始后台写回脏页
+        buffer_pool_manager->start_background_writer();
+
         // 开启服务端，开始接受客户端连接
         start_server();
     } catch (RMDBError &e) {
@@ -0,0 +1,52 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+
+#include "common/config.h"
+
+class BufferPoolManager;
+
+/**
+ * @description: 某个分片上属于同一个BufferAccessStrategy的环形帧集合
+ * frames_[i]上装入的页面为keys_[i](PageId::Get())；帧被淘汰或删除后页面不再匹配，下次轮到该位置时重新选帧
+ */
+struct BufferRing {
+    size_t capacity_;                   // 本分片上最多占用的帧数
+    std::vector<frame_id_t> frames_;    // 环中的帧(分片内编号)
+    std::vector<int64_t> keys_;         // 环中每个帧装入的页面
+    size_t next_{0};                    // 环满后下一个复用的位置
+
+    explicit BufferRing(size_t capacity) : capacity_(capacity) {}
+};
+
+/**
+ * @description: 大表顺序扫描、建索引等一次性访问大量页面的操作使用的缓冲区访问策略。
+ * 缺页时不从replacer中淘汰热页，而是循环复用一个很小的私有帧环，环中的帧不进入replacer；
+ * 命中buffer pool中已有的页面时与普通访问相同。策略析构时把环中未被pin的帧写回(若为脏页)并放回free_list。
+ * 一个策略只能被一个线程使用。
+ */
+class BufferAccessStrategy {
+    friend class BufferPoolManager;
+
+   public:
+    BufferAccessStrategy(BufferPoolManager *bpm, size_t num_instances, size_t ring_size);
+
+    ~BufferAccessStrategy();
+
+    BufferAccessStrategy(const BufferAccessStrategy &) = delete;
+    BufferAccessStrategy &operator=(const BufferAccessStrategy &) = delete;
+
+   private:
+    BufferPoolManager *bpm_;
+    std::vector<BufferRing> rings_;     // 每个分片一个环，下标与BufferPoolManager::instances_相同
+};
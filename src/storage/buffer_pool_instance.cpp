@@ -0,0 +1,638 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "buffer_pool_instance.h"
+
+BufferPoolInstance::BufferPoolInstance(size_t pool_size, frame_id_t frame_offset, Page *pages,
+                                       DiskManager *disk_manager, LogManager *log_manager, ReplacerType replacer_type)
+    : pool_size_(pool_size), frame_offset_(frame_offset), pages_(pages), page_table_(pool_size),
+      disk_manager_(disk_manager), log_manager_(log_manager) {
+    switch (replacer_type) {
+        case ReplacerType::CLOCK:
+            replacer_ = new ClockReplacer(pool_size_);
+            break;
+        case ReplacerType::LRU_K:
+            replacer_ = new LRUKReplacer(pool_size_);
+            break;
+        case ReplacerType::LRU:
+        default:
+            replacer_ = new LRUReplacer(pool_size_);
+            break;
+    }
+    // 初始化时，所有的page都在free_list_中
+    for (size_t i = 0; i < pool_size_; ++i) {
+        pages_[i].pin_count_.store(FRAME_UNAVAILABLE, std::memory_order_relaxed);
+        free_list_.emplace_back(static_cast<frame_id_t>(i));
+    }
+}
+
+/**
+ * @description: 不加锁地pin住帧，空闲帧或正在被淘汰的帧(pin_count_为负)无法被pin
+ * @return {bool} 是否pin成功
+ */
+bool BufferPoolInstance::try_pin(Page* page) {
+    int pin_count = page->pin_count_.load(std::memory_order_acquire);
+    while (pin_count >= 0) {
+        if (page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @description: 不加锁地释放一次pin，pin_count_归零且帧不在replacer中时把帧交给replacer，帧环中的帧除外
+ * @return {bool} 若pin_count_已经<=0则返回false
+ */
+bool BufferPoolInstance::release_pin(Page* page, frame_id_t frame_id) {
+    int pin_count = page->pin_count_.load(std::memory_order_acquire);
+    do {
+        if (pin_count <= 0) {
+            return false;
+        }
+    } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+    // 与leave_ring先清in_ring_再读pin_count_配对(均为seq_cst)，两者至少有一方会把帧交给replacer
+    if (pin_count == 1 && !page->in_ring_.load() && !page->in_replacer_.exchange(true, std::memory_order_acq_rel)) {
+        replacer_->unpin(frame_id);
+    }
+    return true;
+}
+
+/**
+ * @description: 从free_list或replacer中得到可淘汰帧页的 *frame_id，调用时须持有latch_
+ * 命中路径不经过replacer，replacer中的帧可能已被重新pin，只有把pin_count_从0 CAS为FRAME_UNAVAILABLE成功的帧才能被淘汰
+ * @return {bool} true: 可替换帧查找成功 , false: 可替换帧查找失败
+ * @param {frame_id_t*} frame_id 帧页id指针,返回成功找到的可替换帧id
+ */
+bool BufferPoolInstance::find_victim_page(frame_id_t* frame_id) {
+    if (!free_list_.empty()) {
+        *frame_id = free_list_.front();
+        free_list_.pop_front();
+        return true;
+    }
+    // 本分片已满，需要从replacer中选择淘汰页面
+    while (replacer_->victim(frame_id)) {
+        Page* page = &pages_[*frame_id];
+        // 先清除标记再CAS：CAS失败时，持有者释放最后一个pin后会把帧重新交给replacer
+        page->in_replacer_.store(false, std::memory_order_release);
+        int expected = 0;
+        if (page->pin_count_.compare_exchange_strong(expected, FRAME_UNAVAILABLE, std::memory_order_acq_rel)) {
+            // 离开帧环时残留在replacer中的帧，原帧环在页面不匹配后会放弃该帧
+            page->in_ring_.store(false);
+            return true;
+        }
+        // 该帧正在被使用，pin_count_归零时会重新加入replacer
+    }
+    return false;
+}
+
+/**
+ * @description: 为BufferAccessStrategy的缺页选择帧，调用时须持有latch_
+ * 帧环未满时按普通方式取得一个帧并加入帧环；帧环已满时复用最早装入的帧，
+ * 该帧已被他人pin住、淘汰或删除时，用普通方式取得的帧替换它在环中的位置
+ * @return {bool} true: 找到可用帧，此时帧的pin_count_为FRAME_UNAVAILABLE
+ * @param {BufferRing*} ring 调用者的帧环
+ * @param {int64_t} key 将要装入的页面
+ * @param {frame_id_t*} frame_id 返回找到的帧
+ */
+bool BufferPoolInstance::find_ring_frame(BufferRing* ring, int64_t key, frame_id_t* frame_id) {
+    size_t slot;
+    if (ring->frames_.size() < ring->capacity_) {
+        if (!find_victim_page(frame_id)) {
+            return false;
+        }
+        slot = ring->frames_.size();
+        ring->frames_.emplace_back(*frame_id);
+        ring->keys_.emplace_back(key);
+    } else {
+        slot = ring->next_;
+        ring->next_ = (slot + 1) % ring->capacity_;
+        frame_id_t old_frame = ring->frames_[slot];
+        Page* old_page = &pages_[old_frame];
+        bool owned = old_page->in_ring_.load() &&
+                     old_page->page_key_.load(std::memory_order_acquire) == ring->keys_[slot];
+        int expected = 0;
+        if (owned && old_page->pin_count_.compare_exchange_strong(expected, FRAME_UNAVAILABLE)) {
+            *frame_id = old_frame;
+        } else {
+            if (owned) {
+                leave_ring(old_page, old_frame);
+            }
+            if (!find_victim_page(frame_id)) {
+                return false;
+            }
+            ring->frames_[slot] = *frame_id;
+        }
+        ring->keys_[slot] = key;
+    }
+    pages_[*frame_id].in_ring_.store(true);
+    return true;
+}
+
+/**
+ * @description: 帧退出帧环，此后由replacer管理；若帧此时未被pin则直接交给replacer，调用时须持有latch_
+ */
+void BufferPoolInstance::leave_ring(Page* page, frame_id_t frame_id) {
+    page->in_ring_.store(false);
+    if (page->pin_count_.load() == 0 && !page->in_replacer_.exchange(true, std::memory_order_acq_rel)) {
+        replacer_->unpin(frame_id);
+    }
+}
+
+/**
+ * @description: 将页面写回磁盘，根据WAL规则，刷盘前必须先把该页面对应的日志刷盘
+ * @param {Page*} page 写回页指针
+ */
+void BufferPoolInstance::write_back(Page* page) {
+    if (log_manager_ != nullptr) {
+        if (page->get_page_lsn() > log_manager_->flushed_lsn_) {
+            LOG_DEBUG("Trigger WAL");
+            log_manager_->flush_log_to_disk();
+        }
+        log_manager_->remove_dirty_page(page->get_page_id());
+    }
+    PageId page_id = page->get_page_id();
+    if (disk_manager_->has_page_checksums(page_id.fd)) {
+        // 在副本上填入校验和后写盘，flush_page时持有pin的线程可能仍在修改页面，写出的内容与校验和须一致
+        char* buf = thread_page_buffer();
+        memcpy(buf, page->get_data(), PAGE_SIZE);
+        Page::set_checksum(buf);
+        disk_manager_->write_page(page_id.fd, page_id.page_no, buf, PAGE_SIZE);
+    } else {
+        disk_manager_->write_page(page_id.fd, page_id.page_no, page->get_data(), PAGE_SIZE);
+    }
+    page->is_dirty_ = false;
+}
+
+/**
+ * @description: 更新页面数据, 如果为脏页则需写入磁盘，再更新为新页面，更新page元数据(data, is_dirty, page_id)和page table
+ * 调用时须持有latch_，且帧的pin_count_为FRAME_UNAVAILABLE
+ * @param {Page*} page 写回页指针
+ * @param {PageId} new_page_id 新的page_id
+ * @param {frame_id_t} new_frame_id 新的帧frame_id
+ */
+void BufferPoolInstance::update_page(Page *page, PageId new_page_id, frame_id_t new_frame_id) {
+    if (page->is_dirty() && page->get_page_id().fd != TMP_FD) {
+        write_back(page);
+        sync_writes_.fetch_add(1, std::memory_order_relaxed);
+    }
+    page->is_dirty_ = false;
+    if (page->get_page_id().page_no != INVALID_PAGE_ID) {
+        page_table_.erase(page->get_page_id().Get());
+    }
+    page->reset_memory();
+    page->id_ = new_page_id;
+    if (new_page_id.page_no != INVALID_PAGE_ID) {
+        page->page_key_.store(new_page_id.Get(), std::memory_order_release);
+        page_table_.insert(new_page_id.Get(), new_frame_id);
+    } else {
+        page->page_key_.store(PageTable::EMPTY_KEY, std::memory_order_release);
+    }
+}
+
+/**
+ * @description: 把已经摘除映射的帧放回free_list_，调用时须持有latch_
+ */
+void BufferPoolInstance::free_frame(frame_id_t frame_id) {
+    pages_[frame_id].pin_count_.store(FRAME_UNAVAILABLE, std::memory_order_release);
+    // 帧从replacer中移出(并清空访问历史)后再放回free_list_，避免同一帧被重复分配
+    replacer_->remove(frame_id);
+    pages_[frame_id].in_replacer_.store(false, std::memory_order_release);
+    pages_[frame_id].in_ring_.store(false);
+    free_list_.emplace_back(frame_id);
+}
+
+/**
+ * @description: 读盘失败或等待的页面已被撤销时，释放调用者对该帧的pin，最后一个释放者将帧放回free_list_
+ * 调用时须持有latch_
+ */
+void BufferPoolInstance::release_failed_frame(Page* page, frame_id_t frame_id) {
+    if (page->pin_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        int expected = 0;
+        if (page->pin_count_.compare_exchange_strong(expected, FRAME_UNAVAILABLE, std::memory_order_acq_rel)) {
+            free_frame(frame_id);
+        }
+    }
+}
+
+/**
+ * @description: 从本分片获取需要的页。
+ *              命中时不加锁：无锁查找页表，CAS递增pin_count_后校验帧上的页面仍是目标页面；
+ *              否则在latch下重新查找，若页面仍在读盘中则等待读盘完成；
+ *              未命中时找到victim帧(有ring时为帧环中的帧)并在页表中登记，释放latch后再读盘。
+ * @return {Page*} 若获得了需要的页则将其返回，否则返回nullptr
+ * @param {PageId} page_id 需要获取的页的PageId
+ * @param {BufferRing*} ring 调用者在本分片上的帧环，为nullptr时按普通方式淘汰
+ */
+Page* BufferPoolInstance::fetch_page(PageId page_id, BufferRing* ring) {
+    const int64_t key = page_id.Get();
+    frame_id_t frame_id = page_table_.find(key);
+    if (frame_id != INVALID_FRAME_ID) {
+        Page* page = &pages_[frame_id];
+        if (try_pin(page)) {
+            if (page->page_key_.load(std::memory_order_acquire) == key &&
+                !page->io_pending_.load(std::memory_order_acquire)) {
+                replacer_->record_access(frame_id);
+                return page;
+            }
+            release_pin(page, frame_id);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(latch_);
+    while ((frame_id = page_table_.find(key)) != INVALID_FRAME_ID) {
+        Page* page = &pages_[frame_id];
+        page->pin_count_.fetch_add(1, std::memory_order_acq_rel);
+        replacer_->record_access(frame_id);
+        if (!page->io_pending_) {
+            return page;
+        }
+        // 其他线程正在读入该页面，pin住帧后等待读盘结束
+        io_cv_.wait(lock, [page] { return !page->io_pending_; });
+        if (page->page_key_.load(std::memory_order_acquire) == key) {
+            return page;
+        }
+        // 读盘失败，页面已被撤销，重新查找
+        release_failed_frame(page, frame_id);
+    }
+
+    if (ring != nullptr ? !find_ring_frame(ring, key, &frame_id) : !find_victim_page(&frame_id)) {
+        return nullptr;
+    }
+    replacer_->record_access(frame_id);
+    return read_into_frame(lock, page_id, frame_id);
+}
+
+/**
+ * @description: 把页面读入已经选好的帧：在页表中登记并标记io_pending_，释放latch后读盘，读完后唤醒等待者
+ * 调用时须持有latch_(通过lock)，返回时已释放；读盘失败时撤销登记并抛出异常
+ * @return {Page*} pin_count_为1的页面
+ */
+Page* BufferPoolInstance::read_into_frame(std::unique_lock<std::mutex>& lock, PageId page_id, frame_id_t frame_id) {
+    Page* page = begin_frame_read(page_id, frame_id);
+    lock.unlock();
+    try {
+        disk_manager_->read_page(page_id.fd, page_id.page_no, page->get_data(), PAGE_SIZE);
+    } catch (...) {
+        end_frame_read(page, false);
+        throw;
+    }
+    if (!verify_frame(page)) {
+        char* data = page->get_data();
+        uint32_t stored = Page::get_checksum(data);
+        uint32_t computed = Page::compute_checksum(data);
+        checksum_failures_.fetch_add(1, std::memory_order_relaxed);
+        end_frame_read(page, false);
+        throw PageChecksumError(disk_manager_->get_file_name(page_id.fd), page_id.page_no, stored, computed);
+    }
+    end_frame_read(page, true);
+    return page;
+}
+
+/**
+ * @description: 校验刚读入帧中的页面，文件没有开启校验和时总是有效
+ */
+bool BufferPoolInstance::verify_frame(Page* page) {
+    return !disk_manager_->has_page_checksums(page->get_page_id().fd) || Page::verify_checksum(page->get_data());
+}
+
+/**
+ * @description: 在页表中登记帧上将要读入的页面，并标记io_pending_，之后命中该页面的线程等待读盘结束；须持有latch_
+ * @return {Page*} pin_count_为1的页面
+ */
+Page* BufferPoolInstance::begin_frame_read(PageId page_id, frame_id_t frame_id) {
+    Page* page = &pages_[frame_id];
+    update_page(page, page_id, frame_id);
+    page->io_pending_ = true;
+    page->pin_count_.store(1, std::memory_order_release);
+    return page;
+}
+
+/**
+ * @description: 结束begin_frame_read开始的读盘并唤醒等待者；读盘失败时撤销登记，读盘线程的pin随之释放。不能持有latch_
+ */
+void BufferPoolInstance::end_frame_read(Page* page, bool ok) {
+    {
+        std::scoped_lock<std::mutex> lock(latch_);
+        page->io_pending_ = false;
+        if (!ok) {
+            page_table_.erase(page->id_.Get());
+            page->id_.page_no = INVALID_PAGE_ID;
+            page->page_key_.store(PageTable::EMPTY_KEY, std::memory_order_release);
+            release_failed_frame(page, static_cast<frame_id_t>(page - pages_));
+        }
+    }
+    io_cv_.notify_all();
+}
+
+bool BufferPoolInstance::begin_prefetch(PageId page_id, Page** page) {
+    *page = nullptr;
+    if (page_table_.find(page_id.Get()) != INVALID_FRAME_ID) {
+        return true;
+    }
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (page_table_.find(page_id.Get()) != INVALID_FRAME_ID) {
+        return true;
+    }
+    frame_id_t frame_id;
+    if (!find_victim_page(&frame_id)) {
+        return false;
+    }
+    *page = begin_frame_read(page_id, frame_id);
+    return true;
+}
+
+void BufferPoolInstance::end_prefetch(Page* page, bool ok) {
+    // 校验和不匹配的页面不装入，之后的fetch_page重新读盘并报告错误
+    ok = ok && verify_frame(page);
+    end_frame_read(page, ok);
+    if (ok) {
+        release_pin(page, static_cast<frame_id_t>(page - pages_));
+    }
+}
+
+/**
+ * @description: 取消固定pin_count>0的在缓冲池中的page，调用者持有pin，页面不会被淘汰，因此不需要加锁
+ * @return {bool} 如果目标页的pin_count<=0则返回false，否则返回true
+ * @param {PageId} page_id 目标page的page_id
+ * @param {bool} is_dirty 若目标page应该被标记为dirty则为true，否则为false
+ */
+bool BufferPoolInstance::unpin_page(PageId page_id, bool is_dirty) {
+    const int64_t key = page_id.Get();
+    frame_id_t frame_id = page_table_.find(key);
+    if (frame_id == INVALID_FRAME_ID || pages_[frame_id].page_key_.load(std::memory_order_acquire) != key) {
+        // 无锁查找可能出现假阴性，在latch下确认
+        std::scoped_lock<std::mutex> lock(latch_);
+        frame_id = page_table_.find(key);
+        if (frame_id == INVALID_FRAME_ID) {
+            return false;
+        }
+    }
+    auto page = &pages_[frame_id];
+    if (page->pin_count_.load(std::memory_order_acquire) <= 0) {
+        return false;
+    }
+    // 先标记脏页再释放pin，淘汰者CAS成功后一定能看到脏标记
+    if (is_dirty) {
+        page->is_dirty_ = true;
+    }
+    return release_pin(page, frame_id);
+}
+
+/**
+ * @description: 将目标页写回磁盘，不考虑当前页面是否正在被使用
+ * @return {bool} 成功则返回true，否则返回false(只有page_table_中没有目标页时)
+ * @param {PageId} page_id 目标页的page_id，不能为INVALID_PAGE_ID
+ */
+bool BufferPoolInstance::flush_page(PageId page_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    frame_id_t frame_id = page_table_.find(page_id.Get());
+    if (frame_id == INVALID_FRAME_ID) {
+        return false;
+    }
+    auto page = &pages_[frame_id];
+    // 仍在读盘中的页面内容无效，且磁盘上已是最新
+    if (!page->io_pending_) {
+        write_back(page);
+    }
+    return true;
+}
+
+/**
+ * @description: 在本分片中为新页面分配帧，page_id的页号已经由DiskManager分配
+ * @return {Page*} 返回新创建的page，若本分片没有可用帧则返回nullptr
+ * @param {PageId} page_id 新页面的page_id
+ */
+Page* BufferPoolInstance::new_page(PageId page_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    frame_id_t frame_id;
+    if (!find_victim_page(&frame_id)) {
+        return nullptr;
+    }
+    auto page = &pages_[frame_id];
+    update_page(page, page_id, frame_id);
+    // 页号已在磁盘上预分配(见DiskManager::allocate_page)，这里不写盘；标记为脏页，
+    // 保证帧被淘汰后重新读到的是全0的新页面，而不是复用页号上的旧内容
+    page->is_dirty_ = true;
+    page->pin_count_.store(1, std::memory_order_release);
+    return page;
+}
+
+/**
+ * @description: 从本分片删除目标页，并通过DiskManager::deallocate_page释放其页号
+ * @return {bool} 如果目标页不存在于buffer_pool或者成功被删除则返回true，若其存在于buffer_pool但无法删除则返回false
+ * @param {PageId} page_id 目标页
+ */
+bool BufferPoolInstance::delete_page(PageId page_id) {
+    std::unique_lock<std::mutex> lock(latch_);
+    frame_id_t frame_id;
+    Page* page;
+    while (true) {
+        frame_id = page_table_.find(page_id.Get());
+        if (frame_id == INVALID_FRAME_ID) {
+            disk_manager_->deallocate_page(page_id.fd, page_id.page_no);
+            return true;
+        }
+        page = &pages_[frame_id];
+        int expected = 0;
+        if (page->pin_count_.compare_exchange_strong(expected, FRAME_UNAVAILABLE, std::memory_order_acq_rel)) {
+            break;
+        }
+        // 页面只是正在被批量写回，等待写回结束后重试
+        if (expected <= 0 || page->write_pins_.load(std::memory_order_relaxed) < expected) {
+            return false;
+        }
+        io_cv_.wait(lock, [page] { return page->write_pins_.load(std::memory_order_relaxed) == 0; });
+    }
+    // 被释放的页面内容不再需要，脏页不写回，也不必为它先刷日志
+    if (page->is_dirty() && log_manager_ != nullptr) {
+        log_manager_->remove_dirty_page(page_id);
+    }
+    page->is_dirty_ = false;
+    auto new_page_id = page->get_page_id();
+    new_page_id.page_no = INVALID_PAGE_ID;
+    update_page(page, new_page_id, frame_id);
+    free_frame(frame_id);
+    disk_manager_->deallocate_page(page_id.fd, page_id.page_no);
+    return true;
+}
+
+/**
+ * @description: 找出本分片中属于fd的所有页面并pin住，持有pin期间帧不会被淘汰，调用者写回后须调用finish_dirty_page
+ * 正在读盘的页面与磁盘一致，正在被淘汰的页面由淘汰者写回，二者都跳过
+ * @param {int} fd 文件句柄
+ * @param {vector<pair<PageId, frame_id_t>>*} out 返回的页面及其帧号
+ */
+void BufferPoolInstance::collect_pages(int fd, std::vector<std::pair<PageId, frame_id_t>>* out) {
+    std::scoped_lock lock(latch_);
+    for (size_t i = 0; i < pool_size_; i++) {
+        Page *page = &pages_[i];
+        if (page->get_page_id().fd == fd && page->get_page_id().page_no != INVALID_PAGE_ID && !page->io_pending_ &&
+            try_pin(page)) {
+            page->write_pins_.fetch_add(1, std::memory_order_relaxed);
+            out->emplace_back(page->get_page_id(), static_cast<frame_id_t>(i));
+        }
+    }
+}
+
+/**
+ * @description: 删除本分片中属于fd的所有页，不写回磁盘
+ * @param {int} fd 文件句柄
+ */
+void BufferPoolInstance::delete_all_pages(int fd) {
+    std::unique_lock<std::mutex> lock(latch_);
+    for (size_t i = 0; i < pool_size_; i++) {
+        Page *page = &pages_[i];
+        if (page->get_page_id().fd == fd && page->get_page_id().page_no != INVALID_PAGE_ID) {
+            io_cv_.wait(lock, [page] { return !page->io_pending_; });
+            if (page->get_page_id().fd != fd || page->get_page_id().page_no == INVALID_PAGE_ID) {
+                continue;
+            }
+            frame_id_t frame_id = static_cast<frame_id_t>(i);
+            page->pin_count_.store(FRAME_UNAVAILABLE, std::memory_order_release);
+            // 文件已被删除，脏页不再写回
+            if (page->is_dirty() && log_manager_ != nullptr) {
+                log_manager_->remove_dirty_page(page->get_page_id());
+            }
+            page->is_dirty_ = false;
+            auto new_page_id = page->get_page_id();
+            new_page_id.page_no = INVALID_PAGE_ID;
+            update_page(page, new_page_id, frame_id);
+            free_frame(frame_id);
+        }
+    }
+}
+
+Page *BufferPoolInstance::new_tmp_page(PageId *page_id) {
+    assert(page_id->fd == TMP_FD);
+    std::scoped_lock<std::mutex> lock(latch_);
+    frame_id_t frame_id;
+    if (!find_victim_page(&frame_id)) {
+        return nullptr;
+    }
+    // 直接将帧在整个buffer pool中的编号作为新的page_no，unpin时据此找回分片和帧
+    page_id->page_no = frame_offset_ + frame_id;
+
+    auto page = &pages_[frame_id];
+    update_page(page, *page_id, frame_id);
+    page->pin_count_.store(1, std::memory_order_release);
+    return page;
+}
+
+bool BufferPoolInstance::unpin_tmp_page(PageId page_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+
+    frame_id_t frame_id = page_id.page_no - frame_offset_;
+    auto page = &pages_[frame_id];
+    assert(page->get_page_id().fd == TMP_FD);
+    if (page->pin_count_.load(std::memory_order_acquire) <= 0) {
+        return false;
+    }
+    // 临时页面不进入replacer，pin_count归零后直接放回free_list_
+    if (page->pin_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        auto new_page_id = page->get_page_id();
+        new_page_id.page_no = INVALID_PAGE_ID;
+        update_page(page, new_page_id, frame_id);
+        free_frame(frame_id);
+    }
+    return true;
+}
+
+/**
+ * @description: 归还帧环占用的帧。仍属于该帧环且未被pin的帧写回(若为脏页)后放回free_list_，
+ * 已被其他线程pin住的帧退出帧环，由持有者释放pin后交给replacer
+ * @param {BufferRing*} ring 需要归还的帧环，调用后为空
+ */
+void BufferPoolInstance::release_ring(BufferRing* ring) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (size_t i = 0; i < ring->frames_.size(); ++i) {
+        frame_id_t frame_id = ring->frames_[i];
+        Page* page = &pages_[frame_id];
+        if (!page->in_ring_.load() || page->page_key_.load(std::memory_order_acquire) != ring->keys_[i]) {
+            continue;
+        }
+        int expected = 0;
+        if (page->pin_count_.compare_exchange_strong(expected, FRAME_UNAVAILABLE)) {
+            auto new_page_id = page->get_page_id();
+            new_page_id.page_no = INVALID_PAGE_ID;
+            update_page(page, new_page_id, frame_id);
+            free_frame(frame_id);
+        } else {
+            leave_ring(page, frame_id);
+        }
+    }
+    ring->frames_.clear();
+    ring->keys_.clear();
+    ring->next_ = 0;
+}
+
+/**
+ * @description: 后台写页线程的一轮中，在本分片挑选需要写回的脏页。空闲帧与replacer即将淘汰的帧中的干净帧
+ * 合计达到本分片帧数的1/BG_WRITER_CLEAN_DIVISOR即可；不足时，即将淘汰的帧中未被使用的脏页被pin住后返回，
+ * 持有pin期间帧不会被淘汰，调用者写回后须调用finish_dirty_page
+ * @param {size_t} max_pages 最多返回的页数
+ * @param {vector<pair<PageId, frame_id_t>>*} out 返回的脏页及其帧号
+ */
+void BufferPoolInstance::collect_dirty_victims(size_t max_pages, std::vector<std::pair<PageId, frame_id_t>>* out) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    size_t clean_target = std::max<size_t>(1, pool_size_ / BG_WRITER_CLEAN_DIVISOR);
+    if (free_list_.size() >= clean_target) {
+        return;
+    }
+    std::vector<frame_id_t> frames;
+    replacer_->peek_victims(clean_target - free_list_.size(), &frames);
+    size_t added = 0;
+    for (frame_id_t frame_id : frames) {
+        if (added >= max_pages) {
+            break;
+        }
+        Page* page = &pages_[frame_id];
+        if (!page->is_dirty() || page->get_page_id().fd == TMP_FD) {
+            continue;
+        }
+        // 只pin当前无人使用的帧：正在使用的帧不会被淘汰，也可能马上再次被修改
+        int expected = 0;
+        if (page->pin_count_.compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
+            page->write_pins_.fetch_add(1, std::memory_order_relaxed);
+            out->emplace_back(page->get_page_id(), frame_id);
+            ++added;
+        }
+    }
+}
+
+/**
+ * @description: 先清除脏标记再复制页面：复制之后的修改会在unpin时重新标记脏页，由之后的写回处理
+ * @return {lsn_t} 副本中的页面LSN，写回前须保证日志已刷盘到该LSN
+ */
+lsn_t BufferPoolInstance::snapshot_dirty_page(frame_id_t frame_id, char* buf) {
+    Page* page = &pages_[frame_id];
+    page->is_dirty_.exchange(false);
+    memcpy(buf, page->get_data(), PAGE_SIZE);
+    if (disk_manager_->has_page_checksums(page->get_page_id().fd)) {
+        Page::set_checksum(buf);
+    }
+    return *reinterpret_cast<lsn_t*>(buf + Page::OFFSET_LSN);
+}
+
+void BufferPoolInstance::finish_dirty_page(frame_id_t frame_id, bool written) {
+    Page* page = &pages_[frame_id];
+    if (!written) {
+        page->is_dirty_ = true;
+    } else if (log_manager_ != nullptr && !page->is_dirty()) {
+        // 写回期间页面没有被再次修改，才能从脏页表中移除
+        log_manager_->remove_dirty_page(page->get_page_id());
+    }
+    {
+        std::scoped_lock<std::mutex> lock(latch_);
+        page->write_pins_.fetch_sub(1, std::memory_order_relaxed);
+        release_pin(page, frame_id);
+    }
+    io_cv_.notify_all();
+}
@@ -0,0 +1,160 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <climits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "disk_manager.h"
+#include "errors.h"
+#include "common/config.h"
+#include "storage/buffer_access_strategy.h"
+#include "storage/page.h"
+#include "storage/page_table.h"
+#include "replacer/clock_replacer.h"
+#include "replacer/lru_k_replacer.h"
+#include "replacer/lru_replacer.h"
+#include "replacer/replacer.h"
+#include "recovery/log_manager.h"
+
+/**
+ * @description: buffer pool的一个分片。每个分片管理一段连续的帧，拥有独立的latch、页表、空闲链表和replacer，
+ * BufferPoolManager根据PageId的哈希值把页面分配到某个分片上，不同分片之间互不阻塞。
+ * 读盘不持有latch：缺页时先在页表中登记并把帧标记为io_pending_，释放latch后再读盘，
+ * 其他访问该页面的线程在io_cv_上等待读入完成。
+ * 命中路径不加锁：页表支持无锁查找，pin_count_为原子变量，latch_只在缺页、淘汰和删除页面时使用。
+ */
+class BufferPoolInstance {
+   private:
+    size_t pool_size_;      // 本分片的帧数
+    frame_id_t frame_offset_;   // 本分片第一个帧在整个buffer pool中的编号
+    Page *pages_;           // 本分片的Page数组，指向BufferPoolManager申请的连续空间中的一段
+    PageTable page_table_;  // PageId::Get()到本分片内帧号的映射，查找无锁，修改须持有latch_
+    std::list<frame_id_t> free_list_;   // 空闲帧编号的链表
+    DiskManager *disk_manager_;
+    LogManager *log_manager_;
+    Replacer *replacer_;    // 本分片的置换策略
+    std::mutex latch_;      // 保护本分片的页表、空闲链表和页面元数据
+    std::condition_variable io_cv_; // 等待页面读盘完成
+    std::atomic<size_t> sync_writes_{0};    // 前台淘汰或删除页面时同步写回的脏页数
+    std::atomic<size_t> checksum_failures_{0};  // 读入时校验和不匹配的页面数
+
+   public:
+    static constexpr int FRAME_UNAVAILABLE = INT_MIN;   // 空闲帧或正在被淘汰的帧的pin_count_，无锁路径无法pin住
+
+    BufferPoolInstance(size_t pool_size, frame_id_t frame_offset, Page *pages, DiskManager *disk_manager,
+                       LogManager *log_manager, ReplacerType replacer_type = ReplacerType::LRU);
+
+    ~BufferPoolInstance() { delete replacer_; }
+
+    /**
+     * @description: 获取页面，ring不为空时缺页只复用ring中的帧，不淘汰replacer中的页面
+     */
+    Page* fetch_page(PageId page_id, BufferRing* ring = nullptr);
+
+    /**
+     * @description: 开始预读页面：页面不在本分片中时为它选一个帧并登记，由调用者读盘后调用end_prefetch；
+     * 预读不记作一次访问。页面已在缓冲池中时*page为nullptr
+     * @return {bool} 没有可用帧时返回false
+     */
+    bool begin_prefetch(PageId page_id, Page** page);
+
+    /**
+     * @description: 结束预读，ok表示读盘是否成功；成功时页面留在缓冲池中并释放预读的pin，失败时撤销登记
+     */
+    void end_prefetch(Page* page, bool ok);
+
+    bool unpin_page(PageId page_id, bool is_dirty);
+
+    bool flush_page(PageId page_id);
+
+    /**
+     * @description: 在本分片中为已分配好页号的page_id创建新页面
+     */
+    Page* new_page(PageId page_id);
+
+    bool delete_page(PageId page_id);
+
+    /**
+     * @description: pin住本分片中属于fd的所有页面并返回，交给调用者写回
+     */
+    void collect_pages(int fd, std::vector<std::pair<PageId, frame_id_t>>* out);
+
+    void delete_all_pages(int fd);
+
+    size_t get_free_size() {
+        std::scoped_lock lock(latch_);
+        return free_list_.size();
+    }
+
+    /**
+     * @description: 创建临时页面，page_no为该帧在整个buffer pool中的编号
+     */
+    Page* new_tmp_page(PageId* page_id);
+
+    bool unpin_tmp_page(PageId page_id);
+
+    /**
+     * @description: 归还ring占用的帧，未被pin的帧写回后放回free_list_
+     */
+    void release_ring(BufferRing* ring);
+
+    /**
+     * @description: 后台写页线程：找出replacer即将淘汰的脏页并pin住，交给调用者写回
+     */
+    void collect_dirty_victims(size_t max_pages, std::vector<std::pair<PageId, frame_id_t>>* out);
+
+    /**
+     * @description: 清除collect_dirty_victims/collect_pages返回的帧的脏标记并把页面复制到buf，返回页面的LSN
+     */
+    lsn_t snapshot_dirty_page(frame_id_t frame_id, char* buf);
+
+    /**
+     * @description: 写回结束，释放collect_dirty_victims/collect_pages加上的pin；写回失败时恢复脏标记
+     */
+    void finish_dirty_page(frame_id_t frame_id, bool written);
+
+    size_t get_sync_write_count() const { return sync_writes_.load(std::memory_order_relaxed); }
+
+    size_t get_checksum_failure_count() const { return checksum_failures_.load(std::memory_order_relaxed); }
+
+   private:
+    bool try_pin(Page* page);
+
+    bool release_pin(Page* page, frame_id_t frame_id);
+
+    bool find_victim_page(frame_id_t* frame_id);
+
+    bool find_ring_frame(BufferRing* ring, int64_t key, frame_id_t* frame_id);
+
+    void leave_ring(Page* page, frame_id_t frame_id);
+
+    void free_frame(frame_id_t frame_id);
+
+    void update_page(Page* page, PageId new_page_id, frame_id_t new_frame_id);
+
+    void write_back(Page* page);
+
+    void release_failed_frame(Page* page, frame_id_t frame_id);
+
+    Page* read_into_frame(std::unique_lock<std::mutex>& lock, PageId page_id, frame_id_t frame_id);
+
+    Page* begin_frame_read(PageId page_id, frame_id_t frame_id);
+
+    void end_frame_read(Page* page, bool ok);
+
+    bool verify_frame(Page* page);
+};
@@ -10,280 +10,355 @@ See the Mulan PSL v2 for more details. */
 
 #include "buffer_pool_manager.h"
 
+#include <sys/mman.h>
 
-/**
- * @description: 从free_list或replacer中得到可淘汰帧页的 *frame_id
- * @return {bool} true: 可替换帧查找成功 , false: 可替换帧查找失败
- * @param {frame_id_t*} frame_id 帧页id指针,返回成功找到的可替换帧id
- *
- */
-bool BufferPoolManager::find_victim_page(frame_id_t* frame_id) {
-    // 1 使用BufferPoolManager::free_list_判断缓冲池是否已满需要淘汰页面
-    // 1.1 未满获得frame
-    // 1.2 已满使用lru_replacer中的方法选择淘汰页面
-    bool find_victim{false};
-    if(free_list_.empty()) {
-    // buffer pool 已满，需要从replacer中选择淘汰页面。
-    find_victim = replacer_->victim(frame_id);
-    } else {
-        *frame_id = free_list_.front();
-        free_list_.pop_front();
-        find_victim = true;
-    }
-    return find_victim;
-}
+#include <chrono>
+#include <iostream>
 
 /**
- * @description: 更新页面数据, 如果为脏页则需写入磁盘，再更新为新页面，更新page元数据(data, is_dirty, page_id)和page table
- * @param {Page*} page 写回页指针
- * @param {PageId} new_page_id 新的page_id
- * @param {frame_id_t} new_frame_id 新的帧frame_id
+ * @description: 用匿名映射为pool_size个帧分配数据区，映射按页对齐且初始为0，物理内存在帧第一次使用时才分配。
+ * BUFFER_POOL_HUGE_PAGES为true且数据区不小于一个大页时，按HUGE_PAGE_SIZE对齐并建议内核使用透明大页，减少TLB缺失
+ * @param {size_t*} mapped_size 映射的字节数，释放时使用
  */
-void BufferPoolManager::update_page(Page *page, PageId new_page_id, frame_id_t new_frame_id) {
-    // 1 如果是脏页，写回磁盘，并且把dirty置为false
-    // 2 更新page table
-    // 3 重置page的data，更新page id
-    // 根据WAL规则，刷盘前必须先写入LOG
-    if(page->get_page_lsn() > log_manager_->flushed_lsn_) {
-        LOG_DEBUG("Trigger WAL");
-        log_manager_->flush_log_to_disk();
+char* BufferPoolManager::allocate_frame_data(size_t pool_size, size_t* mapped_size) {
+    size_t size = pool_size * PAGE_SIZE;
+    bool huge = BUFFER_POOL_HUGE_PAGES && size >= HUGE_PAGE_SIZE;
+    if (huge) {
+        size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
     }
-    // 首先检查该页上是否是有页面。
-    if(page->is_dirty()&&page->get_page_id().fd!=TMP_FD){
-        page->is_dirty_ = false;
-        disk_manager_->write_page(page->get_page_id().fd, page->get_page_id().page_no, page->get_data(), PAGE_SIZE);
-        log_manager_->dirty_page_table_.erase(page->get_page_id());
+    size_t map_size = huge ? size + HUGE_PAGE_SIZE : size;
+    void* addr = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+        throw UnixError();
     }
-    page_table_.erase(page->get_page_id()); //update page table
-    if(new_page_id.page_no != INVALID_PAGE_ID) {
-        page_table_.insert(std::make_pair(new_page_id, new_frame_id));
+    char* data = static_cast<char*>(addr);
+    if (huge) {
+        // 多映射一个大页，截掉首尾使数据区按大页对齐
+        auto begin = reinterpret_cast<uintptr_t>(data);
+        uintptr_t aligned = (begin + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        if (aligned > begin) {
+            munmap(data, aligned - begin);
+        }
+        if (aligned + size < begin + map_size) {
+            munmap(reinterpret_cast<char*>(aligned + size), begin + map_size - aligned - size);
+        }
+        data = reinterpret_cast<char*>(aligned);
+        madvise(data, size, MADV_HUGEPAGE);     // 只是建议，内核不支持时忽略
     }
-    page->reset_memory();
-    page->id_ = new_page_id;
+    *mapped_size = size;
+    return data;
 }
 
+void BufferPoolManager::free_frame_data(char* frame_data, size_t mapped_size) { munmap(frame_data, mapped_size); }
+
 /**
- * @description: 从buffer pool获取需要的页。
- *              如果页表中存在page_id（说明该page在缓冲池中），并且pin_count++。
- *              如果页表不存在page_id（说明该page在磁盘中），则找缓冲池victim page，将其替换为磁盘中读取的page，pin_count置1。
- * @return {Page*} 若获得了需要的页则将其返回，否则返回nullptr
- * @param {PageId} page_id 需要获取的页的PageId
+ * @description: 创建一个新的page，先由DiskManager分配页号，再在该页号对应的分片中分配帧。
+ * @return {Page*} 返回新创建的page，若创建失败则返回nullptr
+ * @param {PageId*} page_id 当成功创建一个新的page时存储其page_id
  */
-Page* BufferPoolManager::fetch_page(PageId page_id) {
-    // 1.     从page_table_中搜寻目标页
-    // 1.1    若目标页有被page_table_记录，则将其所在frame固定(pin)，并返回目标页。
-    // 1.2    否则，尝试调用find_victim_page获得一个可用的frame，若失败则返回nullptr
-    // 2.     若获得的可用frame存储的为dirty page，则须调用update_page将page写回到磁盘
-    // 3.     调用disk_manager_的read_page读取目标页到frame
-    // 4.     固定目标页，更新pin_count_
-    // 5.     返回目标页
-    std::scoped_lock<std::mutex> lock(latch_);
-    auto it = page_table_.find(page_id);
-    if(it==page_table_.end()) {
-        // not find
-        frame_id_t frame_id;
-        if(!find_victim_page(&frame_id)) {
-            return nullptr;
-        }
-        auto p  = &pages_[frame_id];
-        update_page(p,page_id,frame_id); // 调用update_page将page写回到磁盘
-        disk_manager_->read_page(page_id.fd,page_id.page_no,p->get_data(),PAGE_SIZE); // 调用disk_manager_的read_page读取目标页到frame
-        p->pin_count_ = 1;
-        replacer_->pin(frame_id);
-        return p;
-    } else {
-        auto frame_id = it->second;
-        pages_[frame_id].pin_count_++;
-        replacer_->pin(frame_id);
-        return &pages_[frame_id];
+Page* BufferPoolManager::new_page(PageId* page_id) {
+    // 页号决定了页面所在的分片，因此只能先分配页号；分片已满时把页号还给空闲页面位图(文件启用了位图时)，
+    // 上层(如RmFileHandle)只在new_page成功后才更新num_pages，重新打开文件时页号会按num_pages重新分配
+    page_id->page_no = disk_manager_->allocate_page(page_id->fd);
+    Page* page = get_instance(*page_id)->new_page(*page_id);
+    if (page == nullptr) {
+        disk_manager_->deallocate_page(page_id->fd, page_id->page_no);
     }
+    return page;
 }
 
 /**
- * @description: 取消固定pin_count>0的在缓冲池中的page
- * @return {bool} 如果目标页的pin_count<=0则返回false，否则返回true
- * @param {PageId} page_id 目标page的page_id
- * @param {bool} is_dirty 若目标page应该被标记为dirty则为true，否则为false
+ * @description: 将buffer_pool中属于fd的所有页按页号顺序写回到磁盘，页号连续的页面合并为一次写
+ * @param {int} fd 文件句柄
  */
-bool BufferPoolManager::unpin_page(PageId page_id, bool is_dirty) {
-    // 0. lock latch
-    std::scoped_lock<std::mutex> lock(latch_);
-    // 1. 尝试在page_table_中搜寻page_id对应的页P
-    auto it = page_table_.find(page_id);
-    // 1.1 P在页表中不存在 return false
-    if(it==page_table_.end()) {
-        return false;
+void BufferPoolManager::flush_all_pages(int fd) {
+    // 文件即将关闭，之后不能再为它预读页面
+    cancel_prefetch(fd);
+    std::vector<PinnedPage> pages;
+    std::vector<std::pair<PageId, frame_id_t>> collected;
+    for (auto &instance : instances_) {
+        collected.clear();
+        instance->collect_pages(fd, &collected);
+        for (auto &[page_id, frame_id] : collected) {
+            pages.push_back({page_id, frame_id, instance.get()});
+        }
     }
-    // 1.2 P在页表中存在，获取其pin_count_
-    auto page = &pages_[it->second];
-    auto& pin_count = page->pin_count_;
-    // 2.1 若pin_count_已经等于0，则返回false
-    if(pin_count <= 0) {
-        return false;
+    write_pinned_pages(&pages);
+}
+
+void BufferPoolManager::delete_all_pages(int fd) {
+    // 等待进行中的后台写回结束，被删除的页面不能再被写回
+    cancel_prefetch(fd);
+    std::scoped_lock lock(writer_round_latch_);
+    for (auto &instance : instances_) {
+        instance->delete_all_pages(fd);
     }
+}
 
-    // 2.2 若pin_count_大于0，则pin_count_自减一
-    pin_count--;
-    // 2.2.1 若自减后等于0，则调用replacer_的Unpin
-    if(pin_count==0) {
-        replacer_->unpin(it->second);
-        // free_list_.emplace_back(it->second);
+size_t BufferPoolManager::get_free_size() {
+    size_t free_size = 0;
+    for (auto &instance : instances_) {
+        free_size += instance->get_free_size();
     }
-    // 3 根据参数is_dirty，更改P的is_dirty_
-    page->is_dirty_|=is_dirty;
-    return true;
+    return free_size;
 }
 
 /**
- * @description: 将目标页写回磁盘，不考虑当前页面是否正在被使用
- * @return {bool} 成功则返回true，否则返回false(只有page_table_中没有目标页时)
- * @param {PageId} page_id 目标页的page_id，不能为INVALID_PAGE_ID
+ * @description: 临时页面不对应磁盘页，轮流从各分片中分配，所有分片都没有可用帧时返回nullptr
  */
-bool BufferPoolManager::flush_page(PageId page_id) {
-    // 0. lock latch
-    std::scoped_lock<std::mutex> lock(latch_);
-    // 1. 查找页表,尝试获取目标页P
-    auto it = page_table_.find(page_id);
-    // 1.1 目标页P没有被page_table_记录 ，返回false
-    if(it==page_table_.end()) {
-        return false;
+Page *BufferPoolManager::new_tmp_page(PageId *page_id) {
+    assert(page_id->fd==TMP_FD);
+    size_t start = next_tmp_instance_++;
+    for (size_t i = 0; i < instances_.size(); ++i) {
+        auto page = instances_[(start + i) % instances_.size()]->new_tmp_page(page_id);
+        if (page != nullptr) {
+            return page;
+        }
     }
-    // 2. 无论P是否为脏都将其写回磁盘。
-    auto page = &pages_[it->second];
-    log_manager_->dirty_page_table_.erase(page_id);
-    disk_manager_->write_page(page->get_page_id().fd, page->get_page_id().page_no, page->get_data(), PAGE_SIZE);
-    // 3. 更新P的is_dirty_
-    page->is_dirty_ = false;
-    return true;
+    return nullptr;
 }
 
-/**
- * @description: 创建一个新的page，即从磁盘中移动一个新建的空page到缓冲池某个位置。
- * @return {Page*} 返回新创建的page，若创建失败则返回nullptr
- * @param {PageId*} page_id 当成功创建一个新的page时存储其page_id
- */
-Page* BufferPoolManager::new_page(PageId* page_id) {
-    std::scoped_lock<std::mutex> lock(latch_);
-    // 1.   获得一个可用的frame，若无法获得则返回nullptr
-    frame_id_t frame_id;
+bool BufferPoolManager::unpin_tmp_page(PageId page_id) {
+    // 临时页面的page_no即帧在整个buffer pool中的编号
+    size_t idx = std::min<size_t>(page_id.page_no / instance_size_, instances_.size() - 1);
+    return instances_[idx]->unpin_tmp_page(page_id);
+}
 
-    if(!find_victim_page(&frame_id)) {
-        return nullptr;
+void BufferPoolManager::release_access_strategy(BufferAccessStrategy* strategy) {
+    for (size_t i = 0; i < instances_.size(); ++i) {
+        instances_[i]->release_ring(&strategy->rings_[i]);
     }
-    // 2.   在fd对应的文件分配一个新的page_id
-    page_id->page_no = disk_manager_->allocate_page(page_id->fd);
-    auto page = &pages_[frame_id];
-    // 3.   将frame的数据写回磁盘
-    update_page(page, *page_id,frame_id);
-    // 4.   固定frame，更新pin_count_
-    page->pin_count_++;
-    replacer_->pin(frame_id);
-    // 需写回
-    disk_manager_->write_page(page_id->fd, page_id->page_no, page->data_, PAGE_SIZE);
-    // 5.   返回获得的page
-    return page;
 }
 
-/**
- * @description: 从buffer_pool删除目标页
- * @return {bool} 如果目标页不存在于buffer_pool或者成功被删除则返回true，若其存在于buffer_pool但无法删除则返回false
- * @param {PageId} page_id 目标页
- */
-bool BufferPoolManager::delete_page(PageId page_id) {
-    std::scoped_lock<std::mutex> lock(latch_);
-    // 1.   在page_table_中查找目标页，若不存在返回true
-    auto it = page_table_.find(page_id);
-    if(it==page_table_.end()) {
-        return true;
+BufferAccessStrategy::BufferAccessStrategy(BufferPoolManager* bpm, size_t num_instances, size_t ring_size)
+    : bpm_(bpm) {
+    size_t capacity = std::max<size_t>(2, (ring_size + num_instances - 1) / num_instances);
+    rings_.reserve(num_instances);
+    for (size_t i = 0; i < num_instances; ++i) {
+        rings_.emplace_back(capacity);
     }
-    // 2.   若目标页的pin_count不为0，则返回false
-    auto page = &pages_[it->second];
-    if(page->pin_count_>0) {
-        return false;
+}
+
+BufferAccessStrategy::~BufferAccessStrategy() { bpm_->release_access_strategy(this); }
+
+void BufferPoolManager::start_background_writer() {
+    std::scoped_lock lock(writer_latch_);
+    if (writer_running_) {
+        return;
     }
-    page_table_.erase(it);
-    // 3.   将目标页数据写回磁盘，从页表中删除目标页，重置其元数据，将其加入free_list_，返回true
-    auto new_page_id = page->get_page_id();
-    new_page_id.page_no=INVALID_PAGE_ID;
-    update_page(page,new_page_id,it->second);
-    free_list_.emplace_back(it->second);
-    disk_manager_->deallocate_page(page_id.page_no);
-    return true;
+    writer_running_ = true;
+    writer_thread_ = std::thread([this] {
+        std::unique_lock<std::mutex> lock(writer_latch_);
+        while (writer_running_) {
+            lock.unlock();
+            size_t written = 0;
+            try {
+                written = write_dirty_pages();
+            } catch (RMDBError &e) {
+                std::cerr << "background writer: " << e.what() << std::endl;
+            }
+            lock.lock();
+            // 一轮写满说明脏页积压，不等待直接开始下一轮
+            if (written < BG_WRITER_MAX_PAGES) {
+                writer_cv_.wait_for(lock, std::chrono::milliseconds(BG_WRITER_DELAY_MS),
+                                    [this] { return !writer_running_; });
+            }
+        }
+    });
 }
 
-/**
- * @description: 将buffer_pool中的所有页写回到磁盘
- * @param {int} fd 文件句柄
- */
-void BufferPoolManager::flush_all_pages(int fd) {
-    std::scoped_lock lock(latch_);
-    for (size_t i = 0; i < pool_size_; i++) {
-        Page *page = &pages_[i];
-        if (page->get_page_id().fd == fd && page->get_page_id().page_no != INVALID_PAGE_ID) {
-            log_manager_->dirty_page_table_.erase(page->get_page_id());
-            disk_manager_->write_page(page->get_page_id().fd, page->get_page_id().page_no, page->get_data(), PAGE_SIZE);
-            page->is_dirty_ = false;
+void BufferPoolManager::stop_background_writer() {
+    {
+        std::scoped_lock lock(writer_latch_);
+        if (!writer_running_) {
+            return;
         }
+        writer_running_ = false;
     }
+    writer_cv_.notify_all();
+    writer_thread_.join();
 }
 
-void BufferPoolManager::delete_all_pages(int fd) {
-    std::scoped_lock lock(latch_);
-    for (size_t i = 0; i < pool_size_; i++) {
-        Page *page = &pages_[i];
-        if (page->get_page_id().fd == fd && page->get_page_id().page_no != INVALID_PAGE_ID) {
-            auto it = page_table_.find(page->get_page_id());
-            page_table_.erase(it);
-            auto new_page_id = page->get_page_id();
-            new_page_id.page_no=INVALID_PAGE_ID;
-            update_page(page,new_page_id,it->second);
-            free_list_.emplace_back(it->second);
-            disk_manager_->deallocate_page(page->get_page_id().page_no);
+size_t BufferPoolManager::write_dirty_pages() {
+    std::scoped_lock round_lock(writer_round_latch_);
+    std::vector<PinnedPage> dirty_pages;
+    std::vector<std::pair<PageId, frame_id_t>> collected;
+    for (auto &instance : instances_) {
+        if (dirty_pages.size() >= BG_WRITER_MAX_PAGES) {
+            break;
+        }
+        collected.clear();
+        instance->collect_dirty_victims(BG_WRITER_MAX_PAGES - dirty_pages.size(), &collected);
+        for (auto &[page_id, frame_id] : collected) {
+            dirty_pages.push_back({page_id, frame_id, instance.get()});
         }
     }
+    return write_pinned_pages(&dirty_pages);
 }
 
-Page *BufferPoolManager::new_tmp_page(PageId *page_id) {
-    assert(page_id->fd==TMP_FD);
-    std::scoped_lock<std::mutex> lock(latch_);
-    // 1.   获得一个可用的frame，若无法获得则返回nullptr
-    frame_id_t frame_id;
+/**
+ * @description: 按(fd, page_no)顺序写回已被pin住的页面，每IO_BATCH_PAGES个页面为一批：
+ * 先复制页面并按WAL规则刷日志，再把整批页面交给DiskManager的I/O后端写回，最后释放pin
+ * @param {vector<PinnedPage>*} pages 由各分片collect_*返回并pin住的页面，调用后全部被释放
+ * @return {size_t} 成功写回的页数
+ */
+size_t BufferPoolManager::write_pinned_pages(std::vector<PinnedPage>* pages) {
+    if (pages->empty()) {
+        return 0;
+    }
+    std::sort(pages->begin(), pages->end(), [](const PinnedPage &a, const PinnedPage &b) {
+        return a.page_id.fd != b.page_id.fd ? a.page_id.fd < b.page_id.fd : a.page_id.page_no < b.page_id.page_no;
+    });
 
-    if(!find_victim_page(&frame_id)) {
-        return nullptr;
+    size_t written = 0;
+    AlignedPageBuffer buf(std::min<size_t>(pages->size(), IO_BATCH_PAGES));
+    std::vector<IoRequest> requests;
+    for (size_t begin = 0; begin < pages->size(); begin += IO_BATCH_PAGES) {
+        size_t end = std::min(pages->size(), begin + IO_BATCH_PAGES);
+        lsn_t max_lsn = INVALID_LSN;
+        for (size_t i = begin; i < end; ++i) {
+            auto &page = (*pages)[i];
+            max_lsn = std::max(max_lsn, page.instance->snapshot_dirty_page(page.frame_id, buf.get(i - begin)));
+        }
+        // WAL：页面写回前，修改它的日志必须已经刷盘
+        if (log_manager_ != nullptr && max_lsn > log_manager_->flushed_lsn_) {
+            try {
+                log_manager_->flush_log_to_disk();
+            } catch (RMDBError &e) {
+                for (size_t i = begin; i < pages->size(); ++i) {
+                    (*pages)[i].instance->finish_dirty_page((*pages)[i].frame_id, false);
+                }
+                throw;
+            }
+        }
+        // 整批交给I/O后端：同步后端把页号连续的页面合并为一次pwritev，io_uring后端同时提交
+        requests.clear();
+        for (size_t i = begin; i < end; ++i) {
+            requests.push_back({(*pages)[i].page_id.fd, (*pages)[i].page_id.page_no, buf.get(i - begin), true});
+        }
+        try {
+            disk_manager_->submit_io(requests.data(), requests.size());
+        } catch (RMDBError &e) {
+            for (auto &request : requests) {
+                request.ok_ = false;
+            }
+        }
+        for (size_t i = begin; i < end; ++i) {
+            bool ok = requests[i - begin].ok_;
+            written += ok;
+            (*pages)[i].instance->finish_dirty_page((*pages)[i].frame_id, ok);
+        }
     }
-    // 2.   在fd对应的文件分配一个新的page_id
-    page_id->page_no = frame_id;  // 直接将frame_id作为新的page_id
+    return written;
+}
 
-    auto page = &pages_[frame_id];
-    // 3.   将frame的数据写回磁盘
-    update_page(page, *page_id,frame_id);
-    // 4.   固定frame，更新pin_count_
-    page->pin_count_++;
-    replacer_->pin(frame_id);
-    // 5.   返回获得的page
-    return page;
+size_t BufferPoolManager::get_sync_write_count() const {
+    size_t count = 0;
+    for (auto &instance : instances_) {
+        count += instance->get_sync_write_count();
+    }
+    return count;
 }
 
-bool BufferPoolManager::unpin_tmp_page(PageId page_id) {
-    std::scoped_lock<std::mutex> lock(latch_);
+size_t BufferPoolManager::get_checksum_failure_count() const {
+    size_t count = 0;
+    for (auto &instance : instances_) {
+        count += instance->get_checksum_failure_count();
+    }
+    return count;
+}
 
-    auto frame_id = page_id.page_no;
-    auto page = &pages_[frame_id];
-    assert(page->get_page_id().fd==TMP_FD);
-    auto& pin_count = page->pin_count_;
-    // 2.1 若pin_count_已经等于0，则返回false
-    if(pin_count <= 0) {
-        return false;
+void BufferPoolManager::prefetch_pages(int fd, int start_page_no, int num_pages, BufferAccessStrategy* strategy) {
+    if (num_pages <= 0) {
+        return;
+    }
+    if (strategy != nullptr) {
+        disk_manager_->advise_willneed(fd, start_page_no, num_pages);
+        return;
     }
+    {
+        std::scoped_lock lock(prefetch_latch_);
+        if (!prefetch_running_) {
+            prefetch_running_ = true;
+            prefetch_thread_ = std::thread([this] {
+                std::unique_lock<std::mutex> lock(prefetch_latch_);
+                while (true) {
+                    prefetch_cv_.wait(lock, [this] { return !prefetch_running_ || !prefetch_queue_.empty(); });
+                    if (!prefetch_running_) {
+                        break;
+                    }
+                    PrefetchRequest request = prefetch_queue_.front();
+                    prefetch_queue_.pop_front();
+                    // 先持有prefetch_io_latch_再释放队列的锁，cancel_prefetch不会错过已出队的请求
+                    std::unique_lock<std::mutex> io_lock(prefetch_io_latch_);
+                    lock.unlock();
+                    run_prefetch(request);
+                    io_lock.unlock();
+                    lock.lock();
+                }
+            });
+        }
+        prefetch_queue_.push_back({fd, start_page_no, num_pages});
+    }
+    prefetch_cv_.notify_one();
+}
 
-    // 2.2 若pin_count_大于0，则pin_count_自减一
-    pin_count--;
-    // 2.2.1 若自减后等于0，则调用replacer_的Unpin
-    if(pin_count==0) {
-        replacer_->unpin(frame_id);
-        free_list_.emplace_back(frame_id);
+/**
+ * @description: 执行一次预读请求：先为不在缓冲池中的页面选好帧并登记，再把这些页面作为一批读请求交给I/O后端，
+ * 使它们可以同时在设备上执行。预读只是提示，读盘失败的页面撤销登记，之后的fetch_page会报告错误
+ */
+void BufferPoolManager::run_prefetch(const PrefetchRequest& request) {
+    std::vector<Page*> pages;
+    std::vector<IoRequest> requests;
+    try {
+        for (int i = 0; i < request.num_pages; ++i) {
+            PageId page_id{request.fd, request.start_page_no + i};
+            Page* page;
+            if (!get_instance(page_id)->begin_prefetch(page_id, &page)) {
+                break;
+            }
+            if (page != nullptr) {
+                pages.push_back(page);
+                requests.push_back({page_id.fd, page_id.page_no, page->get_data(), false});
+            }
+        }
+    } catch (RMDBError &e) {
+        // 选帧时写回脏页失败，只读入已经登记的页面
+    }
+    try {
+        disk_manager_->submit_io(requests.data(), requests.size());
+    } catch (RMDBError &e) {
+        for (auto &io_request : requests) {
+            io_request.ok_ = false;
+        }
+    }
+    for (size_t i = 0; i < pages.size(); ++i) {
+        get_instance(pages[i]->get_page_id())->end_prefetch(pages[i], requests[i].ok_);
+    }
+}
+
+void BufferPoolManager::cancel_prefetch(int fd) {
+    {
+        std::scoped_lock lock(prefetch_latch_);
+        if (!prefetch_running_) {
+            return;
+        }
+        prefetch_queue_.erase(std::remove_if(prefetch_queue_.begin(), prefetch_queue_.end(),
+                                             [fd](const PrefetchRequest &request) { return request.fd == fd; }),
+                              prefetch_queue_.end());
+    }
+    std::scoped_lock io_lock(prefetch_io_latch_);
+}
+
+void BufferPoolManager::stop_prefetcher() {
+    {
+        std::scoped_lock lock(prefetch_latch_);
+        if (!prefetch_running_) {
+            return;
+        }
+        prefetch_running_ = false;
+        prefetch_queue_.clear();
     }
-    // 3 根据参数is_dirty，更改P的is_dirty_
-    return true;
+    prefetch_cv_.notify_all();
+    prefetch_thread_.join();
 }
@@ -12,52 +12,86 @@ See the Mulan PSL v2 for more details. */
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <list>
-#include <unordered_map>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "disk_manager.h"
 #include "errors.h"
 #include "common/config.h"
 #include "storage/page.h"
-#include "replacer/lru_replacer.h"
-#include "replacer/replacer.h"
+#include "storage/buffer_access_strategy.h"
+#include "storage/buffer_pool_instance.h"
 #include "recovery/log_manager.h"
+
+/**
+ * @description: buffer pool由多个BufferPoolInstance分片组成，页面根据PageId的哈希值固定落在某个分片上，
+ * 每个分片拥有独立的latch、页表、空闲链表和replacer，不同分片上的页面访问可以并行进行。
+ */
 class BufferPoolManager {
    private:
     size_t pool_size_;      // buffer_pool中可容纳页面的个数，即帧的个数
-    Page *pages_;           // buffer_pool中的Page对象数组，在构造空间中申请内存空间，在析构函数中释放，大小为BUFFER_POOL_SIZE
-    std::unordered_map<PageId, frame_id_t, PageIdHash> page_table_; // 帧号和页面号的映射哈希表，用于根据页面的PageId定位该页面的帧编号
-    std::list<frame_id_t> free_list_;   // 空闲帧编号的链表
+    Page *pages_;           // buffer_pool中的Page对象数组(帧的元数据)，在构造空间中申请内存空间，在析构函数中释放，由各分片按段使用
+    char *frame_data_;      // 帧数据区，与pages_平行，第i个帧的数据位于frame_data_ + i * PAGE_SIZE，按PAGE_SIZE对齐
+    size_t frame_data_size_;
     DiskManager *disk_manager_;
-    Replacer *replacer_;    // buffer_pool的置换策略，当前赛题中为LRU置换策略
-    std::mutex latch_;      // 用于共享数据结构的并发控制
-    std::vector<bool> is_used_; // 如果该frame上有page，标记为true
-    // page_id_t tmp_id_{0}; // 下一个tmp_page的id
+    size_t instance_size_;  // 每个分片的帧数(最后一个分片还包含余下的帧)
+    std::vector<std::unique_ptr<BufferPoolInstance>> instances_;    // buffer pool的各个分片
+    std::atomic<size_t> next_tmp_instance_{0};  // 下一次分配临时页面时首先尝试的分片
+    LogManager *log_manager_;
+
+    std::thread writer_thread_;         // 后台写页线程，提前写回即将被淘汰的脏页
+    bool writer_running_{false};
+    std::mutex writer_latch_;           // 保护writer_running_
+    std::condition_variable writer_cv_; // 通知后台写页线程退出
+    std::mutex writer_round_latch_;     // 后台写页线程的一轮写回与delete_all_pages互斥，避免写回已删除的文件
+
+    /** 一次预读请求：fd中从start_page_no开始的num_pages个页面 */
+    struct PrefetchRequest {
+        int fd;
+        int start_page_no;
+        int num_pages;
+    };
+    std::thread prefetch_thread_;       // 预读线程，第一次预读时启动
+    bool prefetch_running_{false};
+    std::deque<PrefetchRequest> prefetch_queue_;    // 等待执行的预读请求
+    std::mutex prefetch_latch_;         // 保护prefetch_queue_和prefetch_running_
+    std::condition_variable prefetch_cv_;
+    std::mutex prefetch_io_latch_;      // 预读线程执行请求期间持有，cancel_prefetch据此等待进行中的预读结束
+
    public:
-    BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager)
+    BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                      ReplacerType replacer_type = ReplacerType::LRU, size_t num_instances = BUFFER_POOL_INSTANCES)
         : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-        // 为buffer pool分配一块连续的内存空间
+        // 为buffer pool分配一块连续的内存空间：帧的元数据和数据分开存放，数据区对齐后可直接用于O_DIRECT读写
         pages_ = new Page[pool_size_];
-        // 可以被Replacer改变
-        if (REPLACER_TYPE.compare("LRU"))
-            replacer_ = new LRUReplacer(pool_size_);
-        else if (REPLACER_TYPE.compare("CLOCK"))
-            replacer_ = new LRUReplacer(pool_size_);
-        else {
-            replacer_ = new LRUReplacer(pool_size_);
-        }
-        // 初始化时，所有的page都在free_list_中
+        frame_data_ = allocate_frame_data(pool_size_, &frame_data_size_);
         for (size_t i = 0; i < pool_size_; ++i) {
-            free_list_.emplace_back(static_cast<frame_id_t>(i));  // static_cast转换数据类型
+            pages_[i].data_ = frame_data_ + i * PAGE_SIZE;
+        }
+        // pool较小时减少分片数，保证每个分片有足够的帧可供置换
+        num_instances = std::max<size_t>(1, std::min(num_instances, pool_size_ / BUFFER_POOL_MIN_INSTANCE_SIZE));
+        instance_size_ = pool_size_ / num_instances;
+        for (size_t i = 0; i < num_instances; ++i) {
+            size_t offset = i * instance_size_;
+            size_t size = (i + 1 == num_instances) ? pool_size_ - offset : instance_size_;
+            instances_.emplace_back(std::make_unique<BufferPoolInstance>(
+                size, static_cast<frame_id_t>(offset), pages_ + offset, disk_manager_, log_manager, replacer_type));
         }
-        is_used_.reserve(pool_size);
     }
 
     ~BufferPoolManager() {
+        stop_background_writer();
+        stop_prefetcher();
+        instances_.clear();
         delete[] pages_;
-        delete replacer_;
+        free_frame_data(frame_data_, frame_data_size_);
     }
 
     /**
@@ -67,15 +101,23 @@ class BufferPoolManager {
     static void mark_dirty(Page* page) { page->is_dirty_ = true; }
 
    public: 
-    Page* fetch_page(PageId page_id);
+    Page* fetch_page(PageId page_id) { return get_instance(page_id)->fetch_page(page_id); }
+
+    /**
+     * @description: 使用访问策略获取页面，缺页时只复用strategy的私有帧环，strategy为nullptr时与fetch_page(page_id)相同
+     */
+    Page* fetch_page(PageId page_id, BufferAccessStrategy* strategy) {
+        size_t idx = get_instance_index(page_id);
+        return instances_[idx]->fetch_page(page_id, strategy == nullptr ? nullptr : &strategy->rings_[idx]);
+    }
 
-    bool unpin_page(PageId page_id, bool is_dirty);
+    bool unpin_page(PageId page_id, bool is_dirty) { return get_instance(page_id)->unpin_page(page_id, is_dirty); }
 
-    bool flush_page(PageId page_id);
+    bool flush_page(PageId page_id) { return get_instance(page_id)->flush_page(page_id); }
 
     Page* new_page(PageId* page_id);
 
-    bool delete_page(PageId page_id);
+    bool delete_page(PageId page_id) { return get_instance(page_id)->delete_page(page_id); }
 
     void flush_all_pages(int fd);
     /**
@@ -87,10 +129,7 @@ class BufferPoolManager {
      *
      * @return 当前bpm中空闲页的数量
      */
-    size_t get_free_size() {
-        std::scoped_lock lock(latch_);
-        return free_list_.size();
-    }
+    size_t get_free_size();
     /**
      * 创建一个临时的page (不会在磁盘中出现，只会在buffer_pool中出现)
      * @param page_id
@@ -104,10 +143,92 @@ class BufferPoolManager {
      * @return
      */
     bool unpin_tmp_page(PageId page_id);
+
+    size_t get_num_instances() const { return instances_.size(); }
+
+    LogManager *get_log_manager() const { return log_manager_; }
+
+    /**
+     * @description: 启动后台写页线程，每BG_WRITER_DELAY_MS毫秒执行一轮write_dirty_pages
+     */
+    void start_background_writer();
+
+    void stop_background_writer();
+
+    /**
+     * @description: 后台写页线程的一轮：把各分片即将被淘汰的脏页按页号顺序写回，使前台淘汰时不必写盘
+     * @return {size_t} 本轮写回的页数
+     */
+    size_t write_dirty_pages();
+
+    /**
+     * @description: 前台淘汰或删除页面时同步写回的脏页数
+     */
+    size_t get_sync_write_count() const;
+
+    /**
+     * @description: 读入时校验和不匹配、以PageChecksumError报告的页面数
+     */
+    size_t get_checksum_failure_count() const;
+
+    /**
+     * @description: 异步预读fd中从start_page_no开始的num_pages个页面，由预读线程读入各分片的帧。
+     * strategy不为空时页面将由扫描的私有帧环装入，此时只提示内核预读，不占用buffer pool的帧
+     */
+    void prefetch_pages(int fd, int start_page_no, int num_pages, BufferAccessStrategy* strategy = nullptr);
+
+    /**
+     * @description: 丢弃fd尚未执行的预读请求，并等待进行中的预读结束；文件关闭或删除前调用
+     */
+    void cancel_prefetch(int fd);
+
+    size_t get_pool_size() const { return pool_size_; }
+
+    /**
+     * @description: 为一次大范围扫描创建访问策略，帧环共ring_size个帧(不超过pool的1/4)，平均分配到各分片(每个分片至少2个)
+     */
+    std::unique_ptr<BufferAccessStrategy> get_access_strategy(size_t ring_size = BUFFER_RING_SIZE) {
+        ring_size = std::min(ring_size, pool_size_ / BUFFER_RING_SCAN_DIVISOR);
+        return std::make_unique<BufferAccessStrategy>(this, instances_.size(), ring_size);
+    }
+
+    /**
+     * @description: 扫描num_pages个页面是否应当使用访问策略：只有占buffer pool较大比例的扫描才会冲掉热页
+     */
+    bool should_use_access_strategy(size_t num_pages) const {
+        return num_pages > pool_size_ / BUFFER_RING_SCAN_DIVISOR;
+    }
+
+    /**
+     * @description: 归还访问策略占用的帧，由BufferAccessStrategy析构时调用
+     */
+    void release_access_strategy(BufferAccessStrategy* strategy);
+
    private:
-    bool find_victim_page(frame_id_t* frame_id);
+    /**
+     * @description: 根据PageId找到页面所在的分片，对PageId::Get()做乘法哈希，使同一文件的连续页面均匀分散到各分片
+     */
+    size_t get_instance_index(PageId page_id) const {
+        uint64_t h = static_cast<uint64_t>(page_id.Get()) * 0x9E3779B97F4A7C15ULL;
+        return (h >> 32) % instances_.size();
+    }
+
+    BufferPoolInstance* get_instance(PageId page_id) { return instances_[get_instance_index(page_id)].get(); }
+
+    static char* allocate_frame_data(size_t pool_size, size_t* mapped_size);
+
+    static void free_frame_data(char* frame_data, size_t mapped_size);
+
+    void stop_prefetcher();
+
+    void run_prefetch(const PrefetchRequest& request);
 
-    void update_page(Page* page, PageId new_page_id, frame_id_t new_frame_id);
+    /** 已被pin住、等待写回的页面 */
+    struct PinnedPage {
+        PageId page_id;
+        frame_id_t frame_id;
+        BufferPoolInstance *instance;
+    };
 
-    LogManager* log_manager_;
-};
\ No newline at end of file
+    size_t write_pinned_pages(std::vector<PinnedPage>* pages);
+};
@@ -0,0 +1,25 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @description: 计算data的CRC32C，crc为之前数据的CRC，可分段累加计算。支持时使用SSE4.2的crc32指令，否则查表计算
+ */
+uint32_t crc32c(const char *data, size_t len, uint32_t crc = 0);
+
+/**
+ * @description: 页面的校验和：把页面平均分为4块，分别计算CRC32C(初值为块号)，再对4个结果计算CRC32C。
+ * 分块使硬件实现可以4路并行；len须为32的倍数(页面大小都是4KB的整数倍)
+ */
+uint32_t page_checksum(const char *data, size_t len);
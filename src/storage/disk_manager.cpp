@@ -11,13 +11,24 @@ See the Mulan PSL v2 for more details. */
 #include "storage/disk_manager.h"
 
 #include <cassert>    // for assert
+#include <cerrno>
 #include <cstring>    // for memset
+#include <fcntl.h>     // for posix_fadvise
 #include <sys/stat.h>  // for stat
+
 #include <unistd.h>    // for lseek
 
 #include "defs.h"
 
-DiskManager::DiskManager() { memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<page_id_t>) / sizeof(char))); }
+DiskManager::DiskManager() : io_backend_(create_io_backend(IoBackendType::SYNC)) {
+    memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<page_id_t>) / sizeof(char)));
+}
+
+/**
+ * @description: 切换批量页面I/O使用的后端，只能在没有I/O进行时(启动时)调用
+ * @param {IoBackendType} type 后端类型，io_uring不可用时退回同步后端
+ */
+void DiskManager::set_io_backend(IoBackendType type) { io_backend_ = create_io_backend(type); }
 
 /**
  * @description: 将数据写入文件的指定磁盘页面中
@@ -27,13 +38,12 @@ DiskManager::DiskManager() { memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<
  * @param {int} num_bytes 要写入磁盘的数据大小
  */
 void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int num_bytes) {
-    // Todo:
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用write()函数
-    // 注意write返回值与num_bytes不等时 throw InternalError("DiskManager::write_page Error");
-    //偏移量应该乘上PAGE_SIZE
-    if(lseek(fd,page_no*PAGE_SIZE,SEEK_SET) == -1) return;//定位到文件头并且判断是否成功
-    ssize_t res = write(fd,offset,num_bytes);//调用write()函数
+    if (is_direct_io(fd) && needs_bounce(offset, num_bytes)) {
+        write_page_bounced(fd, page_no, offset, num_bytes);
+        return;
+    }
+    // 使用pwrite按偏移写入，不修改fd的文件偏移，多个buffer pool分片可并发写同一文件
+    ssize_t res = pwrite(fd, offset, num_bytes, static_cast<off_t>(page_no) * PAGE_SIZE);
     if(res != num_bytes) throw InternalError("DiskManager::write_page Error");//判断是否写入成功
 }
 
@@ -45,30 +55,195 @@ void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int
  * @param {int} num_bytes 读取的数据量大小
  */
 void DiskManager::read_page(int fd, page_id_t page_no, char *offset, int num_bytes) {
-    // Todo:
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用read()函数
-    // 注意read返回值与num_bytes不等时，throw InternalError("DiskManager::read_page Error");
-    //偏移量应该乘上PAGE_SIZE
-    if(lseek(fd,page_no*PAGE_SIZE,SEEK_SET) == -1) return;//定位到文件头并且判断是否成功
-    ssize_t res = read(fd,offset,num_bytes);//调用read()函数
+    if (is_direct_io(fd) && needs_bounce(offset, num_bytes)) {
+        read_page_bounced(fd, page_no, offset, num_bytes);
+        return;
+    }
+    // 使用pread按偏移读取，读盘在buffer pool的latch之外进行，不能依赖共享的文件偏移
+    ssize_t res = pread(fd, offset, num_bytes, static_cast<off_t>(page_no) * PAGE_SIZE);
     if(res != num_bytes) throw InternalError("DiskManager::read_page Error");//判断是否读取成功
 }
 
 /**
- * @description: 分配一个新的页号
+ * @description: O_DIRECT文件只能以对齐的缓冲区读写整页；文件头等不足一页或未对齐的读写需经过对齐的中转缓冲区
+ */
+bool DiskManager::needs_bounce(const char *buf, int num_bytes) {
+    return num_bytes != PAGE_SIZE || reinterpret_cast<uintptr_t>(buf) % PAGE_SIZE != 0;
+}
+
+/**
+ * @description: 经对齐的中转缓冲区读取O_DIRECT文件中一个页面的前num_bytes个字节
+ */
+void DiskManager::read_page_bounced(int fd, page_id_t page_no, char *offset, int num_bytes) {
+    AlignedPageBuffer buf(1);
+    ssize_t res = pread(fd, buf.get(), PAGE_SIZE, static_cast<off_t>(page_no) * PAGE_SIZE);
+    if (num_bytes > PAGE_SIZE || res < num_bytes) throw InternalError("DiskManager::read_page Error");
+    memcpy(offset, buf.get(), num_bytes);
+}
+
+/**
+ * @description: 经对齐的中转缓冲区写O_DIRECT文件中一个页面的前num_bytes个字节：先读出整页(超出文件末尾的部分为0)，
+ * 覆盖前num_bytes个字节后整页写回，页面其余部分保持不变。同一页面不能与其他写并发进行，
+ * 这类写只用于不进入buffer pool的文件头页面
+ */
+void DiskManager::write_page_bounced(int fd, page_id_t page_no, const char *offset, int num_bytes) {
+    if (num_bytes > PAGE_SIZE) throw InternalError("DiskManager::write_page Error");
+    AlignedPageBuffer buf(1);
+    off_t file_offset = static_cast<off_t>(page_no) * PAGE_SIZE;
+    if (num_bytes < PAGE_SIZE) {
+        ssize_t res = pread(fd, buf.get(), PAGE_SIZE, file_offset);
+        if (res < 0) throw InternalError("DiskManager::write_page Error");
+        memset(buf.get() + res, 0, PAGE_SIZE - res);
+    }
+    memcpy(buf.get(), offset, num_bytes);
+    ssize_t res = pwrite(fd, buf.get(), PAGE_SIZE, file_offset);
+    if (res != PAGE_SIZE) throw InternalError("DiskManager::write_page Error");
+}
+
+/**
+ * @description: 用一次preadv读取文件中从start_page_no开始的num_pages个连续页面
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} start_page_no 起始页面编号
+ * @param {char* const*} bufs 每个页面的目标地址，各PAGE_SIZE字节；O_DIRECT文件要求按PAGE_SIZE对齐
+ * @param {int} num_pages 页面个数
+ */
+void DiskManager::read_pages(int fd, page_id_t start_page_no, char *const *bufs, int num_pages) {
+    if (!vectored_page_io(fd, start_page_no, bufs, num_pages, false)) {
+        throw InternalError("DiskManager::read_pages Error");
+    }
+}
+
+/**
+ * @description: 用一次pwritev写入文件中从start_page_no开始的num_pages个连续页面
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} start_page_no 起始页面编号
+ * @param {const char* const*} bufs 每个页面的数据，各PAGE_SIZE字节；O_DIRECT文件要求按PAGE_SIZE对齐
+ * @param {int} num_pages 页面个数
+ */
+void DiskManager::write_pages(int fd, page_id_t start_page_no, const char *const *bufs, int num_pages) {
+    if (!vectored_page_io(fd, start_page_no, const_cast<char *const *>(bufs), num_pages, true)) {
+        throw InternalError("DiskManager::write_pages Error");
+    }
+}
+
+/**
+ * @description: 提示内核异步预读文件中从page_no开始的num_pages个页面，之后的read_page直接命中page cache
+ * 只是提示，失败时忽略；O_DIRECT文件不经过page cache，不做任何事
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} page_no 起始页面编号
+ * @param {int} num_pages 页面个数
+ */
+void DiskManager::advise_willneed(int fd, page_id_t page_no, int num_pages) {
+    if (is_direct_io(fd)) {
+        return;
+    }
+    posix_fadvise(fd, static_cast<off_t>(page_no) * PAGE_SIZE, static_cast<off_t>(num_pages) * PAGE_SIZE,
+                  POSIX_FADV_WILLNEED);
+}
+
+/**
+ * @description: 分配一个新的页号，文件启用了空闲页面位图时优先复用已释放的页面中页号最小的一个
  * @return {page_id_t} 分配的新页号
  * @param {int} fd 指定文件的文件句柄
  */
 page_id_t DiskManager::allocate_page(int fd) {
-    // 简单的自增分配策略，指定文件的页面编号加1
     assert(fd >= 0 && fd < MAX_FD);
-    // check(AntiO2) 是否需要持久化file handle
-    return fd2pageno_[fd]++;
+    if (num_free_pages_[fd].load(std::memory_order_relaxed) > 0) {
+        std::scoped_lock lock(fsm_latch_);
+        auto &fsm = fsms_[fd];
+        if (fsm != nullptr && fsm->num_free() > 0) {
+            page_id_t page_no = fsm->allocate();
+            num_free_pages_[fd] = fsm->num_free();
+            return page_no;
+        }
+    }
+    // 没有可复用的页面，指定文件的页面编号加1；超出已预分配的区域时按FILE_EXTENT_SIZE扩展文件
+    page_id_t page_no = fd2pageno_[fd]++;
+    if (page_no >= fd2extent_[fd].load(std::memory_order_acquire)) {
+        extend_file(fd, page_no);
+    }
+    return page_no;
+}
+
+/**
+ * @description: 用fallocate把文件扩展到包含page_no的下一个FILE_EXTENT_SIZE边界，新区域读出为全0。
+ * 新页面因此不必立即写盘，文件系统不支持fallocate时用ftruncate扩展文件长度
+ */
+void DiskManager::extend_file(int fd, page_id_t page_no) {
+    std::scoped_lock lock(extent_latch_);
+    page_id_t extent_end = fd2extent_[fd].load(std::memory_order_relaxed);
+    if (page_no < extent_end) {
+        return;
+    }
+    page_id_t extent_pages = std::max(1, FILE_EXTENT_SIZE / PAGE_SIZE);
+    page_id_t new_end = (page_no / extent_pages + 1) * extent_pages;
+    off_t offset = static_cast<off_t>(extent_end) * PAGE_SIZE;
+    off_t len = static_cast<off_t>(new_end - extent_end) * PAGE_SIZE;
+    if (fallocate(fd, 0, offset, len) != 0) {
+        if (errno != EOPNOTSUPP && errno != ENOSYS) {
+            throw UnixError();
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) throw UnixError();
+        if (st.st_size < offset + len && ftruncate(fd, offset + len) != 0) throw UnixError();
+    }
+    fd2extent_[fd].store(new_end, std::memory_order_release);
+}
+
+/**
+ * @description: 释放页面，之后可被allocate_page重新分配。调用者须保证页面已不在buffer pool中且不再被引用
+ */
+void DiskManager::deallocate_page(int fd, page_id_t page_no) {
+    assert(fd >= 0 && fd < MAX_FD);
+    std::scoped_lock lock(fsm_latch_);
+    auto &fsm = fsms_[fd];
+    if (fsm != nullptr && page_no < fd2pageno_[fd].load() && fsm->set_free(page_no)) {
+        num_free_pages_[fd] = fsm->num_free();
+    }
+}
+
+void DiskManager::reserve_page(int fd, page_id_t page_no) {
+    assert(fd >= 0 && fd < MAX_FD);
+    {
+        std::scoped_lock lock(fsm_latch_);
+        auto &fsm = fsms_[fd];
+        if (fsm != nullptr && fsm->set_used(page_no)) {
+            num_free_pages_[fd] = fsm->num_free();
+        }
+    }
+    page_id_t num_pages = fd2pageno_[fd].load();
+    while (num_pages <= page_no && !fd2pageno_[fd].compare_exchange_weak(num_pages, page_no + 1)) {
+    }
+    if (page_no >= fd2extent_[fd].load(std::memory_order_acquire)) {
+        extend_file(fd, page_no);
+    }
 }
 
-void DiskManager::deallocate_page(__attribute__((unused)) page_id_t page_id) {
-    // fd2pageno_[page_id];
+void DiskManager::open_free_space_map(int fd) {
+    AlignedPageBuffer buf(1);
+    ssize_t res = pread(fd, buf.get(), PAGE_SIZE, 0);
+    if (res < 0) throw UnixError();
+    memset(buf.get() + res, 0, PAGE_SIZE - res);
+    auto fsm = std::make_unique<FreeSpaceMap>();
+    fsm->deserialize(buf.get() + FREE_SPACE_MAP_OFFSET);
+    std::scoped_lock lock(fsm_latch_);
+    num_free_pages_[fd] = fsm->num_free();
+    fsms_[fd] = std::move(fsm);
+}
+
+void DiskManager::flush_free_space_map(int fd) {
+    std::scoped_lock lock(fsm_latch_);
+    auto &fsm = fsms_[fd];
+    if (fsm == nullptr) {
+        return;
+    }
+    // O_DIRECT文件只能整页对齐写，因此统一读出整个文件头页面，改写位图部分后整页写回
+    AlignedPageBuffer buf(1);
+    ssize_t res = pread(fd, buf.get(), PAGE_SIZE, 0);
+    if (res < 0) throw UnixError();
+    memset(buf.get() + res, 0, PAGE_SIZE - res);
+    fsm->serialize(buf.get() + FREE_SPACE_MAP_OFFSET);
+    if (pwrite(fd, buf.get(), PAGE_SIZE, 0) != PAGE_SIZE) throw UnixError();
 }
 
 bool DiskManager::is_dir(const std::string& path) {
@@ -159,10 +334,23 @@ int DiskManager::open_file(const std::string &path) {
     if(iter != path2fd_.end() && iter->second != -1 ) {
         throw FileNotClosedError(path); // 说明已经打开
     }
-    int fd = open(path.c_str(), O_RDWR);//否则打开
+    int fd = -1;
+    bool direct = direct_io_ && path != LOG_FILE_NAME;  // 日志按字节追加写，不能使用O_DIRECT
+    if (direct) {
+        fd = open(path.c_str(), O_RDWR | O_DIRECT);
+        // 文件系统不支持O_DIRECT(如tmpfs)时退回普通方式打开
+        direct = fd != -1;
+    }
+    if (fd == -1) {
+        fd = open(path.c_str(), O_RDWR);//否则打开
+    }
     if(fd==-1)  {
         throw FileNotFoundError(path); // 打开失败
     }
+    direct_fds_[fd] = direct;
+    // 已有的文件长度之内不需要再预分配
+    struct stat st;
+    fd2extent_[fd] = fstat(fd, &st) == 0 ? static_cast<page_id_t>(st.st_size / PAGE_SIZE) : 0;
     //更新文件打开列表
     path2fd_[path] = fd;
     fd2path_[fd] = path;
@@ -184,6 +372,14 @@ void DiskManager::close_file(int fd) {
         throw FileNotOpenError(fd); // 说明还没有打开
     }
     close(fd);//关闭文件
+    direct_fds_[fd] = false;
+    checksum_fds_[fd] = false;
+    fd2extent_[fd] = 0;
+    {
+        std::scoped_lock lock(fsm_latch_);
+        fsms_[fd].reset();
+        num_free_pages_[fd] = 0;
+    }
     //更新
     std::string path = fd2path_[fd];
     fd2path_.erase(fd);
@@ -271,7 +467,7 @@ void DiskManager::write_log(char *log_data, int size) {
     }
 }
 
-int DiskManager::reset_file(const std::string &path) {
+void DiskManager::reset_file(const std::string &path) {
     int fd = open(path.c_str(), O_RDWR|O_TRUNC);// 打开并清空之前的数据
     if(fd < 0) {
         throw FileNotFoundError(path);
@@ -14,14 +14,58 @@ See the Mulan PSL v2 for more details. */
 #include <sys/stat.h>  
 #include <unistd.h>    
 
+#include <algorithm>
 #include <atomic>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
 #include "common/config.h"
 #include "errors.h"  
+#include "storage/free_space_map.h"
+#include "storage/io_backend.h"
+
+/**
+ * @description: 按PAGE_SIZE对齐的连续页面缓冲区。以O_DIRECT打开的文件，读写使用的缓冲区地址必须对齐
+ */
+class AlignedPageBuffer {
+   public:
+    explicit AlignedPageBuffer(size_t num_pages)
+        : data_(static_cast<char *>(std::aligned_alloc(PAGE_SIZE, std::max<size_t>(num_pages, 1) * PAGE_SIZE))) {
+        if (data_ == nullptr) {
+            throw std::bad_alloc();
+        }
+    }
+
+    ~AlignedPageBuffer() { std::free(data_); }
+
+    AlignedPageBuffer(const AlignedPageBuffer &) = delete;
+    AlignedPageBuffer &operator=(const AlignedPageBuffer &) = delete;
+
+    char *get(size_t page_idx = 0) { return data_ + page_idx * PAGE_SIZE; }
+
+   private:
+    char *data_;
+};
+
+/**
+ * @description: 线程私有的单页缓冲区，按MAX_PAGE_SIZE对齐，任意页面大小下都可直接用于O_DIRECT读写
+ */
+inline char *thread_page_buffer() {
+    struct Holder {
+        char *data_ = static_cast<char *>(std::aligned_alloc(MAX_PAGE_SIZE, MAX_PAGE_SIZE));
+        ~Holder() { std::free(data_); }
+    };
+    thread_local Holder holder;
+    if (holder.data_ == nullptr) {
+        throw std::bad_alloc();
+    }
+    return holder.data_;
+}
 
 /**
  * @description: DiskManager的作用主要是根据上层的需要对磁盘文件进行操作
@@ -36,9 +80,63 @@ class DiskManager {
 
     void read_page(int fd, page_id_t page_no, char *offset, int num_bytes);
 
+    void read_pages(int fd, page_id_t start_page_no, char *const *bufs, int num_pages);
+
+    void write_pages(int fd, page_id_t start_page_no, const char *const *bufs, int num_pages);
+
+    void advise_willneed(int fd, page_id_t page_no, int num_pages);
+
+    void set_io_backend(IoBackendType type);
+
+    /**
+     * @description: 开启后，之后打开的数据文件(表文件、索引文件，不包括日志文件)使用O_DIRECT，
+     * 页面只缓存在buffer pool中，不再经过内核page cache。只能在打开文件之前(启动时)调用
+     */
+    void set_direct_io(bool direct_io) { direct_io_ = direct_io; }
+
+    bool is_direct_io(int fd) const { return direct_fds_[fd].load(std::memory_order_relaxed); }
+
+    /**
+     * @description: 开启后，buffer pool写回fd的页面时在页头填入校验和，读入时校验。
+     * 由表文件和索引文件的句柄在打开文件时开启，文件关闭时清除
+     */
+    void set_page_checksums(int fd, bool enabled) { checksum_fds_[fd] = enabled; }
+
+    bool has_page_checksums(int fd) const { return fd >= 0 && checksum_fds_[fd].load(std::memory_order_relaxed); }
+
+    /**
+     * @description: 通过当前I/O后端执行一批互不相关的单页读写，各请求的结果记录在IoRequest::ok_中
+     */
+    void submit_io(IoRequest *requests, size_t num_requests) { io_backend_->submit(requests, num_requests); }
+
+    const char *get_io_backend_name() const { return io_backend_->name(); }
+
     page_id_t allocate_page(int fd);
 
-    void deallocate_page(page_id_t page_id);
+    void deallocate_page(int fd, page_id_t page_no);
+
+    /**
+     * @description: 把page_no标记为已分配：从空闲页面位图中移除，必要时增加已分配的页面个数并扩展文件。
+     * 用于故障恢复时重放日志中记录的页面分配，使之后的读盘和allocate_page与崩溃前一致
+     */
+    void reserve_page(int fd, page_id_t page_no);
+
+    /**
+     * @description: 为fd启用空闲页面位图：从文件头页面读出已释放的页面，之后allocate_page优先复用它们。
+     * 未启用位图的文件deallocate_page不起作用，页号只会递增分配
+     */
+    void open_free_space_map(int fd);
+
+    /**
+     * @description: 把fd的空闲页面位图写回文件头页面的FREE_SPACE_MAP_OFFSET处，文件头的其余部分保持不变；
+     * 不能与该文件的文件头写并发进行，在关闭文件之前调用
+     */
+    void flush_free_space_map(int fd);
+
+    /**
+     * @description: fd中已释放、等待复用的页面个数
+     */
+    size_t get_num_free_pages(int fd) const { return num_free_pages_[fd].load(std::memory_order_relaxed); }
 
     /*目录操作*/
     bool is_dir(const std::string &path);
@@ -56,7 +154,7 @@ class DiskManager {
 
     int open_file(const std::string &path);
 
-    int reset_file(const std::string &path);
+    void reset_file(const std::string &path);
 
     void close_file(int fd);
 
@@ -82,6 +180,11 @@ class DiskManager {
      */
     void set_fd2pageno(int fd, int start_page_no) { fd2pageno_[fd] = start_page_no; }
 
+    /**
+     * @description: 文件在磁盘上已预分配的页面个数(按FILE_EXTENT_SIZE向上取整)
+     */
+    page_id_t get_extent_end(int fd) const { return fd2extent_[fd].load(std::memory_order_acquire); }
+
     /**
      * @description: 获得文件目前已分配的页面个数，即如果文件要分配一个新页面，需要从fd2pagenp_[fd]开始分配
      * @return {page_id_t} 已分配的页面个数 
@@ -97,6 +200,23 @@ public:
 
 private:
 
+    static bool needs_bounce(const char *buf, int num_bytes);
+
+    void read_page_bounced(int fd, page_id_t page_no, char *offset, int num_bytes);
+
+    void write_page_bounced(int fd, page_id_t page_no, const char *offset, int num_bytes);
+
+    void extend_file(int fd, page_id_t page_no);
+
+    std::unique_ptr<IoBackend> io_backend_;       // 批量页面I/O使用的后端
+    bool direct_io_{false};                       // 新打开的数据文件是否使用O_DIRECT
+    std::atomic<bool> direct_fds_[MAX_FD]{};      // 文件是否以O_DIRECT打开
+    std::atomic<bool> checksum_fds_[MAX_FD]{};    // 文件的页面是否带校验和
     int log_fd_ = -1;                             // WAL日志文件的文件句柄，默认为-1，代表未打开日志文件
     std::atomic<page_id_t> fd2pageno_[MAX_FD]{};  // 文件中已经分配的页面个数，初始值为0
+    std::atomic<page_id_t> fd2extent_[MAX_FD]{};  // 文件在磁盘上已预分配的页面个数，小于它的页号无需扩展文件
+    std::mutex extent_latch_;                     // 串行化文件扩展
+    std::unique_ptr<FreeSpaceMap> fsms_[MAX_FD];  // 文件的空闲页面位图，未启用时为空
+    std::atomic<size_t> num_free_pages_[MAX_FD]{};  // fsms_[fd]中的空闲页面个数，为0时分配页面不必加锁
+    std::mutex fsm_latch_;                        // 保护fsms_
 };
\ No newline at end of file
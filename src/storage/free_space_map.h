@@ -0,0 +1,130 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * @description: 文件的空闲页面位图，第i位为1表示页号i已被释放、可以重新分配。
+ * 持久化在文件头页面(第0页)的FREE_SPACE_MAP_OFFSET处，格式为：魔数(4字节) + 64位字的个数(4字节) + 位图；
+ * 位图只覆盖页号小于capacity()的页面，更大的页面释放后不再复用。本身不加锁，由DiskManager串行访问
+ */
+class FreeSpaceMap {
+   public:
+    static constexpr uint32_t MAGIC = 0x314d5346;  // "FSM1"
+
+    FreeSpaceMap() : words_(capacity() / 64, 0) {}
+
+    /**
+     * @description: 当前PAGE_SIZE下文件头页面中能记录的页面个数
+     */
+    static size_t capacity() {
+        return (static_cast<size_t>(PAGE_SIZE - FREE_SPACE_MAP_OFFSET) - 2 * sizeof(uint32_t)) / 8 / 8 * 64;
+    }
+
+    /**
+     * @description: 标记页面为空闲
+     * @return {bool} 页面此前不是空闲且在位图覆盖范围内
+     */
+    bool set_free(page_id_t page_no) {
+        if (page_no < 0 || static_cast<size_t>(page_no) >= capacity()) {
+            return false;
+        }
+        uint64_t &word = words_[page_no / 64];
+        uint64_t mask = uint64_t{1} << (page_no % 64);
+        if (word & mask) {
+            return false;
+        }
+        word |= mask;
+        num_free_++;
+        return true;
+    }
+
+    /**
+     * @description: 标记页面为已使用，用于故障恢复时重放日志中的页面分配
+     * @return {bool} 页面此前是空闲的
+     */
+    bool set_used(page_id_t page_no) {
+        if (!is_free(page_no)) {
+            return false;
+        }
+        words_[page_no / 64] &= ~(uint64_t{1} << (page_no % 64));
+        num_free_--;
+        return true;
+    }
+
+    bool is_free(page_id_t page_no) const {
+        return page_no >= 0 && static_cast<size_t>(page_no) < capacity() &&
+               (words_[page_no / 64] >> (page_no % 64) & 1);
+    }
+
+    /**
+     * @description: 取出页号最小的空闲页面，优先复用文件前部的页面
+     * @return {page_id_t} 页号，没有空闲页面时返回INVALID_PAGE_ID
+     */
+    page_id_t allocate() {
+        if (num_free_ == 0) {
+            return INVALID_PAGE_ID;
+        }
+        for (size_t i = 0; i < words_.size(); i++) {
+            if (words_[i] != 0) {
+                int bit = __builtin_ctzll(words_[i]);
+                words_[i] &= words_[i] - 1;
+                num_free_--;
+                return static_cast<page_id_t>(i * 64 + bit);
+            }
+        }
+        return INVALID_PAGE_ID;
+    }
+
+    size_t num_free() const { return num_free_; }
+
+    /**
+     * @description: 序列化后的字节数，不超过PAGE_SIZE - FREE_SPACE_MAP_OFFSET
+     */
+    size_t serialized_size() const { return 2 * sizeof(uint32_t) + words_.size() * sizeof(uint64_t); }
+
+    void serialize(char *dest) const {
+        uint32_t magic = MAGIC;
+        auto num_words = static_cast<uint32_t>(words_.size());
+        memcpy(dest, &magic, sizeof(magic));
+        memcpy(dest + sizeof(magic), &num_words, sizeof(num_words));
+        memcpy(dest + 2 * sizeof(uint32_t), words_.data(), words_.size() * sizeof(uint64_t));
+    }
+
+    /**
+     * @description: 从文件头页面中的位图恢复；魔数不匹配(新文件或旧格式文件)时为空位图
+     */
+    void deserialize(const char *src) {
+        std::fill(words_.begin(), words_.end(), 0);
+        num_free_ = 0;
+        uint32_t magic, num_words;
+        memcpy(&magic, src, sizeof(magic));
+        memcpy(&num_words, src + sizeof(magic), sizeof(num_words));
+        if (magic != MAGIC) {
+            return;
+        }
+        num_words = std::min<uint32_t>(num_words, words_.size());
+        memcpy(words_.data(), src + 2 * sizeof(uint32_t), num_words * sizeof(uint64_t));
+        for (auto word : words_) {
+            num_free_ += __builtin_popcountll(word);
+        }
+    }
+
+   private:
+    std::vector<uint64_t> words_;
+    size_t num_free_{0};
+};
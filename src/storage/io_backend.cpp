@@ -0,0 +1,245 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/io_backend.h"
+
+#include <linux/io_uring.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "errors.h"
+
+bool vectored_page_io(int fd, page_id_t start_page_no, char *const *bufs, int num_pages, bool write) {
+    std::vector<struct iovec> iov(std::min(num_pages, IOV_MAX));
+    int done = 0;           // 已完成的页数
+    size_t partial = 0;     // 第done个页面已完成的字节数
+    while (done < num_pages) {
+        int cnt = std::min(num_pages - done, IOV_MAX);
+        for (int i = 0; i < cnt; ++i) {
+            size_t skip = i == 0 ? partial : 0;
+            iov[i].iov_base = bufs[done + i] + skip;
+            iov[i].iov_len = PAGE_SIZE - skip;
+        }
+        off_t offset = static_cast<off_t>(start_page_no + done) * PAGE_SIZE + static_cast<off_t>(partial);
+        ssize_t res = write ? pwritev(fd, iov.data(), cnt, offset) : preadv(fd, iov.data(), cnt, offset);
+        if (res < 0 && errno == EINTR) {
+            continue;
+        }
+        if (res <= 0) {
+            return false;
+        }
+        size_t bytes = partial + static_cast<size_t>(res);
+        done += static_cast<int>(bytes / PAGE_SIZE);
+        partial = bytes % PAGE_SIZE;
+    }
+    return true;
+}
+
+/**
+ * @description: 同一文件中页号连续的同类请求合并为一次vectored_page_io；合并的请求失败时逐页重试，得到每个请求各自的结果
+ */
+void SyncIoBackend::submit(IoRequest *requests, size_t num_requests) {
+    std::vector<char *> bufs;
+    for (size_t begin = 0; begin < num_requests;) {
+        size_t end = begin + 1;
+        while (end < num_requests && requests[end].fd_ == requests[begin].fd_ &&
+               requests[end].write_ == requests[begin].write_ &&
+               requests[end].page_no_ == requests[end - 1].page_no_ + 1) {
+            ++end;
+        }
+        bufs.clear();
+        for (size_t i = begin; i < end; ++i) {
+            bufs.push_back(requests[i].buf_);
+        }
+        bool ok = vectored_page_io(requests[begin].fd_, requests[begin].page_no_, bufs.data(),
+                                   static_cast<int>(bufs.size()), requests[begin].write_);
+        for (size_t i = begin; i < end; ++i) {
+            requests[i].ok_ = ok || vectored_page_io(requests[i].fd_, requests[i].page_no_, &requests[i].buf_, 1,
+                                                     requests[i].write_);
+        }
+        begin = end;
+    }
+}
+
+IoUringBackend::IoUringBackend(unsigned queue_depth) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+    if (ring_fd_ < 0) {
+        throw UnixError();
+    }
+    queue_depth_ = params.sq_entries;
+
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    }
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    cq_ptr_ = single_mmap ? sq_ptr_
+                          : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                 IORING_OFF_CQ_RING);
+    sqes_ptr_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                     IORING_OFF_SQES);
+    if (sq_ptr_ == MAP_FAILED || cq_ptr_ == MAP_FAILED || sqes_ptr_ == MAP_FAILED) {
+        UnixError error;
+        if (sq_ptr_ == MAP_FAILED) sq_ptr_ = nullptr;
+        if (cq_ptr_ == MAP_FAILED) cq_ptr_ = nullptr;
+        if (sqes_ptr_ == MAP_FAILED) sqes_ptr_ = nullptr;
+        release_ring();
+        throw error;
+    }
+
+    auto sq = static_cast<char *>(sq_ptr_);
+    auto cq = static_cast<char *>(cq_ptr_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    sqes_ = static_cast<struct io_uring_sqe *>(sqes_ptr_);
+    cqes_ = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+}
+
+IoUringBackend::~IoUringBackend() { release_ring(); }
+
+void IoUringBackend::release_ring() {
+    if (sqes_ptr_ != nullptr) munmap(sqes_ptr_, sqes_size_);
+    if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_size_);
+    if (sq_ptr_ != nullptr) munmap(sq_ptr_, sq_size_);
+    sqes_ptr_ = cq_ptr_ = sq_ptr_ = nullptr;
+    if (ring_fd_ >= 0) close(ring_fd_);
+    ring_fd_ = -1;
+}
+
+/**
+ * @description: 从完成队列收割已经完成的请求，调用时须持有latch_。不足一页的完成(如被信号打断)用同步读写补齐剩余部分
+ * @return {unsigned} 收割的请求数
+ */
+unsigned IoUringBackend::reap(IoRequest *requests) {
+    unsigned head = *cq_head_;
+    unsigned reaped = 0;
+    while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+        IoRequest &request = requests[cqe->user_data];
+        int res = cqe->res;
+        ++head;
+        ++reaped;
+        if (res == PAGE_SIZE) {
+            request.ok_ = true;
+        } else if (res > 0) {
+            // 完成了一部分，剩余部分同步补齐
+            off_t offset = static_cast<off_t>(request.page_no_) * PAGE_SIZE + res;
+            char *buf = request.buf_ + res;
+            size_t left = PAGE_SIZE - res;
+            ssize_t n = request.write_ ? pwrite(request.fd_, buf, left, offset) : pread(request.fd_, buf, left, offset);
+            request.ok_ = n == static_cast<ssize_t>(left);
+        } else {
+            request.ok_ = false;
+        }
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+/**
+ * @description: 保持最多queue_depth_个请求在设备上执行：每次io_uring_enter提交新放入提交队列的请求并至少等待一个完成，
+ * 再从完成队列收割结果。
+ * io_uring_enter出现不可重试的错误时，撤回内核尚未取走的请求，等待已提交的请求全部完成后才返回，
+ * 保证返回后内核不再访问调用者的缓冲区、完成队列中也没有残留；之后该后端停用io_uring，本批剩余的请求及以后的请求都用同步读写
+ */
+void IoUringBackend::submit(IoRequest *requests, size_t num_requests) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (broken_) {
+        fallback_.submit(requests, num_requests);
+        return;
+    }
+    size_t next = 0;            // 下一个放入提交队列的请求
+    size_t completed = 0;
+    unsigned in_flight = 0;     // 已放入提交队列、尚未完成的请求数
+    unsigned to_submit = 0;     // 已放入提交队列、尚未被内核取走的请求数
+    while (completed < num_requests) {
+        unsigned tail = *sq_tail_;
+        while (next < num_requests && in_flight < queue_depth_) {
+            IoRequest &request = requests[next];
+            unsigned idx = tail & *sq_mask_;
+            struct io_uring_sqe *sqe = &sqes_[idx];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = request.write_ ? IORING_OP_WRITE : IORING_OP_READ;
+            sqe->fd = request.fd_;
+            sqe->addr = reinterpret_cast<uint64_t>(request.buf_);
+            sqe->len = PAGE_SIZE;
+            sqe->off = static_cast<uint64_t>(request.page_no_) * PAGE_SIZE;
+            sqe->user_data = next;
+            sq_array_[idx] = idx;
+            ++tail;
+            ++next;
+            ++in_flight;
+            ++to_submit;
+        }
+        __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+        int ret = static_cast<int>(
+            syscall(__NR_io_uring_enter, ring_fd_, to_submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                continue;
+            }
+            int error = errno;
+            // 没有SQPOLL时内核只在io_uring_enter中读取提交队列，失败的调用没有取走请求，可以直接撤回
+            __atomic_store_n(sq_tail_, tail - to_submit, __ATOMIC_RELEASE);
+            next -= to_submit;
+            in_flight -= to_submit;
+            while (in_flight > 0) {
+                unsigned reaped = reap(requests);
+                in_flight -= reaped;
+                if (in_flight > 0 && reaped == 0 &&
+                    syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+                    // 等待也失败时让出CPU，内核仍会把完成写入完成队列
+                    sched_yield();
+                }
+            }
+            broken_ = true;
+            std::cerr << "io_uring_enter failed (" << strerror(error) << "), falling back to sync I/O" << std::endl;
+            fallback_.submit(requests + next, num_requests - next);
+            return;
+        }
+        to_submit -= std::min<unsigned>(to_submit, static_cast<unsigned>(ret));
+
+        unsigned reaped = reap(requests);
+        completed += reaped;
+        in_flight -= reaped;
+    }
+}
+
+std::unique_ptr<IoBackend> create_io_backend(IoBackendType type) {
+    if (type == IoBackendType::IO_URING) {
+        try {
+            return std::make_unique<IoUringBackend>();
+        } catch (RMDBError &e) {
+            std::cerr << "io_uring is not available (" << e.what() << "), falling back to sync I/O" << std::endl;
+        }
+    }
+    return std::make_unique<SyncIoBackend>();
+}
@@ -0,0 +1,128 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "common/config.h"
+
+/** DiskManager批量读写页面使用的I/O后端，由启动参数选择 */
+enum class IoBackendType { SYNC, IO_URING };
+
+/**
+ * @description: 把启动参数中的I/O后端名称(sync/io_uring，不区分大小写)解析为IoBackendType
+ * @return {bool} 名称是否合法
+ */
+inline bool parse_io_backend_type(std::string name, IoBackendType *type) {
+    for (auto &ch : name) ch = static_cast<char>(tolower(ch));
+    if (name == "sync") {
+        *type = IoBackendType::SYNC;
+    } else if (name == "io_uring" || name == "io-uring" || name == "uring") {
+        *type = IoBackendType::IO_URING;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/** 一次单页读写请求，完成后ok_表示是否成功 */
+struct IoRequest {
+    int fd_;
+    page_id_t page_no_;
+    char *buf_;         // PAGE_SIZE字节，读请求的目标或写请求的数据
+    bool write_;
+    bool ok_{false};
+};
+
+/**
+ * @description: 在fd中从start_page_no开始的num_pages个连续页面上做preadv/pwritev，
+ * 每次系统调用最多IOV_MAX个页面，读写不完整时从中断处继续
+ * @return {bool} 全部读写完成返回true；遇到错误或文件末尾返回false
+ */
+bool vectored_page_io(int fd, page_id_t start_page_no, char *const *bufs, int num_pages, bool write);
+
+/**
+ * @description: 批量页面I/O的后端。submit把一批请求全部交给设备后等待它们完成，
+ * 各请求的成败记录在IoRequest::ok_中，不抛出异常；可被多个线程同时调用
+ */
+class IoBackend {
+   public:
+    virtual ~IoBackend() = default;
+
+    virtual void submit(IoRequest *requests, size_t num_requests) = 0;
+
+    virtual const char *name() const = 0;
+};
+
+/**
+ * @description: 同步后端：按顺序执行请求，同一文件中页号连续的同类请求合并为一次preadv/pwritev
+ */
+class SyncIoBackend : public IoBackend {
+   public:
+    void submit(IoRequest *requests, size_t num_requests) override;
+
+    const char *name() const override { return "sync"; }
+};
+
+/**
+ * @description: io_uring后端：直接使用io_uring_setup/io_uring_enter系统调用和内核头文件，不依赖liburing。
+ * 一批请求最多IO_URING_QUEUE_DEPTH个同时在设备上执行，一次io_uring_enter提交并等待；
+ * 提交队列只有一个，submit之间用latch_串行；io_uring_enter出现不可重试的错误后退回同步后端
+ */
+class IoUringBackend : public IoBackend {
+   public:
+    /**
+     * @description: 创建io_uring，内核不支持或被禁止时抛出UnixError
+     */
+    explicit IoUringBackend(unsigned queue_depth = IO_URING_QUEUE_DEPTH);
+
+    ~IoUringBackend() override;
+
+    void submit(IoRequest *requests, size_t num_requests) override;
+
+    const char *name() const override { return "io_uring"; }
+
+   private:
+    void release_ring();
+
+    unsigned reap(IoRequest *requests);
+
+    int ring_fd_{-1};
+    unsigned queue_depth_;
+    std::mutex latch_;
+    bool broken_{false};            // io_uring_enter出错后不再使用io_uring
+    SyncIoBackend fallback_;
+
+    void *sq_ptr_{nullptr};
+    size_t sq_size_{0};
+    void *cq_ptr_{nullptr};         // 内核支持IORING_FEAT_SINGLE_MMAP时与sq_ptr_相同
+    size_t cq_size_{0};
+    void *sqes_ptr_{nullptr};
+    size_t sqes_size_{0};
+
+    unsigned *sq_tail_;
+    unsigned *sq_mask_;
+    unsigned *sq_array_;
+    unsigned *cq_head_;
+    unsigned *cq_tail_;
+    unsigned *cq_mask_;
+    struct io_uring_sqe *sqes_;
+    struct io_uring_cqe *cqes_;
+};
+
+/**
+ * @description: 创建指定类型的I/O后端，io_uring不可用时退回同步后端
+ */
+std::unique_ptr<IoBackend> create_io_backend(IoBackendType type);
@@ -10,10 +10,12 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 
 #include "common/config.h"
 #include "common/rwlatch.h"
+#include "storage/checksum.h"
 
 
 /**
@@ -33,8 +35,10 @@ struct PageId {
         return "{fd: " + std::to_string(fd) + " page_no: " + std::to_string(page_no) + "}"; 
     }
 
+    // fd和page_no各占32位打包成一个64位值，不同PageId的打包值互不相同，可直接作为页表的key
     inline int64_t Get() const {
-        return (static_cast<int64_t>(fd << 16) | page_no);
+        return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(fd)) << 32) |
+                                    static_cast<uint32_t>(page_no));
     }
 };
 
@@ -54,10 +58,12 @@ struct std::hash<PageId> {
  */
 class Page {
     friend class BufferPoolManager;
+    friend class BufferPoolInstance;
 
    public:
     
-    Page() { reset_memory(); }
+    // data_由BufferPoolManager指向帧数据区中对应的位置，帧装入页面时(update_page)才初始化
+    Page() = default;
 
     ~Page() = default;
 
@@ -65,16 +71,59 @@ class Page {
 
     inline char *get_data() { return data_; }
 
-    bool is_dirty() const { return is_dirty_; }
+    bool is_dirty() const { return is_dirty_.load(std::memory_order_relaxed); }
 
     static constexpr size_t OFFSET_PAGE_START = 0;
     static constexpr size_t OFFSET_LSN = 0;
-    static constexpr size_t OFFSET_PAGE_HDR = 4;
+    static constexpr size_t OFFSET_CHECKSUM = 4;
+    static constexpr size_t OFFSET_PAGE_HDR = 8;
 
     inline lsn_t get_page_lsn() { return *reinterpret_cast<lsn_t *>(get_data() + OFFSET_LSN) ; }
 
     inline void set_page_lsn(lsn_t page_lsn) { memcpy(get_data() + OFFSET_LSN, &page_lsn, sizeof(lsn_t)); }
 
+    /**
+     * @description: 计算页面数据的校验和，计算时校验和字段视为0
+     */
+    static uint32_t compute_checksum(char *data) {
+        uint32_t stored;
+        memcpy(&stored, data + OFFSET_CHECKSUM, sizeof(stored));
+        memset(data + OFFSET_CHECKSUM, 0, sizeof(stored));
+        uint32_t checksum = page_checksum(data, PAGE_SIZE);
+        memcpy(data + OFFSET_CHECKSUM, &stored, sizeof(stored));
+        return checksum;
+    }
+
+    /**
+     * @description: 写盘前在页面数据中填入校验和，data须是不会被并发修改的页面副本
+     */
+    static void set_checksum(char *data) {
+        memset(data + OFFSET_CHECKSUM, 0, sizeof(uint32_t));
+        uint32_t checksum = page_checksum(data, PAGE_SIZE);
+        memcpy(data + OFFSET_CHECKSUM, &checksum, sizeof(checksum));
+    }
+
+    static uint32_t get_checksum(const char *data) {
+        uint32_t checksum;
+        memcpy(&checksum, data + OFFSET_CHECKSUM, sizeof(checksum));
+        return checksum;
+    }
+
+    /**
+     * @description: 校验读入的页面。预分配后从未写过的页面全为0，没有校验和，也视为有效
+     */
+    static bool verify_checksum(char *data) {
+        if (compute_checksum(data) == get_checksum(data)) {
+            return true;
+        }
+        for (int i = 0; i < PAGE_SIZE; i++) {
+            if (data[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
 
     void RLock() {latch_.read_lock();}
     void RUnlock() {latch_.read_unlock();}
@@ -92,15 +141,30 @@ private:
     PageId id_;
 
     /** The actual data that is stored within a page.
-     *  该页面在bufferPool中的偏移地址
+     *  该页面在bufferPool帧数据区中的地址，按PAGE_SIZE对齐，可直接用于O_DIRECT读写
      */
-    char data_[PAGE_SIZE] = {};
+    char *data_{nullptr};
 
     /** 脏页判断 */
-    bool is_dirty_ = false;
+    std::atomic<bool> is_dirty_{false};
+
+    /** The pin count of this page. 命中时不加锁直接CAS递增，空闲或正在被淘汰的帧为负值 */
+    std::atomic<int> pin_count_{0};
+
+    /** id_打包后的值(PageId::Get())，无锁命中时用于校验帧上的页面是否仍是目标页面 */
+    std::atomic<int64_t> page_key_{INT64_MIN};
+
+    /** 页面正在从磁盘读入(读盘在分片latch之外进行)，其他线程需等待读入完成后才能使用 */
+    std::atomic<bool> io_pending_{false};
+
+    /** 帧是否在replacer中；命中路径不再调用replacer_->pin，释放最后一个pin时据此决定是否把帧交给replacer */
+    std::atomic<bool> in_replacer_{false};
+
+    /** 帧属于某个BufferAccessStrategy的私有帧环，释放最后一个pin时不交给replacer */
+    std::atomic<bool> in_ring_{false};
 
-    /** The pin count of this page. */
-    int pin_count_ = 0;
+    /** 批量写回为写盘而持有的pin数，delete_page遇到这类pin时等待写回结束而不是失败 */
+    std::atomic<int> write_pins_{0};
     RWLatch latch_;
 
 };
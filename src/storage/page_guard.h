@@ -0,0 +1,65 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <utility>
+
+#include "buffer_pool_manager.h"
+
+/**
+ * @description: 持有一个页面的pin，析构或reset时unpin(不标记为脏页)。只能移动，不能复制，
+ * 用于让指向帧内数据的指针在使用期间保持有效
+ */
+class PageGuard {
+   public:
+    PageGuard() = default;
+
+    PageGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page) {}
+
+    PageGuard(PageGuard &&other) noexcept : bpm_(other.bpm_), page_(std::exchange(other.page_, nullptr)) {}
+
+    PageGuard &operator=(PageGuard &&other) noexcept {
+        if (this != &other) {
+            reset();
+            bpm_ = other.bpm_;
+            page_ = std::exchange(other.page_, nullptr);
+        }
+        return *this;
+    }
+
+    PageGuard(const PageGuard &) = delete;
+    PageGuard &operator=(const PageGuard &) = delete;
+
+    ~PageGuard() { reset(); }
+
+    /**
+     * @description: 释放持有的pin
+     */
+    void reset() {
+        if (page_ != nullptr) {
+            bpm_->unpin_page(page_->get_page_id(), false);
+            page_ = nullptr;
+        }
+    }
+
+    Page *get() const { return page_; }
+
+    /**
+     * @description: 是否持有文件fd中页号为page_no的页面
+     */
+    bool holds(int fd, int page_no) const {
+        return page_ != nullptr && page_->get_page_id().fd == fd && page_->get_page_id().page_no == page_no;
+    }
+
+   private:
+    BufferPoolManager *bpm_{nullptr};
+    Page *page_{nullptr};
+};
@@ -0,0 +1,120 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/config.h"
+
+/**
+ * @description: buffer pool分片使用的页表，开放定址(线性探测)，以PageId::Get()打包后的64位值为key。
+ * 查找(find)不加锁，可以与修改并发执行；插入和删除(insert/erase)必须由调用者持有分片的latch串行执行。
+ * 并发查找可能得到假阴性(条目正在被移动)或过期的帧号，调用者需要pin住帧后校验页面的key，
+ * 校验失败或查找失败时再在latch下重新查找。
+ */
+class PageTable {
+   public:
+    static constexpr int64_t EMPTY_KEY = INT64_MIN;     // 空槽位，不会与任何PageId::Get()冲突
+
+    explicit PageTable(size_t num_frames) {
+        // 容量取不小于2倍帧数的2的幂，负载因子不超过0.5
+        capacity_ = 1;
+        while (capacity_ < num_frames * 2) capacity_ <<= 1;
+        mask_ = capacity_ - 1;
+        slots_ = std::make_unique<Slot[]>(capacity_);
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].key.store(EMPTY_KEY, std::memory_order_relaxed);
+            slots_[i].frame.store(INVALID_FRAME_ID, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @description: 无锁查找key对应的帧号
+     * @return {frame_id_t} 找到时返回帧号，否则返回INVALID_FRAME_ID
+     */
+    frame_id_t find(int64_t key) const {
+        for (size_t i = home(key);; i = (i + 1) & mask_) {
+            int64_t k = slots_[i].key.load(std::memory_order_acquire);
+            if (k == key) {
+                return slots_[i].frame.load(std::memory_order_acquire);
+            }
+            if (k == EMPTY_KEY) {
+                return INVALID_FRAME_ID;
+            }
+        }
+    }
+
+    /**
+     * @description: 插入或覆盖key对应的帧号，调用者须持有latch
+     */
+    void insert(int64_t key, frame_id_t frame_id) {
+        size_t i = home(key);
+        while (true) {
+            int64_t k = slots_[i].key.load(std::memory_order_relaxed);
+            if (k == key || k == EMPTY_KEY) break;
+            i = (i + 1) & mask_;
+        }
+        // 先写帧号再发布key，查找者看到key时一定能看到对应的帧号
+        slots_[i].frame.store(frame_id, std::memory_order_release);
+        slots_[i].key.store(key, std::memory_order_release);
+    }
+
+    /**
+     * @description: 删除key，采用backward shift把后续探测链上的条目前移，不留墓碑，调用者须持有latch
+     * @return {bool} key是否存在
+     */
+    bool erase(int64_t key) {
+        size_t i = home(key);
+        while (true) {
+            int64_t k = slots_[i].key.load(std::memory_order_relaxed);
+            if (k == EMPTY_KEY) return false;
+            if (k == key) break;
+            i = (i + 1) & mask_;
+        }
+        size_t j = i;
+        while (true) {
+            j = (j + 1) & mask_;
+            int64_t k = slots_[j].key.load(std::memory_order_relaxed);
+            if (k == EMPTY_KEY) break;
+            size_t h = home(k);
+            // j上的条目的home不在(i, j]之间时，可以移动到空出的i
+            bool movable = (i <= j) ? (h <= i || h > j) : (h <= i && h > j);
+            if (movable) {
+                slots_[i].frame.store(slots_[j].frame.load(std::memory_order_relaxed), std::memory_order_release);
+                slots_[i].key.store(k, std::memory_order_release);
+                i = j;
+            }
+        }
+        slots_[i].key.store(EMPTY_KEY, std::memory_order_release);
+        return true;
+    }
+
+   private:
+    struct Slot {
+        std::atomic<int64_t> key;
+        std::atomic<frame_id_t> frame;
+    };
+
+    size_t home(int64_t key) const {
+        // splitmix64的混合函数，避免与BufferPoolManager选择分片时使用的哈希相关
+        uint64_t x = static_cast<uint64_t>(key);
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return static_cast<size_t>(x) & mask_;
+    }
+
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+};
@@ -0,0 +1,459 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "csv_loader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "errors.h"
+#include "index/ix.h"
+#include "record/rm.h"
+
+namespace csv_field {
+
+namespace {
+
+inline const char *skip_space(const char *p, const char *end) {
+    while (p < end && isspace(static_cast<unsigned char>(*p))) {
+        p++;
+    }
+    return p;
+}
+
+inline bool only_space(const char *p, const char *end) { return skip_space(p, end) == end; }
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+/**
+ * @description: 解析可带符号的十进制整数，绝对值超过limit时overflow为true
+ */
+bool parse_integer(const char *begin, const char *end, uint64_t limit, bool *negative, uint64_t *abs_val,
+                   bool *overflow) {
+    const char *p = skip_space(begin, end);
+    *negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        *negative = (*p == '-');
+        p++;
+    }
+    const char *digits = p;
+    uint64_t v = 0;
+    *overflow = false;
+    for (; p < end && is_digit(*p); p++) {
+        if (v > (limit - (*p - '0')) / 10) {
+            *overflow = true;
+        } else {
+            v = v * 10 + (*p - '0');
+        }
+    }
+    if (p == digits || !only_space(p, end)) {
+        return false;
+    }
+    *abs_val = v;
+    return true;
+}
+
+/**
+ * @description: 读取恰好n位数字
+ */
+inline bool read_digits(const char *&p, const char *end, int n, int *out) {
+    if (end - p < n) {
+        return false;
+    }
+    int v = 0;
+    for (int i = 0; i < n; i++) {
+        if (!is_digit(p[i])) {
+            return false;
+        }
+        v = v * 10 + (p[i] - '0');
+    }
+    p += n;
+    *out = v;
+    return true;
+}
+
+inline bool expect(const char *&p, const char *end, char c) {
+    if (p == end || *p != c) {
+        return false;
+    }
+    p++;
+    return true;
+}
+
+}  // namespace
+
+bool parse_int(const char *begin, const char *end, int *out) {
+    bool negative, overflow;
+    uint64_t v;
+    uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int>::max()) + 1;
+    if (!parse_integer(begin, end, limit, &negative, &v, &overflow) || overflow ||
+        (!negative && v == limit)) {
+        return false;
+    }
+    *out = static_cast<int>(negative ? -static_cast<int64_t>(v) : static_cast<int64_t>(v));
+    return true;
+}
+
+bool parse_bigint(const char *begin, const char *end, int64_t *out, bool *overflow) {
+    bool negative;
+    uint64_t v;
+    uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1;
+    if (!parse_integer(begin, end, limit, &negative, &v, overflow)) {
+        *overflow = false;
+        return false;
+    }
+    if (!negative && v == limit) {
+        *overflow = true;
+    }
+    if (*overflow) {
+        return false;
+    }
+    *out = negative ? static_cast<int64_t>(0 - v) : static_cast<int64_t>(v);
+    return true;
+}
+
+bool parse_float(const char *begin, const char *end, float *out) {
+    const char *p = skip_space(begin, end);
+    if (p < end && *p == '+') {
+        p++;
+    }
+    auto res = std::from_chars(p, end, *out);
+    return res.ec == std::errc() && res.ptr != p && only_space(res.ptr, end);
+}
+
+bool parse_datetime(const char *begin, const char *end, int64_t *out) {
+    const char *p = begin;
+    int year, month, day, hour, minute, second;
+    if (!read_digits(p, end, 4, &year) || !expect(p, end, '-') || !read_digits(p, end, 2, &month) ||
+        !expect(p, end, '-') || !read_digits(p, end, 2, &day)) {
+        return false;
+    }
+    const char *time = skip_space(p, end);
+    if (time == p) {
+        return false;
+    }
+    p = time;
+    if (!read_digits(p, end, 2, &hour) || !expect(p, end, ':') || !read_digits(p, end, 2, &minute) ||
+        !expect(p, end, ':') || !read_digits(p, end, 2, &second) || p != end) {
+        return false;
+    }
+    if (year < 1000 || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 ||
+        second > 59 || (month == 2 && day > 29)) {
+        return false;
+    }
+    *out = ((((year * 100LL + month) * 100 + day) * 100 + hour) * 100 + minute) * 100 + second;
+    return true;
+}
+
+}  // namespace csv_field
+
+size_t CsvLoader::parse_lines(const TabMeta &tab, int record_size, const char *begin, const char *end,
+                              std::vector<char> *recs) {
+    size_t num_records = 0;
+    const char *line = begin;
+    while (line < end) {
+        auto nl = static_cast<const char *>(memchr(line, '\n', end - line));
+        const char *line_end = nl == nullptr ? end : nl;
+        const char *next = nl == nullptr ? end : nl + 1;
+        if (line_end > line && line_end[-1] == '\r') {
+            line_end--;
+        }
+        if (line_end == line) {
+            line = next;
+            continue;
+        }
+        size_t rec_offset = recs->size();
+        recs->resize(rec_offset + record_size);
+        char *rec = recs->data() + rec_offset;
+        const char *field = line;
+        for (size_t i = 0; i < tab.cols.size(); i++) {
+            auto comma = static_cast<const char *>(memchr(field, ',', line_end - field));
+            const char *field_end = comma == nullptr ? line_end : comma;
+            // 除最后一列外每个字段后面都应当有逗号
+            if ((comma != nullptr) != (i + 1 < tab.cols.size())) {
+                throw InvalidValueCountError();
+            }
+            auto &col = tab.cols[i];
+            char *dst = rec + col.offset;
+            switch (col.type) {
+                case TYPE_INT: {
+                    int v;
+                    if (!csv_field::parse_int(field, field_end, &v)) {
+                        throw IncompatibleTypeError(coltype2str(col.type), std::string(field, field_end));
+                    }
+                    memcpy(dst, &v, sizeof(v));
+                    break;
+                }
+                case TYPE_FLOAT: {
+                    float v;
+                    if (!csv_field::parse_float(field, field_end, &v)) {
+                        throw IncompatibleTypeError(coltype2str(col.type), std::string(field, field_end));
+                    }
+                    memcpy(dst, &v, sizeof(v));
+                    break;
+                }
+                case TYPE_BIGINT: {
+                    int64_t v;
+                    bool overflow;
+                    if (!csv_field::parse_bigint(field, field_end, &v, &overflow)) {
+                        if (overflow) {
+                            throw BigintOutOfRangeError("", std::string(field, field_end));
+                        }
+                        throw IncompatibleTypeError(coltype2str(col.type), std::string(field, field_end));
+                    }
+                    memcpy(dst, &v, sizeof(v));
+                    break;
+                }
+                case TYPE_DATETIME: {
+                    int64_t v;
+                    if (!csv_field::parse_datetime(field, field_end, &v)) {
+                        throw DateTimeAbsurdError("", std::string(field, field_end));
+                    }
+                    memcpy(dst, &v, sizeof(v));
+                    break;
+                }
+                default: {
+                    // 字符串以0补齐，新分配的记录已经全部为0
+                    if (field_end - field > col.len) {
+                        throw StringOverflowError();
+                    }
+                    memcpy(dst, field, field_end - field);
+                    break;
+                }
+            }
+            field = field_end + 1;
+        }
+        num_records++;
+        line = next;
+    }
+    return num_records;
+}
+
+/**
+ * @description: 把[begin, end)在换行处切分为若干段，每段由一个线程解析；解析错误保存在对应段的error中
+ */
+void CsvLoader::parse_window(const char *begin, const char *end, std::vector<ParsedPart> *parts) {
+    size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::max<size_t>(1, std::min<size_t>(num_threads, (end - begin) / BULK_LOAD_MIN_PART_SIZE));
+    std::vector<const char *> bounds{begin};
+    for (size_t i = 1; i < num_threads; i++) {
+        const char *target = std::max(begin + (end - begin) * i / num_threads, bounds.back());
+        auto nl = static_cast<const char *>(memchr(target, '\n', end - target));
+        bounds.push_back(nl == nullptr ? end : nl + 1);
+    }
+    bounds.push_back(end);
+    parts->clear();
+    parts->resize(num_threads);
+    auto parse_part = [&](size_t i) {
+        auto &part = (*parts)[i];
+        try {
+            part.recs.reserve((bounds[i + 1] - bounds[i]) / 4);
+            part.num_records = parse_lines(tab_, record_size_, bounds[i], bounds[i + 1], &part.recs);
+        } catch (...) {
+            part.error = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_threads; i++) {
+        workers.emplace_back(parse_part, i);
+    }
+    parse_part(0);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @description: 按文件顺序把各段的记录批量写入堆文件，并抽取各索引的键
+ */
+void CsvLoader::insert_parts(std::vector<ParsedPart> *parts) {
+    for (auto &part : *parts) {
+        if (part.error) {
+            std::rethrow_exception(part.error);
+        }
+        if (part.num_records == 0) {
+            continue;
+        }
+        auto rids = fh_->insert_records(part.recs.data(), static_cast<int>(part.num_records), context_, &tab_name_);
+        rids_.insert(rids_.end(), rids.begin(), rids.end());
+        for (size_t i = 0; i < tab_.indexes.size(); i++) {
+            auto &index = tab_.indexes[i];
+            auto &keys = keys_[i];
+            size_t key_offset = keys.size();
+            keys.resize(key_offset + part.num_records * index.col_tot_len);
+            char *key = keys.data() + key_offset;
+            for (size_t r = 0; r < part.num_records; r++) {
+                const char *rec = part.recs.data() + r * record_size_;
+                for (auto &col : index.cols) {
+                    memcpy(key, rec + col.offset, col.len);
+                    key += col.len;
+                }
+            }
+        }
+        std::vector<char>().swap(part.recs);
+    }
+}
+
+/**
+ * @description: 对每个索引，把本次导入的键排序：索引为空时(通常是向新表导入)自底向上建树，
+ * 否则按顺序插入B+树，相邻的插入落在同一个叶子上，访问的页面集中在树的最右侧路径附近。出错时删除已插入的索引项
+ */
+void CsvLoader::build_indexes() {
+    for (size_t i = 0; i < tab_.indexes.size(); i++) {
+        auto &index = tab_.indexes[i];
+        const char *keys = keys_[i].data();
+        int key_len = index.col_tot_len;
+        std::vector<ColType> col_types;
+        std::vector<int> col_lens;
+        for (auto &col : index.cols) {
+            col_types.push_back(col.type);
+            col_lens.push_back(col.len);
+        }
+        std::vector<size_t> order(rids_.size());
+        for (size_t r = 0; r < order.size(); r++) {
+            order[r] = r;
+        }
+        ix_parallel_sort(&order, [&](size_t a, size_t b) {
+            return ix_compare(keys + a * key_len, keys + b * key_len, col_types, col_lens) < 0;
+        });
+
+        size_t pos = 0;
+        try {
+            if (ihs_[i]->is_empty_tree()) {
+                // bulk_load失败时索引恢复为空，不需要逐项删除
+                size_t next = 0;
+                ihs_[i]->bulk_load(order.size(), [&](const char **key, Rid *rid) {
+                    *key = keys + order[next] * key_len;
+                    *rid = rids_[order[next]];
+                    next++;
+                });
+                continue;
+            }
+            for (; pos < order.size(); pos++) {
+                ihs_[i]->insert_entry(keys + order[pos] * key_len, rids_[order[pos]], context_->txn_);
+            }
+        } catch (...) {
+            for (size_t k = 0; k < pos; k++) {
+                ihs_[i]->delete_entry(keys + order[k] * key_len, context_->txn_);
+            }
+            for (size_t j = 0; j < i; j++) {
+                int len = tab_.indexes[j].col_tot_len;
+                for (size_t r = 0; r < rids_.size(); r++) {
+                    ihs_[j]->delete_entry(keys_[j].data() + r * len, context_->txn_);
+                }
+            }
+            throw;
+        }
+    }
+}
+
+size_t CsvLoader::load(const std::string &file_name) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw UnixError();
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw UnixError();
+    }
+    size_t file_size = st.st_size;
+    const char *data = nullptr;
+    if (file_size > 0) {
+        void *addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            throw UnixError();
+        }
+        madvise(addr, file_size, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(addr);
+    }
+    close(fd);
+    struct Unmap {
+        const char *data;
+        size_t size;
+        ~Unmap() {
+            if (data != nullptr) {
+                munmap(const_cast<char *>(data), size);
+            }
+        }
+    } unmap{data, file_size};
+
+    record_size_ = fh_->get_file_hdr().record_size;
+    keys_.assign(tab_.indexes.size(), std::vector<char>());
+    const char *end = data + file_size;
+    // 第一行是各列的列名，舍弃
+    const char *pos = data;
+    if (file_size > 0) {
+        auto nl = static_cast<const char *>(memchr(data, '\n', file_size));
+        pos = nl == nullptr ? end : nl + 1;
+    }
+    auto window_end = [end](const char *begin) {
+        if (static_cast<size_t>(end - begin) <= BULK_LOAD_WINDOW_SIZE) {
+            return end;
+        }
+        auto nl = static_cast<const char *>(memchr(begin + BULK_LOAD_WINDOW_SIZE, '\n',
+                                                   end - begin - BULK_LOAD_WINDOW_SIZE));
+        return nl == nullptr ? end : nl + 1;
+    };
+
+    try {
+        // 解析下一个窗口的同时写入当前窗口
+        std::vector<ParsedPart> cur, next;
+        if (pos < end) {
+            const char *wend = window_end(pos);
+            parse_window(pos, wend, &cur);
+            pos = wend;
+        }
+        while (!cur.empty()) {
+            std::thread parser;
+            if (pos < end) {
+                const char *wbegin = pos;
+                pos = window_end(wbegin);
+                parser = std::thread([this, wbegin, wend = pos, &next]() { parse_window(wbegin, wend, &next); });
+            }
+            try {
+                insert_parts(&cur);
+            } catch (...) {
+                if (parser.joinable()) {
+                    parser.join();
+                }
+                throw;
+            }
+            if (parser.joinable()) {
+                parser.join();
+            }
+            cur.swap(next);
+            next.clear();
+        }
+        build_indexes();
+    } catch (...) {
+        // 整条语句不生效，删除已写入的记录
+        for (auto &rid : rids_) {
+            fh_->delete_record(rid, context_, &tab_name_);
+        }
+        throw;
+    }
+
+    auto undo_next = context_->txn_->get_transaction_id();
+    for (auto &rid : rids_) {
+        context_->txn_->append_write_record(new WriteRecord(WType::INSERT_TUPLE, tab_name_, rid, undo_next));
+    }
+    return rids_.size();
+}
@@ -0,0 +1,91 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "common/context.h"
+#include "sm_meta.h"
+
+class RmFileHandle;
+class IxIndexHandle;
+
+/**
+ * @description: CSV字段的解析，不使用正则表达式和locale，结果与Value的set_xxx + init_raw相同。
+ * 字段为[begin, end)，解析成功返回true
+ */
+namespace csv_field {
+
+bool parse_int(const char *begin, const char *end, int *out);
+
+/**
+ * @param {bool*} overflow 字段是合法的整数但超出int64范围时置为true
+ */
+bool parse_bigint(const char *begin, const char *end, int64_t *out, bool *overflow);
+
+bool parse_float(const char *begin, const char *end, float *out);
+
+/**
+ * @description: 解析"YYYY-MM-DD hh:mm:ss"，检查规则与is_valid_date相同，out为YYYYMMDDhhmmss形式的整数
+ */
+bool parse_datetime(const char *begin, const char *end, int64_t *out);
+
+}  // namespace csv_field
+
+/**
+ * @description: 把CSV文件批量导入表中。文件被映射到内存后按窗口处理：每个窗口在换行处切分为多段，
+ * 由多个线程并行解析为定长记录；主线程按文件顺序把上一个窗口的记录批量写入堆文件(每个页面一条日志)，
+ * 与下一个窗口的解析同时进行。全部记录写入后，对每个索引抽取键并排序，按键的顺序插入B+树。
+ * 任何一行出错时整条语句不生效：已插入的索引项和记录都会被删除
+ */
+class CsvLoader {
+   public:
+    CsvLoader(const TabMeta &tab, RmFileHandle *fh, std::vector<IxIndexHandle *> ihs, Context *context)
+        : tab_(tab), tab_name_(tab.name), fh_(fh), ihs_(std::move(ihs)), context_(context) {}
+
+    /**
+     * @return {size_t} 导入的记录数
+     */
+    size_t load(const std::string &file_name);
+
+    /**
+     * @description: 解析[begin, end)中的各行(第一行之后的内容)，把定长记录追加到recs中，跳过空行
+     * @return {size_t} 解析出的记录数
+     */
+    static size_t parse_lines(const TabMeta &tab, int record_size, const char *begin, const char *end,
+                              std::vector<char> *recs);
+
+   private:
+    /** 一个窗口中一段的解析结果 */
+    struct ParsedPart {
+        std::vector<char> recs;
+        size_t num_records{0};
+        std::exception_ptr error;
+    };
+
+    void parse_window(const char *begin, const char *end, std::vector<ParsedPart> *parts);
+
+    void insert_parts(std::vector<ParsedPart> *parts);
+
+    void build_indexes();
+
+    const TabMeta &tab_;
+    std::string tab_name_;
+    RmFileHandle *fh_;
+    std::vector<IxIndexHandle *> ihs_;      // 与tab_.indexes一一对应
+    Context *context_;
+    int record_size_{0};
+    std::vector<Rid> rids_;                 // 已插入的全部记录
+    std::vector<std::vector<char>> keys_;   // 每个索引中已插入记录的键，与rids_一一对应
+};
@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "index/ix.h"
 #include "record/rm.h"
+#include "csv_loader.h"
 #include "record_printer.h"
 
 /**
@@ -48,6 +49,7 @@ void SmManager::create_db(const std::string& db_name) {
     //创建系统目录
     DbMeta *new_db = new DbMeta();
     new_db->name_ = db_name;
+    new_db->page_size_ = PAGE_SIZE;
 
     // 注意，此处ofstream会在当前目录创建(如果没有此文件先创建)和打开一个名为DB_META_NAME的文件
     std::ofstream ofs(DB_META_NAME);
@@ -65,6 +67,23 @@ void SmManager::create_db(const std::string& db_name) {
     }
 }
 
+/**
+ * @description: 读取已有数据库的页面大小，启动时在创建buffer pool之前调用
+ * @return {bool} 数据库或其db.meta不存在时返回false
+ * @param {string&} db_name 数据库名称，与文件夹同名
+ * @param {int*} page_size 数据库创建时记录的页面大小
+ */
+bool SmManager::read_db_page_size(const std::string& db_name, int* page_size) {
+    std::ifstream ifs(db_name + "/" + DB_META_NAME);
+    if (!ifs.is_open()) {
+        return false;
+    }
+    DbMeta db_meta;
+    ifs >> db_meta;
+    *page_size = db_meta.get_page_size();
+    return true;
+}
+
 /**
  * @description: 删除数据库，同时需要清空相关文件以及数据库同名文件夹
  * @param {string&} db_name 数据库名称，与文件夹同名
@@ -100,6 +119,11 @@ void SmManager::open_db(const std::string& db_name) {
 
     // 读入ofs打开的DB_META_NAME文件，写入到db_
     ofs >> db_;
+    // 表文件和索引文件的页面布局依赖页面大小，进程的PAGE_SIZE必须与创建数据库时一致
+    if (db_.get_page_size() != PAGE_SIZE) {
+        throw InternalError("SmManager::open_db: database page size " + std::to_string(db_.get_page_size()) +
+                            " does not match PAGE_SIZE " + std::to_string(PAGE_SIZE));
+    }
 
     //将数据库中包含的表 导入到当前fhs
     for (const auto &table: db_.tabs_) {
@@ -107,12 +131,11 @@ void SmManager::open_db(const std::string& db_name) {
         auto file = rm_manager_->open_file(table.first);
         disk_manager_->set_fd2pageno(file->GetFd(), file->getFileHdr().num_pages);
         fhs_.emplace(table.first, std::move(file));
-        const auto &indices = table.second.indexes;
-        if (!INDEX_REBUILD_MODE) {
-            for (const auto &index: table.second.indexes) {
-                auto index_name = ix_manager_->get_index_name(table.first, index.cols);
-                ihs_.emplace(index_name,
-                             ix_manager_->open_index(index_name));
+        // 索引的修改记录在日志中，由故障恢复重做和撤销；索引文件缺失或校验失败时由RecoveryManager::rebuild重建
+        for (const auto &index: table.second.indexes) {
+            auto index_name = ix_manager_->get_index_name(table.first, index.cols);
+            if (ix_manager_->exists(index_name)) {
+                ihs_.emplace(index_name, ix_manager_->open_index(index_name));
             }
         }
     }
@@ -134,7 +157,10 @@ void SmManager::close_db() {
     //1.将数据落盘
     flush_meta();
 
-    //2.关闭当前fhs_的文件及退出目录
+    //2.关闭当前ihs_和fhs_的文件及退出目录，索引的文件头和空闲页面位图随之写盘
+    for(auto &pair : ihs_)
+        ix_manager_->close_index(pair.second.get());
+    ihs_.clear();
     for(auto &pair : fhs_)
         rm_manager_->close_file(pair.second.get());
 
@@ -226,8 +252,10 @@ void SmManager::desc_table(const std::string& tab_name, Context* context) {
  * @param {string&} tab_name 表的名称
  * @param {vector<ColDef>&} col_defs 表的字段
  * @param {Context*} context 
+ * @param {bool} pax 数据文件是否使用PAX页面(按列存放)，VARCHAR字段按最大长度存放
  */
-void SmManager::create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context) {
+void SmManager::create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context,
+                             bool pax) {
     if (db_.is_table(tab_name)) {
         throw TableExistsError(tab_name);
     }
@@ -247,7 +275,16 @@ void SmManager::create_table(const std::string& tab_name, const std::vector<ColD
     }
     // Create & open record file
     int record_size = curr_offset;  // record_size就是col meta所占的大小（表的元数据也是以记录的形式进行存储的）
-    rm_manager_->create_file(tab_name, record_size);
+    std::vector<RmVarCol> var_cols;
+    std::vector<RmPaxCol> pax_cols;
+    for (auto &col : tab.cols) {
+        if (pax) {
+            pax_cols.push_back({static_cast<uint16_t>(col.offset), static_cast<uint16_t>(col.len)});
+        } else if (col.type == TYPE_VARCHAR) {
+            var_cols.push_back({col.offset, col.len});
+        }
+    }
+    rm_manager_->create_file(tab_name, record_size, var_cols, pax_cols);
     db_.tabs_[tab_name] = tab;
     // fhs_[tab_name] = rm_manager_->open_file(tab_name);
     fhs_.emplace(tab_name, rm_manager_->open_file(tab_name));
@@ -316,18 +353,17 @@ void SmManager::create_index(const std::string& tab_name, const std::vector<std:
     indexMeta.col_num = col_num;
     indexMeta.col_tot_len = tot_len;
     indexMeta.cols=index_cols;
-    table.indexes.emplace_back(indexMeta);
-
-    auto table_file_handle = fhs_.find(tab_name)->second.get();
-    RmScan rm_scan(table_file_handle);
-    Transaction transaction(INVALID_TXN_ID); // TODO (AntiO2) 事务
-    while (!rm_scan.is_end()) {
-        auto rid = rm_scan.rid();
-        auto origin_key = table_file_handle->get_record(rid,context);
-        auto key = origin_key->key_from_rec(index_cols);
-        index_handler->insert_entry(key->data,rid, &transaction);
-        rm_scan.next();
+    try {
+        build_index(tab_name, index_cols, index_handler);
+    } catch (RMDBError &) {
+        // 表中有重复的键等，不建立索引
+        buffer_pool_manager_->delete_all_pages(index_handler->getFd());
+        ix_manager_->close_index(index_handler);
+        ix_manager_->destroy_index(index_name);
+        ihs_.erase(index_name);
+        throw;
     }
+    table.indexes.emplace_back(indexMeta);
     flush_meta();
 }
 
@@ -378,7 +414,18 @@ void SmManager::rebuild_index(const std::string &tab_name, const IndexMeta&index
         col_names.emplace_back(col.name);
     }
     auto ix_name = IxManager::get_index_name(tab_name, col_names);
-    disk_manager_->reset_file(ix_name);
+    // 丢弃已打开的索引，文件清空后重建
+    auto ihs_iter = ihs_.find(ix_name);
+    if (ihs_iter != ihs_.end()) {
+        buffer_pool_manager_->delete_all_pages(ihs_iter->second->getFd());
+        disk_manager_->close_file(ihs_iter->second->getFd());
+        ihs_.erase(ihs_iter);
+    }
+    if (disk_manager_->is_file(ix_name)) {
+        disk_manager_->reset_file(ix_name);
+    } else {
+        disk_manager_->create_file(ix_name);
+    }
     int fd = disk_manager_->open_file(ix_name);
     int col_tot_len = 0;
     int col_num = index_cols.size();
@@ -388,11 +435,11 @@ void SmManager::rebuild_index(const std::string &tab_name, const IndexMeta&index
     if (col_tot_len > IX_MAX_COL_LEN) {
         throw InvalidColLengthError(col_tot_len);
     }
-    // 根据 |page_hdr| + (|attr| + |rid|) * (n + 1) <= PAGE_SIZE 求得n的最大值btree_order
+    // 根据 OFFSET_PAGE_HDR + |page_hdr| + (|attr| + |rid|) * (n + 1) <= PAGE_SIZE 求得n的最大值btree_order
     // 即 n <= btree_order，那么btree_order就是每个结点最多可插入的键值对数量（实际还多留了一个空位，但其不可插入）
     // Key: index cols
     // Value: RID
-    int btree_order = static_cast<int>((PAGE_SIZE - sizeof(IxPageHdr)) / (col_tot_len + sizeof(Rid)) - 1);
+    int btree_order = static_cast<int>((PAGE_SIZE - Page::OFFSET_PAGE_HDR - sizeof(IxPageHdr)) / (col_tot_len + sizeof(Rid)) - 1);
     // assert(btree_order > 2);
 
     // Create file header and write to file
@@ -403,6 +450,8 @@ void SmManager::rebuild_index(const std::string &tab_name, const IndexMeta&index
         fhdr->col_types_.push_back(index_cols[i].type);
         fhdr->col_lens_.push_back(index_cols[i].len);
     }
+    auto log_manager = buffer_pool_manager_->get_log_manager();
+    fhdr->base_lsn_ = log_manager != nullptr ? log_manager->get_global_lsn() : INVALID_LSN;
     fhdr->update_tot_len();
 
     char* data = new char[fhdr->tot_len_];
@@ -410,13 +459,13 @@ void SmManager::rebuild_index(const std::string &tab_name, const IndexMeta&index
 
     disk_manager_->write_page(fd, IX_FILE_HDR_PAGE, data, fhdr->tot_len_); // 将索引数据写到索引文件的第0页中（header page）
 
-    char page_buf[PAGE_SIZE];  // 在内存中初始化page_buf中的内容，然后将其写入磁盘
+    char page_buf[MAX_PAGE_SIZE];  // 在内存中初始化page_buf中的内容，然后将其写入磁盘
     memset(page_buf, 0, PAGE_SIZE);
     // 注意leaf header页号为1，也标记为叶子结点，其前一个/后一个叶子均指向root node
     // Create leaf list header page and write to file
     {
         memset(page_buf, 0, PAGE_SIZE);
-        auto phdr = reinterpret_cast<IxPageHdr *>(page_buf);
+        auto phdr = reinterpret_cast<IxPageHdr *>(page_buf + Page::OFFSET_PAGE_HDR);
         *phdr = {
                 .next_free_page_no = IX_NO_PAGE,
                 .parent = IX_NO_PAGE,
@@ -425,13 +474,14 @@ void SmManager::rebuild_index(const std::string &tab_name, const IndexMeta&index
                 .prev_leaf = IX_INIT_ROOT_PAGE,
                 .next_leaf = IX_INIT_ROOT_PAGE,
         };
+        Page::set_checksum(page_buf);
         disk_manager_->write_page(fd, IX_LEAF_HEADER_PAGE, page_buf, PAGE_SIZE);
     }
     // 注意root node页号为2，也标记为叶子结点，其前一个/后一个叶子均指向leaf header
     // Create root node and write to file
     {
         memset(page_buf, 0, PAGE_SIZE);
-        auto phdr = reinterpret_cast<IxPageHdr *>(page_buf);
+        auto phdr = reinterpret_cast<IxPageHdr *>(page_buf + Page::OFFSET_PAGE_HDR);
         *phdr = {
                 .next_free_page_no = IX_NO_PAGE,
                 .parent = IX_NO_PAGE,
@@ -440,6 +490,7 @@ void SmManager::rebuild_index(const std::string &tab_name, const IndexMeta&index
                 .prev_leaf = IX_LEAF_HEADER_PAGE,
                 .next_leaf = IX_LEAF_HEADER_PAGE,
         };
+        Page::set_checksum(page_buf);
         // Must write PAGE_SIZE here in case of future fetch_node()
         disk_manager_->write_page(fd, IX_INIT_ROOT_PAGE, page_buf, PAGE_SIZE);
     }
@@ -452,90 +503,53 @@ void SmManager::rebuild_index(const std::string &tab_name, const IndexMeta&index
     // assert(ihs_.count(index_name)==0); // 确保之前没有创建过该index
     ihs_.emplace(index_name, std::make_unique<IxIndexHandle>(disk_manager_, buffer_pool_manager_, fd));
     auto index_handler = ihs_.find(index_name)->second.get();
+    build_index(tab_name, index_cols, index_handler);
+}
+
+/**
+ * @description: 为空索引装入表中的全部记录：扫描表取出(键, rid)，外部排序后自底向上建树
+ * @param {IxIndexHandle*} ih 新建的空索引
+ */
+void SmManager::build_index(const std::string &tab_name, const std::vector<ColMeta> &index_cols, IxIndexHandle *ih) {
     auto table_file_handle = fhs_.find(tab_name)->second.get();
-    RmScan rm_scan(table_file_handle);
-    Transaction transaction(INVALID_TXN_ID);
-    while (!rm_scan.is_end()) {
+    // 建索引扫描整张表，表页只占用私有帧环，不冲掉buffer pool中的热页
+    auto strategy = table_file_handle->get_scan_strategy();
+    RmScan rm_scan(table_file_handle, strategy.get());
+    std::vector<char> decode_buf(table_file_handle->getFileHdr().record_size);
+    std::vector<char> key;
+    RmColumnMask key_cols = 0;  // PAX表只读取索引字段
+    for (auto &col : index_cols) {
+        key_cols |= rm_column_bit(db_.get_table(tab_name).cols, col.tab_name, col.name);
+    }
+    IxKeySorter sorter(ih->getFileHdr()->col_types_, ih->getFileHdr()->col_lens_);
+    for (; !rm_scan.is_end(); rm_scan.next()) {
         auto rid = rm_scan.rid();
-        auto origin_key = table_file_handle->get_record(rid,context);
-        auto key = origin_key->key_from_rec(index_cols);
-        index_handler->insert_entry(key->data,rid, &transaction);
-        rm_scan.next();
+        // 页面由rm_scan pin住，直接从帧内的记录中取出索引键
+        auto rec = table_file_handle->get_record_view(rid, rm_scan.page_guard(), decode_buf.data(), nullptr, key_cols);
+        key.clear();
+        for (auto &col : index_cols) {
+            key.insert(key.end(), rec.data() + col.offset, rec.data() + col.offset + col.len);
+        }
+        sorter.add(key.data(), rid);
     }
+    sorter.finish();
+    ih->bulk_load(sorter.size(), [&](const char **k, Rid *rid) { sorter.next(k, rid); });
 }
 
 //load lsy
-/**  TODO
- * @description: load data
+/**
+ * @description: 把CSV文件导入表中，文件第一行是列名，由CsvLoader并行解析、批量写入并维护索引
  * @param {string} 要读取的文件名
  * @param {string} tab_name 表名称
  * @param {Context*} context
  */
 void SmManager::load_csv(std::string file_name,std::string tab_name,Context* context){
-    //思路是借鉴insert的方式，对csv里面的每一行进行insert
-    //1.打开文件
-    std::ifstream infile;
-    infile.open(file_name);
-    if(!infile.is_open()){
-        throw UnixError();
-    }
-    //2.读取文件 第一行 是每列的列名，舍弃
-    std::string line;
-    std::vector<std::string> values;
-    std::getline(infile,line);
-    //3.对每一行进行insert
-    //去拿sm_manager
-    extern std::unique_ptr<SmManager>  sm_manager;
-    auto sm_manager_ = sm_manager.get();
-    while(std::getline(infile,line)){
-        //将values清空
-        values.clear();
-        std::stringstream ss(line);
-        std::string value;
-        while(std::getline(ss,value,',')){
-            values.push_back(value);
-        }
-
-        //这个时候values里面就是装有每一行的所有数据了，按照从左到右的顺序，先模仿portal的操作，对insert进行初始化
-//        if(context->txn_->get_isolation_level()==IsolationLevel::SERIALIZABLE) {
-//            auto fd = sm_manager->fhs_.at(tab_name).get()->GetFd();
-//            context->lock_mgr_->lock_exclusive_on_table(context->txn_,fd);
-//        }不需要加锁
-        auto fh_ = sm_manager_->fhs_.at(tab_name).get();
-        auto tab_ = sm_manager_->db_.get_table(tab_name);
-        // Make record buffer
-        RmRecord rec(fh_->get_file_hdr().record_size);
-        //根据table里面的数据得到各个列元素的类型，从而把values数据转化为std::vector<Value> values_
-        std::vector<Value> values_;
-        for (size_t i = 0; i < values.size(); i++) {//遍历一行的数据
-            auto &col = tab_.cols[i];
-            auto &val = values[i];
-            Value value_;//根据col来初始化value
-            if(col.type==ColType::TYPE_INT) {
-                value_.set_int(std::stoi(val));//将string转化为int
-            }else if(col.type==ColType::TYPE_FLOAT) {
-                value_.set_float(std::stof(val));//将string转化为float
-            }else if(col.type==ColType::TYPE_STRING) {
-                value_.set_str(val);//将string转化为string
-            }else if(col.type==ColType::TYPE_BIGINT) {
-                value_.set_bigint(val);//将string转化为bigint
-            }else if(col.type==TYPE_DATETIME){
-                value_.set_datetime(val);
-            }
-            values_.push_back(value_);//将value_放入values_中
-        }
-        //将values_中的数据存入rec中
-        for (size_t i = 0; i < values_.size(); i++) {
-            auto &col = tab_.cols[i];
-            auto &val = values_[i];
-            val.init_raw(col.len);
-            // 将Value数据存入rec中。
-            memcpy(rec.data + col.offset, val.raw->data, col.len);
-        }
-        auto undo_next = context->txn_->get_transaction_id();
-        // Insert into record file
-        auto rid_ = fh_->insert_record(rec.data, context,&tab_name);
-        auto* writeRecord = new WriteRecord(WType::INSERT_TUPLE,tab_name,rid_, undo_next);
-        context->txn_->append_write_record(writeRecord);
-    }
+    // 不需要加锁
+    auto &tab = db_.get_table(tab_name);
+    std::vector<IxIndexHandle *> ihs;
+    for (auto &index : tab.indexes) {
+        ihs.push_back(ihs_.at(ix_manager_->get_index_name(tab_name, index.cols)).get());
+    }
+    CsvLoader loader(tab, fhs_.at(tab_name).get(), std::move(ihs), context);
+    loader.load(file_name);
 }
@@ -61,6 +61,8 @@ class SmManager {
 
     void create_db(const std::string& db_name);
 
+    static bool read_db_page_size(const std::string& db_name, int* page_size);
+
     void drop_db(const std::string& db_name);
 
     void open_db(const std::string& db_name);
@@ -75,7 +77,8 @@ class SmManager {
 
     void desc_table(const std::string& tab_name, Context* context);
 
-    void create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context);
+    void create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context,
+                      bool pax = false);
 
     void drop_table(const std::string& tab_name, Context* context);
 
@@ -91,4 +94,7 @@ class SmManager {
     void setOff(Context *context);
 
     void load_csv(std::string file_name, std::string tab_name, Context *context);
+
+   private:
+    void build_index(const std::string& tab_name, const std::vector<ColMeta>& index_cols, IxIndexHandle* ih);
 };
\ No newline at end of file
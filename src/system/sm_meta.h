@@ -288,10 +288,13 @@ class DbMeta {
    private:
     std::string name_;                      // 数据库名称
     std::map<std::string, TabMeta> tabs_;   // 数据库中包含的表
+    int page_size_{DEFAULT_PAGE_SIZE};      // 数据库所有表文件和索引文件的页面大小，create_db时确定
 
    public:
     // DbMeta(std::string name) : name_(name) {}
 
+    int get_page_size() const { return page_size_; }
+
     /* 判断数据库中是否存在指定名称的表 */
     bool is_table(const std::string &tab_name) const { return tabs_.find(tab_name) != tabs_.end(); }
 
@@ -321,6 +324,7 @@ class DbMeta {
         for (auto &entry : db_meta.tabs_) {
             os << entry.second << '\n';
         }
+        os << db_meta.page_size_ << '\n';
         return os;
     }
 
@@ -332,6 +336,10 @@ class DbMeta {
             is >> tab;
             db_meta.tabs_[tab.name] = tab;
         }
+        // 页面大小写在最后，旧版本创建的db.meta中没有这一项，使用默认页面大小
+        if (!(is >> db_meta.page_size_)) {
+            db_meta.page_size_ = DEFAULT_PAGE_SIZE;
+        }
         return is;
     }
 };
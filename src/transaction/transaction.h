@@ -34,6 +34,7 @@ class Transaction {
         lock_set_ = std::make_shared<std::unordered_set<LockDataId>>();
         index_latch_page_set_ = std::make_shared<std::deque<Page *>>();
         index_deleted_page_set_ = std::make_shared<std::deque<Page*>>();
+        index_smo_page_set_ = std::make_shared<std::deque<std::pair<Page*, bool>>>();
         prev_lsn_ = INVALID_LSN;
         thread_id_ = std::this_thread::get_id();
     }
@@ -65,6 +66,7 @@ class Transaction {
     inline void append_index_deleted_page(Page* page) { index_deleted_page_set_->push_back(page); }
 
     inline std::shared_ptr<std::deque<Page*>> get_index_latch_page_set() { return index_latch_page_set_; }
+    inline std::shared_ptr<std::deque<std::pair<Page*, bool>>> get_index_smo_page_set() { return index_smo_page_set_; }
     inline void append_index_latch_page_set(Page* page) { index_latch_page_set_->push_back(page); }
 
     inline std::shared_ptr<std::unordered_set<LockDataId>> get_lock_set() { return lock_set_; }
@@ -164,6 +166,7 @@ class Transaction {
 
     std::shared_ptr<std::deque<Page*>> index_latch_page_set_;          // 维护事务执行过程中加锁的索引页面
     std::shared_ptr<std::deque<Page*>> index_deleted_page_set_;    // 维护事务执行过程中删除的索引页面
+    std::shared_ptr<std::deque<std::pair<Page*, bool>>> index_smo_page_set_;  // 当前索引结构修改涉及的页面及是否只修改了页头
 
     // 事务拥有的表锁
     std::shared_ptr<std::unordered_set<int>> s_table_lock_set_;
@@ -117,8 +117,7 @@ void TransactionManager::abort(Transaction * txn, LogManager *log_manager) {
           auto &index_handler = sm_manager_->ihs_.at(index_name);
           index_handler->delete_entry(new_rec->key_from_rec(index.cols)->data,txn);
         }
-        auto rid = write->GetRid();
-        table->update_record(rid, old_rec.data, context, &write->GetTableName(),LogOperation::UNDO, write->getUndoNext());
+        auto rid = table->update_record(write->GetRid(), old_rec.data, context, &write->GetTableName(),LogOperation::UNDO, write->getUndoNext());
         for(const auto& index:sm_manager_->db_.get_table(tab_name).indexes) {
           auto index_name = sm_manager_->get_ix_manager()->get_index_name(tab_name,index.cols);
           auto &index_handler = sm_manager_->ihs_.at(index_name);
@@ -0,0 +1,397 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+/**
+ * 微基准：输出各项优化的耗时和吞吐量，不属于unit_test，也不加入ctest，需要时手动运行
+ * ./bin/unit_benchmark [--gtest_filter=...]
+ * 耗时取决于编译选项和机器，只有写明了目标的基准才断言
+ */
+
+#undef NDEBUG
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/rwlatch.h"
+#include "gtest/gtest.h"
+#include "index/ix.h"
+#include "record/bitmap.h"
+#include "storage/buffer_pool_manager.h"
+#include "storage/disk_manager.h"
+
+const std::string BENCHMARK_DB_NAME = "UnitBenchmark_db";  // 以数据库名作为根目录
+const std::string BENCHMARK_FILE_NAME = "benchmark";        // 基准使用的文件
+
+/**
+ * @description: 每个基准在BENCHMARK_DB_NAME目录下新建并打开文件BENCHMARK_FILE_NAME，结束时关闭文件并回到上一层目录
+ */
+class DiskBenchmark : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    int fd_ = -1;
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        if (!disk_manager_->is_dir(BENCHMARK_DB_NAME)) {
+            disk_manager_->create_dir(BENCHMARK_DB_NAME);
+        }
+        if (chdir(BENCHMARK_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+        if (disk_manager_->is_file(BENCHMARK_FILE_NAME)) {
+            disk_manager_->destroy_file(BENCHMARK_FILE_NAME);
+        }
+        disk_manager_->create_file(BENCHMARK_FILE_NAME);
+        fd_ = disk_manager_->open_file(BENCHMARK_FILE_NAME);
+    }
+
+    void TearDown() override {
+        disk_manager_->close_file(fd_);
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    }
+};
+
+/**
+ * @brief 命中路径的微基准：所有页面都已在buffer pool中，多个线程随机fetch/unpin，
+ * 输出不同线程数下的吞吐量，命中路径不加锁时吞吐量应随线程数近似线性增长
+ */
+TEST_F(DiskBenchmark, HitThroughput) {
+    const int num_pages = 1024;
+    const int ops_per_thread = 1000000;
+    auto bpm = std::make_unique<BufferPoolManager>(num_pages * 2, disk_manager_.get());
+
+    std::vector<PageId> page_ids;
+    for (int i = 0; i < num_pages; i++) {
+        PageId page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
+        ASSERT_NE(nullptr, bpm->new_page(&page_id));
+        page_ids.push_back(page_id);
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    }
+
+    unsigned max_threads = std::max(1u, std::min(16u, std::thread::hardware_concurrency()));
+    for (unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned tid = 0; tid < num_threads; tid++) {
+            threads.emplace_back([&bpm, &page_ids, tid]() {
+                std::mt19937 rng(tid);
+                for (int i = 0; i < ops_per_thread; i++) {
+                    auto &page_id = page_ids[rng() % page_ids.size()];
+                    Page *page = bpm->fetch_page(page_id);
+                    ASSERT_NE(nullptr, page);
+                    bpm->unpin_page(page_id, false);
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double total_ops = static_cast<double>(ops_per_thread) * num_threads;
+        std::cout << "threads " << num_threads << ": " << total_ops / secs / 1e6 << " M fetch+unpin/s, "
+                  << secs * 1e9 / ops_per_thread << " ns/op per thread" << std::endl;
+    }
+    // 命中路径不会产生新的缺页，所有帧仍然可用
+    EXPECT_EQ(static_cast<size_t>(num_pages), bpm->get_free_size());
+}
+
+/**
+ * @brief 在同一负载(随机单页读，每批64个请求)上比较同步后端和io_uring后端的吞吐量
+ */
+TEST_F(DiskBenchmark, IoBackendRandomRead) {
+    const int num_pages = 4096;
+    const int batch_size = 64;
+    const int num_batches = 256;
+    std::vector<char> data(static_cast<size_t>(num_pages) * PAGE_SIZE);
+    std::vector<char *> bufs;
+    for (int i = 0; i < num_pages; i++) {
+        bufs.push_back(&data[static_cast<size_t>(i) * PAGE_SIZE]);
+        snprintf(bufs.back(), PAGE_SIZE, "page %d", i);
+    }
+    disk_manager_->write_pages(fd_, 0, bufs.data(), num_pages);
+    disk_manager_->set_fd2pageno(fd_, num_pages);
+
+    for (auto type : {IoBackendType::SYNC, IoBackendType::IO_URING}) {
+        disk_manager_->set_io_backend(type);
+        std::mt19937 rng(1);
+        std::vector<char> read_data(static_cast<size_t>(batch_size) * PAGE_SIZE);
+        std::vector<IoRequest> requests(batch_size);
+        auto start = std::chrono::steady_clock::now();
+        for (int b = 0; b < num_batches; b++) {
+            for (int i = 0; i < batch_size; i++) {
+                requests[i] = {fd_, static_cast<int>(rng() % num_pages),
+                               &read_data[static_cast<size_t>(i) * PAGE_SIZE], false};
+            }
+            disk_manager_->submit_io(requests.data(), requests.size());
+            for (auto &request : requests) {
+                ASSERT_TRUE(request.ok_);
+            }
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << disk_manager_->get_io_backend_name() << ": "
+                  << static_cast<long>(num_batches * batch_size / secs) << " random reads/s" << std::endl;
+    }
+}
+
+/**
+ * @brief 校验和的开销：输出page_checksum本身的速度，再比较buffer pool容纳不下工作集时开启和关闭校验和的缺页耗时。
+ * 目标是缺页路径上的开销在3%以内。缺页以O_DIRECT读盘，每次都真正访问设备，读入后像扫描一样读一遍页面的每个缓存行。
+ * 不读页面时校验和替使用者承担了刚读入的页面第一次访问的缓存缺失，开销会多算到2%左右。
+ * 设备的速度会漂移，偶尔还有延迟尖峰，因此每读block个页面就切换一次模式，两种模式交替读同样多的页面后比较每块耗时的中位数
+ */
+TEST_F(DiskBenchmark, ChecksumOverhead) {
+    const int num_pages = 2048;
+    const int pool_size = 256;
+    const int rounds = 24;
+    const int block = 16;
+    const double max_overhead = 0.03;
+
+    std::vector<char> data(PAGE_SIZE);
+    std::mt19937 rng(0);
+    for (auto &ch : data) {
+        ch = static_cast<char>(rng());
+    }
+    const int checksum_iters = 200000;
+    uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < checksum_iters; i++) {
+        data[0] = static_cast<char>(i);
+        sink ^= Page::compute_checksum(data.data());
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "page_checksum: " << static_cast<double>(checksum_iters) * PAGE_SIZE / secs / 1e9 << " GB/s, "
+              << secs * 1e9 / checksum_iters << " ns/page (" << sink % 2 << ")" << std::endl;
+
+    // 写入带校验和的页面并落盘
+    disk_manager_->set_page_checksums(fd_, true);
+    {
+        auto bpm = std::make_unique<BufferPoolManager>(pool_size, disk_manager_.get());
+        for (int i = 0; i < num_pages; i++) {
+            PageId page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
+            Page *page = bpm->new_page(&page_id);
+            ASSERT_NE(nullptr, page);
+            memcpy(page->get_data() + Page::OFFSET_PAGE_HDR, data.data(), PAGE_SIZE - Page::OFFSET_PAGE_HDR);
+            EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+        }
+        bpm->flush_all_pages(fd_);
+        bpm->delete_all_pages(fd_);
+    }
+    fsync(fd_);
+
+    auto direct = std::make_unique<DiskManager>();
+    direct->set_direct_io(true);
+    int fd = direct->open_file(BENCHMARK_FILE_NAME);
+    if (!direct->is_direct_io(fd)) {
+        direct->close_file(fd);
+        GTEST_SKIP() << "file system does not support O_DIRECT";
+    }
+    auto bpm = std::make_unique<BufferPoolManager>(pool_size, direct.get());
+    std::vector<double> times[2];
+    for (int round = 0; round < rounds; round++) {
+        for (int begin = 0; begin < num_pages; begin += block) {
+            bool checksums = (begin / block + round) % 2 == 1;
+            direct->set_page_checksums(fd, checksums);
+            start = std::chrono::steady_clock::now();
+            for (int i = begin; i < begin + block; i++) {
+                PageId page_id = {.fd = fd, .page_no = i};
+                Page *page = bpm->fetch_page(page_id);
+                ASSERT_NE(nullptr, page);
+                for (int off = 0; off < PAGE_SIZE; off += 64) {
+                    sink += static_cast<unsigned char>(page->get_data()[off]);
+                }
+                bpm->unpin_page(page_id, false);
+            }
+            times[checksums].push_back(
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        bpm->delete_all_pages(fd);
+    }
+    EXPECT_EQ(0u, bpm->get_checksum_failure_count());
+    double medians[2];
+    for (bool checksums : {false, true}) {
+        std::sort(times[checksums].begin(), times[checksums].end());
+        medians[checksums] = times[checksums][times[checksums].size() / 2];
+        std::cout << "O_DIRECT miss path, checksums " << (checksums ? "on" : "off") << ": "
+                  << medians[checksums] * 1e6 / block << " us/fetch" << std::endl;
+    }
+    double overhead = medians[1] / medians[0] - 1;
+    std::cout << "checksum overhead: " << overhead * 100 << "% (target < " << max_overhead * 100 << "%) ("
+              << sink % 2 << ")" << std::endl;
+    EXPECT_LT(overhead, max_overhead);
+    bpm.reset();
+    direct->close_file(fd);
+}
+
+/**
+ * @brief 稀疏位图上逐位扫描与按字扫描、一次取出全部为1的位的速度对比
+ */
+TEST(BitmapBenchmark, Scan) {
+    const int max_n = 4000;
+    const int iters = 20000;
+    std::vector<char> bm((max_n + BITMAP_WIDTH - 1) / BITMAP_WIDTH);
+    Bitmap::init(bm.data(), bm.size());
+    for (int i = 0; i < max_n; i += 97) {
+        Bitmap::set(bm.data(), i);
+    }
+    auto measure = [&](const char *name, auto &&scan) {
+        long sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iters; i++) {
+            sink += scan();
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << secs * 1e9 / iters << " ns/page (" << sink % 2 << ")" << std::endl;
+        return secs;
+    };
+    double per_bit = measure("per-bit", [&] {
+        int n = 0;
+        for (int i = 0; i < max_n; i++) {
+            n += Bitmap::is_set(bm.data(), i);
+        }
+        return n;
+    });
+    double per_word = measure("next_bit", [&] {
+        int n = 0;
+        for (int i = Bitmap::first_bit(true, bm.data(), max_n); i < max_n; i = Bitmap::next_bit(true, bm.data(), max_n, i)) {
+            n++;
+        }
+        return n;
+    });
+    measure("SetBitIterator", [&] {
+        int n = 0;
+        Bitmap::SetBitIterator iter(bm.data(), max_n);
+        for (int i = iter.next(); i < max_n; i = iter.next()) {
+            n++;
+        }
+        return n;
+    });
+    EXPECT_LT(per_word, per_bit);
+}
+
+/**
+ * @brief 无竞争时加读锁/解读锁的开销，与原先基于mutex和两个条件变量的实现对比，并给出乐观读(只校验版本号)的开销。
+ * 耗时只打印不断言，结果取决于编译选项和机器
+ */
+TEST(RWLatchBenchmark, ReadLock) {
+    // 原实现：每次加解读锁都要取mutex并notify_all
+    struct CondVarLatch {
+        std::mutex mtx;
+        bool write_locked = false;
+        size_t reader_cnt = 0;
+        std::condition_variable can_read_or_write;
+        std::condition_variable can_unlock;
+        void read_lock() {
+            std::unique_lock<std::mutex> lock(mtx);
+            can_read_or_write.wait(lock, [&] { return !write_locked; });
+            reader_cnt++;
+            can_unlock.notify_all();
+        }
+        void read_unlock() {
+            std::unique_lock<std::mutex> lock(mtx);
+            can_unlock.wait(lock, [&] { return reader_cnt >= 1; });
+            if (--reader_cnt == 0) {
+                can_read_or_write.notify_all();
+            }
+        }
+    };
+    const int iters = 2000000;
+    auto measure = [&](const char *name, auto &latch) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iters; i++) {
+            latch.read_lock();
+            latch.read_unlock();
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << secs * 1e9 / iters << " ns/read lock+unlock" << std::endl;
+        return secs;
+    };
+    // 乐观读不写latch所在的缓存行，只读取并校验版本号
+    struct OptimisticRead {
+        RWLatch latch;
+        uint32_t version = 0;
+        size_t failed = 0;
+        void read_lock() { version = latch.read_version(); }
+        void read_unlock() { failed += !latch.validate(version); }
+    };
+    CondVarLatch old_latch;
+    RWLatch latch;
+    OptimisticRead optimistic;
+    double old_secs = measure("mutex+condvar", old_latch);
+    double new_secs = measure("RWLatch", latch);
+    double optimistic_secs = measure("RWLatch optimistic", optimistic);
+    std::cout << "speedup: " << old_secs / new_secs << "x shared, " << old_secs / optimistic_secs << "x optimistic"
+              << std::endl;
+    EXPECT_EQ(0u, optimistic.failed);
+    EXPECT_EQ(0u, latch.getReaderCnt());
+}
+
+/**
+ * @brief 相邻键的比较：按列类型逐列比较原始格式的键(ix_compare)，与编码后的键直接memcmp对比
+ */
+TEST(IndexBenchmark, KeyCompare) {
+    // 键依次为int, float, bigint, datetime, char(3)
+    std::vector<ColType> col_types{TYPE_INT, TYPE_FLOAT, TYPE_BIGINT, TYPE_DATETIME, TYPE_STRING};
+    std::vector<int> col_lens{4, 4, 8, 8, 3};
+    const int key_len = 27;
+    const int num_keys = 2000;
+    std::mt19937_64 rng(25);
+    std::vector<char> raw(num_keys * key_len), normalized(num_keys * key_len);
+    for (int k = 0; k < num_keys; k++) {
+        char *key = raw.data() + k * key_len;
+        // 前几列取值很少，比较时经常要比到后面的列
+        int i = static_cast<int>(rng() % 3) - 1;
+        float f = static_cast<float>(rng() % 3) - 1.5f;
+        int64_t b = static_cast<int64_t>(rng() % 3) << 40;
+        int64_t d = static_cast<int64_t>(rng() % 3) - 1;
+        memcpy(key, &i, 4);
+        memcpy(key + 4, &f, 4);
+        memcpy(key + 8, &b, 8);
+        memcpy(key + 16, &d, 8);
+        for (int c = 0; c < 3; c++) {
+            key[24 + c] = static_cast<char>('a' + rng() % 26);
+        }
+        ix_normalize_key(key, normalized.data() + k * key_len, col_types, col_lens);
+    }
+
+    long sink = 0;
+    auto measure = [&](const char *name, auto &&cmp) {
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < 20; round++) {
+            for (int a = 0; a + 1 < num_keys; a++) {
+                sink += cmp(a, a + 1) < 0;
+            }
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << secs * 1e9 / (20 * (num_keys - 1)) << " ns/compare" << std::endl;
+    };
+    measure("ix_compare", [&](int a, int b) {
+        return ix_compare(raw.data() + a * key_len, raw.data() + b * key_len, col_types, col_lens);
+    });
+    measure("memcmp", [&](int a, int b) {
+        return memcmp(normalized.data() + a * key_len, normalized.data() + b * key_len, key_len);
+    });
+    std::cout << "(" << sink % 2 << ")" << std::endl;
+}
@@ -18,23 +18,38 @@ See the Mulan PSL v2 for more details. */
 #undef private
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <random>
 #include <set>
 #include <string>
 #include <thread>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "common/common.h"
+#include "common/rwlatch.h"
 #include "gtest/gtest.h"
+#include "index/ix.h"
+#include "replacer/clock_replacer.h"
+#include "replacer/lru_k_replacer.h"
+#include "recovery/log_recovery.h"
 #include "replacer/lru_replacer.h"
 #include "storage/disk_manager.h"
+#include "system/csv_loader.h"
+#include "system/sm_manager.h"
+#include "transaction/transaction_manager.h"
 
 const std::string TEST_DB_NAME = "BufferPoolManagerTest_db";  // 以数据库名作为根目录
 const std::string TEST_FILE_NAME = "basic";                   // 测试文件的名字
@@ -53,7 +68,7 @@ std::unordered_map<int, char *> mock;  // fd -> buffer
 char *mock_get_page(int fd, int page_no) { return &mock[fd][page_no * PAGE_SIZE]; }
 
 void check_disk(int fd, int page_no) {
-    char buf[PAGE_SIZE];
+    char buf[MAX_PAGE_SIZE];
     disk_manager->read_page(fd, page_no, buf, PAGE_SIZE);
     char *mock_buf = mock_get_page(fd, page_no);
     assert(memcmp(buf, mock_buf, PAGE_SIZE) == 0);
@@ -142,6 +157,46 @@ std::ostream &operator<<(std::ostream &os, const Rid &rid) {
     return os << '(' << rid.page_no << ", " << rid.slot_no << ')';
 }
 
+TEST(LRUKReplacerTest, HistoryTest) {
+    LRUKReplacer lru_k_replacer(7, 2);
+    int value;
+
+    // Scenario: frame 1 is accessed again while it sits in the replacer, so frame 2 now has the larger k-distance.
+    lru_k_replacer.record_access(1);
+    lru_k_replacer.record_access(1);
+    lru_k_replacer.record_access(2);
+    lru_k_replacer.record_access(2);
+    lru_k_replacer.unpin(1);
+    lru_k_replacer.unpin(2);
+    lru_k_replacer.record_access(1);
+    lru_k_replacer.record_access(1);
+    lru_k_replacer.victim(&value);
+    EXPECT_EQ(2, value);
+    lru_k_replacer.victim(&value);
+    EXPECT_EQ(1, value);
+
+    // Scenario: a frame returned to the free list forgets its history; the next page loaded into it
+    // has been accessed only once and is evicted before frame 3, whose k-th access is older.
+    lru_k_replacer.record_access(3);
+    lru_k_replacer.record_access(3);
+    lru_k_replacer.unpin(3);
+    lru_k_replacer.record_access(4);
+    lru_k_replacer.record_access(4);
+    lru_k_replacer.unpin(4);
+    lru_k_replacer.remove(4);
+    EXPECT_EQ(1, lru_k_replacer.Size());
+    lru_k_replacer.record_access(4);
+    lru_k_replacer.unpin(4);
+    std::vector<frame_id_t> frames;
+    lru_k_replacer.peek_victims(2, &frames);
+    EXPECT_EQ((std::vector<frame_id_t>{4, 3}), frames);
+    lru_k_replacer.victim(&value);
+    EXPECT_EQ(4, value);
+    lru_k_replacer.victim(&value);
+    EXPECT_EQ(3, value);
+    EXPECT_EQ(false, lru_k_replacer.victim(&value));
+}
+
 /** 注意：每个测试点只测试了单个文件！
  * 对于每个测试点，先创建和进入目录TEST_DB_NAME
  * 然后在此目录下创建和打开文件TEST_FILE_NAME_BIG，记录其文件描述符fd */
@@ -231,6 +286,71 @@ TEST(LRUReplacerTest, SampleTest) {
     EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, SampleTest) {
+    ClockReplacer clock_replacer(7);
+
+    // Scenario: unpin six elements, i.e. add them to the replacer.
+    for (int i = 1; i <= 6; i++) {
+        clock_replacer.unpin(i);
+    }
+    clock_replacer.unpin(1);
+    EXPECT_EQ(6, clock_replacer.Size());
+
+    // Scenario: the first sweep clears every reference bit, so victims come out in clock order.
+    int value;
+    clock_replacer.victim(&value);
+    EXPECT_EQ(1, value);
+    clock_replacer.victim(&value);
+    EXPECT_EQ(2, value);
+    clock_replacer.victim(&value);
+    EXPECT_EQ(3, value);
+
+    clock_replacer.pin(3);
+    clock_replacer.pin(4);
+    EXPECT_EQ(2, clock_replacer.Size());
+
+    // Scenario: unpin 4, its reference bit gives it a second chance over 5 and 6.
+    clock_replacer.unpin(4);
+    clock_replacer.victim(&value);
+    EXPECT_EQ(5, value);
+    clock_replacer.victim(&value);
+    EXPECT_EQ(6, value);
+    clock_replacer.victim(&value);
+    EXPECT_EQ(4, value);
+    EXPECT_EQ(false, clock_replacer.victim(&value));
+}
+
+TEST(LRUKReplacerTest, SampleTest) {
+    LRUKReplacer lru_k_replacer(7, 2);
+
+    // Scenario: frames 1 and 2 are accessed twice, frames 3 and 4 only once (e.g. by a sequential scan).
+    for (int i = 1; i <= 4; i++) {
+        lru_k_replacer.record_access(i);
+    }
+    lru_k_replacer.record_access(1);
+    lru_k_replacer.record_access(2);
+    for (int i = 1; i <= 4; i++) {
+        lru_k_replacer.unpin(i);
+    }
+    lru_k_replacer.pin(2);
+    EXPECT_EQ(3, lru_k_replacer.Size());
+
+    // Scenario: frames with fewer than k accesses have infinite k-distance and are evicted first.
+    int value;
+    lru_k_replacer.victim(&value);
+    EXPECT_EQ(3, value);
+    lru_k_replacer.victim(&value);
+    EXPECT_EQ(4, value);
+    lru_k_replacer.victim(&value);
+    EXPECT_EQ(1, value);
+    EXPECT_EQ(false, lru_k_replacer.victim(&value));
+
+    lru_k_replacer.unpin(2);
+    lru_k_replacer.victim(&value);
+    EXPECT_EQ(2, value);
+    EXPECT_EQ(0, lru_k_replacer.Size());
+}
+
 /** 注意：每个测试点只测试了单个文件！
  * 对于每个测试点，先创建和进入目录TEST_DB_NAME
  * 然后在此目录下创建和打开文件TEST_FILE_NAME，记录其文件描述符fd */
@@ -328,6 +448,484 @@ TEST_F(BufferPoolManagerTest, SampleTest) {
     bpm->flush_all_pages(fd);
 }
 
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, AccessStrategyTest) {
+    const size_t buffer_pool_size = 256;
+    const int num_hot_pages = 128;
+    const int num_cold_pages = 1024;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    int fd = BufferPoolManagerTest::fd_;
+
+    // 热页面留在buffer pool中
+    std::vector<PageId> hot_pages;
+    for (int i = 0; i < num_hot_pages; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->new_page(&page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->get_data(), PAGE_SIZE, "hot %d", page_id.page_no);
+        EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+        hot_pages.push_back(page_id);
+    }
+    // 冷页面只在磁盘上
+    char buf[MAX_PAGE_SIZE] = {};
+    std::vector<PageId> cold_pages;
+    for (int i = 0; i < num_cold_pages; i++) {
+        PageId page_id = {.fd = fd, .page_no = disk_manager->allocate_page(fd)};
+        snprintf(buf, PAGE_SIZE, "cold %d", page_id.page_no);
+        disk_manager->write_page(fd, page_id.page_no, buf, PAGE_SIZE);
+        cold_pages.push_back(page_id);
+    }
+    const size_t free_size = bpm->get_free_size();
+    EXPECT_EQ(buffer_pool_size - num_hot_pages, free_size);
+
+    // Scenario: 使用访问策略扫描冷页面，只占用私有帧环，策略释放后帧全部归还
+    {
+        auto strategy = bpm->get_access_strategy();
+        for (auto &page_id : cold_pages) {
+            Page *page = bpm->fetch_page(page_id, strategy.get());
+            ASSERT_NE(nullptr, page);
+            snprintf(buf, PAGE_SIZE, "cold %d", page_id.page_no);
+            EXPECT_EQ(0, strcmp(page->get_data(), buf));
+            EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+        }
+    }
+    EXPECT_EQ(free_size, bpm->get_free_size());
+
+    // Scenario: 热页面没有被淘汰，再次访问全部命中，不占用新的帧
+    for (auto &page_id : hot_pages) {
+        Page *page = bpm->fetch_page(page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(buf, PAGE_SIZE, "hot %d", page_id.page_no);
+        EXPECT_EQ(0, strcmp(page->get_data(), buf));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    }
+    EXPECT_EQ(free_size, bpm->get_free_size());
+
+    // Scenario: 不使用访问策略的扫描会占满整个buffer pool
+    for (auto &page_id : cold_pages) {
+        ASSERT_NE(nullptr, bpm->fetch_page(page_id));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    }
+    EXPECT_EQ(0u, bpm->get_free_size());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, BackgroundWriterTest) {
+    const size_t buffer_pool_size = 256;
+    const size_t clean_target = buffer_pool_size / BG_WRITER_CLEAN_DIVISOR;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    // 单个分片，淘汰顺序即LRU顺序
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager, nullptr, ReplacerType::LRU, 1);
+    int fd = BufferPoolManagerTest::fd_;
+
+    // 占满buffer pool的脏页
+    std::vector<PageId> dirty_pages;
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->new_page(&page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->get_data(), PAGE_SIZE, "dirty %d", page_id.page_no);
+        EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+        dirty_pages.push_back(page_id);
+    }
+    std::vector<PageId> cold_pages;
+    char buf[MAX_PAGE_SIZE] = {};
+    for (size_t i = 0; i <= clean_target; i++) {
+        cold_pages.push_back({.fd = fd, .page_no = disk_manager->allocate_page(fd)});
+        disk_manager->write_page(fd, cold_pages.back().page_no, buf, PAGE_SIZE);
+    }
+
+    // Scenario: 一轮后台写回把即将被淘汰的clean_target个脏页写回磁盘
+    EXPECT_EQ(clean_target, bpm->write_dirty_pages());
+    EXPECT_EQ(0u, bpm->write_dirty_pages());
+    for (size_t i = 0; i < clean_target; i++) {
+        disk_manager->read_page(fd, dirty_pages[i].page_no, buf, PAGE_SIZE);
+        EXPECT_EQ("dirty " + std::to_string(dirty_pages[i].page_no), std::string(buf));
+    }
+
+    // Scenario: 淘汰这些页面时前台不再写盘，之后淘汰未写回的脏页才会同步写盘
+    for (size_t i = 0; i < clean_target; i++) {
+        ASSERT_NE(nullptr, bpm->fetch_page(cold_pages[i]));
+        EXPECT_EQ(true, bpm->unpin_page(cold_pages[i], false));
+    }
+    EXPECT_EQ(0u, bpm->get_sync_write_count());
+    ASSERT_NE(nullptr, bpm->fetch_page(cold_pages[clean_target]));
+    EXPECT_EQ(true, bpm->unpin_page(cold_pages[clean_target], false));
+    EXPECT_EQ(1u, bpm->get_sync_write_count());
+
+    // Scenario: 后台线程启动后会持续写回即将淘汰的脏页
+    bpm->start_background_writer();
+    std::this_thread::sleep_for(std::chrono::milliseconds(BG_WRITER_DELAY_MS * 5));
+    bpm->stop_background_writer();
+    EXPECT_EQ(0u, bpm->write_dirty_pages());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, PrefetchTest) {
+    const size_t buffer_pool_size = 256;
+    const int num_pages = 64;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    int fd = BufferPoolManagerTest::fd_;
+
+    char buf[MAX_PAGE_SIZE] = {};
+    for (int i = 0; i < num_pages; i++) {
+        int page_no = disk_manager->allocate_page(fd);
+        snprintf(buf, PAGE_SIZE, "page %d", page_no);
+        disk_manager->write_page(fd, page_no, buf, PAGE_SIZE);
+    }
+
+    // Scenario: 预读线程把页面读入空闲帧，页面未被pin
+    bpm->prefetch_pages(fd, 0, num_pages);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (bpm->get_free_size() > buffer_pool_size - num_pages && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(buffer_pool_size - num_pages, bpm->get_free_size());
+
+    // Scenario: 之后的访问全部命中，不再占用新的帧
+    for (int i = 0; i < num_pages; i++) {
+        Page *page = bpm->fetch_page(PageId{fd, i});
+        ASSERT_NE(nullptr, page);
+        snprintf(buf, PAGE_SIZE, "page %d", i);
+        EXPECT_EQ(0, strcmp(page->get_data(), buf));
+        EXPECT_EQ(true, bpm->unpin_page(PageId{fd, i}, false));
+    }
+    EXPECT_EQ(buffer_pool_size - num_pages, bpm->get_free_size());
+
+    // Scenario: 取消后不再为该文件预读
+    bpm->cancel_prefetch(fd);
+    bpm->delete_all_pages(fd);
+    EXPECT_EQ(buffer_pool_size, bpm->get_free_size());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, VectoredIOTest) {
+    const int num_pages = 2000;  // 超过IOV_MAX，需要拆成多次系统调用
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    int fd = BufferPoolManagerTest::fd_;
+
+    // Scenario: write_pages/read_pages读写连续页面
+    std::vector<char> data(static_cast<size_t>(num_pages) * PAGE_SIZE);
+    std::vector<char *> bufs;
+    for (int i = 0; i < num_pages; i++) {
+        bufs.push_back(&data[static_cast<size_t>(i) * PAGE_SIZE]);
+        snprintf(bufs.back(), PAGE_SIZE, "page %d", i);
+    }
+    disk_manager->write_pages(fd, 0, bufs.data(), num_pages);
+    disk_manager->set_fd2pageno(fd, num_pages);
+    std::vector<char> read_data(data.size());
+    std::vector<char *> read_bufs;
+    for (int i = 0; i < num_pages; i++) {
+        read_bufs.push_back(&read_data[static_cast<size_t>(i) * PAGE_SIZE]);
+    }
+    disk_manager->read_pages(fd, 0, read_bufs.data(), num_pages);
+    EXPECT_EQ(0, memcmp(data.data(), read_data.data(), data.size()));
+    EXPECT_THROW(disk_manager->read_pages(fd, num_pages - 1, read_bufs.data(), 2), InternalError);
+
+    // Scenario: flush_all_pages把修改过的页面合并写回
+    const size_t buffer_pool_size = 256;
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    for (int i = 0; i < static_cast<int>(buffer_pool_size); i++) {
+        Page *page = bpm->fetch_page(PageId{fd, i * 3});
+        ASSERT_NE(nullptr, page);
+        snprintf(page->get_data(), PAGE_SIZE, "flushed %d", i * 3);
+        EXPECT_EQ(true, bpm->unpin_page(PageId{fd, i * 3}, true));
+    }
+    bpm->flush_all_pages(fd);
+    char buf[MAX_PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+        disk_manager->read_page(fd, i, buf, PAGE_SIZE);
+        std::string expected = (i % 3 == 0 && i / 3 < static_cast<int>(buffer_pool_size))
+                                   ? "flushed " + std::to_string(i)
+                                   : "page " + std::to_string(i);
+        EXPECT_EQ(expected, std::string(buf));
+    }
+}
+
+// 在同一负载(随机单页读，每批64个请求)上检查同步后端和io_uring后端，两者都通过buffer pool正确写回和预读。
+// 两者的吞吐量对比见unit_benchmark中的DiskBenchmark.IoBackendRandomRead
+TEST_F(BufferPoolManagerTest, IoBackendTest) {
+    const int num_pages = 4096;
+    const int batch_size = 64;
+    const int num_batches = 256;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    int fd = BufferPoolManagerTest::fd_;
+
+    std::vector<char> data(static_cast<size_t>(num_pages) * PAGE_SIZE);
+    std::vector<char *> bufs;
+    std::vector<std::string> contents;  // 每个页面在磁盘上的内容
+    for (int i = 0; i < num_pages; i++) {
+        bufs.push_back(&data[static_cast<size_t>(i) * PAGE_SIZE]);
+        contents.push_back("page " + std::to_string(i));
+        snprintf(bufs.back(), PAGE_SIZE, "%s", contents.back().c_str());
+    }
+    disk_manager->write_pages(fd, 0, bufs.data(), num_pages);
+    disk_manager->set_fd2pageno(fd, num_pages);
+
+    for (auto type : {IoBackendType::SYNC, IoBackendType::IO_URING}) {
+        disk_manager->set_io_backend(type);
+        std::string name = disk_manager->get_io_backend_name();
+
+        // Scenario: 随机读，每个请求读到正确的页面
+        std::mt19937 rng(1);
+        std::vector<char> read_data(static_cast<size_t>(batch_size) * PAGE_SIZE);
+        std::vector<IoRequest> requests(batch_size);
+        for (int b = 0; b < num_batches; b++) {
+            for (int i = 0; i < batch_size; i++) {
+                requests[i] = {fd, static_cast<int>(rng() % num_pages), &read_data[static_cast<size_t>(i) * PAGE_SIZE],
+                               false};
+            }
+            disk_manager->submit_io(requests.data(), requests.size());
+            for (auto &request : requests) {
+                ASSERT_TRUE(request.ok_);
+                EXPECT_EQ(contents[request.page_no_], std::string(request.buf_));
+            }
+        }
+
+        // Scenario: 读文件末尾之后的页面失败，不影响同一批中的其他请求
+        requests.resize(2);
+        requests[0] = {fd, num_pages - 1, &read_data[0], false};
+        requests[1] = {fd, num_pages + 10, &read_data[PAGE_SIZE], false};
+        disk_manager->submit_io(requests.data(), requests.size());
+        EXPECT_TRUE(requests[0].ok_);
+        EXPECT_FALSE(requests[1].ok_);
+
+        // Scenario: io_uring_enter出现不可重试的错误时，撤回未提交的请求，之后该后端改用同步读写
+        if (name == "io_uring") {
+            IoUringBackend backend;
+            close(backend.ring_fd_);
+            backend.ring_fd_ = -1;
+            unsigned sq_tail = *backend.sq_tail_;
+            for (int round = 0; round < 2; round++) {
+                requests.resize(batch_size);
+                for (int i = 0; i < batch_size; i++) {
+                    requests[i] = {fd, i * 3, &read_data[static_cast<size_t>(i) * PAGE_SIZE], false};
+                }
+                backend.submit(requests.data(), requests.size());
+                for (auto &request : requests) {
+                    ASSERT_TRUE(request.ok_);
+                    EXPECT_EQ(contents[request.page_no_], std::string(request.buf_));
+                }
+            }
+            EXPECT_TRUE(backend.broken_);
+            EXPECT_EQ(sq_tail, *backend.sq_tail_);
+        }
+
+        // Scenario: flush_all_pages通过当前后端写回，预读通过当前后端读入
+        auto bpm = std::make_unique<BufferPoolManager>(256, disk_manager);
+        for (int i = 0; i < 128; i++) {
+            Page *page = bpm->fetch_page(PageId{fd, i * 7});
+            ASSERT_NE(nullptr, page);
+            contents[i * 7] = name + " " + std::to_string(i * 7);
+            snprintf(page->get_data(), PAGE_SIZE, "%s", contents[i * 7].c_str());
+            EXPECT_EQ(true, bpm->unpin_page(PageId{fd, i * 7}, true));
+        }
+        bpm->flush_all_pages(fd);
+        char buf[MAX_PAGE_SIZE];
+        for (int i = 0; i < 128; i++) {
+            disk_manager->read_page(fd, i * 7, buf, PAGE_SIZE);
+            EXPECT_EQ(contents[i * 7], std::string(buf));
+        }
+        bpm->prefetch_pages(fd, 1000, 64);
+        for (int i = 1000; i < 1064; i++) {
+            Page *page = bpm->fetch_page(PageId{fd, i});
+            ASSERT_NE(nullptr, page);
+            EXPECT_EQ(contents[i], std::string(page->get_data()));
+            EXPECT_EQ(true, bpm->unpin_page(PageId{fd, i}, false));
+        }
+    }
+}
+
+// O_DIRECT模式：帧数据区对齐，缓冲池整页读写直接访问磁盘，文件头等不足一页或未对齐的读写经中转缓冲区完成
+TEST_F(BufferPoolManagerTest, DirectIOTest) {
+    const std::string file_name = "direct";
+    auto disk_manager = std::make_unique<DiskManager>();
+    disk_manager->set_direct_io(true);
+    if (disk_manager->is_file(file_name)) {
+        disk_manager->destroy_file(file_name);
+    }
+    disk_manager->create_file(file_name);
+    int fd = disk_manager->open_file(file_name);
+    if (!disk_manager->is_direct_io(fd)) {
+        GTEST_SKIP() << "file system does not support O_DIRECT";
+    }
+
+    // Scenario: 不足一页、未对齐的读写
+    char header[100];
+    snprintf(header, sizeof(header), "header");
+    disk_manager->write_page(fd, 0, header, sizeof(header));
+    std::vector<char> unaligned(PAGE_SIZE + 1);
+    snprintf(&unaligned[1], PAGE_SIZE, "page 1");
+    disk_manager->write_page(fd, 1, &unaligned[1], PAGE_SIZE);
+    snprintf(header, sizeof(header), "header v2");
+    disk_manager->write_page(fd, 0, header, 16);
+    char read_header[16];
+    disk_manager->read_page(fd, 0, read_header, sizeof(read_header));
+    EXPECT_EQ("header v2", std::string(read_header));
+    disk_manager->read_page(fd, 1, &unaligned[1], PAGE_SIZE);
+    EXPECT_EQ("page 1", std::string(&unaligned[1]));
+    disk_manager->set_fd2pageno(fd, 2);
+
+    // Scenario: 缓冲池的帧按PAGE_SIZE对齐，写回和重新读入都直接访问磁盘
+    const int num_pages = 300;
+    {
+        auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+        for (int i = 0; i < num_pages; i++) {
+            PageId page_id{fd, INVALID_PAGE_ID};
+            Page *page = bpm->new_page(&page_id);
+            ASSERT_NE(nullptr, page);
+            EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(page->get_data()) % PAGE_SIZE);
+            snprintf(page->get_data(), PAGE_SIZE, "direct %d", page_id.page_no);
+            EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+        }
+        bpm->flush_all_pages(fd);
+    }
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    for (int i = 2; i < num_pages + 2; i++) {
+        Page *page = bpm->fetch_page(PageId{fd, i});
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ("direct " + std::to_string(i), std::string(page->get_data()));
+        EXPECT_EQ(true, bpm->unpin_page(PageId{fd, i}, false));
+    }
+    disk_manager->read_page(fd, 0, read_header, sizeof(read_header));
+    EXPECT_EQ("header v2", std::string(read_header));
+
+    bpm->delete_all_pages(fd);
+    disk_manager->close_file(fd);
+    disk_manager->destroy_file(file_name);
+}
+
+TEST_F(BufferPoolManagerTest, FreeSpaceMapTest) {
+    auto disk_manager = disk_manager_.get();
+    char header[32];
+    snprintf(header, sizeof(header), "header");
+    disk_manager->write_page(fd_, 0, header, sizeof(header));
+    disk_manager->set_fd2pageno(fd_, 1);
+    disk_manager->open_free_space_map(fd_);
+    EXPECT_EQ(0u, disk_manager->get_num_free_pages(fd_));
+
+    // Scenario: 删除的页面进入空闲页面位图，新页面优先复用其中页号最小的
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager);
+    for (int i = 1; i <= 10; i++) {
+        PageId page_id{fd_, INVALID_PAGE_ID};
+        ASSERT_NE(nullptr, bpm->new_page(&page_id));
+        EXPECT_EQ(i, page_id.page_no);
+        EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    }
+    for (int page_no : {7, 3, 5}) {
+        EXPECT_EQ(true, bpm->delete_page(PageId{fd_, page_no}));
+    }
+    EXPECT_EQ(3u, disk_manager->get_num_free_pages(fd_));
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    ASSERT_NE(nullptr, bpm->new_page(&page_id));
+    EXPECT_EQ(3, page_id.page_no);
+    EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    bpm->flush_all_pages(fd_);
+    bpm->delete_all_pages(fd_);
+
+    // Scenario: 位图持久化在文件头页面中，不影响文件头原有内容
+    disk_manager->flush_free_space_map(fd_);
+    disk_manager->close_file(fd_);
+    fd_ = disk_manager->open_file(TEST_FILE_NAME);
+    char read_header[32];
+    disk_manager->read_page(fd_, 0, read_header, sizeof(read_header));
+    EXPECT_EQ("header", std::string(read_header));
+    disk_manager->set_fd2pageno(fd_, 11);
+    EXPECT_EQ(0u, disk_manager->get_num_free_pages(fd_));
+    disk_manager->open_free_space_map(fd_);
+    EXPECT_EQ(2u, disk_manager->get_num_free_pages(fd_));
+    EXPECT_EQ(5, disk_manager->allocate_page(fd_));
+    EXPECT_EQ(7, disk_manager->allocate_page(fd_));
+    EXPECT_EQ(11, disk_manager->allocate_page(fd_));
+}
+
+TEST_F(BufferPoolManagerTest, ExtentTest) {
+    auto disk_manager = disk_manager_.get();
+    const int extent_pages = std::max(1, FILE_EXTENT_SIZE / PAGE_SIZE);
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager);
+
+    // Scenario: 新页面不写盘，文件按FILE_EXTENT_SIZE整块增长，预分配区域读出为全0
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = bpm->new_page(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, page_id.page_no);
+    EXPECT_TRUE(page->is_dirty());
+    EXPECT_EQ(extent_pages, disk_manager->get_extent_end(fd_));
+    EXPECT_EQ(static_cast<int64_t>(extent_pages) * PAGE_SIZE, disk_manager->get_file_size(TEST_FILE_NAME));
+    std::vector<char> buf(PAGE_SIZE, 1);
+    disk_manager->read_page(fd_, extent_pages - 1, buf.data(), PAGE_SIZE);
+    EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), buf);
+    EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+
+    // Scenario: 新页面被写回时覆盖页号上原有的数据
+    snprintf(buf.data(), PAGE_SIZE, "stale");
+    disk_manager->write_page(fd_, 1, buf.data(), PAGE_SIZE);
+    page = bpm->new_page(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, page_id.page_no);
+    std::vector<char> fresh(page->get_data(), page->get_data() + PAGE_SIZE);
+    EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    bpm->flush_all_pages(fd_);
+    disk_manager->read_page(fd_, 1, buf.data(), PAGE_SIZE);
+    EXPECT_EQ(fresh, buf);
+
+    // Scenario: 超出预分配区域时再扩展一个extent
+    disk_manager->set_fd2pageno(fd_, extent_pages);
+    page = bpm->new_page(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(extent_pages, page_id.page_no);
+    EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    EXPECT_EQ(2 * extent_pages, disk_manager->get_extent_end(fd_));
+    EXPECT_EQ(static_cast<int64_t>(2 * extent_pages) * PAGE_SIZE, disk_manager->get_file_size(TEST_FILE_NAME));
+    bpm->delete_all_pages(fd_);
+}
+
+TEST_F(BufferPoolManagerTest, ChecksumTest) {
+    auto disk_manager = disk_manager_.get();
+    disk_manager->set_page_checksums(fd_, true);
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager);
+
+    // Scenario: 写回时填入校验和，重新读入时校验通过
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = bpm->new_page(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->get_data() + Page::OFFSET_PAGE_HDR, PAGE_SIZE - Page::OFFSET_PAGE_HDR, "checksum");
+    EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    bpm->flush_all_pages(fd_);
+    bpm->delete_all_pages(fd_);
+    std::vector<char> buf(PAGE_SIZE);
+    disk_manager->read_page(fd_, page_id.page_no, buf.data(), PAGE_SIZE);
+    EXPECT_EQ(Page::compute_checksum(buf.data()), Page::get_checksum(buf.data()));
+    page = bpm->fetch_page(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("checksum", std::string(page->get_data() + Page::OFFSET_PAGE_HDR));
+    EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    bpm->delete_all_pages(fd_);
+
+    // Scenario: 磁盘上的页面损坏，fetch_page抛出PageChecksumError并计数，页面不留在buffer pool中
+    buf[PAGE_SIZE / 2] ^= 0x10;
+    disk_manager->write_page(fd_, page_id.page_no, buf.data(), PAGE_SIZE);
+    EXPECT_THROW(bpm->fetch_page(page_id), PageChecksumError);
+    EXPECT_EQ(1u, bpm->get_checksum_failure_count());
+    EXPECT_THROW(bpm->fetch_page(page_id), PageChecksumError);
+    EXPECT_EQ(2u, bpm->get_checksum_failure_count());
+    EXPECT_EQ(64u, bpm->get_free_size());
+
+    // Scenario: 未写过的全0页面视为有效；未开启校验和的文件不做校验
+    disk_manager->set_fd2pageno(fd_, page_id.page_no + 1);
+    PageId zero_page_id{fd_, page_id.page_no + 1};
+    disk_manager->write_page(fd_, zero_page_id.page_no, std::vector<char>(PAGE_SIZE, 0).data(), PAGE_SIZE);
+    ASSERT_NE(nullptr, bpm->fetch_page(zero_page_id));
+    EXPECT_EQ(true, bpm->unpin_page(zero_page_id, false));
+    disk_manager->set_page_checksums(fd_, false);
+    ASSERT_NE(nullptr, bpm->fetch_page(page_id));
+    EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    EXPECT_EQ(2u, bpm->get_checksum_failure_count());
+    bpm->delete_all_pages(fd_);
+}
+
 /** 注意：每个测试点只测试了单个文件！
  * 对于每个测试点，先创建和进入目录TEST_DB_NAME
  * 然后在此目录下创建和打开文件TEST_FILE_NAME_CCUR，记录其文件描述符fd */
@@ -425,6 +1023,126 @@ TEST_F(BufferPoolManagerConcurrencyTest, ConcurrencyTest) {
     }  // end loop run=[0,num_runs)
 }
 
+// 按字扫描的next_bit/first_bit和SetBitIterator与逐位检查的结果一致，覆盖AVX2跳过整块和位图末尾不足一个字的情况
+TEST(BitmapTest, NextBitTest) {
+    std::mt19937 rng(0);
+    for (int max_n : {1, 7, 8, 63, 64, 65, 200, 1000, 4000, 8191}) {
+        for (int density : {0, 1, 50, 99, 100}) {
+            int size = (max_n + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+            std::vector<char> bm(size);
+            Bitmap::init(bm.data(), size);
+            std::vector<bool> bits(max_n);
+            for (int i = 0; i < max_n; i++) {
+                // 中间留出一段连续的空位和满位，让AVX2路径有整块可跳
+                bool bit = (i > max_n / 4 && i < max_n / 2) ? density >= 50 : static_cast<int>(rng() % 100) < density;
+                bits[i] = bit;
+                if (bit) {
+                    Bitmap::set(bm.data(), i);
+                }
+            }
+            for (bool bit : {false, true}) {
+                for (int curr = -1; curr < max_n; curr++) {
+                    int expected = curr + 1;
+                    while (expected < max_n && bits[expected] != bit) {
+                        expected++;
+                    }
+                    ASSERT_EQ(expected, Bitmap::next_bit(bit, bm.data(), max_n, curr))
+                        << "max_n " << max_n << " density " << density << " bit " << bit << " curr " << curr;
+                }
+            }
+            std::vector<int> expected_set;
+            for (int i = 0; i < max_n; i++) {
+                if (bits[i]) {
+                    expected_set.push_back(i);
+                }
+            }
+            std::vector<int> set;
+            Bitmap::SetBitIterator iter(bm.data(), max_n);
+            for (int pos = iter.next(); pos < max_n; pos = iter.next()) {
+                set.push_back(pos);
+            }
+            EXPECT_EQ(expected_set, set);
+        }
+    }
+}
+
+/**
+ * @brief 读写latch的正确性：写者之间、写者与读者之间互斥，升级锁可与读者共存并升级为写锁，乐观读能发现并发的修改
+ */
+TEST(RWLatchTest, ConcurrencyTest) {
+    RWLatch latch;
+    const int num_threads = 8;
+    const int iters = 20000;
+    long long a = 0, b = 0;  // 写者同时修改两者，持有读锁或乐观读校验通过时两者必须相等
+    std::atomic<int> torn{0};
+    std::atomic<int> readers_inside{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < iters; i++) {
+                switch ((i + t) % 4) {
+                    case 0:
+                        latch.write_lock();
+                        if (readers_inside.load() != 0) {
+                            torn++;
+                        }
+                        a++;
+                        b++;
+                        latch.write_unlock();
+                        break;
+                    case 1:
+                        latch.read_lock();
+                        readers_inside++;
+                        if (a != b) {
+                            torn++;
+                        }
+                        readers_inside--;
+                        latch.read_unlock();
+                        break;
+                    case 2:
+                        latch.upgrade_lock();
+                        if (a != b) {
+                            torn++;
+                        }
+                        if (i % 8 < 4) {
+                            latch.upgrade();
+                            a++;
+                            b++;
+                            latch.write_unlock();
+                        } else {
+                            latch.upgrade_unlock();
+                        }
+                        break;
+                    default: {
+                        uint32_t version = latch.read_version();
+                        long long x = reinterpret_cast<volatile long long &>(a);
+                        long long y = reinterpret_cast<volatile long long &>(b);
+                        if (latch.validate(version) && x != y) {
+                            torn++;
+                        }
+                    }
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(0, torn.load());
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(0u, latch.getReaderCnt());
+
+    uint32_t version = latch.read_version();
+    EXPECT_TRUE(latch.try_read_lock());
+    EXPECT_FALSE(latch.try_write_lock());
+    latch.read_unlock();
+    EXPECT_TRUE(latch.validate(version));
+    EXPECT_TRUE(latch.try_write_lock());
+    EXPECT_FALSE(latch.try_read_lock());
+    latch.write_unlock();
+    EXPECT_FALSE(latch.validate(version));
+}
+
 // TODO: fix detected memory leaks found by Google Test
 TEST(StorageTest, SimpleTest) {
     srand((unsigned)time(nullptr));
@@ -465,7 +1183,7 @@ TEST(StorageTest, SimpleTest) {
 
     /** Test buffer_pool_manager*/
     int num_pages = 0;
-    char init_buf[PAGE_SIZE];
+    char init_buf[MAX_PAGE_SIZE];
     for (auto &fh : mock) {
         int fd = fh.first;
         for (page_id_t i = 0; i < MAX_PAGES; i++) {
@@ -567,6 +1285,1196 @@ TEST(StorageTest, SimpleTest) {
     }
 }
 
+// 页面大小在启动时确定：按16KB页面创建、写入并重新打开表文件，每页容纳的记录数随页面大小增长
+TEST(StorageTest, PageSizeTest) {
+    struct PageSizeGuard {
+        int old_page_size = PAGE_SIZE;
+        ~PageSizeGuard() { PAGE_SIZE = old_page_size; }
+    } guard;
+    PAGE_SIZE = 16384;
+
+    const std::string filename = "page_size_16k";
+    const int record_size = 100;
+    const int num_records = 1000;
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    rm_manager->create_file(filename, record_size);
+    auto file_handle = rm_manager->open_file(filename);
+    int records_per_page = file_handle->file_hdr_.num_records_per_page;
+    EXPECT_GT(records_per_page * record_size, 3 * DEFAULT_PAGE_SIZE);
+    EXPECT_LE(records_per_page * record_size + file_handle->file_hdr_.bitmap_size + (int)sizeof(RmPageHdr), PAGE_SIZE);
+
+    LogManager log_manager(disk_manager.get());
+    Transaction txn(0);
+    Context context(nullptr, &log_manager, &txn);
+    std::string table_name = filename;
+    char buf[MAX_PAGE_SIZE] = {};
+    std::vector<Rid> rids;
+    for (int i = 0; i < num_records; i++) {
+        snprintf(buf, record_size, "record %d", i);
+        rids.push_back(file_handle->insert_record(buf, &context, &table_name));
+    }
+    int num_pages = file_handle->file_hdr_.num_pages;
+    EXPECT_EQ(1 + (num_records + records_per_page - 1) / records_per_page, num_pages);
+    rm_manager->close_file(file_handle.get());
+    // 文件按FILE_EXTENT_SIZE整块增长
+    EXPECT_LE(num_pages * PAGE_SIZE, disk_manager->get_file_size(filename));
+    EXPECT_EQ(0, disk_manager->get_file_size(filename) % std::max(FILE_EXTENT_SIZE, PAGE_SIZE));
+
+    // 重新打开，记录从16KB页面中读回
+    buffer_pool_manager = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+    rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    file_handle = rm_manager->open_file(filename);
+    for (int i = 0; i < num_records; i++) {
+        EXPECT_EQ("record " + std::to_string(i), std::string(file_handle->get_record(rids[i], nullptr)->data));
+    }
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
+
+// 含VARCHAR字段的表使用slotted page：短字符串只占实际长度，记录变长放不下时移动到其它页面
+TEST(StorageTest, SlottedPageTest) {
+    const std::string filename = "slotted_page";
+    const int str_len = 200;
+    const int record_size = 4 + str_len + 4;  // int id, VARCHAR(200), int
+    const int num_records = 2000;
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    rm_manager->create_file(filename, record_size, {RmVarCol{4, str_len}});
+    auto file_handle = rm_manager->open_file(filename);
+    ASSERT_TRUE(file_handle->file_hdr_.is_slotted());
+
+    LogManager log_manager(disk_manager.get());
+    Transaction txn(0);
+    Context context(nullptr, &log_manager, &txn);
+    std::string table_name = filename;
+    auto make_record = [&](int id, const std::string &str) {
+        std::string rec(record_size, '\0');
+        memcpy(&rec[0], &id, sizeof(id));
+        memcpy(&rec[4], str.data(), str.size());
+        memcpy(&rec[4 + str_len], &id, sizeof(id));
+        return rec;
+    };
+    std::unordered_map<Rid, std::string, RidHash> mock;
+    for (int i = 0; i < num_records; i++) {
+        auto rec = make_record(i, "str" + std::to_string(i));
+        mock[file_handle->insert_record(&rec[0], &context, &table_name)] = rec;
+    }
+    // 定长存储每页只能放下PAGE_SIZE / record_size条记录
+    int fixed_pages = (num_records + PAGE_SIZE / record_size - 1) / (PAGE_SIZE / record_size);
+    EXPECT_LT(file_handle->file_hdr_.num_pages * 4, fixed_pages);
+
+    // 把一部分记录更新为最长的字符串，页面放不下时记录移动，返回新的rid
+    int num_moved = 0;
+    std::vector<Rid> rids;
+    for (auto &entry : mock) {
+        rids.push_back(entry.first);
+    }
+    for (size_t i = 0; i < rids.size(); i += 3) {
+        int id;
+        memcpy(&id, mock[rids[i]].data(), sizeof(id));
+        auto rec = make_record(id, std::string(str_len, 'a' + id % 26));
+        Rid new_rid = file_handle->update_record(rids[i], &rec[0], &context, &table_name);
+        if (new_rid != rids[i]) {
+            num_moved++;
+            EXPECT_FALSE(file_handle->is_record(rids[i]));
+            mock.erase(rids[i]);
+        }
+        mock[new_rid] = rec;
+        rids[i] = new_rid;
+    }
+    EXPECT_GT(num_moved, 0);
+    // 缩短和删除
+    for (size_t i = 1; i < rids.size(); i += 3) {
+        int id;
+        memcpy(&id, mock[rids[i]].data(), sizeof(id));
+        auto rec = make_record(id, "");
+        EXPECT_EQ(rids[i], file_handle->update_record(rids[i], &rec[0], &context, &table_name));
+        mock[rids[i]] = rec;
+    }
+    for (size_t i = 2; i < rids.size(); i += 3) {
+        file_handle->delete_record(rids[i], &context, &table_name);
+        mock.erase(rids[i]);
+    }
+    // 删除后空出的空间被再次利用
+    int num_pages = file_handle->file_hdr_.num_pages;
+    for (int i = 0; i < 200; i++) {
+        auto rec = make_record(num_records + i, "new" + std::to_string(i));
+        mock[file_handle->insert_record(&rec[0], &context, &table_name)] = rec;
+    }
+    EXPECT_EQ(num_pages, file_handle->file_hdr_.num_pages);
+    rm_manager->close_file(file_handle.get());
+
+    // 重新打开后逐条读取并扫描
+    buffer_pool_manager = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+    rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    file_handle = rm_manager->open_file(filename);
+    for (auto &entry : mock) {
+        auto rec = file_handle->get_record(entry.first, nullptr);
+        EXPECT_EQ(entry.second, std::string(rec->data, rec->size));
+    }
+    size_t num_scanned = 0;
+    for (RmScan scan(file_handle.get()); !scan.is_end(); scan.next()) {
+        EXPECT_TRUE(mock.count(scan.rid()));
+        num_scanned++;
+    }
+    EXPECT_EQ(mock.size(), num_scanned);
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
+
+// get_record_view不复制记录：视图指向帧内数据，PageGuard在切换页面或reset之前一直pin住页面
+TEST(StorageTest, RecordViewTest) {
+    const std::string filename = "record_view";
+    const int record_size = 64;
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    rm_manager->create_file(filename, record_size);
+    auto file_handle = rm_manager->open_file(filename);
+    LogManager log_manager(disk_manager.get());
+    Transaction txn(0);
+    Context context(nullptr, &log_manager, &txn);
+    std::string table_name = filename;
+    char buf[record_size] = {};
+    std::vector<Rid> rids;
+    int num_records = file_handle->file_hdr_.num_records_per_page * 3;
+    for (int i = 0; i < num_records; i++) {
+        snprintf(buf, record_size, "record %d", i);
+        rids.push_back(file_handle->insert_record(buf, &context, &table_name));
+    }
+
+    PageGuard guard;
+    std::vector<char> decode_buf(record_size);
+    for (int i = 0; i < num_records; i++) {
+        RmTupleView view = file_handle->get_record_view(rids[i], &guard, decode_buf.data());
+        EXPECT_EQ("record " + std::to_string(i), std::string(view.data()));
+        EXPECT_EQ(record_size, view.size());
+        ASSERT_TRUE(guard.holds(file_handle->GetFd(), rids[i].page_no));
+        // 视图指向帧内，页面只被guard pin了一次
+        Page *page = guard.get();
+        EXPECT_TRUE(view.data() > page->get_data() && view.data() < page->get_data() + PAGE_SIZE);
+        EXPECT_EQ(1, page->pin_count_.load());
+    }
+    Page *page = guard.get();
+    guard.reset();
+    EXPECT_EQ(0, page->pin_count_.load());
+    file_handle->delete_record(rids[0], &context, &table_name);
+    EXPECT_THROW(file_handle->get_record_view(rids[0], &guard, decode_buf.data()), RecordNotFoundError);
+    guard.reset();
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
+
+// RmScan逐页pin一次页面并用谓词筛选记录，当前页面由扫描持有，读取记录不再访问buffer pool
+TEST(StorageTest, PageSlotsTest) {
+    const std::string filename = "page_slots";
+    const int record_size = 64;
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    rm_manager->create_file(filename, record_size);
+    auto file_handle = rm_manager->open_file(filename);
+    LogManager log_manager(disk_manager.get());
+    Transaction txn(0);
+    Context context(nullptr, &log_manager, &txn);
+    std::string table_name = filename;
+    char buf[record_size] = {};
+    std::vector<Rid> rids;
+    int num_records = file_handle->file_hdr_.num_records_per_page * 5 + 7;
+    for (int i = 0; i < num_records; i++) {
+        memcpy(buf, &i, sizeof(i));
+        rids.push_back(file_handle->insert_record(buf, &context, &table_name));
+    }
+    // 删除一部分，留下空洞
+    for (int i = 0; i < num_records; i += 5) {
+        file_handle->delete_record(rids[i], &context, &table_name);
+    }
+
+    std::vector<int> expected;
+    for (int i = 0; i < num_records; i++) {
+        if (i % 5 != 0 && i % 3 == 0) {
+            expected.push_back(i);
+        }
+    }
+    std::vector<int> scanned;
+    std::vector<char> decode_buf(record_size);
+    RmScan scan(file_handle.get(), nullptr, [](const char *rec) { return *reinterpret_cast<const int *>(rec) % 3 == 0; });
+    for (; !scan.is_end(); scan.next()) {
+        ASSERT_TRUE(scan.page_guard()->holds(file_handle->GetFd(), scan.rid().page_no));
+        EXPECT_EQ(1, scan.page_guard()->get()->pin_count_.load());
+        auto view = file_handle->get_record_view(scan.rid(), scan.page_guard(), decode_buf.data());
+        scanned.push_back(*reinterpret_cast<const int *>(view.data()));
+    }
+    EXPECT_EQ(expected, scanned);
+    EXPECT_EQ(nullptr, scan.page_guard()->get());
+
+    // 不带谓词时返回页面中全部记录
+    std::vector<int> slots;
+    PageGuard guard;
+    file_handle->get_page_slots(RM_FIRST_RECORD_PAGE, &guard, &slots);
+    int per_page = file_handle->file_hdr_.num_records_per_page;
+    EXPECT_EQ(per_page - (per_page + 4) / 5, static_cast<int>(slots.size()));
+    EXPECT_TRUE(std::is_sorted(slots.begin(), slots.end()));
+    guard.reset();
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
+
+// PAX页面：同一列的值在minipage中连续存放，按列掩码读取时只解码需要的字段
+TEST(StorageTest, PaxPageTest) {
+    const std::string filename = "pax_page";
+    const int record_size = 32;  // int, bigint, CHAR(20)
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    rm_manager->create_file(filename, record_size, {}, {RmPaxCol{0, 4}, RmPaxCol{4, 8}, RmPaxCol{12, 20}});
+    auto file_handle = rm_manager->open_file(filename);
+    ASSERT_TRUE(file_handle->file_hdr_.is_pax());
+    LogManager log_manager(disk_manager.get());
+    Transaction txn(0);
+    Context context(nullptr, &log_manager, &txn);
+    std::string table_name = filename;
+
+    auto make_record = [&](int i, char *buf) {
+        int64_t big = int64_t{i} * 1000000007;
+        memset(buf, 0, record_size);
+        memcpy(buf, &i, sizeof(i));
+        memcpy(buf + 4, &big, sizeof(big));
+        snprintf(buf + 12, 20, "name %d", i);
+    };
+    char buf[record_size];
+    int per_page = file_handle->file_hdr_.num_records_per_page;
+    int num_records = per_page * 3 + 5;
+    std::vector<Rid> rids;
+    for (int i = 0; i < per_page; i++) {
+        make_record(i, buf);
+        rids.push_back(file_handle->insert_record(buf, &context, &table_name));
+    }
+    std::vector<char> bufs(static_cast<size_t>(num_records - per_page) * record_size);
+    for (int i = per_page; i < num_records; i++) {
+        make_record(i, bufs.data() + static_cast<size_t>(i - per_page) * record_size);
+    }
+    auto batch_rids = file_handle->insert_records(bufs.data(), num_records - per_page, &context, &table_name);
+    rids.insert(rids.end(), batch_rids.begin(), batch_rids.end());
+
+    for (int i = 0; i < num_records; i++) {
+        make_record(i, buf);
+        auto rec = file_handle->get_record(rids[i], &context);
+        ASSERT_EQ(0, memcmp(buf, rec->data, record_size)) << i;
+    }
+    // 第一个页面中第0列的minipage就是各记录的id按槽号排列
+    RmPageHandle page_handle = file_handle->fetch_page_handle(RM_FIRST_RECORD_PAGE);
+    for (int slot_no = 0; slot_no < per_page; slot_no++) {
+        EXPECT_EQ(slot_no, reinterpret_cast<const int *>(page_handle.get_minipage(0))[slot_no]);
+    }
+    buffer_pool_manager->unpin_page(page_handle.page->get_page_id(), false);
+
+    make_record(-1, buf);
+    file_handle->update_record(rids[1], buf, &context, &table_name);
+    EXPECT_EQ(0, memcmp(buf, file_handle->get_record(rids[1], &context)->data, record_size));
+    file_handle->delete_record(rids[2], &context, &table_name);
+    EXPECT_FALSE(file_handle->is_record(rids[2]));
+
+    // 谓词只用第0列，上层只读取第1列，第2列保持decode_buf中的原值
+    std::vector<char> decode_buf(record_size, 0x7f);
+    RmScan scan(file_handle.get(), nullptr, [](const char *rec) { return *reinterpret_cast<const int *>(rec) % 2 == 0; },
+                RmColumnMask{1} << 0);
+    int num_scanned = 0;
+    for (; !scan.is_end(); scan.next()) {
+        auto view = file_handle->get_record_view(scan.rid(), scan.page_guard(), decode_buf.data(), nullptr,
+                                                 RmColumnMask{1} << 1);
+        int64_t big;
+        memcpy(&big, view.data() + 4, sizeof(big));
+        EXPECT_EQ(0, big % 2);
+        EXPECT_EQ(0x7f, view.data()[12]);
+        num_scanned++;
+    }
+    // 偶数id中2已被删除，id为1的记录改写为-1
+    EXPECT_EQ((num_records + 1) / 2 - 1, num_scanned);
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
+
+TEST(StorageTest, BulkInsertTest) {
+    const std::string filename = "bulk_insert";
+    const int str_len = 60;
+    const int record_size = 4 + str_len;  // int id, CHAR/VARCHAR(60)
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    LogManager log_manager(disk_manager.get());
+    Transaction txn(0);
+    Context context(nullptr, &log_manager, &txn);
+    std::string table_name = filename;
+
+    for (bool slotted : {false, true}) {
+        if (disk_manager->is_file(filename)) {
+            disk_manager->destroy_file(filename);
+        }
+        if (slotted) {
+            rm_manager->create_file(filename, record_size, {RmVarCol{4, str_len}});
+        } else {
+            rm_manager->create_file(filename, record_size);
+        }
+        auto file_handle = rm_manager->open_file(filename);
+        auto make_record = [&](int id, char *rec) {
+            memset(rec, 0, record_size);
+            memcpy(rec, &id, sizeof(id));
+            memset(rec + 4, 'a' + id % 26, id % str_len);
+        };
+        // 先插入一页多的记录再删除一部分，批量插入从有空洞的页面开始填
+        std::vector<char> rec(record_size);
+        std::vector<Rid> old_rids;
+        for (int i = 0; i < 200; i++) {
+            make_record(100000 + i, rec.data());
+            old_rids.push_back(file_handle->insert_record(rec.data(), &context, &table_name));
+        }
+        for (int i = 0; i < 200; i += 2) {
+            file_handle->delete_record(old_rids[i], &context, &table_name);
+        }
+
+        const int num_records = 1000;
+        std::vector<char> recs(num_records * record_size);
+        for (int i = 0; i < num_records; i++) {
+            make_record(i, recs.data() + i * record_size);
+        }
+        lsn_t prev_lsn = txn.get_prev_lsn();
+        auto rids = file_handle->insert_records(recs.data(), num_records, &context, &table_name);
+        ASSERT_EQ(num_records, static_cast<int>(rids.size()));
+        std::set<int> pages;
+        for (int i = 0; i < num_records; i++) {
+            pages.insert(rids[i].page_no);
+            auto got = file_handle->get_record(rids[i], &context);
+            EXPECT_EQ(0, memcmp(got->data, recs.data() + i * record_size, record_size));
+        }
+        // 每个页面一条日志
+        EXPECT_EQ(static_cast<int>(pages.size()), txn.get_prev_lsn() - prev_lsn);
+        std::unordered_set<Rid, RidHash> unique_rids(rids.begin(), rids.end());
+        EXPECT_EQ(rids.size(), unique_rids.size());
+        // 文件头在批量插入结束时写回
+        RmFileHdr disk_hdr;
+        disk_manager->read_page(file_handle->GetFd(), RM_FILE_HDR_PAGE, (char *)&disk_hdr, sizeof(disk_hdr));
+        EXPECT_EQ(file_handle->file_hdr_.num_pages, disk_hdr.num_pages);
+        EXPECT_EQ(file_handle->file_hdr_.first_free_page_no, disk_hdr.first_free_page_no);
+        rm_manager->close_file(file_handle.get());
+    }
+
+    // 批量insert日志的序列化
+    InsertBatchLogRecord log(3, 7, table_name, 5, 2, 9);
+    log.add_tuple(1, "abc", 3);
+    log.add_tuple(4, "defgh", 5);
+    std::vector<char> buf(log.log_tot_len_);
+    log.serialize(buf.data());
+    InsertBatchLogRecord copy(buf.data());
+    EXPECT_EQ(log.log_tot_len_, copy.log_tot_len_);
+    EXPECT_EQ(7, copy.page_no_);
+    EXPECT_EQ(2, copy.num_tuples());
+    EXPECT_EQ(std::vector<int>({1, 4}), copy.slot_nos_);
+    EXPECT_EQ(0, memcmp(copy.tuple(1), "defgh", 5));
+    EXPECT_EQ(table_name, std::string(copy.table_name_, copy.table_name_size_));
+    EXPECT_EQ(9, copy.num_pages_);
+    rm_manager->destroy_file(filename);
+}
+
+/**
+ * @brief 编码后的键用memcmp比较的结果与ix_compare逐列比较的结果一致，并且可以还原；同时对比两种比较的速度
+ */
+TEST(StorageTest, IndexKeyNormalizeTest) {
+    // 键依次为int, float, bigint, datetime, char(3)
+    std::vector<ColType> col_types{TYPE_INT, TYPE_FLOAT, TYPE_BIGINT, TYPE_DATETIME, TYPE_STRING};
+    std::vector<int> col_lens{4, 4, 8, 8, 3};
+    const int key_len = 27;
+    std::mt19937_64 rng(25);
+    std::vector<int> ints{INT32_MIN, -7, -1, 0, 1, 7, INT32_MAX};
+    std::vector<float> floats{-1e30f, -2.5f, -0.0f, 0.0f, 1e-30f, 2.5f, 1e30f};
+    std::vector<int64_t> bigints{INT64_MIN, -(int64_t(1) << 40), -1, 0, 1, int64_t(1) << 40, INT64_MAX};
+    std::vector<std::string> strs{std::string("\0\0\0", 3), "a\0\0", "ab\0", "abc", "b\0\0", "\xff\0\0"};
+    const int num_keys = 2000;
+    std::vector<char> raw(num_keys * key_len), normalized(num_keys * key_len);
+    for (int k = 0; k < num_keys; k++) {
+        char *key = raw.data() + k * key_len;
+        int i = ints[rng() % ints.size()];
+        float f = floats[rng() % floats.size()];
+        int64_t b = bigints[rng() % bigints.size()];
+        int64_t d = static_cast<int64_t>(rng() % 3) - 1;
+        memcpy(key, &i, 4);
+        memcpy(key + 4, &f, 4);
+        memcpy(key + 8, &b, 8);
+        memcpy(key + 16, &d, 8);
+        memcpy(key + 24, strs[rng() % strs.size()].data(), 3);
+        ix_normalize_key(key, normalized.data() + k * key_len, col_types, col_lens);
+    }
+    auto sign = [](int x) { return (x > 0) - (x < 0); };
+    for (int a = 0; a < num_keys; a++) {
+        const char *ra = raw.data() + a * key_len;
+        const char *na = normalized.data() + a * key_len;
+        for (int b = a; b < std::min(num_keys, a + 50); b++) {
+            const char *rb = raw.data() + b * key_len;
+            const char *nb = normalized.data() + b * key_len;
+            ASSERT_EQ(ix_compare(ra, rb, col_types, col_lens), sign(memcmp(na, nb, key_len))) << a << " " << b;
+            // 只比较前两列
+            ASSERT_EQ(ix_compare(ra, rb, col_types, col_lens, 2), sign(memcmp(na, nb, 8))) << a << " " << b;
+        }
+        std::vector<char> back(key_len);
+        ix_denormalize_key(na, back.data(), col_types, col_lens);
+        ASSERT_EQ(0, ix_compare(ra, back.data(), col_types, col_lens)) << a;
+    }
+}
+
+TEST(StorageTest, IndexBulkLoadTest) {
+    const std::string table_name = "ix_bulk_load";
+    std::vector<ColMeta> index_cols{ColMeta{table_name, "id", TYPE_INT, 4, 0, false}};
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+    auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    Transaction txn(0);
+    std::string ix_name = IxManager::get_index_name(table_name, index_cols);
+    if (disk_manager->is_file(ix_name)) {
+        disk_manager->destroy_file(ix_name);
+    }
+    ix_manager->create_index(table_name, index_cols);
+    auto ih = ix_manager->open_index(table_name, index_cols);
+    ASSERT_TRUE(ih->is_empty_tree());
+
+    // 偶数键乱序加入，内存上限很小，排序时写出多个有序段
+    const int num_keys = 20000;
+    std::vector<int> keys;
+    for (int i = 0; i < num_keys; i++) {
+        keys.push_back(i * 2);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+    IxKeySorter sorter({TYPE_INT}, {4}, 4096);
+    for (int key : keys) {
+        sorter.add(reinterpret_cast<const char *>(&key), Rid{key / 2, key % 7});
+    }
+    sorter.finish();
+    ih->bulk_load(sorter.size(), [&](const char **key, Rid *rid) { sorter.next(key, rid); });
+    EXPECT_FALSE(ih->is_empty_tree());
+    EXPECT_THROW(ih->bulk_load(0, nullptr), InternalError);
+
+    // 沿叶子链表遍历：键有序且齐全，结点按填充因子填充
+    int expected = 0;
+    int num_leaves = 0;
+    int min_size = num_keys, max_size = 0;
+    int per_node = static_cast<int>(ih->getFileHdr()->btree_order_ * INDEX_BULK_LOAD_FILL_FACTOR);
+    for (page_id_t page_no = ih->getFileHdr()->first_leaf_; page_no != IX_LEAF_HEADER_PAGE; num_leaves++) {
+        auto node = std::make_unique<IxNodeHandle>(ih->getFileHdr(),
+                                                   buffer_pool_manager->fetch_page(PageId{ih->getFd(), page_no}));
+        ASSERT_TRUE(node->is_leaf_page());
+        min_size = std::min(min_size, node->get_size());
+        max_size = std::max(max_size, node->get_size());
+        for (int i = 0; i < node->get_size(); i++) {
+            int key;
+            ix_denormalize_key(node->get_key(i), reinterpret_cast<char *>(&key), ih->getFileHdr()->col_types_,
+                               ih->getFileHdr()->col_lens_);
+            ASSERT_EQ(expected, key);
+            EXPECT_EQ(expected / 2, node->get_rid(i)->page_no);
+            expected += 2;
+        }
+        page_no = node->get_next_leaf();
+        buffer_pool_manager->unpin_page(node->get_page_id(), false);
+    }
+    EXPECT_EQ(num_keys * 2, expected);
+    EXPECT_EQ((num_keys + per_node - 1) / per_node, num_leaves);
+    EXPECT_LE(max_size, per_node);
+    EXPECT_LE(max_size - min_size, 1);
+
+    // 经内部结点查找，之后照常插入(会分裂结点)
+    for (int key = 0; key < num_keys * 2; key += 97) {
+        std::vector<Rid> result;
+        EXPECT_EQ(key % 2 == 0, ih->get_value(reinterpret_cast<const char *>(&key), &result, &txn)) << key;
+    }
+    for (int key = 1; key < 2000; key += 2) {
+        ih->insert_entry(reinterpret_cast<const char *>(&key), Rid{key, 0}, &txn);
+    }
+    for (int key = 0; key < 2000; key++) {
+        std::vector<Rid> result;
+        ASSERT_TRUE(ih->get_value(reinterpret_cast<const char *>(&key), &result, &txn)) << key;
+    }
+    buffer_pool_manager->delete_all_pages(ih->getFd());
+    ix_manager->close_index(ih.get());
+    ix_manager->destroy_index(ix_name);
+
+    // 键重复时抛出异常，索引恢复为空并可继续使用
+    ix_manager->create_index(table_name, index_cols);
+    ih = ix_manager->open_index(table_name, index_cols);
+    std::vector<int> dup_keys{1, 2, 3, 3, 4};
+    size_t pos = 0;
+    EXPECT_THROW(ih->bulk_load(dup_keys.size(),
+                               [&](const char **key, Rid *rid) {
+                                   *key = reinterpret_cast<const char *>(&dup_keys[pos]);
+                                   *rid = Rid{dup_keys[pos++], 0};
+                               },
+                               0.0),
+                 IndexEntryDuplicateError);
+    EXPECT_TRUE(ih->is_empty_tree());
+    int key = 3;
+    ih->insert_entry(reinterpret_cast<const char *>(&key), Rid{3, 0}, &txn);
+    std::vector<Rid> result;
+    EXPECT_TRUE(ih->get_value(reinterpret_cast<const char *>(&key), &result, &txn));
+    buffer_pool_manager->delete_all_pages(ih->getFd());
+    ix_manager->close_index(ih.get());
+    ix_manager->destroy_index(ix_name);
+}
+
+TEST(StorageTest, IndexSuffixTruncationTest) {
+    const std::string table_name = "ix_suffix_truncation";
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+    auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    Transaction txn(0);
+
+    // 自顶向下检查：内部结点的分隔键比完整的键短，且介于相邻两个孩子的键之间；非根叶子不为空。返回树高
+    int max_fanout = 0;
+    std::function<int(IxIndexHandle *, page_id_t, std::vector<char> *, std::vector<char> *)> walk =
+        [&](IxIndexHandle *ih, page_id_t page_no, std::vector<char> *min_key, std::vector<char> *max_key) {
+            int len = ih->getFileHdr()->col_tot_len_;
+            IxNodeHandle node(ih->getFileHdr(), buffer_pool_manager->fetch_page(PageId{ih->getFd(), page_no}));
+            int height = 1;
+            if (node.is_leaf_page()) {
+                EXPECT_TRUE(node.get_size() > 0 || node.is_root_page()) << page_no;
+                if (node.get_size() > 0) {
+                    min_key->assign(node.get_key(0), node.get_key(0) + len);
+                    max_key->assign(node.get_key(node.get_size() - 1), node.get_key(node.get_size() - 1) + len);
+                }
+            } else {
+                max_fanout = std::max(max_fanout, node.get_size());
+                EXPECT_FALSE(node.is_full()) << page_no;
+                std::vector<char> child_min(len), child_max(len);
+                for (int i = 0; i < node.get_size(); i++) {
+                    EXPECT_EQ(page_no, [&] {
+                        IxNodeHandle child(ih->getFileHdr(),
+                                           buffer_pool_manager->fetch_page(PageId{ih->getFd(), node.value_at(i)}));
+                        page_id_t parent = child.get_parent_page_no();
+                        buffer_pool_manager->unpin_page(child.get_page_id(), false);
+                        return parent;
+                    }());
+                    if (i > 0) {
+                        EXPECT_GT(node.compare_key(i, child_max.data(), len), 0) << page_no << " " << i;
+                    }
+                    height = walk(ih, node.value_at(i), &child_min, &child_max) + 1;
+                    if (i > 0) {
+                        EXPECT_LE(node.compare_key(i, child_min.data(), len), 0) << page_no << " " << i;
+                        EXPECT_LT(node.get_key_size(i), len);
+                    }
+                    if (i == 0) {
+                        *min_key = child_min;
+                    }
+                }
+                *max_key = child_max;
+            }
+            buffer_pool_manager->unpin_page(node.get_page_id(), false);
+            return height;
+        };
+
+    // 两种宽键：(int, char(200))的第一列重复、第二列在开头就不同；char(200)的键有100字节的公共前缀
+    struct Config {
+        std::vector<ColMeta> cols;
+        std::function<void(int, char *)> make_key;
+    };
+    std::vector<Config> configs{
+        {{ColMeta{table_name, "grp", TYPE_INT, 4, 0, false}, ColMeta{table_name, "name", TYPE_STRING, 200, 4, false}},
+         [](int id, char *key) {
+             int grp = id / 4;
+             memcpy(key, &grp, 4);
+             std::string name = std::to_string(id % 4) + std::string(150, 'x');
+             memset(key + 4, 0, 200);
+             memcpy(key + 4, name.data(), name.size());
+         }},
+        {{ColMeta{table_name, "name", TYPE_STRING, 200, 0, false}},
+         [](int id, char *key) {
+             char digits[16];
+             snprintf(digits, sizeof(digits), "%08d", id);
+             std::string name = std::string(100, 'p') + digits + std::string(50, 'x');
+             memset(key, 0, 200);
+             memcpy(key, name.data(), name.size());
+         }},
+    };
+    const int num_keys = 6000;
+    for (auto &config : configs) {
+        std::string ix_name = IxManager::get_index_name(table_name, config.cols);
+        if (disk_manager->is_file(ix_name)) {
+            disk_manager->destroy_file(ix_name);
+        }
+        ix_manager->create_index(table_name, config.cols);
+        auto ih = ix_manager->open_index(table_name, config.cols);
+        int len = ih->getFileHdr()->col_tot_len_;
+        std::vector<char> key(len);
+        std::vector<int> ids(num_keys);
+        std::iota(ids.begin(), ids.end(), 0);
+        std::shuffle(ids.begin(), ids.end(), std::mt19937(len));
+        for (int id : ids) {
+            config.make_key(id, key.data());
+            ih->insert_entry(key.data(), Rid{id, 0}, &txn);
+        }
+        std::vector<char> min_key, max_key;
+        max_fanout = 0;
+        int height = walk(ih.get(), ih->getFileHdr()->root_page_, &min_key, &max_key);
+        // 定长的内部结点最多有btree_order+1个孩子
+        EXPECT_GT(max_fanout, ih->getFileHdr()->btree_order_ + 1) << ix_name;
+        EXPECT_LE(height, 3) << ix_name;
+
+        // 删除三分之二的键，引起合并和重分配，之后查找、扫描、按第一列定位都正确
+        std::shuffle(ids.begin(), ids.end(), std::mt19937(len + 1));
+        for (int id : ids) {
+            if (id % 3 != 0) {
+                config.make_key(id, key.data());
+                ASSERT_TRUE(ih->delete_entry(key.data(), &txn)) << id;
+            }
+        }
+        walk(ih.get(), ih->getFileHdr()->root_page_, &min_key, &max_key);
+        EXPECT_TRUE(ih->verify());
+        for (int id = 0; id < num_keys; id++) {
+            config.make_key(id, key.data());
+            std::vector<Rid> result;
+            ASSERT_EQ(id % 3 == 0, ih->get_value(key.data(), &result, &txn)) << id;
+        }
+        IxScan scan(ih.get(), ih->leaf_begin(), ih->leaf_end(), buffer_pool_manager.get());
+        int expected = 0;
+        for (; !scan.is_end(); scan.next(), expected += 3) {
+            ASSERT_EQ(expected, scan.rid().page_no);
+        }
+        EXPECT_EQ(num_keys, expected);
+        if (config.cols.size() == 2) {
+            for (int grp = 0; grp < num_keys / 4; grp++) {
+                // 第grp组及下一组中第一个未删除的id为组的第一个id向上取到3的倍数
+                int first = (grp * 4 + 2) / 3 * 3;
+                int next = ((grp + 1) * 4 + 2) / 3 * 3;
+                IxScan group(ih.get(), ih->lower_bound_cnt(reinterpret_cast<const char *>(&grp), 1),
+                             ih->upper_bound_cnt(reinterpret_cast<const char *>(&grp), 1), buffer_pool_manager.get());
+                for (int id = first; id < next; id += 3, group.next()) {
+                    ASSERT_FALSE(group.is_end()) << grp;
+                    EXPECT_EQ(id, group.rid().page_no) << grp;
+                }
+                EXPECT_TRUE(group.is_end()) << grp;
+            }
+        }
+
+        // 删除全部的键后树为空，再用批量建树建立同样的索引
+        for (int id = 0; id < num_keys; id += 3) {
+            config.make_key(id, key.data());
+            ASSERT_TRUE(ih->delete_entry(key.data(), &txn)) << id;
+        }
+        EXPECT_TRUE(ih->is_empty_tree());
+        std::vector<char> sorted(num_keys * len);
+        for (int id = 0; id < num_keys; id++) {
+            config.make_key(id, sorted.data() + id * len);
+        }
+        int next_id = 0;
+        ih->bulk_load(num_keys, [&](const char **key, Rid *rid) {
+            *key = sorted.data() + next_id * len;
+            *rid = Rid{next_id++, 0};
+        });
+        max_fanout = 0;
+        walk(ih.get(), ih->getFileHdr()->root_page_, &min_key, &max_key);
+        EXPECT_GT(max_fanout, ih->getFileHdr()->btree_order_ + 1) << ix_name;
+        for (int id = 0; id < num_keys; id += 7) {
+            config.make_key(id, key.data());
+            std::vector<Rid> result;
+            ASSERT_TRUE(ih->get_value(key.data(), &result, &txn)) << id;
+            EXPECT_EQ(id, result[0].page_no);
+        }
+        buffer_pool_manager->delete_all_pages(ih->getFd());
+        ix_manager->close_index(ih.get());
+        ix_manager->destroy_index(ix_name);
+    }
+}
+
+TEST(StorageTest, IndexLogRecoveryTest) {
+    const std::string table_name = "ix_log_recovery";
+    std::vector<ColMeta> index_cols{ColMeta{table_name, "id", TYPE_INT, 4, 0, false}};
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(1024, disk_manager.get(), log_manager.get());
+    auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    Transaction txn(0);
+    std::string ix_name = IxManager::get_index_name(table_name, index_cols);
+    if (disk_manager->is_file(ix_name)) {
+        disk_manager->destroy_file(ix_name);
+    }
+    if (disk_manager->is_file(LOG_FILE_NAME)) {
+        disk_manager->destroy_file(LOG_FILE_NAME);
+    }
+    disk_manager->create_file(LOG_FILE_NAME);
+    ix_manager->create_index(table_name, index_cols);
+    auto ih = ix_manager->open_index(table_name, index_cols);
+
+    // 乱序插入引起多次分裂，再删除大部分键引起合并和重分配
+    const int num_keys = 6000;
+    std::vector<int> keys;
+    for (int i = 0; i < num_keys; i++) {
+        keys.push_back(i);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(11));
+    for (int key : keys) {
+        ih->insert_entry(reinterpret_cast<const char *>(&key), Rid{key, 1}, &txn);
+    }
+    for (int key : keys) {
+        if (key % 5 != 0) {
+            ih->delete_entry(reinterpret_cast<const char *>(&key), &txn);
+        }
+    }
+    ASSERT_TRUE(ih->verify());
+
+    log_manager->flush_log_to_disk();
+    auto records = log_manager->get_records();
+    int num_entries = 0, num_splits = 0, num_merges = 0;
+    for (auto &record : records) {
+        num_entries += record->log_type_ == IX_INSERT || record->log_type_ == IX_DELETE;
+        num_splits += record->log_type_ == IX_SPLIT;
+        num_merges += record->log_type_ == IX_MERGE;
+    }
+    EXPECT_EQ(num_keys * 2 - num_keys / 5, num_entries);
+    EXPECT_GT(num_splits, 0);
+    EXPECT_GT(num_merges, 0);
+    auto first = dynamic_cast<IxEntryLogRecord *>(records.front().get());
+    ASSERT_NE(nullptr, first);
+    EXPECT_EQ(ix_name, first->index_name_);
+    EXPECT_EQ(keys[0], *reinterpret_cast<const int *>(first->key_.data()));
+    EXPECT_EQ(1, first->rid_.slot_no);
+
+    // 模拟崩溃：丢弃缓冲池中的页面和内存中的文件头，重新打开索引
+    int fd = ih->getFd();
+    buffer_pool_manager->delete_all_pages(fd);
+    disk_manager->close_file(fd);
+    ih = ix_manager->open_index(table_name, index_cols);
+    fd = ih->getFd();
+    EXPECT_TRUE(ih->is_empty_tree());
+
+    // 按恢复的顺序先分析文件头，再依次重做
+    for (auto &record : records) {
+        if (auto smo = dynamic_cast<IxSmoLogRecord *>(record.get())) {
+            ih->smo_analyze(*smo);
+        }
+    }
+    for (auto &record : records) {
+        if (auto smo = dynamic_cast<IxSmoLogRecord *>(record.get())) {
+            ih->smo_recover(*smo, smo->lsn_);
+            continue;
+        }
+        auto entry = dynamic_cast<IxEntryLogRecord *>(record.get());
+        Page *page = buffer_pool_manager->fetch_page(PageId{fd, entry->page_no_});
+        if (page->get_page_lsn() < entry->lsn_) {
+            if (entry->log_type_ == IX_INSERT) {
+                ih->insert_entry_recover(entry->page_no_, entry->key_.data(), entry->rid_, entry->lsn_);
+            } else {
+                ih->delete_entry_recover(entry->page_no_, entry->key_.data(), entry->lsn_);
+            }
+        }
+        buffer_pool_manager->unpin_page(page->get_page_id(), false);
+    }
+    ASSERT_TRUE(ih->verify());
+    int expected = 0;
+    for (page_id_t page_no = ih->getFileHdr()->first_leaf_; page_no != IX_LEAF_HEADER_PAGE;) {
+        auto node = std::make_unique<IxNodeHandle>(ih->getFileHdr(),
+                                                   buffer_pool_manager->fetch_page(PageId{fd, page_no}));
+        for (int i = 0; i < node->get_size(); i++) {
+            int key;
+            ix_denormalize_key(node->get_key(i), reinterpret_cast<char *>(&key), ih->getFileHdr()->col_types_,
+                               ih->getFileHdr()->col_lens_);
+            ASSERT_EQ(expected, key);
+            expected += 5;
+        }
+        page_no = node->get_next_leaf();
+        buffer_pool_manager->unpin_page(node->get_page_id(), false);
+    }
+    EXPECT_EQ(num_keys, expected);
+
+    // 恢复后空闲页面位图与崩溃前一致，继续插入不会覆盖已有结点；回滚时记录补偿日志
+    for (int key = 1; key < num_keys; key += 5) {
+        ih->insert_entry(reinterpret_cast<const char *>(&key), Rid{key, 1}, &txn);
+    }
+    for (int key = 0; key < num_keys; key++) {
+        std::vector<Rid> result;
+        ASSERT_EQ(key % 5 <= 1, ih->get_value(reinterpret_cast<const char *>(&key), &result, &txn)) << key;
+    }
+    lsn_t prev_lsn = txn.get_prev_lsn();
+    int key = 1;
+    ih->delete_entry(reinterpret_cast<const char *>(&key), &txn, LogOperation::UNDO, prev_lsn);
+    log_manager->flush_log_to_disk();
+    records = log_manager->get_records();
+    // 删除后可能还有合并或重分配的日志
+    IxEntryLogRecord *clr = nullptr;
+    for (auto it = records.rbegin(); clr == nullptr; ++it) {
+        clr = dynamic_cast<IxEntryLogRecord *>(it->get());
+    }
+    EXPECT_EQ(IX_CLR_DELETE, clr->log_type_);
+    EXPECT_EQ(prev_lsn, clr->undo_next_);
+    EXPECT_TRUE(ih->verify());
+
+    buffer_pool_manager->delete_all_pages(fd);
+    disk_manager->close_file(fd);
+    ix_manager->destroy_index(ix_name);
+    disk_manager->close_file(disk_manager->GetLogFd());
+    disk_manager->destroy_file(LOG_FILE_NAME);
+}
+
+TEST(StorageTest, IndexConcurrencyTest) {
+    const std::string table_name = "ix_concurrency";
+    std::vector<ColMeta> index_cols{ColMeta{table_name, "id", TYPE_INT, 4, 0, false}};
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+    auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    std::string ix_name = IxManager::get_index_name(table_name, index_cols);
+    if (disk_manager->is_file(ix_name)) {
+        disk_manager->destroy_file(ix_name);
+    }
+    ix_manager->create_index(table_name, index_cols);
+    auto ih = ix_manager->open_index(table_name, index_cols);
+
+    // 多个线程交错插入各自的键，同时查找已插入的键；之后并发删除一半的键，引起分裂、合并和重分配
+    const int num_threads = 8;
+    const int keys_per_thread = 4000;
+    auto run = [&](const std::function<void(int)> &work) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; t++) {
+            threads.emplace_back(work, t);
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    };
+    std::atomic<int> errors{0};
+    run([&](int t) {
+        Transaction txn(t);
+        std::vector<int> keys;
+        for (int i = 0; i < keys_per_thread; i++) {
+            keys.push_back(i * num_threads + t);
+        }
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(t));
+        for (int i = 0; i < keys_per_thread; i++) {
+            ih->insert_entry(reinterpret_cast<const char *>(&keys[i]), Rid{keys[i], 0}, &txn);
+            std::vector<Rid> result;
+            int key = keys[i / 2];
+            if (!ih->get_value(reinterpret_cast<const char *>(&key), &result, &txn) || result[0].page_no != key) {
+                errors++;
+            }
+        }
+    });
+    EXPECT_EQ(0, errors.load());
+    run([&](int t) {
+        Transaction txn(t);
+        for (int i = 0; i < keys_per_thread; i += 2) {
+            int key = i * num_threads + t;
+            if (!ih->delete_entry(reinterpret_cast<const char *>(&key), &txn)) {
+                errors++;
+            }
+        }
+    });
+    EXPECT_EQ(0, errors.load());
+    EXPECT_TRUE(ih->verify());
+
+    // 扫描全部叶子，之后仍可以修改(扫描不残留页面latch)
+    Transaction txn(0);
+    IxScan scan(ih.get(), ih->leaf_begin(), ih->leaf_end(), buffer_pool_manager.get());
+    int num_keys = 0;
+    for (; !scan.is_end(); scan.next(), num_keys++) {
+        int key = scan.rid().page_no;
+        ASSERT_EQ(1, key / num_threads % 2) << key;
+    }
+    EXPECT_EQ(num_threads * keys_per_thread / 2, num_keys);
+    for (int key = 0; key < num_threads * keys_per_thread; key += num_threads * 2) {
+        ih->insert_entry(reinterpret_cast<const char *>(&key), Rid{key, 0}, &txn);
+        IxScan point(ih.get(), ih->lower_bound(reinterpret_cast<const char *>(&key)),
+                     ih->upper_bound(reinterpret_cast<const char *>(&key)), buffer_pool_manager.get());
+        ASSERT_FALSE(point.is_end());
+        EXPECT_EQ(key, point.rid().page_no);
+        EXPECT_TRUE(ih->delete_entry(reinterpret_cast<const char *>(&key), &txn));
+    }
+    EXPECT_TRUE(ih->verify());
+
+    buffer_pool_manager->delete_all_pages(ih->getFd());
+    ix_manager->close_index(ih.get());
+    ix_manager->destroy_index(ix_name);
+}
+
+TEST(CsvLoaderTest, ParseTest) {
+    auto parse_int = [](const std::string &s, int *v) { return csv_field::parse_int(s.data(), s.data() + s.size(), v); };
+    int i;
+    EXPECT_TRUE(parse_int("-2147483648", &i));
+    EXPECT_EQ(INT32_MIN, i);
+    EXPECT_TRUE(parse_int(" +42 ", &i));
+    EXPECT_EQ(42, i);
+    EXPECT_FALSE(parse_int("2147483648", &i));
+    EXPECT_FALSE(parse_int("12a", &i));
+    EXPECT_FALSE(parse_int("-", &i));
+
+    int64_t b;
+    bool overflow;
+    std::string s = "-9223372036854775808";
+    EXPECT_TRUE(csv_field::parse_bigint(s.data(), s.data() + s.size(), &b, &overflow));
+    EXPECT_EQ(INT64_MIN, b);
+    s = "9223372036854775808";
+    EXPECT_FALSE(csv_field::parse_bigint(s.data(), s.data() + s.size(), &b, &overflow));
+    EXPECT_TRUE(overflow);
+    s = "99999999999999999999x";
+    EXPECT_FALSE(csv_field::parse_bigint(s.data(), s.data() + s.size(), &b, &overflow));
+    EXPECT_FALSE(overflow);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1e6f, 1e6f);
+    for (int k = 0; k < 1000; k++) {
+        std::string f = std::to_string(dist(rng));
+        float v;
+        ASSERT_TRUE(csv_field::parse_float(f.data(), f.data() + f.size(), &v));
+        EXPECT_EQ(std::stof(f), v);
+    }
+
+    // datetime的检查和编码与Value::set_datetime一致
+    for (std::string d : {"2023-05-18 09:12:19", "1999-02-29  23:59:59", "2023-13-01 00:00:00",
+                          "2023-02-30 00:00:00", "0999-01-01 00:00:00", "2023-01-01T00:00:00",
+                          "2023-1-01 00:00:00", "2023-01-01 24:00:00", "2023-01-01 00:00:00 "}) {
+        int64_t v;
+        bool ok = csv_field::parse_datetime(d.data(), d.data() + d.size(), &v);
+        Value expect;
+        ASSERT_EQ(expect.is_valid_date(d), ok) << d;
+        if (ok) {
+            expect.set_datetime(d);
+            EXPECT_EQ(expect.datetime_val, v) << d;
+        }
+    }
+
+    // 各行解析为与Value::init_raw相同的定长记录
+    TabMeta tab;
+    tab.name = "t";
+    int offset = 0;
+    for (auto [type, len] : std::vector<std::pair<ColType, int>>{
+             {TYPE_INT, 4}, {TYPE_FLOAT, 4}, {TYPE_STRING, 6}, {TYPE_BIGINT, 8}, {TYPE_DATETIME, 8}, {TYPE_VARCHAR, 5}}) {
+        tab.cols.push_back(ColMeta{.tab_name = "t", .name = "c" + std::to_string(offset), .type = type, .len = len,
+                                   .offset = offset, .index = false});
+        offset += len;
+    }
+    std::string lines = "7,1.5,abc,-12345678901,2023-05-18 09:12:19,xy\r\n\n-3,0.25,abcdef,0,1000-01-01 00:00:00,";
+    std::vector<char> recs;
+    EXPECT_EQ(2u, CsvLoader::parse_lines(tab, offset, lines.data(), lines.data() + lines.size(), &recs));
+    ASSERT_EQ(2u * offset, recs.size());
+    std::vector<std::vector<Value>> expect_rows(2, std::vector<Value>(6));
+    expect_rows[0][0].set_int(7);
+    expect_rows[0][1].set_float(1.5f);
+    expect_rows[0][2].set_str("abc");
+    expect_rows[0][3].set_bigint(std::string("-12345678901"));
+    expect_rows[0][4].set_datetime("2023-05-18 09:12:19");
+    expect_rows[0][5].set_varchar("xy");
+    expect_rows[1][0].set_int(-3);
+    expect_rows[1][1].set_float(0.25f);
+    expect_rows[1][2].set_str("abcdef");
+    expect_rows[1][3].set_bigint(0);
+    expect_rows[1][4].set_datetime("1000-01-01 00:00:00");
+    expect_rows[1][5].set_varchar("");
+    for (int r = 0; r < 2; r++) {
+        for (size_t c = 0; c < tab.cols.size(); c++) {
+            expect_rows[r][c].init_raw(tab.cols[c].len);
+            EXPECT_EQ(0, memcmp(expect_rows[r][c].raw->data, recs.data() + r * offset + tab.cols[c].offset,
+                                tab.cols[c].len));
+        }
+    }
+
+    auto parse_error = [&](const std::string &line) {
+        std::vector<char> out;
+        CsvLoader::parse_lines(tab, offset, line.data(), line.data() + line.size(), &out);
+    };
+    EXPECT_THROW(parse_error("1,1.0,abcdefg,1,2023-01-01 00:00:00,a"), StringOverflowError);
+    EXPECT_THROW(parse_error("1,1.0,a,1,2023-01-01 00:00:00"), InvalidValueCountError);
+    EXPECT_THROW(parse_error("1,1.0,a,1,2023-01-01 00:00:00,a,b"), InvalidValueCountError);
+    EXPECT_THROW(parse_error("x,1.0,a,1,2023-01-01 00:00:00,a"), IncompatibleTypeError);
+    EXPECT_THROW(parse_error("1,1.0,a,99999999999999999999,2023-01-01 00:00:00,a"), BigintOutOfRangeError);
+    EXPECT_THROW(parse_error("1,1.0,a,1,2023-02-30 00:00:00,a"), DateTimeAbsurdError);
+}
+
+// LOAD向空索引批量建树不写索引日志；事务未提交就崩溃时，撤销删除了表中的记录，索引须在rebuild中重建
+TEST(CsvLoaderTest, LoadRecoveryTest) {
+    const std::string db_name = "load_recovery_db";
+    const int num_rows = 1000;
+    if (system(("rm -rf " + db_name).c_str()) < 0) {
+        throw UnixError();
+    }
+    {
+        auto disk_manager = std::make_unique<DiskManager>();
+        auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+        auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get(),
+                                                                       log_manager.get());
+        auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+        auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+        SmManager sm_manager(disk_manager.get(), buffer_pool_manager.get(), rm_manager.get(), ix_manager.get());
+        LockManager lock_manager;
+        TransactionManager txn_manager(&lock_manager, &sm_manager);
+        sm_manager.create_db(db_name);
+        sm_manager.open_db(db_name);
+
+        Transaction *ddl_txn = txn_manager.begin(nullptr, log_manager.get());
+        Context ddl_context(&lock_manager, log_manager.get(), ddl_txn);
+        sm_manager.create_table("t", {{"id", TYPE_INT, 4}, {"v", TYPE_INT, 4}}, &ddl_context);
+        sm_manager.create_index("t", {"id"}, &ddl_context);
+        txn_manager.commit(ddl_txn, log_manager.get());
+
+        std::ofstream csv("load.csv");
+        csv << "id,v\n";
+        for (int i = 0; i < num_rows; i++) {
+            csv << i << "," << i * 2 << "\n";
+        }
+        csv.close();
+        Transaction *load_txn = txn_manager.begin(nullptr, log_manager.get());
+        Context load_context(&lock_manager, log_manager.get(), load_txn);
+        sm_manager.load_csv("load.csv", "t", &load_context);
+        EXPECT_NE(INVALID_LSN, sm_manager.ihs_.begin()->second->getFileHdr()->base_lsn_);
+
+        // 模拟崩溃：日志和表的页面已经写盘，LOAD事务没有提交
+        log_manager->flush_log_to_disk();
+        buffer_pool_manager->flush_all_pages(sm_manager.fhs_.at("t")->GetFd());
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    }
+
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get(),
+                                                                   log_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    SmManager sm_manager(disk_manager.get(), buffer_pool_manager.get(), rm_manager.get(), ix_manager.get());
+    sm_manager.open_db(db_name);
+    RecoveryManager recovery(disk_manager.get(), buffer_pool_manager.get(), &sm_manager, log_manager.get());
+    recovery.analyze();
+    recovery.redo();
+    recovery.undo();
+    recovery.rebuild();
+
+    auto fh = sm_manager.fhs_.at("t").get();
+    RmScan scan(fh);
+    EXPECT_TRUE(scan.is_end());
+    auto ih = sm_manager.ihs_.begin()->second.get();
+    EXPECT_TRUE(ih->verify());
+    for (int i = 0; i < num_rows; i += 97) {
+        std::vector<Rid> result;
+        EXPECT_FALSE(ih->get_value(reinterpret_cast<const char *>(&i), &result, nullptr)) << i;
+    }
+
+    sm_manager.close_db();
+    if (system(("rm -rf " + db_name).c_str()) < 0) {
+        throw UnixError();
+    }
+}
+
+// 撤销删除时记录被放到第一个空闲位置：删除后的空位已被提交的事务占用时，恢复的索引项须指向记录的新位置
+TEST(RecoveryTest, UndoDeleteRidTest) {
+    const std::string db_name = "undo_rid_db";
+    const int num_rows = 10;
+    if (system(("rm -rf " + db_name).c_str()) < 0) {
+        throw UnixError();
+    }
+    Rid deleted_rid{};
+    {
+        auto disk_manager = std::make_unique<DiskManager>();
+        auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+        auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get(),
+                                                                       log_manager.get());
+        auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+        auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+        SmManager sm_manager(disk_manager.get(), buffer_pool_manager.get(), rm_manager.get(), ix_manager.get());
+        LockManager lock_manager;
+        TransactionManager txn_manager(&lock_manager, &sm_manager);
+        sm_manager.create_db(db_name);
+        sm_manager.open_db(db_name);
+
+        Transaction *ddl_txn = txn_manager.begin(nullptr, log_manager.get());
+        Context ddl_context(&lock_manager, log_manager.get(), ddl_txn);
+        sm_manager.create_table("t", {{"id", TYPE_INT, 4}, {"v", TYPE_INT, 4}}, &ddl_context);
+        sm_manager.create_index("t", {"id"}, &ddl_context);
+        txn_manager.commit(ddl_txn, log_manager.get());
+
+        std::string table_name = "t";
+        auto fh = sm_manager.fhs_.at(table_name).get();
+        auto ih = sm_manager.ihs_.begin()->second.get();
+        auto insert_row = [&](int id, Context *context) {
+            int row[2] = {id, id * 2};
+            Rid rid = fh->insert_record(reinterpret_cast<char *>(row), context, &table_name);
+            ih->insert_entry(reinterpret_cast<const char *>(&id), rid, context->txn_);
+            return rid;
+        };
+        Transaction *insert_txn = txn_manager.begin(nullptr, log_manager.get());
+        Context insert_context(&lock_manager, log_manager.get(), insert_txn);
+        std::vector<Rid> rids;
+        for (int i = 0; i < num_rows; i++) {
+            rids.push_back(insert_row(i, &insert_context));
+        }
+        txn_manager.commit(insert_txn, log_manager.get());
+
+        // 未提交的事务删除id=3，之后提交的事务插入id=100，占用了删除留下的空位
+        Transaction *loser_txn = txn_manager.begin(nullptr, log_manager.get());
+        Context loser_context(&lock_manager, log_manager.get(), loser_txn);
+        int key = 3;
+        deleted_rid = rids[key];
+        ih->delete_entry(reinterpret_cast<const char *>(&key), loser_txn);
+        fh->delete_record(deleted_rid, &loser_context, &table_name);
+        Transaction *winner_txn = txn_manager.begin(nullptr, log_manager.get());
+        Context winner_context(&lock_manager, log_manager.get(), winner_txn);
+        EXPECT_EQ(deleted_rid, insert_row(100, &winner_context));
+        txn_manager.commit(winner_txn, log_manager.get());
+
+        log_manager->flush_log_to_disk();
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    }
+
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get(),
+                                                                   log_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    SmManager sm_manager(disk_manager.get(), buffer_pool_manager.get(), rm_manager.get(), ix_manager.get());
+    sm_manager.open_db(db_name);
+    RecoveryManager recovery(disk_manager.get(), buffer_pool_manager.get(), &sm_manager, log_manager.get());
+    recovery.analyze();
+    recovery.redo();
+    recovery.undo();
+    recovery.rebuild();
+
+    // 每个索引项都指向键相同的记录
+    auto fh = sm_manager.fhs_.at("t").get();
+    auto ih = sm_manager.ihs_.begin()->second.get();
+    std::vector<int> keys;
+    for (int i = 0; i < num_rows; i++) {
+        keys.push_back(i);
+    }
+    keys.push_back(100);
+    for (int key : keys) {
+        std::vector<Rid> result;
+        ASSERT_TRUE(ih->get_value(reinterpret_cast<const char *>(&key), &result, nullptr)) << key;
+        auto rec = fh->get_record(result[0], nullptr);
+        EXPECT_EQ(key, *reinterpret_cast<int *>(rec->data)) << key;
+    }
+    std::vector<Rid> result;
+    int key = 3;
+    ih->get_value(reinterpret_cast<const char *>(&key), &result, nullptr);
+    EXPECT_NE(deleted_rid, result[0]);
+
+    sm_manager.close_db();
+    if (system(("rm -rf " + db_name).c_str()) < 0) {
+        throw UnixError();
+    }
+}
+
 TEST(RecordManagerTest, SimpleTest) {
     srand((unsigned)time(nullptr));
 
@@ -596,7 +2504,7 @@ TEST(RecordManagerTest, SimpleTest) {
         assert(file_handle->file_hdr_.num_pages == 1);
 
         int max_bytes = file_handle->file_hdr_.record_size * file_handle->file_hdr_.num_records_per_page +
-                        file_handle->file_hdr_.bitmap_size + (int)sizeof(RmPageHdr);
+                        file_handle->file_hdr_.bitmap_size + (int)sizeof(RmPageHdr) + (int)Page::OFFSET_PAGE_HDR;
         assert(max_bytes <= PAGE_SIZE);
         int rand_val = rand();
         file_handle->file_hdr_.num_pages = rand_val;
@@ -612,7 +2520,11 @@ TEST(RecordManagerTest, SimpleTest) {
     rm_manager->create_file(filename, record_size);
     auto file_handle = rm_manager->open_file(filename);
 
-    char write_buf[PAGE_SIZE];
+    LogManager log_manager(disk_manager.get());
+    Transaction txn(0);
+    Context context(nullptr, &log_manager, &txn);
+
+    char write_buf[MAX_PAGE_SIZE];
     size_t add_cnt = 0;
     size_t upd_cnt = 0;
     size_t del_cnt = 0;
@@ -621,7 +2533,7 @@ TEST(RecordManagerTest, SimpleTest) {
         double dice = rand() * 1. / RAND_MAX;
         if (mock.empty() || dice < insert_prob) {
             rand_buf(file_handle->file_hdr_.record_size, write_buf);
-            Rid rid = file_handle->insert_record(write_buf, nullptr);
+            Rid rid = file_handle->insert_record(write_buf, &context, &filename);
             mock[rid] = std::string((char *)write_buf, file_handle->file_hdr_.record_size);
             add_cnt++;
             //            std::cout << "insert " << rid << '\n'; // operator<<(cout,rid)
@@ -636,13 +2548,13 @@ TEST(RecordManagerTest, SimpleTest) {
             if (rand() % 2 == 0) {
                 // update
                 rand_buf(file_handle->file_hdr_.record_size, write_buf);
-                file_handle->update_record(rid, write_buf, nullptr);
+                file_handle->update_record(rid, write_buf, &context, &filename);
                 mock[rid] = std::string((char *)write_buf, file_handle->file_hdr_.record_size);
                 upd_cnt++;
                 //                std::cout << "update " << rid << '\n';
             } else {
                 // erase
-                file_handle->delete_record(rid, nullptr);
+                file_handle->delete_record(rid, &context, &filename);
                 mock.erase(rid);
                 del_cnt++;
                 //                std::cout << "delete " << rid << '\n';